@@ -0,0 +1,584 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifdef WINDOWSENV
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+#include <mtl/st40_api.h>
+
+#include "../sample/sample_util.h"
+
+/* include "struct sockaddr_in" define before include mudp_api */
+// clang-format off
+#ifdef WINDOWSENV
+#include <mtl/mudp_win.h>
+#endif
+#include <mtl/mudp_api.h>
+// clang-format on
+
+/* the size of the evict buffer and the max rotated buffers in cold mode, > any LLC */
+#define BENCH_COLD_BYTES (512 * 1024 * 1024)
+#define BENCH_RESULT_MAX (256)
+/* the udw words of one st40 anc packet */
+#define BENCH_ST40_UDW_NUM (255)
+/* the anc packets of one st40 op, amortize the tsc read */
+#define BENCH_ST40_PKTS (64)
+
+struct bench_result {
+  char suite[16];
+  char name[48];
+  const char* level;
+  uint32_t ops;
+  size_t bytes_per_op;
+  double ns_min;
+  double ns_avg;
+  double ns_p50;
+  double ns_p99;
+  double ns_max;
+};
+
+struct bench_ctx {
+  struct st_sample_context* ctx;
+  mtl_handle st;
+  double tsc_hz;
+  uint32_t iterations;
+  uint32_t warmup;
+  bool cold;
+  uint8_t* evict_buf; /* read through before each timed loop in cold mode */
+
+  uint64_t* samples; /* the tsc cycles of each timed op */
+  struct bench_result results[BENCH_RESULT_MAX];
+  int nb_results;
+};
+
+typedef int (*bench_cvt_fn)(void* src, void* dst, uint32_t w, uint32_t h,
+                            enum mtl_simd_level level);
+typedef void (*bench_fill_fn)(void* buf, uint32_t w, uint32_t h);
+
+struct bench_cvt {
+  const char* name;
+  bench_cvt_fn cvt;
+  bench_fill_fn fill;
+  /* bytes per 6 pixels, the lcm of the pgroup of all formats */
+  size_t src_bytes_6px;
+  size_t dst_bytes_6px;
+};
+
+static inline uint64_t bench_tsc(void) { return __rdtsc(); }
+
+static double bench_tsc_calibrate(void) {
+  uint64_t start_ns = sample_get_monotonic_time();
+  uint64_t start_tsc = bench_tsc();
+  uint64_t end_ns, end_tsc;
+
+  usleep(100 * 1000);
+  end_tsc = bench_tsc();
+  end_ns = sample_get_monotonic_time();
+  return (double)(end_tsc - start_tsc) * NS_PER_S / (end_ns - start_ns);
+}
+
+static int bench_cmp_u64(const void* a, const void* b) {
+  uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+  return (x > y) - (x < y);
+}
+
+static struct bench_result* bench_result_new(struct bench_ctx* b, const char* suite,
+                                             const char* name, const char* level,
+                                             size_t bytes_per_op) {
+  struct bench_result* r;
+
+  if (b->nb_results >= BENCH_RESULT_MAX) {
+    err("%s, max %d results\n", __func__, BENCH_RESULT_MAX);
+    return NULL;
+  }
+  r = &b->results[b->nb_results++];
+  memset(r, 0, sizeof(*r));
+  snprintf(r->suite, sizeof(r->suite), "%s", suite);
+  snprintf(r->name, sizeof(r->name), "%s", name);
+  r->level = level;
+  r->bytes_per_op = bytes_per_op;
+  return r;
+}
+
+/* fill the result by the tsc samples, ops_per_sample for the batched samples */
+static void bench_result_fill(struct bench_ctx* b, struct bench_result* r,
+                              uint32_t nb_samples, uint32_t ops_per_sample) {
+  double ns_per_cycle = (double)NS_PER_S / b->tsc_hz / ops_per_sample;
+  uint64_t sum = 0;
+
+  if (!r || !nb_samples) return;
+  qsort(b->samples, nb_samples, sizeof(*b->samples), bench_cmp_u64);
+  for (uint32_t i = 0; i < nb_samples; i++) sum += b->samples[i];
+
+  r->ops = nb_samples * ops_per_sample;
+  r->ns_min = b->samples[0] * ns_per_cycle;
+  r->ns_avg = (double)sum / nb_samples * ns_per_cycle;
+  r->ns_p50 = b->samples[nb_samples / 2] * ns_per_cycle;
+  r->ns_p99 = b->samples[(uint64_t)nb_samples * 99 / 100] * ns_per_cycle;
+  r->ns_max = b->samples[nb_samples - 1] * ns_per_cycle;
+}
+
+static double bench_mb_per_s(struct bench_result* r) {
+  if (!r->bytes_per_op || r->ns_avg <= 0) return 0;
+  return (double)r->bytes_per_op * NS_PER_S / r->ns_avg / 1024 / 1024;
+}
+
+static void bench_dump(struct bench_ctx* b) {
+  enum sample_bench_output output = b->ctx->bench_output;
+  struct bench_result* r;
+
+  if (output == SAMPLE_BENCH_OUTPUT_CSV) {
+    printf("suite,name,level,cache,ops,bytes,ns_min,ns_avg,ns_p50,ns_p99,ns_max,mb_s\n");
+    for (int i = 0; i < b->nb_results; i++) {
+      r = &b->results[i];
+      printf("%s,%s,%s,%s,%u,%" PRIu64 ",%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n", r->suite,
+             r->name, r->level, b->cold ? "cold" : "warm", r->ops,
+             (uint64_t)r->bytes_per_op, r->ns_min, r->ns_avg, r->ns_p50, r->ns_p99,
+             r->ns_max, bench_mb_per_s(r));
+    }
+    return;
+  }
+
+  if (output == SAMPLE_BENCH_OUTPUT_JSON) {
+    printf("{\"simd\":\"%s\",\"tsc_hz\":%.0f,\"cache\":\"%s\",\"results\":[\n",
+           mtl_get_simd_level_name(mtl_get_simd_level()), b->tsc_hz,
+           b->cold ? "cold" : "warm");
+    for (int i = 0; i < b->nb_results; i++) {
+      r = &b->results[i];
+      printf("{\"suite\":\"%s\",\"name\":\"%s\",\"level\":\"%s\",\"ops\":%u,"
+             "\"bytes\":%" PRIu64 ",\"ns_min\":%.1f,\"ns_avg\":%.1f,\"ns_p50\":%.1f,"
+             "\"ns_p99\":%.1f,\"ns_max\":%.1f,\"mb_s\":%.1f}%s\n",
+             r->suite, r->name, r->level, r->ops, (uint64_t)r->bytes_per_op, r->ns_min,
+             r->ns_avg, r->ns_p50, r->ns_p99, r->ns_max, bench_mb_per_s(r),
+             (i == b->nb_results - 1) ? "" : ",");
+    }
+    printf("]}\n");
+    return;
+  }
+
+  printf("simd %s, tsc %.0fhz, cache %s\n", mtl_get_simd_level_name(mtl_get_simd_level()),
+         b->tsc_hz, b->cold ? "cold" : "warm");
+  printf("%-6s %-28s %-12s %-8s %-12s %-12s %-12s %-12s %-10s\n", "SUITE", "NAME",
+         "LEVEL", "OPS", "MIN(ns)", "AVG(ns)", "P50(ns)", "P99(ns)", "MB/s");
+  for (int i = 0; i < b->nb_results; i++) {
+    r = &b->results[i];
+    printf("%-6s %-28s %-12s %-8u %-12.1f %-12.1f %-12.1f %-12.1f %-10.1f\n", r->suite,
+           r->name, r->level, r->ops, r->ns_min, r->ns_avg, r->ns_p50, r->ns_p99,
+           bench_mb_per_s(r));
+  }
+}
+
+/*
+ * The number of buffer sets to rotate, one for cache warm. In cold mode each timed op
+ * uses a set not touched since the last bench_cache_evict, or more than the LLC ago.
+ */
+static uint32_t bench_buf_cnt(struct bench_ctx* b, size_t set_size) {
+  uint32_t cnt;
+
+  if (!b->cold) return 1;
+  cnt = BENCH_COLD_BYTES / set_size;
+  if (cnt < 2) cnt = 2;
+  if (cnt > b->iterations) cnt = b->iterations; /* each set used once after the evict */
+  return cnt;
+}
+
+/* read a buffer bigger than the LLC to push the bench buffers out of the cache */
+static void bench_cache_evict(struct bench_ctx* b) {
+  volatile uint8_t sink = 0;
+
+  if (!b->cold) return;
+  for (size_t i = 0; i < BENCH_COLD_BYTES; i += 64) sink += b->evict_buf[i];
+}
+
+static void bench_fill_be10(void* buf, uint32_t w, uint32_t h) {
+  fill_rfc4175_422_10_pg2_data(buf, w, h);
+}
+
+static void bench_fill_be12(void* buf, uint32_t w, uint32_t h) {
+  fill_rfc4175_422_12_pg2_data(buf, w, h);
+}
+
+/* 10 bit value in each 16 bit word, for p10le and y210(msb aligned) */
+static void bench_fill_u16(void* buf, uint32_t w, uint32_t h) {
+  uint16_t* p = buf;
+  size_t words = (size_t)w * h * 2;
+
+  for (size_t i = 0; i < words; i++) p[i] = (rand() & 0x3ff) << 6;
+}
+
+static void bench_fill_p10le(void* buf, uint32_t w, uint32_t h) {
+  uint16_t* p = buf;
+  size_t words = (size_t)w * h * 2;
+
+  for (size_t i = 0; i < words; i++) p[i] = rand() & 0x3ff;
+}
+
+static void bench_fill_v210(void* buf, uint32_t w, uint32_t h) {
+  uint8_t* p = buf;
+  size_t bytes = (size_t)w * h * 8 / 3;
+
+  for (size_t i = 0; i < bytes; i++) p[i] = rand();
+}
+
+static int bench_be10_to_p10le(void* src, void* dst, uint32_t w, uint32_t h,
+                               enum mtl_simd_level level) {
+  uint16_t* y = dst;
+  return st20_rfc4175_422be10_to_yuv422p10le_simd(src, y, y + w * h, y + w * h * 3 / 2,
+                                                  w, h, level);
+}
+
+static int bench_p10le_to_be10(void* src, void* dst, uint32_t w, uint32_t h,
+                               enum mtl_simd_level level) {
+  uint16_t* y = src;
+  return st20_yuv422p10le_to_rfc4175_422be10_simd(y, y + w * h, y + w * h * 3 / 2, dst,
+                                                  w, h, level);
+}
+
+static int bench_be10_to_le10(void* src, void* dst, uint32_t w, uint32_t h,
+                              enum mtl_simd_level level) {
+  return st20_rfc4175_422be10_to_422le10_simd(src, dst, w, h, level);
+}
+
+static int bench_le10_to_be10(void* src, void* dst, uint32_t w, uint32_t h,
+                              enum mtl_simd_level level) {
+  return st20_rfc4175_422le10_to_422be10_simd(src, dst, w, h, level);
+}
+
+static int bench_be10_to_le8(void* src, void* dst, uint32_t w, uint32_t h,
+                             enum mtl_simd_level level) {
+  return st20_rfc4175_422be10_to_422le8_simd(src, dst, w, h, level);
+}
+
+static int bench_be10_to_v210(void* src, void* dst, uint32_t w, uint32_t h,
+                              enum mtl_simd_level level) {
+  return st20_rfc4175_422be10_to_v210_simd(src, dst, w, h, level);
+}
+
+static int bench_v210_to_be10(void* src, void* dst, uint32_t w, uint32_t h,
+                              enum mtl_simd_level level) {
+  return st20_v210_to_rfc4175_422be10_simd(src, dst, w, h, level);
+}
+
+static int bench_be10_to_y210(void* src, void* dst, uint32_t w, uint32_t h,
+                              enum mtl_simd_level level) {
+  return st20_rfc4175_422be10_to_y210_simd(src, dst, w, h, level);
+}
+
+static int bench_y210_to_be10(void* src, void* dst, uint32_t w, uint32_t h,
+                              enum mtl_simd_level level) {
+  return st20_y210_to_rfc4175_422be10_simd(src, dst, w, h, level);
+}
+
+static int bench_be12_to_le12(void* src, void* dst, uint32_t w, uint32_t h,
+                              enum mtl_simd_level level) {
+  return st20_rfc4175_422be12_to_422le12_simd(src, dst, w, h, level);
+}
+
+static int bench_be12_to_p12le(void* src, void* dst, uint32_t w, uint32_t h,
+                               enum mtl_simd_level level) {
+  uint16_t* y = dst;
+  return st20_rfc4175_422be12_to_yuv422p12le_simd(src, y, y + w * h, y + w * h * 3 / 2,
+                                                  w, h, level);
+}
+
+static const struct bench_cvt bench_cvts[] = {
+    {"rfc4175_422be10_to_p10le", bench_be10_to_p10le, bench_fill_be10, 15, 24},
+    {"p10le_to_rfc4175_422be10", bench_p10le_to_be10, bench_fill_p10le, 24, 15},
+    {"rfc4175_422be10_to_le10", bench_be10_to_le10, bench_fill_be10, 15, 15},
+    {"rfc4175_422le10_to_be10", bench_le10_to_be10, bench_fill_be10, 15, 15},
+    {"rfc4175_422be10_to_le8", bench_be10_to_le8, bench_fill_be10, 15, 12},
+    {"rfc4175_422be10_to_v210", bench_be10_to_v210, bench_fill_be10, 15, 16},
+    {"v210_to_rfc4175_422be10", bench_v210_to_be10, bench_fill_v210, 16, 15},
+    {"rfc4175_422be10_to_y210", bench_be10_to_y210, bench_fill_be10, 15, 24},
+    {"y210_to_rfc4175_422be10", bench_y210_to_be10, bench_fill_u16, 24, 15},
+    {"rfc4175_422be12_to_le12", bench_be12_to_le12, bench_fill_be12, 18, 18},
+    {"rfc4175_422be12_to_p12le", bench_be12_to_p12le, bench_fill_be12, 18, 24},
+};
+
+static int bench_cvt_one(struct bench_ctx* b, const struct bench_cvt* c, uint32_t w,
+                         uint32_t h, enum mtl_simd_level level) {
+  size_t src_size = (size_t)w * h / 6 * c->src_bytes_6px;
+  size_t dst_size = (size_t)w * h / 6 * c->dst_bytes_6px;
+  uint32_t cnt = bench_buf_cnt(b, src_size + dst_size);
+  uint8_t* src = malloc(src_size * cnt);
+  uint8_t* dst = malloc(dst_size * cnt);
+  struct bench_result* r;
+  uint64_t start;
+  int ret = 0;
+
+  if (!src || !dst) {
+    err("%s, %s malloc fail for %u buffers\n", __func__, c->name, cnt);
+    free(src);
+    free(dst);
+    return -ENOMEM;
+  }
+  for (uint32_t i = 0; i < cnt; i++) c->fill(src + i * src_size, w, h);
+  memset(dst, 0, dst_size * cnt); /* fault in all pages before the timing */
+
+  for (uint32_t i = 0; i < b->warmup; i++) {
+    ret = c->cvt(src, dst, w, h, level);
+    if (ret < 0) {
+      err("%s, %s fail %d at level %s\n", __func__, c->name, ret,
+          mtl_get_simd_level_name(level));
+      goto out;
+    }
+  }
+  bench_cache_evict(b);
+  for (uint32_t i = 0; i < b->iterations; i++) {
+    uint32_t idx = i % cnt;
+    start = bench_tsc();
+    c->cvt(src + idx * src_size, dst + idx * dst_size, w, h, level);
+    b->samples[i] = bench_tsc() - start;
+  }
+
+  r = bench_result_new(b, "cvt", c->name, mtl_get_simd_level_name(level), src_size);
+  bench_result_fill(b, r, b->iterations, 1);
+
+out:
+  free(src);
+  free(dst);
+  return ret;
+}
+
+static int bench_cvt(struct bench_ctx* b) {
+  enum mtl_simd_level cpu_level = mtl_get_simd_level();
+  uint32_t w = b->ctx->width, h = b->ctx->height;
+
+  if ((w * h) % 6) {
+    err("%s, %ux%u not aligned to 6 pixels\n", __func__, w, h);
+    return -EINVAL;
+  }
+  for (size_t i = 0; i < sizeof(bench_cvts) / sizeof(bench_cvts[0]); i++) {
+    for (int level = MTL_SIMD_LEVEL_NONE; level <= cpu_level; level++) {
+      bench_cvt_one(b, &bench_cvts[i], w, h, level);
+    }
+  }
+
+  return 0;
+}
+
+static void bench_st40_pack(uint8_t* udw_buf, uint16_t seed) {
+  for (uint32_t i = 0; i < BENCH_ST40_UDW_NUM; i++) {
+    st40_set_udw(i + 3, st40_add_parity_bits((uint8_t)(seed + i)), udw_buf);
+  }
+  st40_set_udw(BENCH_ST40_UDW_NUM + 3,
+               st40_calc_checksum(BENCH_ST40_UDW_NUM + 3, udw_buf), udw_buf);
+}
+
+static uint32_t bench_st40_unpack(uint8_t* udw_buf) {
+  uint32_t sum = 0;
+
+  for (uint32_t i = 0; i < BENCH_ST40_UDW_NUM; i++) {
+    sum += st40_get_udw(i + 3, udw_buf) & 0xff;
+  }
+  return sum;
+}
+
+static int bench_st40(struct bench_ctx* b) {
+  /* did, sdid, data count, the udw and the checksum in 10 bit words */
+  size_t pkt_size = (BENCH_ST40_UDW_NUM + 4) * 10 / 8 + 4;
+  size_t set_size = pkt_size * BENCH_ST40_PKTS;
+  uint32_t cnt = bench_buf_cnt(b, set_size);
+  uint8_t* buf = calloc(cnt, set_size);
+  struct bench_result* r;
+  volatile uint32_t sink = 0;
+  uint64_t start;
+
+  if (!buf) {
+    err("%s, malloc fail for %u buffers\n", __func__, cnt);
+    return -ENOMEM;
+  }
+  memset(buf, 0, cnt * set_size); /* fault in all pages before the timing */
+
+  for (uint32_t i = 0; i < b->warmup; i++) bench_st40_pack(buf, i);
+  bench_cache_evict(b);
+  for (uint32_t i = 0; i < b->iterations; i++) {
+    uint8_t* set = buf + (i % cnt) * set_size;
+    start = bench_tsc();
+    for (uint32_t p = 0; p < BENCH_ST40_PKTS; p++) bench_st40_pack(set + p * pkt_size, i);
+    b->samples[i] = bench_tsc() - start;
+  }
+  r = bench_result_new(b, "st40", "udw_pack", "none", pkt_size);
+  bench_result_fill(b, r, b->iterations, BENCH_ST40_PKTS);
+
+  for (uint32_t i = 0; i < b->warmup; i++) sink += bench_st40_unpack(buf);
+  bench_cache_evict(b);
+  for (uint32_t i = 0; i < b->iterations; i++) {
+    uint8_t* set = buf + (i % cnt) * set_size;
+    start = bench_tsc();
+    for (uint32_t p = 0; p < BENCH_ST40_PKTS; p++)
+      sink += bench_st40_unpack(set + p * pkt_size);
+    b->samples[i] = bench_tsc() - start;
+  }
+  r = bench_result_new(b, "st40", "udw_unpack", "none", pkt_size);
+  bench_result_fill(b, r, b->iterations, BENCH_ST40_PKTS);
+
+  free(buf);
+  return 0;
+}
+
+static bool bench_is_loopback(struct bench_ctx* b, const char* suite) {
+  if (mtl_pmd_by_port_name(b->ctx->param.port[MTL_PORT_P]) == MTL_PMD_DPDK_LOOPBACK)
+    return true;
+  warn("%s, skip the %s suite, it runs on a loopback port(--p_port loopback0)\n",
+       __func__, suite);
+  return false;
+}
+
+/* one op is a sendto and a recvfrom on the same socket through the loopback port */
+static int bench_mudp(struct bench_ctx* b) {
+  struct st_sample_context* ctx = b->ctx;
+  size_t udp_len = ctx->udp_len ? ctx->udp_len : 1024;
+  uint32_t total = b->warmup + b->iterations, nb_samples = 0, fails = 0;
+  struct sockaddr_in addr;
+  struct bench_result* r;
+  mudp_handle socket;
+  uint8_t *tx_buf, *rx_buf;
+  uint64_t start;
+  ssize_t ret;
+
+  if (!bench_is_loopback(b, "mudp")) return 0;
+
+  socket = mudp_socket(b->st, AF_INET, SOCK_DGRAM, 0);
+  if (!socket) {
+    err("%s, socket create fail\n", __func__);
+    return -EIO;
+  }
+  mudp_init_sockaddr(&addr, mtl_p_sip_addr(&ctx->param), ctx->udp_port);
+  ret = mudp_bind(socket, (const struct sockaddr*)&addr, sizeof(addr));
+  if (ret < 0) {
+    err("%s, bind fail %d\n", __func__, (int)ret);
+    mudp_close(socket);
+    return -EIO;
+  }
+  mudp_set_rx_timeout(socket, 10 * 1000);
+
+  tx_buf = calloc(1, udp_len);
+  rx_buf = calloc(1, udp_len);
+  if (!tx_buf || !rx_buf) {
+    free(tx_buf);
+    free(rx_buf);
+    mudp_close(socket);
+    return -ENOMEM;
+  }
+
+  for (uint32_t i = 0; i < total; i++) {
+    start = bench_tsc();
+    ret = mudp_sendto(socket, tx_buf, udp_len, 0, (const struct sockaddr*)&addr,
+                      sizeof(addr));
+    if (ret == (ssize_t)udp_len)
+      ret = mudp_recvfrom(socket, rx_buf, udp_len, 0, NULL, NULL);
+    if (ret != (ssize_t)udp_len) {
+      fails++;
+      continue;
+    }
+    if (i >= b->warmup) b->samples[nb_samples++] = bench_tsc() - start;
+  }
+  if (fails) warn("%s, %u round trips fail\n", __func__, fails);
+
+  r = bench_result_new(b, "mudp", "sendto_recvfrom", "none", udp_len);
+  bench_result_fill(b, r, nb_samples, 1);
+
+  free(tx_buf);
+  free(rx_buf);
+  mudp_close(socket);
+  return 0;
+}
+
+static bool bench_match(struct bench_ctx* b, const char* suite) {
+  return !strcmp(b->ctx->bench, "all") || !strcmp(b->ctx->bench, suite);
+}
+
+static void* bench_thread(void* arg) {
+  struct bench_ctx* b = arg;
+  unsigned int lcore = 0;
+  int ret;
+
+  ret = mtl_get_lcore(b->st, &lcore);
+  if (ret < 0) {
+    err("%s, get lcore fail %d\n", __func__, ret);
+    return NULL;
+  }
+  mtl_bind_to_lcore(b->st, pthread_self(), lcore);
+  info("%s, run in lcore %u\n", __func__, lcore);
+
+  b->tsc_hz = bench_tsc_calibrate();
+  if (bench_match(b, "cvt")) bench_cvt(b);
+  if (bench_match(b, "st40")) bench_st40(b);
+  /* the traffic suite, the socket is created on the started instance */
+  if (bench_match(b, "mudp")) {
+    ret = mtl_start(b->st);
+    if (ret < 0) {
+      err("%s, mtl_start fail %d\n", __func__, ret);
+    } else {
+      bench_mudp(b);
+      mtl_stop(b->st);
+    }
+  }
+
+  mtl_put_lcore(b->st, lcore);
+  return NULL;
+}
+
+int main(int argc, char** argv) {
+  struct st_sample_context ctx;
+  struct bench_ctx* b;
+  pthread_t thread;
+  int ret;
+
+  memset(&ctx, 0, sizeof(ctx));
+  ret = tx_sample_parse_args(&ctx, argc, argv);
+  if (ret < 0) return ret;
+  /* the benchmark result only */
+  if (ctx.bench_output != SAMPLE_BENCH_OUTPUT_TEXT)
+    ctx.param.log_level = MTL_LOG_LEVEL_ERROR;
+
+  b = calloc(1, sizeof(*b));
+  if (!b) return -ENOMEM;
+  b->ctx = &ctx;
+  b->iterations = ctx.bench_iterations ? ctx.bench_iterations : 1;
+  b->warmup = ctx.bench_warmup;
+  b->cold = ctx.bench_cold;
+  b->samples = calloc(b->iterations, sizeof(*b->samples));
+  if (!b->samples) {
+    free(b);
+    return -ENOMEM;
+  }
+  if (b->cold) {
+    b->evict_buf = malloc(BENCH_COLD_BYTES);
+    if (!b->evict_buf) {
+      free(b->samples);
+      free(b);
+      return -ENOMEM;
+    }
+    memset(b->evict_buf, 1, BENCH_COLD_BYTES); /* real pages, not the zero page */
+  }
+
+  ctx.st = mtl_init(&ctx.param);
+  if (!ctx.st) {
+    err("%s: mtl_init fail\n", __func__);
+    free(b->evict_buf);
+    free(b->samples);
+    free(b);
+    return -EIO;
+  }
+  b->st = ctx.st;
+
+  pthread_create(&thread, NULL, bench_thread, b);
+  pthread_join(thread, NULL);
+  bench_dump(b);
+
+  /* release sample(st) dev */
+  if (ctx.st) {
+    mtl_uninit(ctx.st);
+    ctx.st = NULL;
+  }
+  free(b->evict_buf);
+  free(b->samples);
+  free(b);
+  return 0;
+}
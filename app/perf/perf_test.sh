@@ -32,5 +32,6 @@ perf_func PerfY210ToRfc4175422be10
 perf_func PerfRfc4175422be12ToLe
 perf_func PerfRfc4175422be12ToP12Le
 perf_func PerfDma
+perf_func PerfBench
 
 echo "****** All Perf test OK ******"
\ No newline at end of file
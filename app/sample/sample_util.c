@@ -58,6 +58,12 @@ enum sample_args_cmd {
   SAMPLE_ARG_UDP_LEN,
   SAMPLE_ARG_UDP_TX_BPS_G,
 
+  SAMPLE_ARG_BENCH = 0x400,
+  SAMPLE_ARG_BENCH_ITERATIONS,
+  SAMPLE_ARG_BENCH_WARMUP,
+  SAMPLE_ARG_BENCH_COLD,
+  SAMPLE_ARG_BENCH_OUTPUT,
+
   SAMPLE_ARG_MAX,
 };
 
@@ -105,6 +111,12 @@ static struct option sample_args_options[] = {
     {"use_cpu_copy", no_argument, 0, SAMPLE_ARG_USE_CPU_COPY},
     {"rx_dump", no_argument, 0, SAMPLE_ARG_RX_DUMP},
 
+    {"bench", required_argument, 0, SAMPLE_ARG_BENCH},
+    {"bench_iterations", required_argument, 0, SAMPLE_ARG_BENCH_ITERATIONS},
+    {"bench_warmup", required_argument, 0, SAMPLE_ARG_BENCH_WARMUP},
+    {"bench_cold", no_argument, 0, SAMPLE_ARG_BENCH_COLD},
+    {"bench_output", required_argument, 0, SAMPLE_ARG_BENCH_OUTPUT},
+
     {0, 0, 0, 0}};
 
 static int sample_args_parse_tx_mac(struct st_sample_context* ctx, char* mac_str,
@@ -318,6 +330,28 @@ static int _sample_parse_args(struct st_sample_context* ctx, int argc, char** ar
       case SAMPLE_ARG_USE_CPU_COPY:
         ctx->use_cpu_copy = true;
         break;
+      case SAMPLE_ARG_BENCH:
+        snprintf(ctx->bench, sizeof(ctx->bench), "%s", optarg);
+        break;
+      case SAMPLE_ARG_BENCH_ITERATIONS:
+        ctx->bench_iterations = atoi(optarg);
+        break;
+      case SAMPLE_ARG_BENCH_WARMUP:
+        ctx->bench_warmup = atoi(optarg);
+        break;
+      case SAMPLE_ARG_BENCH_COLD:
+        ctx->bench_cold = true;
+        break;
+      case SAMPLE_ARG_BENCH_OUTPUT:
+        if (!strcmp(optarg, "text"))
+          ctx->bench_output = SAMPLE_BENCH_OUTPUT_TEXT;
+        else if (!strcmp(optarg, "csv"))
+          ctx->bench_output = SAMPLE_BENCH_OUTPUT_CSV;
+        else if (!strcmp(optarg, "json"))
+          ctx->bench_output = SAMPLE_BENCH_OUTPUT_JSON;
+        else
+          err("%s, unknow bench_output %s\n", __func__, optarg);
+        break;
       case '?':
         break;
       default:
@@ -403,6 +437,10 @@ int sample_parse_args(struct st_sample_context* ctx, int argc, char** argv, bool
   ctx->st22p_output_fmt = ST_FRAME_FMT_YUV422PLANAR10LE;
   ctx->st22p_codec = ST22_CODEC_JPEGXS;
 
+  snprintf(ctx->bench, sizeof(ctx->bench), "all");
+  ctx->bench_iterations = 100;
+  ctx->bench_warmup = 10;
+
   p->tx_queues_cnt_max = 8;
   p->rx_queues_cnt_max = 8;
 
@@ -66,6 +66,16 @@ enum sample_udp_mode {
   SAMPLE_UDP_MODE_MAX,
 };
 
+enum sample_bench_output {
+  /* human readable table */
+  SAMPLE_BENCH_OUTPUT_TEXT = 0,
+  /* one line per result with a header line */
+  SAMPLE_BENCH_OUTPUT_CSV,
+  /* array of result objects */
+  SAMPLE_BENCH_OUTPUT_JSON,
+  SAMPLE_BENCH_OUTPUT_MAX,
+};
+
 struct st_sample_context {
   mtl_handle st;
   struct mtl_init_params param;
@@ -103,6 +113,12 @@ struct st_sample_context {
   uint64_t udp_tx_bps;
   int udp_len;
 
+  char bench[32]; /* the suite of PerfBench, all for every suite */
+  uint32_t bench_iterations;
+  uint32_t bench_warmup;
+  bool bench_cold; /* evict the LLC before each timed loop, a fresh buffer for each op */
+  enum sample_bench_output bench_output;
+
   bool exit;
   void (*sig_handler)(int signo);
 
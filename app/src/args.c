@@ -51,6 +51,9 @@ enum st_args_cmd {
   ST_ARG_TEST_TIME,
   ST_ARG_PTP_UNICAST_ADDR,
   ST_ARG_CNI_THREAD,
+  ST_ARG_CNI_RX_TS,
+  ST_ARG_FRAME_ARENA,
+  ST_ARG_TELEMETRY,
   ST_ARG_RX_EBU,
   ST_ARG_USER_LCORES,
   ST_ARG_SCH_DATA_QUOTA,
@@ -77,6 +80,16 @@ enum st_args_cmd {
   ST_ARG_START_QUEUE,
   ST_ARG_P_START_QUEUE,
   ST_ARG_R_START_QUEUE,
+  ST_ARG_AF_XDP_BUSY_BUDGET,
+  ST_ARG_AF_XDP_BUSY_POLL_DISABLE,
+  ST_ARG_AF_XDP_SHARED_UMEM,
+  ST_ARG_AF_XDP_FORCE_COPY,
+  ST_ARG_AF_XDP_PROG,
+  ST_ARG_P_PCAP_RX,
+  ST_ARG_P_PCAP_TX,
+  ST_ARG_R_PCAP_RX,
+  ST_ARG_R_PCAP_TX,
+  ST_ARG_PCAP_REALTIME,
   ST_ARG_TASKLET_TIME,
   ST_ARG_UTC_OFFSET,
   ST_ARG_NO_SYSTEM_RX_QUEUES,
@@ -84,12 +97,18 @@ enum st_args_cmd {
   ST_ARG_TASKLET_THREAD,
   ST_ARG_TASKLET_SLEEP,
   ST_ARG_TASKLET_SLEEP_US,
+  ST_ARG_TASKLET_BALANCE,
+  ST_ARG_SCH_QUOTA_AUTO,
   ST_ARG_APP_THREAD,
   ST_ARG_RXTX_SIMD_512,
   ST_ARG_PTP_PI,
   ST_ARG_PTP_KP,
   ST_ARG_PTP_KI,
   ST_ARG_PTP_TSC,
+  ST_ARG_PTP_SERVO,
+  ST_ARG_PTP_DELAY_FILTER,
+  ST_ARG_PTP_DELAY_FILTER_LEN,
+  ST_ARG_PTP_DOMAIN,
   ST_ARG_RSS_MODE,
   ST_ARG_RANDOM_SRC_PORT,
   ST_ARG_TX_NO_CHAIN,
@@ -149,6 +168,9 @@ static struct option st_app_args_options[] = {
     {"test_time", required_argument, 0, ST_ARG_TEST_TIME},
     {"ptp_unicast", no_argument, 0, ST_ARG_PTP_UNICAST_ADDR},
     {"cni_thread", no_argument, 0, ST_ARG_CNI_THREAD},
+    {"cni_rx_ts", no_argument, 0, ST_ARG_CNI_RX_TS},
+    {"frame_arena", no_argument, 0, ST_ARG_FRAME_ARENA},
+    {"telemetry", no_argument, 0, ST_ARG_TELEMETRY},
     {"ebu", no_argument, 0, ST_ARG_RX_EBU},
     {"lcores", required_argument, 0, ST_ARG_USER_LCORES},
     {"sch_data_quota", required_argument, 0, ST_ARG_SCH_DATA_QUOTA},
@@ -175,6 +197,16 @@ static struct option st_app_args_options[] = {
     {"start_queue", required_argument, 0, ST_ARG_START_QUEUE},
     {"p_start_queue", required_argument, 0, ST_ARG_P_START_QUEUE},
     {"r_start_queue", required_argument, 0, ST_ARG_R_START_QUEUE},
+    {"afxdp_busy_budget", required_argument, 0, ST_ARG_AF_XDP_BUSY_BUDGET},
+    {"afxdp_busy_poll_disable", no_argument, 0, ST_ARG_AF_XDP_BUSY_POLL_DISABLE},
+    {"afxdp_shared_umem", no_argument, 0, ST_ARG_AF_XDP_SHARED_UMEM},
+    {"afxdp_force_copy", no_argument, 0, ST_ARG_AF_XDP_FORCE_COPY},
+    {"afxdp_prog", required_argument, 0, ST_ARG_AF_XDP_PROG},
+    {"p_pcap_rx", required_argument, 0, ST_ARG_P_PCAP_RX},
+    {"p_pcap_tx", required_argument, 0, ST_ARG_P_PCAP_TX},
+    {"r_pcap_rx", required_argument, 0, ST_ARG_R_PCAP_RX},
+    {"r_pcap_tx", required_argument, 0, ST_ARG_R_PCAP_TX},
+    {"pcap_realtime", no_argument, 0, ST_ARG_PCAP_REALTIME},
     {"tasklet_time", no_argument, 0, ST_ARG_TASKLET_TIME},
     {"utc_offset", required_argument, 0, ST_ARG_UTC_OFFSET},
     {"no_srq", no_argument, 0, ST_ARG_NO_SYSTEM_RX_QUEUES},
@@ -182,12 +214,18 @@ static struct option st_app_args_options[] = {
     {"tasklet_thread", no_argument, 0, ST_ARG_TASKLET_THREAD},
     {"tasklet_sleep", no_argument, 0, ST_ARG_TASKLET_SLEEP},
     {"tasklet_sleep_us", required_argument, 0, ST_ARG_TASKLET_SLEEP_US},
+    {"tasklet_balance", no_argument, 0, ST_ARG_TASKLET_BALANCE},
+    {"sch_quota_auto", no_argument, 0, ST_ARG_SCH_QUOTA_AUTO},
     {"app_thread", no_argument, 0, ST_ARG_APP_THREAD},
     {"rxtx_simd_512", no_argument, 0, ST_ARG_RXTX_SIMD_512},
     {"pi", no_argument, 0, ST_ARG_PTP_PI},
     {"kp", required_argument, 0, ST_ARG_PTP_KP},
     {"ki", required_argument, 0, ST_ARG_PTP_KI},
     {"ptp_tsc", no_argument, 0, ST_ARG_PTP_TSC},
+    {"ptp_servo", required_argument, 0, ST_ARG_PTP_SERVO},
+    {"ptp_delay_filter", required_argument, 0, ST_ARG_PTP_DELAY_FILTER},
+    {"ptp_delay_filter_len", required_argument, 0, ST_ARG_PTP_DELAY_FILTER_LEN},
+    {"ptp_domain", required_argument, 0, ST_ARG_PTP_DOMAIN},
     {"rss_mode", required_argument, 0, ST_ARG_RSS_MODE},
     {"random_src_port", no_argument, 0, ST_ARG_RANDOM_SRC_PORT},
     {"tx_no_chain", no_argument, 0, ST_ARG_TX_NO_CHAIN},
@@ -416,6 +454,15 @@ int st_app_parse_args(struct st_app_context* ctx, struct mtl_init_params* p, int
       case ST_ARG_CNI_THREAD:
         p->flags |= MTL_FLAG_CNI_THREAD;
         break;
+      case ST_ARG_CNI_RX_TS:
+        p->flags |= MTL_FLAG_CNI_RX_TIMESTAMP;
+        break;
+      case ST_ARG_FRAME_ARENA:
+        p->flags |= MTL_FLAG_FRAME_ARENA;
+        break;
+      case ST_ARG_TELEMETRY:
+        p->flags |= MTL_FLAG_TELEMETRY_SHM;
+        break;
       case ST_ARG_TEST_TIME:
         ctx->test_time_s = atoi(optarg);
         break;
@@ -515,6 +562,48 @@ int st_app_parse_args(struct st_app_context* ctx, struct mtl_init_params* p, int
       case ST_ARG_R_START_QUEUE:
         p->xdp_info[MTL_PORT_R].start_queue = atoi(optarg);
         break;
+      case ST_ARG_AF_XDP_BUSY_BUDGET:
+        p->xdp_info[MTL_PORT_P].busy_budget = atoi(optarg);
+        p->xdp_info[MTL_PORT_R].busy_budget = atoi(optarg);
+        break;
+      case ST_ARG_AF_XDP_BUSY_POLL_DISABLE:
+        p->xdp_info[MTL_PORT_P].busy_poll_disable = true;
+        p->xdp_info[MTL_PORT_R].busy_poll_disable = true;
+        break;
+      case ST_ARG_AF_XDP_SHARED_UMEM:
+        p->xdp_info[MTL_PORT_P].shared_umem = true;
+        p->xdp_info[MTL_PORT_R].shared_umem = true;
+        break;
+      case ST_ARG_AF_XDP_FORCE_COPY:
+        p->xdp_info[MTL_PORT_P].force_copy = true;
+        p->xdp_info[MTL_PORT_R].force_copy = true;
+        break;
+      case ST_ARG_AF_XDP_PROG:
+        snprintf(p->xdp_info[MTL_PORT_P].xdp_prog,
+                 sizeof(p->xdp_info[MTL_PORT_P].xdp_prog), "%s", optarg);
+        snprintf(p->xdp_info[MTL_PORT_R].xdp_prog,
+                 sizeof(p->xdp_info[MTL_PORT_R].xdp_prog), "%s", optarg);
+        break;
+      case ST_ARG_P_PCAP_RX:
+        snprintf(p->pcap_info[MTL_PORT_P].rx_file,
+                 sizeof(p->pcap_info[MTL_PORT_P].rx_file), "%s", optarg);
+        break;
+      case ST_ARG_P_PCAP_TX:
+        snprintf(p->pcap_info[MTL_PORT_P].tx_file,
+                 sizeof(p->pcap_info[MTL_PORT_P].tx_file), "%s", optarg);
+        break;
+      case ST_ARG_R_PCAP_RX:
+        snprintf(p->pcap_info[MTL_PORT_R].rx_file,
+                 sizeof(p->pcap_info[MTL_PORT_R].rx_file), "%s", optarg);
+        break;
+      case ST_ARG_R_PCAP_TX:
+        snprintf(p->pcap_info[MTL_PORT_R].tx_file,
+                 sizeof(p->pcap_info[MTL_PORT_R].tx_file), "%s", optarg);
+        break;
+      case ST_ARG_PCAP_REALTIME:
+        p->pcap_info[MTL_PORT_P].rx_realtime = true;
+        p->pcap_info[MTL_PORT_R].rx_realtime = true;
+        break;
       case ST_ARG_TASKLET_TIME:
         p->flags |= MTL_FLAG_TASKLET_TIME_MEASURE;
         break;
@@ -533,6 +622,12 @@ int st_app_parse_args(struct st_app_context* ctx, struct mtl_init_params* p, int
       case ST_ARG_TASKLET_SLEEP_US:
         ctx->var_para.sch_force_sleep_us = atoi(optarg);
         break;
+      case ST_ARG_TASKLET_BALANCE:
+        p->flags |= MTL_FLAG_TASKLET_BALANCE;
+        break;
+      case ST_ARG_SCH_QUOTA_AUTO:
+        p->flags |= MTL_FLAG_SCH_QUOTA_AUTO;
+        break;
       case ST_ARG_TASKLET_THREAD:
         p->flags |= MTL_FLAG_TASKLET_THREAD;
         break;
@@ -554,6 +649,29 @@ int st_app_parse_args(struct st_app_context* ctx, struct mtl_init_params* p, int
       case ST_ARG_PTP_TSC:
         p->flags |= MTL_FLAG_PTP_SOURCE_TSC;
         break;
+      case ST_ARG_PTP_SERVO:
+        if (!strcmp(optarg, "default"))
+          p->ptp_servo = MTL_PTP_SERVO_DEFAULT;
+        else if (!strcmp(optarg, "linreg"))
+          p->ptp_servo = MTL_PTP_SERVO_LINREG;
+        else
+          err("%s, unknow ptp servo %s\n", __func__, optarg);
+        break;
+      case ST_ARG_PTP_DELAY_FILTER:
+        if (!strcmp(optarg, "median"))
+          p->ptp_delay_filter = MTL_PTP_DELAY_FILTER_MEDIAN;
+        else if (!strcmp(optarg, "min"))
+          p->ptp_delay_filter = MTL_PTP_DELAY_FILTER_MIN;
+        else
+          err("%s, unknow ptp delay filter %s\n", __func__, optarg);
+        break;
+      case ST_ARG_PTP_DELAY_FILTER_LEN:
+        p->ptp_delay_filter_len = atoi(optarg);
+        break;
+      case ST_ARG_PTP_DOMAIN:
+        p->flags |= MTL_FLAG_PTP_DOMAIN;
+        p->ptp_domain_number = atoi(optarg);
+        break;
       case ST_ARG_RANDOM_SRC_PORT:
         p->flags |= MTL_FLAG_RANDOM_SRC_PORT;
         break;
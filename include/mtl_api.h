@@ -61,6 +61,14 @@ extern "C" {
  * Max length of a DPDK port name and session logical port
  */
 #define MTL_PORT_MAX_LEN (64)
+/**
+ * The port name prefix of MTL_PMD_DPDK_LOOPBACK, ex: loopback0
+ */
+#define MTL_LOOPBACK_PORT_PREFIX "loopback"
+/**
+ * The port name prefix of MTL_PMD_DPDK_PCAP, ex: pcap0
+ */
+#define MTL_PCAP_PORT_PREFIX "pcap"
 /**
  * Length of a IPV4 address
  */
@@ -96,6 +104,14 @@ extern "C" {
  * Max length of a pcap dump file name
  */
 #define MTL_PCAP_FILE_MAX_LEN (32)
+/**
+ * Max length of the file path of a MTL_PMD_DPDK_PCAP port
+ */
+#define MTL_PCAP_PATH_MAX_LEN (256)
+/**
+ * Max length of the xdp program path of a MTL_PMD_DPDK_AF_XDP port
+ */
+#define MTL_XDP_PROG_PATH_MAX_LEN (256)
 
 /** Helper to get array size from arrays */
 #define MTL_ARRAY_SIZE(arr) (sizeof(arr) / sizeof(arr[0]))
@@ -173,10 +189,47 @@ enum mtl_pmd_type {
   MTL_PMD_DPDK_USER = 0,
   /** address family(kernel) high performance packet processing */
   MTL_PMD_DPDK_AF_XDP,
+  /**
+   * in-process loopback port backed by rte_ring, no NIC required. Two loopback ports
+   * are crossed, the pkts sent on one port are received by the other, and a single
+   * loopback port receive the pkts sent by itself. The rx pkts are steered to the
+   * sessions by the shared rx queue. The tx pacing is by tsc without chained mbufs
+   * and the ptp clock follow the system time.
+   */
+  MTL_PMD_DPDK_LOOPBACK,
+  /**
+   * pcap file backed port, no NIC required. The rx pkts are replayed from a pcap or
+   * pcapng file and the tx pkts are recorded to a pcap file, see mtl_pcap_params.
+   */
+  MTL_PMD_DPDK_PCAP,
   /** max value of this enum */
   MTL_PMD_TYPE_MAX,
 };
 
+/**
+ * The servo of the built-in PTP client
+ */
+enum mtl_ptp_servo {
+  /** the averaged frequency coefficient, with pi controller if MTL_FLAG_PTP_PI */
+  MTL_PTP_SERVO_DEFAULT = 0,
+  /** linear regression of the offset with outlier rejection and holdover */
+  MTL_PTP_SERVO_LINREG,
+  /** max value of this enum */
+  MTL_PTP_SERVO_MAX,
+};
+
+/**
+ * The path delay filter of the built-in PTP client, for MTL_PTP_SERVO_LINREG
+ */
+enum mtl_ptp_delay_filter {
+  /** median of the delay window */
+  MTL_PTP_DELAY_FILTER_MEDIAN = 0,
+  /** min of the delay window, for the network with queuing delay */
+  MTL_PTP_DELAY_FILTER_MIN,
+  /** max value of this enum */
+  MTL_PTP_DELAY_FILTER_MAX,
+};
+
 /**
  * RSS mode
  */
@@ -338,6 +391,27 @@ enum st21_tx_pacing_way {
  * Enable multiple source port for MTL_TRANSPORT_ST2110 20 tx.
  */
 #define MTL_FLAG_MULTI_SRC_PORT (MTL_BIT64(12))
+/**
+ * Flag bit in flags of struct mtl_init_params.
+ * Enable the cycle based balancer, the cpu cycles of each tasklet are measured and the
+ * audio/ancillary/udp tasklets are moved from the overloaded LCOREs to the idle ones.
+ * New video sessions are placed to the least loaded LCORE which still has the quota.
+ */
+#define MTL_FLAG_TASKLET_BALANCE (MTL_BIT64(13))
+/**
+ * Flag bit in flags of struct mtl_init_params.
+ * Calibrate the data quota of each LCORE by a short benchmark of the st20 tx/rx pkt
+ * path at init instead of the fixed 1080p session count, new sessions are admitted only
+ * if the measured load of the LCORE has headroom. No effect if data_quota_mbs_per_sch
+ * is set.
+ */
+#define MTL_FLAG_SCH_QUOTA_AUTO (MTL_BIT64(14))
+/**
+ * Flag bit in flags of struct mtl_init_params.
+ * The built-in ptp only follow the masters on ptp_domain_number, the masters on other
+ * domains are monitored only. If not set, the domain of the first master is used.
+ */
+#define MTL_FLAG_PTP_DOMAIN (MTL_BIT64(15))
 
 /**
  * Flag bit in flags of struct mtl_init_params, debug usage only.
@@ -349,6 +423,18 @@ enum st21_tx_pacing_way {
  * Enable video rx ebu check
  */
 #define MTL_FLAG_RX_VIDEO_EBU (MTL_BIT64(17))
+/**
+ * Flag bit in flags of struct mtl_init_params.
+ * Use the per pkt hw rx timestamp in the mbuf for the ptp sync if the NIC support
+ * RX_OFFLOAD_TIMESTAMP, instead of the rx timestamp register read for each sync.
+ */
+#define MTL_FLAG_CNI_RX_TIMESTAMP (MTL_BIT64(18))
+/**
+ * Flag bit in flags of struct mtl_init_params.
+ * Allocate the video session/pipeline frames from a size class frame arena shared by
+ * all sessions, the frames are kept and reused when a session is recreated.
+ */
+#define MTL_FLAG_FRAME_ARENA (MTL_BIT64(19))
 /**
  * Flag bit in flags of struct mtl_init_params, debug usage only.
  * Enable NIC promiscuous mode for RX
@@ -364,6 +450,12 @@ enum st21_tx_pacing_way {
  * Mono memory pool for all rx queue(sessions)
  */
 #define MTL_FLAG_RX_MONO_POOL (MTL_BIT64(22))
+/**
+ * Flag bit in flags of struct mtl_init_params.
+ * Publish the sessions, sch, ptp and dma state to a read-only shared memory segment for
+ * the monitor tools, see mtl_telemetry_api.h for the layout.
+ */
+#define MTL_FLAG_TELEMETRY_SHM (MTL_BIT64(23))
 /**
  * Flag bit in flags of struct mtl_init_params, debug usage only.
  * Do mtl_start in mtl_init, mtl_stop in mtl_uninit, and skip the mtl_start/mtl_stop
@@ -372,7 +464,8 @@ enum st21_tx_pacing_way {
 /**
  * Flag bit in flags of struct mtl_init_params, debug usage only.
  * Enable tasklet time measurement, report status if tasklet run time longer than
- * tasklet_time_thresh_us in mtl_init_params.
+ * tasklet_time_thresh_us in mtl_init_params. The p50/p99/p99.9/max of the tasklet and
+ * the sch loop time are also reported in the stat dump.
  */
 #define MTL_FLAG_TASKLET_TIME_MEASURE (MTL_BIT64(25))
 /**
@@ -416,6 +509,35 @@ struct mtl_af_xdp_params {
   uint8_t start_queue;
   /** total netdev queue number, must > 0 */
   uint8_t queue_count;
+  /**
+   * preferred busy poll budget of the queue sockets, 0 for the pmd default(64).
+   * Require kernel >= 5.11, also tune napi_defer_hard_irqs and gro_flush_timeout
+   * of the netdev as the af_xdp guide.
+   */
+  uint16_t busy_budget;
+  /** disable the preferred busy poll, the queues are driven by the kernel irq */
+  bool busy_poll_disable;
+  /** share one UMEM between the queues created from the same mempool */
+  bool shared_umem;
+  /** force the kernel copy mode of the queue sockets for rx and tx, no zero copy */
+  bool force_copy;
+  /**
+   * custom xdp program loaded to the netdev by the pmd, empty for the built-in one.
+   * The program should redirect the pkts to the queue sockets in the "xsks_map".
+   */
+  char xdp_prog[MTL_XDP_PROG_PATH_MAX_LEN];
+};
+
+/**
+ * The structure describing how to init a pcap port(MTL_PMD_DPDK_PCAP).
+ */
+struct mtl_pcap_params {
+  /** the pcap or pcapng file replayed as the rx traffic, empty for no rx */
+  char rx_file[MTL_PCAP_PATH_MAX_LEN];
+  /** the pcap file to record the tx traffic with ns timestamp, empty to drop tx */
+  char tx_file[MTL_PCAP_PATH_MAX_LEN];
+  /** replay at the original timestamps of rx_file, false for the max speed */
+  bool rx_realtime;
 };
 
 /**
@@ -424,7 +546,10 @@ struct mtl_af_xdp_params {
  */
 struct mtl_init_params {
   /* below are mandatory parameters */
-  /** Pcie BDF(ex: 0000:af:00.0) or enp175s0f0(MTL_PMD_DPDK_AF_XDP) */
+  /**
+   * Pcie BDF(ex: 0000:af:00.0), enp175s0f0(MTL_PMD_DPDK_AF_XDP) or
+   * loopback0(MTL_PMD_DPDK_LOOPBACK) or pcap0(MTL_PMD_DPDK_PCAP)
+   */
   char port[MTL_PORT_MAX][MTL_PORT_MAX_LEN];
   /** number of pcie ports, 1 or 2, mandatory */
   uint8_t num_ports;
@@ -486,6 +611,8 @@ struct mtl_init_params {
    * MTL_PMD_DPDK_AF_XDP will use the IP of kernel itself.
    */
   struct mtl_af_xdp_params xdp_info[MTL_PORT_MAX];
+  /** pcap port info, mandatory for MTL_PMD_DPDK_PCAP */
+  struct mtl_pcap_params pcap_info[MTL_PORT_MAX];
   /**
    * logical cores list can be used, e.g. "28,29,30,31".
    * NULL means determined by system itself
@@ -549,6 +676,22 @@ struct mtl_init_params {
    * The ptp pi controller integral gain.
    */
   double ki;
+  /**
+   * The servo of the built-in ptp client, default MTL_PTP_SERVO_DEFAULT.
+   */
+  enum mtl_ptp_servo ptp_servo;
+  /**
+   * The path delay filter of the built-in ptp client, default median.
+   */
+  enum mtl_ptp_delay_filter ptp_delay_filter;
+  /**
+   * The window of the path delay filter, leave to zero for the default(16), max 64.
+   */
+  uint8_t ptp_delay_filter_len;
+  /**
+   * The domain for the built-in ptp to follow, only used with MTL_FLAG_PTP_DOMAIN.
+   */
+  uint8_t ptp_domain_number;
   /**
    * Suggest using rss (L3 or L4) for rx packets direction.
    */
@@ -564,6 +707,38 @@ struct mtl_init_params {
   enum mtl_net_proto net_proto[MTL_PORT_MAX];
 };
 
+/**
+ * A structure used to retrieve the master selected by the built-in ptp.
+ */
+struct mtl_ptp_master_info {
+  /** the grandmaster clock identity */
+  uint8_t gm_identity[8];
+  /** the clock identity of the master port */
+  uint8_t master_identity[8];
+  /** the port number of the master port */
+  uint16_t master_port_number;
+  /** the ptp domain */
+  uint8_t domain_number;
+  /** grandmaster priority1 */
+  uint8_t priority1;
+  /** grandmaster priority2 */
+  uint8_t priority2;
+  /** grandmaster clock class */
+  uint8_t clock_class;
+  /** grandmaster clock accuracy */
+  uint8_t clock_accuracy;
+  /** grandmaster offset scaled log variance */
+  uint16_t offset_scaled_log_variance;
+  /** the steps between the master and the grandmaster */
+  uint16_t steps_removed;
+  /** the offset to UTC of the grandmaster */
+  int16_t utc_offset;
+  /** the masters seen on this port, include the ones of other domains */
+  uint8_t foreign_master_cnt;
+  /** the times of master change since init */
+  uint32_t master_changes;
+};
+
 /**
  * A structure used to retrieve capacity for an MTL instance.
  */
@@ -578,6 +753,37 @@ struct mtl_cap {
   uint64_t init_flags;
 };
 
+/** Max length of the metric name */
+#define MTL_METRIC_NAME_MAX (64)
+
+/**
+ * Type of a metric.
+ */
+enum mtl_metric_type {
+  /** monotonic counter since the publisher created, never reset */
+  MTL_METRIC_COUNTER = 0,
+  /** the current value */
+  MTL_METRIC_GAUGE,
+  /** max value of this enum */
+  MTL_METRIC_TYPE_MAX,
+};
+
+/**
+ * A structure used to retrieve one metric by mtl_metrics_snapshot.
+ */
+struct mtl_metric {
+  /** name in <publisher>.<index>.<metric> format, ex: st20_rx.0.0.pkts_received */
+  char name[MTL_METRIC_NAME_MAX];
+  /** type of the metric */
+  enum mtl_metric_type type;
+  union {
+    /** the value of MTL_METRIC_COUNTER */
+    uint64_t counter;
+    /** the value of MTL_METRIC_GAUGE */
+    int64_t gauge;
+  };
+};
+
 /**
  * A structure used to retrieve state for an MTL instance.
  */
@@ -739,6 +945,23 @@ int mtl_get_cap(mtl_handle mt, struct mtl_cap* cap);
  */
 int mtl_get_stats(mtl_handle mt, struct mtl_stats* stats);
 
+/**
+ * Read a snapshot of the metrics published by the sessions, the shared queues, the
+ * schedulers and the PTP. The counters are per lcore inside, the read never takes a
+ * lock on the data path so it can be called at any rate.
+ *
+ * @param mt
+ *   The handle to the media transport device context.
+ * @param metrics
+ *   The array to be filled, NULL to query the number of the metrics.
+ * @param max
+ *   The max number of elements in the metrics array.
+ * @return
+ *   - >=0: the number of metrics filled, or the total number if metrics is NULL.
+ *   - <0: Error code if fail.
+ */
+int mtl_metrics_snapshot(mtl_handle mt, struct mtl_metric* metrics, int max);
+
 /**
  * Enable or disable sleep mode for sch.
  *
@@ -833,6 +1056,22 @@ void* mtl_memcpy(void* dest, const void* src, size_t n);
  */
 uint64_t mtl_ptp_read_time(mtl_handle mt);
 
+/**
+ * Get the master selected by the built-in ptp on one port.
+ *
+ * @param mt
+ *   The handle to the media transport device context.
+ * @param port
+ *   The port.
+ * @param info
+ *   A pointer to info structure.
+ * @return
+ *   - >=0 succ.
+ *   - <0: Error code if no master selected or no built-in ptp on this port.
+ */
+int mtl_ptp_get_master(mtl_handle mt, enum mtl_port port,
+                       struct mtl_ptp_master_info* info);
+
 /**
  * Allocate memory from the huge-page area of memory. The memory is not cleared.
  * In NUMA systems, the memory allocated from the same NUMA socket of the port.
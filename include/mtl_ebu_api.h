@@ -0,0 +1,411 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+/**
+ * @file mtl_ebu_api.h
+ *
+ * The ST2110-21 video timing and ST2110-30 audio timing math of the EBU compliance
+ * check, shared by the rx sessions created with MTL_FLAG_RX_VIDEO_EBU and the offline
+ * analyzer in tools/ebu_analyzer.
+ * The caller feed the rtp timestamp and the rx time(ns, ptp time) of each packet, the
+ * per packet and per frame values are returned for the caller to aggregate and check.
+ * This header has no dependency to the library, the analyzer need not link to MTL.
+ *
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef _MTL_EBU_API_HEAD_H_
+/** Marco for re-include protect */
+#define _MTL_EBU_API_HEAD_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/** Drain factor of the Cinst check */
+#define MTL_EBU_CINST_DRAIN_FACTOR (1.1f)
+/** Max latency in ns */
+#define MTL_EBU_LATENCY_MAX_NS (1000 * 1000)
+/** Min RTP offset */
+#define MTL_EBU_RTP_OFFSET_MIN (-1)
+
+/**
+ * Result of one EBU check.
+ */
+enum mtl_ebu_result {
+  /** failed */
+  MTL_EBU_FAIL = 0,
+  /** passed, for the checks without narrow and wide */
+  MTL_EBU_PASS,
+  /** passed with narrow */
+  MTL_EBU_PASS_NARROW,
+  /** failed with narrow but passed with wide */
+  MTL_EBU_PASS_WIDE,
+  /** passed with the extended wide criteria, as the sw rx time is inaccurate */
+  MTL_EBU_PASS_WIDE_WA,
+};
+
+/**
+ * The ST2110-21 timing model and the pass criteria of a video stream.
+ */
+struct mtl_ebu_video_info {
+  /** in ns for of 2 consecutive packets, T-Frame / N-Packets */
+  double trs;
+  /** in ns, tr offset time of each frame */
+  double tr_offset;
+  /** time of the frame in ns */
+  double frame_time;
+  /** time of the frame in sampling(90k) */
+  double frame_time_sampling;
+  /** number of packets of each frame */
+  uint32_t pkts_per_frame;
+  /** linear sender model, TRS without the vertical blanking */
+  bool linear;
+
+  /** max Cinst for narrow */
+  uint32_t c_max_narrow_pass;
+  /** max Cinst for wide */
+  uint32_t c_max_wide_pass;
+  /** max VRX full for narrow */
+  uint32_t vrx_full_narrow_pass;
+  /** max VRX full for wide */
+  uint32_t vrx_full_wide_pass;
+  /** max RTP offset */
+  uint32_t rtp_offset_max_pass;
+};
+
+/**
+ * The per frame state and values of a video stream, updated by
+ * mtl_ebu_video_on_frame and mtl_ebu_video_on_packet.
+ */
+struct mtl_ebu_video_frame {
+  /** epoch of current frame */
+  uint64_t cur_epochs;
+  /** rx time of the first pkt of current frame */
+  uint64_t first_pkt_time;
+  /** vrx drained of the prev pkt */
+  int32_t vrx_drained_prev;
+  /** vrx of the prev pkt */
+  int32_t vrx_prev;
+  /** rx time of the prev pkt, 0 for the first pkt of a frame */
+  uint64_t prev_pkt_time;
+  /** rtp timestamp of the prev frame */
+  uint32_t prev_rtp_ts;
+
+  /** first packet time to the epoch(TPR0) in ns, frame level */
+  double fpt;
+  /** latency in ns, frame level */
+  double latency;
+  /** rtp offset to the epoch in sampling, frame level */
+  double rtp_offset;
+  /** rtp ts delta to the prev frame, frame level, valid if has_rtp_ts_delta */
+  int32_t rtp_ts_delta;
+  /** if rtp_ts_delta is valid */
+  bool has_rtp_ts_delta;
+
+  /** vrx of current pkt, packet level */
+  int32_t vrx;
+  /** Cinst of current pkt, packet level */
+  int32_t cinst;
+  /** inter-packet time in ns of current pkt, packet level, valid if has_ipt */
+  double ipt;
+  /** if ipt is valid */
+  bool has_ipt;
+};
+
+static inline double mtl_ebu_max(double a, double b) { return a > b ? a : b; }
+
+/**
+ * Init the timing model and the pass criteria of a video stream.
+ *
+ * @param info
+ *   The info to be filled.
+ * @param frame_time
+ *   The time of the frame in ns.
+ * @param sampling_rate
+ *   The rtp sampling clock rate, 90k for video.
+ * @param height
+ *   The height of the video.
+ * @param interlaced
+ *   If the video is interlaced.
+ * @param pkts_per_frame
+ *   The number of packets of each frame.
+ * @param linear
+ *   Use the linear sender model(TRS = T-Frame / N-Packets) instead of gapped.
+ * @return
+ *   - 0: Success.
+ *   - <0: Error code if any argument is invalid.
+ */
+static inline int mtl_ebu_video_info_init(struct mtl_ebu_video_info* info,
+                                          double frame_time, uint32_t sampling_rate,
+                                          uint32_t height, bool interlaced,
+                                          uint32_t pkts_per_frame, bool linear) {
+  double frame_time_s = frame_time / 1000000000.0;
+  double reactive = 1080.0 / 1125.0;
+
+  if ((frame_time <= 0) || !sampling_rate || !pkts_per_frame) return -1;
+
+  if (interlaced && height <= 576) {
+    reactive = (height == 480) ? 487.0 / 525.0 : 576.0 / 625.0;
+  }
+
+  info->frame_time = frame_time;
+  info->frame_time_sampling = (double)sampling_rate * frame_time_s;
+  info->pkts_per_frame = pkts_per_frame;
+  info->linear = linear;
+  if (linear)
+    info->trs = frame_time / pkts_per_frame;
+  else
+    info->trs = frame_time * reactive / pkts_per_frame;
+  if (!interlaced) {
+    info->tr_offset =
+        height >= 1080 ? frame_time * (43.0 / 1125.0) : frame_time * (28.0 / 750.0);
+  } else {
+    if (height == 480) {
+      info->tr_offset = frame_time * (20.0 / 525.0) * 2;
+    } else if (height == 576) {
+      info->tr_offset = frame_time * (26.0 / 625.0) * 2;
+    } else {
+      info->tr_offset = frame_time * (22.0 / 1125.0) * 2;
+    }
+  }
+
+  info->c_max_narrow_pass =
+      mtl_ebu_max(4, (double)pkts_per_frame / (43200 * reactive * frame_time_s));
+  info->c_max_wide_pass =
+      mtl_ebu_max(16, (double)pkts_per_frame / (21600 * frame_time_s));
+  info->vrx_full_narrow_pass = mtl_ebu_max(8, pkts_per_frame / (27000 * frame_time_s));
+  info->vrx_full_wide_pass = mtl_ebu_max(720, pkts_per_frame / (300 * frame_time_s));
+  info->rtp_offset_max_pass = ceil((info->tr_offset / 1000000000.0) * sampling_rate) + 1;
+
+  return 0;
+}
+
+/**
+ * Start a new frame on the first packet, fill the frame level values.
+ *
+ * @param info
+ *   The video info.
+ * @param frame
+ *   The frame state.
+ * @param rtp_ts
+ *   The rtp timestamp of the packet.
+ * @param pkt_time
+ *   The rx time of the packet in ns.
+ */
+static inline void mtl_ebu_video_on_frame(const struct mtl_ebu_video_info* info,
+                                          struct mtl_ebu_video_frame* frame,
+                                          uint32_t rtp_ts, uint64_t pkt_time) {
+  uint64_t epochs = (double)pkt_time / info->frame_time;
+  uint64_t epoch_tmstamp = (double)epochs * info->frame_time;
+  double fpt_delta = (double)pkt_time - epoch_tmstamp;
+  uint64_t tmstamp64 = epochs * info->frame_time_sampling;
+  uint32_t tmstamp32 = tmstamp64;
+  double diff_rtp_ts = (double)rtp_ts - tmstamp32;
+  double diff_rtp_ts_ns = diff_rtp_ts * info->frame_time / info->frame_time_sampling;
+
+  frame->cur_epochs = epochs;
+  frame->first_pkt_time = pkt_time;
+  frame->vrx_drained_prev = 0;
+  frame->vrx_prev = 0;
+  frame->prev_pkt_time = 0;
+
+  frame->fpt = fpt_delta;
+  frame->latency = fpt_delta - diff_rtp_ts_ns;
+  frame->rtp_offset = diff_rtp_ts;
+  frame->has_rtp_ts_delta = frame->prev_rtp_ts ? true : false;
+  if (frame->has_rtp_ts_delta) frame->rtp_ts_delta = rtp_ts - frame->prev_rtp_ts;
+  frame->prev_rtp_ts = rtp_ts;
+}
+
+/**
+ * Update the packet level values on each packet, after mtl_ebu_video_on_frame for the
+ * first packet of a frame.
+ *
+ * @param info
+ *   The video info.
+ * @param frame
+ *   The frame state.
+ * @param pkt_time
+ *   The rx time of the packet in ns.
+ * @param pkt_idx
+ *   The index of the packet in the frame, from 0.
+ */
+static inline void mtl_ebu_video_on_packet(const struct mtl_ebu_video_info* info,
+                                           struct mtl_ebu_video_frame* frame,
+                                           uint64_t pkt_time, int pkt_idx) {
+  uint64_t epoch_tmstamp = (uint64_t)(frame->cur_epochs * info->frame_time);
+  double tvd = epoch_tmstamp + info->tr_offset;
+  double trs = info->trs;
+
+  /* vrx */
+  double packet_delta_ns = (double)pkt_time - tvd;
+  int32_t drained = (packet_delta_ns + trs) / trs;
+  frame->vrx = frame->vrx_prev + 1 - (drained - frame->vrx_drained_prev);
+  frame->vrx_prev = frame->vrx;
+  frame->vrx_drained_prev = drained;
+
+  /* Cinst */
+  int exp_cin_pkts =
+      ((pkt_time - frame->first_pkt_time) / trs) * MTL_EBU_CINST_DRAIN_FACTOR;
+  frame->cinst = (pkt_idx - exp_cin_pkts) > 0 ? (pkt_idx - exp_cin_pkts) : 0;
+
+  /* inter-packet time */
+  frame->has_ipt = frame->prev_pkt_time ? true : false;
+  if (frame->has_ipt) frame->ipt = (double)pkt_time - frame->prev_pkt_time;
+  frame->prev_pkt_time = pkt_time;
+}
+
+/** Check the max Cinst of a period */
+static inline enum mtl_ebu_result mtl_ebu_video_cinst_check(
+    const struct mtl_ebu_video_info* info, int32_t cinst_max) {
+  if (cinst_max <= (int32_t)info->c_max_narrow_pass) return MTL_EBU_PASS_NARROW;
+  if (cinst_max <= (int32_t)info->c_max_wide_pass) return MTL_EBU_PASS_WIDE;
+  /* WA, the RX time inaccurate */
+  if (cinst_max <= (int32_t)(info->c_max_wide_pass * 16)) return MTL_EBU_PASS_WIDE_WA;
+  return MTL_EBU_FAIL;
+}
+
+/** Check the min and max VRX of a period */
+static inline enum mtl_ebu_result mtl_ebu_video_vrx_check(
+    const struct mtl_ebu_video_info* info, int32_t vrx_min, int32_t vrx_max) {
+  if ((vrx_min > 0) && (vrx_max <= (int32_t)info->vrx_full_narrow_pass))
+    return MTL_EBU_PASS_NARROW;
+  if ((vrx_min > 0) && (vrx_max <= (int32_t)info->vrx_full_wide_pass))
+    return MTL_EBU_PASS_WIDE;
+  return MTL_EBU_FAIL;
+}
+
+/** Check the max first packet time(TPR0) of a period */
+static inline enum mtl_ebu_result mtl_ebu_video_fpt_check(
+    const struct mtl_ebu_video_info* info, int32_t fpt_max) {
+  if (fpt_max <= info->tr_offset) return MTL_EBU_PASS;
+  if (fpt_max <= (info->tr_offset * 2)) return MTL_EBU_PASS_WIDE_WA; /* no HW RX time */
+  return MTL_EBU_FAIL;
+}
+
+/** Check the min and max latency of a period */
+static inline enum mtl_ebu_result mtl_ebu_video_latency_check(int32_t latency_min,
+                                                              int32_t latency_max) {
+  if ((latency_min < 0) || (latency_max > MTL_EBU_LATENCY_MAX_NS)) return MTL_EBU_FAIL;
+  return MTL_EBU_PASS;
+}
+
+/** Check the min and max rtp offset of a period */
+static inline enum mtl_ebu_result mtl_ebu_video_rtp_offset_check(
+    const struct mtl_ebu_video_info* info, int32_t rtp_offset_min,
+    int32_t rtp_offset_max) {
+  if ((rtp_offset_min < MTL_EBU_RTP_OFFSET_MIN) ||
+      (rtp_offset_max > (int32_t)info->rtp_offset_max_pass))
+    return MTL_EBU_FAIL;
+  return MTL_EBU_PASS;
+}
+
+/** Check the min and max rtp ts delta between frames of a period */
+static inline enum mtl_ebu_result mtl_ebu_video_rtp_ts_delta_check(
+    const struct mtl_ebu_video_info* info, int32_t delta_min, int32_t delta_max) {
+  int32_t rtd = info->frame_time_sampling;
+
+  if ((delta_min < rtd) || (delta_max > (rtd + 1))) return MTL_EBU_FAIL;
+  return MTL_EBU_PASS;
+}
+
+/**
+ * The ST2110-30 timing model and the pass criteria of an audio stream.
+ */
+struct mtl_ebu_audio_info {
+  /** packet time in ns */
+  double pkt_time;
+  /** packet time in sampling */
+  double pkt_time_sampling;
+
+  /** max delta packet vs rtp in us for narrow */
+  int32_t dpvr_max_pass_narrow;
+  /** max delta packet vs rtp in us for wide */
+  int32_t dpvr_max_pass_wide;
+  /** max avg delta packet vs rtp in us for wide */
+  float dpvr_avg_pass_wide;
+  /** max timestamped delay factor in us */
+  int32_t tsdf_max_pass;
+};
+
+/**
+ * Init the timing model and the pass criteria of an audio stream.
+ *
+ * @param info
+ *   The info to be filled.
+ * @param pkt_time
+ *   The packet time in ns, ex 1000000 for 1ms.
+ * @param sampling_rate
+ *   The audio sampling rate, ex 48000.
+ * @return
+ *   - 0: Success.
+ *   - <0: Error code if any argument is invalid.
+ */
+static inline int mtl_ebu_audio_info_init(struct mtl_ebu_audio_info* info,
+                                          double pkt_time, uint32_t sampling_rate) {
+  if ((pkt_time <= 0) || !sampling_rate) return -1;
+
+  info->pkt_time = pkt_time;
+  info->pkt_time_sampling = (double)sampling_rate * pkt_time / 1000000000.0;
+
+  info->dpvr_max_pass_narrow = 3 * pkt_time / 1000; /* in us */
+  info->dpvr_max_pass_wide = 20 * pkt_time / 1000;  /* in us */
+  info->dpvr_avg_pass_wide = 2.5 * pkt_time / 1000; /* in us */
+  info->tsdf_max_pass = 17 * pkt_time / 1000;       /* in us */
+
+  return 0;
+}
+
+/**
+ * The delta packet vs rtp of an audio packet.
+ *
+ * @param info
+ *   The audio info.
+ * @param rtp_ts
+ *   The rtp timestamp of the packet.
+ * @param pkt_time
+ *   The rx time of the packet in ns.
+ * @return
+ *   The delta in us.
+ */
+static inline double mtl_ebu_audio_dpvr(const struct mtl_ebu_audio_info* info,
+                                        uint32_t rtp_ts, uint64_t pkt_time) {
+  uint64_t epochs = (double)pkt_time / info->pkt_time;
+  uint64_t epoch_tmstamp = (double)epochs * info->pkt_time;
+  double fpt_delta = (double)pkt_time - epoch_tmstamp;
+  uint64_t tmstamp64 = epochs * info->pkt_time_sampling;
+  uint32_t tmstamp32 = tmstamp64;
+  double diff_rtp_ts = (double)rtp_ts - tmstamp32;
+  double diff_rtp_ts_ns = diff_rtp_ts * info->pkt_time / info->pkt_time_sampling;
+
+  return (fpt_delta - diff_rtp_ts_ns) / 1000;
+}
+
+/** Check the max and avg delta packet vs rtp(us) of a period */
+static inline enum mtl_ebu_result mtl_ebu_audio_dpvr_check(
+    const struct mtl_ebu_audio_info* info, int64_t dpvr_max, float dpvr_avg) {
+  if (dpvr_max >= 0 && dpvr_max < info->dpvr_max_pass_narrow)
+    return MTL_EBU_PASS_NARROW;
+  if (dpvr_max >= 0 && dpvr_max < info->dpvr_max_pass_wide && dpvr_avg >= 0 &&
+      dpvr_avg < info->dpvr_avg_pass_wide)
+    return MTL_EBU_PASS_WIDE;
+  return MTL_EBU_FAIL;
+}
+
+/** Check the max timestamped delay factor(us) of a period */
+static inline enum mtl_ebu_result mtl_ebu_audio_tsdf_check(
+    const struct mtl_ebu_audio_info* info, int64_t tsdf_max) {
+  if (tsdf_max < info->tsdf_max_pass) return MTL_EBU_PASS;
+  return MTL_EBU_FAIL;
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
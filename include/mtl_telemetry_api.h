@@ -0,0 +1,248 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+/**
+ * @file mtl_telemetry_api.h
+ *
+ * The layout of the telemetry shared memory segment published by a MTL instance
+ * created with MTL_FLAG_TELEMETRY_SHM. A monitor process attach the segment read-only
+ * with shmget(mtl_telemetry_shm_key(pid), 0, 0) and shmat(id, NULL, SHM_RDONLY), then
+ * take a consistent copy by mtl_telemetry_read.
+ * This header has no dependency to the library, the monitor need not link to MTL.
+ *
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/types.h>
+
+#ifndef _MTL_TELEMETRY_API_HEAD_H_
+/** Marco for re-include protect */
+#define _MTL_TELEMETRY_API_HEAD_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/** Magic of the segment, "MTLT" */
+#define MTL_TELEMETRY_MAGIC (0x4d544c54)
+/** Version of the segment layout, bumped on any layout change */
+#define MTL_TELEMETRY_VERSION (1)
+/** The base of the SysV shm key, the pid of the MTL process is added */
+#define MTL_TELEMETRY_SHM_KEY_BASE (0x4d000000)
+
+/** Max length of the session name */
+#define MTL_TELEMETRY_NAME_MAX (32)
+/** Max number of sessions in the segment */
+#define MTL_TELEMETRY_SESSION_MAX (512)
+/** Max number of schedulers in the segment */
+#define MTL_TELEMETRY_SCH_MAX (32)
+/** Max number of ports in the segment */
+#define MTL_TELEMETRY_PORT_MAX (8)
+/** Max number of dma devices in the segment */
+#define MTL_TELEMETRY_DMA_MAX (8)
+
+/**
+ * Session type in the telemetry segment.
+ */
+enum mtl_telemetry_session_type {
+  MTL_TELEMETRY_ST20_TX = 0,      /**< st2110-20 tx video */
+  MTL_TELEMETRY_ST20_RX,          /**< st2110-20 rx video */
+  MTL_TELEMETRY_ST22_TX,          /**< st2110-22 tx video */
+  MTL_TELEMETRY_ST22_RX,          /**< st2110-22 rx video */
+  MTL_TELEMETRY_SESSION_TYPE_MAX, /**< max value of this enum */
+};
+
+/**
+ * The EBU(ST2110-21) compliance results of a rx video session, the number of
+ * frames in each class since the session created.
+ */
+struct mtl_telemetry_ebu {
+  /** number of frames checked */
+  uint32_t frames;
+  /** frames pass with narrow */
+  uint32_t compliance_narrow;
+  /** frames pass with wide */
+  uint32_t compliance_wide;
+  /** frames failed */
+  uint32_t compliance_fail;
+};
+
+/**
+ * One video session in the telemetry segment.
+ */
+struct mtl_telemetry_session {
+  /** session name from the ops */
+  char name[MTL_TELEMETRY_NAME_MAX];
+  /** enum mtl_telemetry_session_type */
+  uint8_t type;
+  /** number of ports, 2 for redundant */
+  uint8_t num_port;
+  /** index of the session in the sch */
+  uint16_t idx;
+  /** the sch which the session is running on */
+  int32_t sch_idx;
+  /** video width */
+  uint32_t width;
+  /** video height */
+  uint32_t height;
+  /** frames transmitted or received */
+  uint64_t frames;
+  /** pkts burst to the nic for tx, pkts received for rx */
+  uint64_t pkts;
+  /** epoch drops for tx, frames dropped for rx */
+  uint64_t drops;
+  /** out of order pkts, rx only */
+  uint64_t pkts_out_of_order;
+  /** redundant pkts, rx only */
+  uint64_t pkts_redundant;
+  /** valid if MTL_FLAG_RX_VIDEO_EBU, rx only */
+  struct mtl_telemetry_ebu ebu;
+};
+
+/**
+ * One scheduler in the telemetry segment.
+ */
+struct mtl_telemetry_sch {
+  /** index of the sch */
+  int32_t idx;
+  /** the lcore, -1 if it runs in a thread */
+  int32_t lcore;
+  /** number of tasklets */
+  uint32_t nb_tasklets;
+  /** sleep ratio in percent, valid with MTL_FLAG_TASKLET_SLEEP */
+  float sleep_ratio;
+  /** measured cpu load 0 - 1.0, valid with MTL_FLAG_TASKLET_BALANCE */
+  float load;
+  /** total loops of the tasklet runner */
+  uint64_t loops;
+  /** total sleep time in ns */
+  uint64_t sleep_ns;
+};
+
+/**
+ * The PTP state of one port in the telemetry segment.
+ */
+struct mtl_telemetry_ptp {
+  /** 1 if ptp is running on this port */
+  uint8_t active;
+  /** 1 if a master is selected */
+  uint8_t master_initialized;
+  /** total sync msgs from the master */
+  uint64_t sync;
+  /** the last offset to the master */
+  int64_t offset_ns;
+  /** the last mean path delay */
+  int64_t path_delay_ns;
+};
+
+/**
+ * One dma device in the telemetry segment.
+ */
+struct mtl_telemetry_dma {
+  /** index of the dma device */
+  int32_t idx;
+  /** the sch which the dma is polled from */
+  int32_t sch_idx;
+  /** number of sessions attached */
+  uint16_t nb_session;
+  /** number of copies in flight */
+  uint16_t nb_inflight;
+  /** avg queue depth of last stat period */
+  uint16_t load_q;
+  /** copy bandwidth of last stat period, bit per second */
+  uint64_t load_bps;
+};
+
+/**
+ * The telemetry segment. The writer increase seq to odd before update and to even
+ * after, a reader copy is consistent only if the seq is the same even value before
+ * and after the copy, see mtl_telemetry_read.
+ */
+struct mtl_telemetry_shm {
+  /** MTL_TELEMETRY_MAGIC */
+  uint32_t magic;
+  /** MTL_TELEMETRY_VERSION */
+  uint32_t version;
+  /** size of this structure */
+  uint32_t size;
+  /** pid of the MTL process */
+  int32_t pid;
+  /** seqlock counter, odd when an update is in progress */
+  uint32_t seq;
+  /** update period in ms */
+  uint32_t period_ms;
+  /** CLOCK_REALTIME of the last update */
+  uint64_t update_ns;
+
+  /** number of valid entries in sessions */
+  uint32_t nb_sessions;
+  /** number of valid entries in schs */
+  uint32_t nb_schs;
+  /** number of valid entries in ptp */
+  uint32_t nb_ports;
+  /** number of valid entries in dma */
+  uint32_t nb_dmas;
+
+  /** active schedulers */
+  struct mtl_telemetry_sch schs[MTL_TELEMETRY_SCH_MAX];
+  /** ptp of each port */
+  struct mtl_telemetry_ptp ptp[MTL_TELEMETRY_PORT_MAX];
+  /** active dma devices */
+  struct mtl_telemetry_dma dma[MTL_TELEMETRY_DMA_MAX];
+  /** the video sessions */
+  struct mtl_telemetry_session sessions[MTL_TELEMETRY_SESSION_MAX];
+};
+
+/**
+ * The SysV shm key of the telemetry segment of a MTL process.
+ *
+ * @param pid
+ *   The pid of the MTL process.
+ * @return
+ *   The key for shmget.
+ */
+static inline key_t mtl_telemetry_shm_key(pid_t pid) {
+  return (key_t)(MTL_TELEMETRY_SHM_KEY_BASE + pid);
+}
+
+/**
+ * Take a consistent copy of the telemetry segment.
+ *
+ * @param shm
+ *   The attached segment.
+ * @param copy
+ *   The copy to be filled.
+ * @param retry
+ *   The max times to retry if the copy races with an update.
+ * @return
+ *   - 0: Success.
+ *   - <0: Error code, -EIO for an unknown layout, -EAGAIN if always raced.
+ */
+static inline int mtl_telemetry_read(const struct mtl_telemetry_shm* shm,
+                                     struct mtl_telemetry_shm* copy, int retry) {
+  uint32_t seq_start, seq_end;
+
+  if ((shm->magic != MTL_TELEMETRY_MAGIC) || (shm->version != MTL_TELEMETRY_VERSION) ||
+      (shm->size != sizeof(*shm)))
+    return -EIO;
+
+  for (int i = 0; i <= retry; i++) {
+    seq_start = __atomic_load_n(&shm->seq, __ATOMIC_ACQUIRE);
+    if (seq_start & 0x1) continue; /* update in progress */
+    memcpy(copy, shm, sizeof(*copy));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    seq_end = __atomic_load_n(&shm->seq, __ATOMIC_RELAXED);
+    if (seq_start == seq_end) return 0;
+  }
+
+  return -EAGAIN;
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
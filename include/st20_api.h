@@ -1109,6 +1109,11 @@ struct st20_rx_ops {
   void* priv;
   /** source IP address of sender */
   uint8_t sip_addr[MTL_SESSION_PORT_MAX][MTL_IP_ADDR_LEN];
+  /**
+   * Optional. The sender IP of the multicast for the SSM(source specific multicast)
+   * join, leave as 0 to receive from any source.
+   */
+  uint8_t mcast_sip_addr[MTL_SESSION_PORT_MAX][MTL_IP_ADDR_LEN];
   /** 1 or 2, num of ports this session attached to */
   uint8_t num_port;
   /** Pcie BDF path like 0000:af:00.0, should align to BDF of mtl_init */
@@ -1251,6 +1256,11 @@ struct st22_rx_ops {
   void* priv;
   /** source IP address of sender */
   uint8_t sip_addr[MTL_SESSION_PORT_MAX][MTL_IP_ADDR_LEN];
+  /**
+   * Optional. The sender IP of the multicast for the SSM(source specific multicast)
+   * join, leave as 0 to receive from any source.
+   */
+  uint8_t mcast_sip_addr[MTL_SESSION_PORT_MAX][MTL_IP_ADDR_LEN];
   /** 1 or 2, num of ports this session attached to */
   uint8_t num_port;
   /** Pcie BDF path like 0000:af:00.0, should align to BDF of mtl_init */
@@ -346,6 +346,11 @@ struct st30_rx_ops {
   void* priv;
   /** source IP address of sender */
   uint8_t sip_addr[MTL_SESSION_PORT_MAX][MTL_IP_ADDR_LEN];
+  /**
+   * Optional. The sender IP of the multicast for the SSM(source specific multicast)
+   * join, leave as 0 to receive from any source.
+   */
+  uint8_t mcast_sip_addr[MTL_SESSION_PORT_MAX][MTL_IP_ADDR_LEN];
   /** 1 or 2, num of ports this session attached to */
   uint8_t num_port;
   /** Pcie BDF path like 0000:af:00.0, should align to BDF of mtl_init */
@@ -416,6 +421,11 @@ struct st30_rx_ops {
    * routine.
    */
   int (*notify_rtp_ready)(void* priv);
+  /**
+   * max time in us to wait the missing pkt from the late path for st2022-7 redundant,
+   * only for num_port 2, leave as 0 to use the default 10ms.
+   */
+  uint32_t merge_window_us;
 };
 
 /**
@@ -0,0 +1,314 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+/**
+ * @file st30_pipeline_api.h
+ *
+ * Interfaces for st2110-30 pipeline transport.
+ * The pipeline hides the packet time to frame size math and the sample format
+ * conversion, app can get/put audio frames with any samples number per frame.
+ *
+ */
+
+#include "st30_api.h"
+#include "st_pipeline_api.h"
+
+#ifndef _ST30_PIPELINE_API_HEAD_H_
+#define _ST30_PIPELINE_API_HEAD_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/** Handle to tx st2110-30 pipeline session of lib */
+typedef struct st30p_tx_ctx* st30p_tx_handle;
+/** Handle to rx st2110-30 pipeline session of lib */
+typedef struct st30p_rx_ctx* st30p_rx_handle;
+
+/** Max frame buffer count for one st30 pipeline session */
+#define ST30P_FB_MAX_COUNT (64)
+
+/**
+ * Flag bit in flags of struct st30p_tx_ops.
+ * P TX destination mac assigned by user
+ */
+#define ST30P_TX_FLAG_USER_P_MAC (MTL_BIT32(0))
+/**
+ * Flag bit in flags of struct st30p_tx_ops.
+ * R TX destination mac assigned by user
+ */
+#define ST30P_TX_FLAG_USER_R_MAC (MTL_BIT32(1))
+/**
+ * Flag bit in flags of struct st30p_tx_ops.
+ * If enabled, lib will assign the rtp timestamp from the value in st30_frame,
+ * only ST10_TIMESTAMP_FMT_MEDIA_CLK is supported. The timestamp of the packets
+ * inside the frame is derived from the sample offset.
+ */
+#define ST30P_TX_FLAG_USER_TIMESTAMP (MTL_BIT32(4))
+
+/**
+ * Flag bit in flags of struct st30p_rx_ops, for non MTL_PMD_DPDK_USER.
+ * If set, it's application duty to set the rx flow(queue) and multicast join/drop.
+ * Use st30p_rx_get_queue_meta to get the queue meta(queue number etc) info.
+ */
+#define ST30P_RX_FLAG_DATA_PATH_ONLY (MTL_BIT32(0))
+
+/** The structure info for st2110-30 pipeline frame. */
+struct st30_frame {
+  /** frame buffer address */
+  void* addr;
+  /** frame buffer IOVA */
+  mtl_iova_t iova;
+  /** sample format of the frame */
+  enum st30_fmt fmt;
+  /** channel number */
+  uint16_t channel;
+  /** sampling rate */
+  enum st30_sampling sampling;
+  /** samples number of single channel in the frame */
+  uint32_t samples;
+  /** frame buffer size */
+  size_t buffer_size;
+  /** frame valid data size, may < buffer_size if rx stream is stopped */
+  size_t data_size;
+  /**
+   * frame timestamp format.
+   * TX: ST10_TIMESTAMP_FMT_TAI of the first sample on the notify_frame_done,
+   * or ST10_TIMESTAMP_FMT_MEDIA_CLK set by user with ST30P_TX_FLAG_USER_TIMESTAMP.
+   * RX: ST10_TIMESTAMP_FMT_MEDIA_CLK of the first sample.
+   */
+  enum st10_timestamp_fmt tfmt;
+  /** frame timestamp value */
+  uint64_t timestamp;
+
+  /** priv pointer for lib, do not touch this */
+  void* priv;
+  /** priv data for user */
+  void* opaque;
+};
+
+/** The structure describing how to create a tx st2110-30 pipeline session. */
+struct st30p_tx_ops {
+  /** name */
+  const char* name;
+  /** private data to the callback function */
+  void* priv;
+  /** tx port info */
+  struct st_tx_port port;
+  /** flags, value in ST30P_TX_FLAG_* */
+  uint32_t flags;
+  /**
+   * tx destination mac address.
+   * Valid if ST30P_TX_FLAG_USER_P(R)_MAC is enabled
+   */
+  uint8_t tx_dst_mac[MTL_SESSION_PORT_MAX][MTL_MAC_ADDR_LEN];
+  /** Session input frame format */
+  enum st30_fmt input_fmt;
+  /** Session transport format */
+  enum st30_fmt transport_fmt;
+  /** Session channel number */
+  uint16_t channel;
+  /** Session sampling rate */
+  enum st30_sampling sampling;
+  /** Session packet time */
+  enum st30_ptime ptime;
+  /**
+   * Samples number of single channel in one frame, independent of the ptime.
+   * Ex: 480 for 10ms frame or 1024 for a mixer period at 48kHz.
+   */
+  uint32_t samples_per_frame;
+  /**
+   * The frame buffer count requested for one st30 pipeline tx session,
+   * should be in range [2, ST30P_FB_MAX_COUNT],
+   */
+  uint16_t framebuff_cnt;
+  /**
+   * Callback when frame available in the lib.
+   * And only non-block method can be used within this callback as it run from lcore
+   * tasklet routine.
+   */
+  int (*notify_frame_available)(void* priv);
+  /**
+   * Callback when all samples of the frame are transmitted in the lib.
+   * And only non-block method can be used within this callback as it run from lcore
+   * tasklet routine.
+   */
+  int (*notify_frame_done)(void* priv, struct st30_frame* frame);
+};
+
+/** The structure describing how to create a rx st2110-30 pipeline session. */
+struct st30p_rx_ops {
+  /** name */
+  const char* name;
+  /** private data to the callback function */
+  void* priv;
+  /** rx port info */
+  struct st_rx_port port;
+  /** flags, value in ST30P_RX_FLAG_* */
+  uint32_t flags;
+  /** Session output frame format */
+  enum st30_fmt output_fmt;
+  /** Session transport format */
+  enum st30_fmt transport_fmt;
+  /** Session channel number */
+  uint16_t channel;
+  /** Session sampling rate */
+  enum st30_sampling sampling;
+  /** Session packet time */
+  enum st30_ptime ptime;
+  /** Samples number of single channel in one frame, independent of the ptime */
+  uint32_t samples_per_frame;
+  /**
+   * The frame buffer count requested for one st30 pipeline rx session,
+   * should be in range [2, ST30P_FB_MAX_COUNT],
+   */
+  uint16_t framebuff_cnt;
+  /**
+   * Callback when frame available in the lib.
+   * And only non-block method can be used within this callback as it run from lcore
+   * tasklet routine.
+   */
+  int (*notify_frame_available)(void* priv);
+};
+
+/**
+ * Create one tx st2110-30 pipeline session.
+ *
+ * @param mt
+ *   The handle to the media transport device context.
+ * @param ops
+ *   The pointer to the structure describing how to create a tx
+ * st2110-30 pipeline session.
+ * @return
+ *   - NULL on error.
+ *   - Otherwise, the handle to the tx st2110-30 pipeline session.
+ */
+st30p_tx_handle st30p_tx_create(mtl_handle mt, struct st30p_tx_ops* ops);
+
+/**
+ * Free the tx st2110-30 pipeline session.
+ *
+ * @param handle
+ *   The handle to the tx st2110-30 pipeline session.
+ * @return
+ *   - 0: Success, tx st2110-30 pipeline session freed.
+ *   - <0: Error code of the tx st2110-30 pipeline session free.
+ */
+int st30p_tx_free(st30p_tx_handle handle);
+
+/**
+ * Get one tx frame from the tx st2110-30 pipeline session.
+ * Call st30p_tx_put_frame to return the frame to session.
+ *
+ * @param handle
+ *   The handle to the tx st2110-30 pipeline session.
+ * @return
+ *   - NULL if no available frame in the session.
+ *   - Otherwise, the frame pointer.
+ */
+struct st30_frame* st30p_tx_get_frame(st30p_tx_handle handle);
+
+/**
+ * Put back the frame which get by st30p_tx_get_frame to the tx
+ * st2110-30 pipeline session.
+ *
+ * @param handle
+ *   The handle to the tx st2110-30 pipeline session.
+ * @param frame
+ *   The frame pointer by st30p_tx_get_frame.
+ * @return
+ *   - 0 if successful.
+ *   - <0: Error code if put fail.
+ */
+int st30p_tx_put_frame(st30p_tx_handle handle, struct st30_frame* frame);
+
+/**
+ * Get the framebuffer size from the tx st2110-30 pipeline session.
+ *
+ * @param handle
+ *   The handle to the tx st2110-30 pipeline session.
+ * @return
+ *   - size
+ */
+size_t st30p_tx_frame_size(st30p_tx_handle handle);
+
+/**
+ * Create one rx st2110-30 pipeline session.
+ *
+ * @param mt
+ *   The handle to the media transport device context.
+ * @param ops
+ *   The pointer to the structure describing how to create a rx
+ * st2110-30 pipeline session.
+ * @return
+ *   - NULL on error.
+ *   - Otherwise, the handle to the rx st2110-30 pipeline session.
+ */
+st30p_rx_handle st30p_rx_create(mtl_handle mt, struct st30p_rx_ops* ops);
+
+/**
+ * Free the rx st2110-30 pipeline session.
+ *
+ * @param handle
+ *   The handle to the rx st2110-30 pipeline session.
+ * @return
+ *   - 0: Success, rx st2110-30 pipeline session freed.
+ *   - <0: Error code of the rx st2110-30 pipeline session free.
+ */
+int st30p_rx_free(st30p_rx_handle handle);
+
+/**
+ * Get one rx frame from the rx st2110-30 pipeline session.
+ * Call st30p_rx_put_frame to return the frame to session.
+ *
+ * @param handle
+ *   The handle to the rx st2110-30 pipeline session.
+ * @return
+ *   - NULL if no available frame in the session.
+ *   - Otherwise, the frame pointer.
+ */
+struct st30_frame* st30p_rx_get_frame(st30p_rx_handle handle);
+
+/**
+ * Put back the frame which get by st30p_rx_get_frame to the rx
+ * st2110-30 pipeline session.
+ *
+ * @param handle
+ *   The handle to the rx st2110-30 pipeline session.
+ * @param frame
+ *   The frame pointer by st30p_rx_get_frame.
+ * @return
+ *   - 0 if successful.
+ *   - <0: Error code if put fail.
+ */
+int st30p_rx_put_frame(st30p_rx_handle handle, struct st30_frame* frame);
+
+/**
+ * Get the framebuffer size from the rx st2110-30 pipeline session.
+ *
+ * @param handle
+ *   The handle to the rx st2110-30 pipeline session.
+ * @return
+ *   - size
+ */
+size_t st30p_rx_frame_size(st30p_rx_handle handle);
+
+/**
+ * Get the queue meta attached to rx st2110-30 pipeline session.
+ *
+ * @param handle
+ *   The handle to the rx st2110-30 pipeline session.
+ * @param meta
+ *   the rx queue meta info.
+ * @return
+ *   - 0: Success.
+ *   - <0: Error code.
+ */
+int st30p_rx_get_queue_meta(st30p_rx_handle handle, struct st_queue_meta* meta);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
@@ -295,6 +295,11 @@ struct st40_rx_ops {
   void* priv;
   /** source IP address of sender */
   uint8_t sip_addr[MTL_SESSION_PORT_MAX][MTL_IP_ADDR_LEN];
+  /**
+   * Optional. The sender IP of the multicast for the SSM(source specific multicast)
+   * join, leave as 0 to receive from any source.
+   */
+  uint8_t mcast_sip_addr[MTL_SESSION_PORT_MAX][MTL_IP_ADDR_LEN];
   /** 1 or 2, num of ports this session attached to */
   uint8_t num_port;
   /** Pcie BDF path like 0000:af:00.0, should align to BDF of mtl_init */
@@ -316,6 +321,11 @@ struct st40_rx_ops {
    * routine.
    */
   int (*notify_rtp_ready)(void* priv);
+  /**
+   * max time in us to wait the missing pkt from the late path for st2022-7 redundant,
+   * only for num_port 2, leave as 0 to use the default 10ms.
+   */
+  uint32_t merge_window_us;
 };
 
 /**
@@ -524,6 +534,111 @@ uint16_t st40_add_parity_bits(uint16_t val);
  */
 int st40_check_parity_bits(uint16_t val);
 
+/**
+ * Pack one ANC data packet to the 10-bit words of st2110-40(ancillary) payload with
+ * simd level, the DID, SDID, DATA_COUNT, all the user data words with parity bits and
+ * the checksum word are built in a single pass.
+ *
+ * @param did
+ *   Data Identification Word, 8 bits value.
+ * @param sdid
+ *   Secondary Data Identification Word, 8 bits value.
+ * @param udw
+ *   The user data words, 8 bits value for each.
+ * @param udw_size
+ *   The number of user data words, max 255.
+ * @param data
+ *   The pointer to the 10-bit words area of st2110-40 payload, which is the
+ * second_hdr_chunk of struct st40_rfc8331_payload_hdr.
+ * @param level
+ *   simd level.
+ * @return
+ *   - >0: the bytes of the 10-bit words written.
+ *   - <0: Error code.
+ */
+int st40_pack_udw_simd(uint16_t did, uint16_t sdid, const uint8_t* udw,
+                       uint16_t udw_size, uint8_t* data, enum mtl_simd_level level);
+
+/**
+ * Pack one ANC data packet to the 10-bit words of st2110-40(ancillary) payload.
+ *
+ * @param did
+ *   Data Identification Word, 8 bits value.
+ * @param sdid
+ *   Secondary Data Identification Word, 8 bits value.
+ * @param udw
+ *   The user data words, 8 bits value for each.
+ * @param udw_size
+ *   The number of user data words, max 255.
+ * @param data
+ *   The pointer to the 10-bit words area of st2110-40 payload, which is the
+ * second_hdr_chunk of struct st40_rfc8331_payload_hdr.
+ * @return
+ *   - >0: the bytes of the 10-bit words written.
+ *   - <0: Error code.
+ */
+static inline int st40_pack_udw(uint16_t did, uint16_t sdid, const uint8_t* udw,
+                                uint16_t udw_size, uint8_t* data) {
+  return st40_pack_udw_simd(did, sdid, udw, udw_size, data, MTL_SIMD_LEVEL_MAX);
+}
+
+/**
+ * Unpack one ANC data packet from the 10-bit words of st2110-40(ancillary) payload with
+ * simd level, the parity bits of all words and the checksum are verified in a single
+ * pass.
+ *
+ * @param data
+ *   The pointer to the 10-bit words area of st2110-40 payload, which is the
+ * second_hdr_chunk of struct st40_rfc8331_payload_hdr.
+ * @param data_size
+ *   The valid bytes from data, the 10-bit words should not exceed this size.
+ * @param did
+ *   Return the Data Identification Word, 8 bits value.
+ * @param sdid
+ *   Return the Secondary Data Identification Word, 8 bits value.
+ * @param udw
+ *   The buffer to return the user data words, 8 bits value for each.
+ * @param udw_max
+ *   The size of the udw buffer.
+ * @param level
+ *   simd level.
+ * @return
+ *   - >=0: the number of user data words.
+ *   - -EIO: parity or checksum error.
+ *   - <0: Other error code.
+ */
+int st40_unpack_udw_simd(const uint8_t* data, uint32_t data_size, uint16_t* did,
+                         uint16_t* sdid, uint8_t* udw, uint16_t udw_max,
+                         enum mtl_simd_level level);
+
+/**
+ * Unpack one ANC data packet from the 10-bit words of st2110-40(ancillary) payload.
+ *
+ * @param data
+ *   The pointer to the 10-bit words area of st2110-40 payload, which is the
+ * second_hdr_chunk of struct st40_rfc8331_payload_hdr.
+ * @param data_size
+ *   The valid bytes from data, the 10-bit words should not exceed this size.
+ * @param did
+ *   Return the Data Identification Word, 8 bits value.
+ * @param sdid
+ *   Return the Secondary Data Identification Word, 8 bits value.
+ * @param udw
+ *   The buffer to return the user data words, 8 bits value for each.
+ * @param udw_max
+ *   The size of the udw buffer.
+ * @return
+ *   - >=0: the number of user data words.
+ *   - -EIO: parity or checksum error.
+ *   - <0: Other error code.
+ */
+static inline int st40_unpack_udw(const uint8_t* data, uint32_t data_size,
+                                  uint16_t* did, uint16_t* sdid, uint8_t* udw,
+                                  uint16_t udw_max) {
+  return st40_unpack_udw_simd(data, data_size, did, sdid, udw, udw_max,
+                              MTL_SIMD_LEVEL_MAX);
+}
+
 #if defined(__cplusplus)
 }
 #endif
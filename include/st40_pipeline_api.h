@@ -0,0 +1,297 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+/**
+ * @file st40_pipeline_api.h
+ *
+ * Interfaces for st2110-40 pipeline transport.
+ * The pipeline hides the rfc8331 RTP packing and parsing, app can get/put frames of
+ * decoded ANC packets(DID/SDID, line, horizontal offset and user data words) which
+ * aligned to the video frame time.
+ *
+ */
+
+#include "st40_api.h"
+#include "st_pipeline_api.h"
+
+#ifndef _ST40_PIPELINE_API_HEAD_H_
+#define _ST40_PIPELINE_API_HEAD_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/** Handle to tx st2110-40 pipeline session of lib */
+typedef struct st40p_tx_ctx* st40p_tx_handle;
+/** Handle to rx st2110-40 pipeline session of lib */
+typedef struct st40p_rx_ctx* st40p_rx_handle;
+
+/** Max frame buffer count for one st40 pipeline session */
+#define ST40P_FB_MAX_COUNT (16)
+/** Max user data words number of one ANC packet, the data count is 8 bits */
+#define ST40P_MAX_UDW (255)
+/** Default udw buffer size of one frame, enough for ST40_MAX_META full ANC packets */
+#define ST40P_DEFAULT_UDW_BUFF_SIZE (ST40_MAX_META * ST40P_MAX_UDW)
+
+/**
+ * Flag bit in flags of struct st40p_tx_ops.
+ * P TX destination mac assigned by user
+ */
+#define ST40P_TX_FLAG_USER_P_MAC (MTL_BIT32(0))
+/**
+ * Flag bit in flags of struct st40p_tx_ops.
+ * R TX destination mac assigned by user
+ */
+#define ST40P_TX_FLAG_USER_R_MAC (MTL_BIT32(1))
+/**
+ * Flag bit in flags of struct st40p_tx_ops.
+ * If enabled, lib will assign the rtp timestamp from the value in st40p_frame,
+ * only ST10_TIMESTAMP_FMT_MEDIA_CLK is supported.
+ */
+#define ST40P_TX_FLAG_USER_TIMESTAMP (MTL_BIT32(4))
+
+/**
+ * Flag bit in flags of struct st40p_rx_ops, for non MTL_PMD_DPDK_USER.
+ * If set, it's application duty to set the rx flow(queue) and multicast join/drop.
+ * Use st40p_rx_get_queue_meta to get the queue meta(queue number etc) info.
+ */
+#define ST40P_RX_FLAG_DATA_PATH_ONLY (MTL_BIT32(0))
+
+/**
+ * The structure info for st2110-40 pipeline frame, one frame carry all the ANC packets
+ * of one video frame time.
+ */
+struct st40p_frame {
+  /**
+   * ANC packets meta, the user data words of meta[i] are the bytes in
+   * [udw_buf + meta[i].udw_offset, udw_buf + meta[i].udw_offset + meta[i].udw_size).
+   */
+  struct st40_meta meta[ST40_MAX_META];
+  /** number of the valid ANC packets in meta */
+  uint32_t meta_num;
+  /** user data words buffer, 8 bits value for each udw, parity bits are handled by lib */
+  uint8_t* udw_buf;
+  /** user data words buffer size */
+  uint32_t udw_buffer_size;
+  /** valid bytes in the udw_buf */
+  uint32_t udw_data_size;
+  /**
+   * frame timestamp format.
+   * TX: ST10_TIMESTAMP_FMT_TAI on the notify_frame_done,
+   * or ST10_TIMESTAMP_FMT_MEDIA_CLK set by user with ST40P_TX_FLAG_USER_TIMESTAMP.
+   * RX: ST10_TIMESTAMP_FMT_MEDIA_CLK of the rtp timestamp.
+   */
+  enum st10_timestamp_fmt tfmt;
+  /** frame timestamp value */
+  uint64_t timestamp;
+  /** RX only, ANC packets dropped for parity or checksum error in this frame */
+  uint32_t err_anc_cnt;
+
+  /** priv pointer for lib, do not touch this */
+  void* priv;
+  /** priv data for user */
+  void* opaque;
+};
+
+/** The structure describing how to create a tx st2110-40 pipeline session. */
+struct st40p_tx_ops {
+  /** name */
+  const char* name;
+  /** private data to the callback function */
+  void* priv;
+  /** tx port info */
+  struct st_tx_port port;
+  /** flags, value in ST40P_TX_FLAG_* */
+  uint32_t flags;
+  /**
+   * tx destination mac address.
+   * Valid if ST40P_TX_FLAG_USER_P(R)_MAC is enabled
+   */
+  uint8_t tx_dst_mac[MTL_SESSION_PORT_MAX][MTL_MAC_ADDR_LEN];
+  /** Session fps, should align to the video session which the ANC belong to */
+  enum st_fps fps;
+  /**
+   * The frame buffer count requested for one st40 pipeline tx session,
+   * should be in range [2, ST40P_FB_MAX_COUNT],
+   */
+  uint16_t framebuff_cnt;
+  /** The udw buffer size of one frame, leave as 0 to use ST40P_DEFAULT_UDW_BUFF_SIZE */
+  uint32_t udw_buff_size;
+  /**
+   * Callback when frame available in the lib.
+   * And only non-block method can be used within this callback as it run from lcore
+   * tasklet routine.
+   */
+  int (*notify_frame_available)(void* priv);
+  /**
+   * Callback when the frame is transmitted in the lib.
+   * And only non-block method can be used within this callback as it run from lcore
+   * tasklet routine.
+   */
+  int (*notify_frame_done)(void* priv, struct st40p_frame* frame);
+};
+
+/** The structure describing how to create a rx st2110-40 pipeline session. */
+struct st40p_rx_ops {
+  /** name */
+  const char* name;
+  /** private data to the callback function */
+  void* priv;
+  /** rx port info */
+  struct st_rx_port port;
+  /** flags, value in ST40P_RX_FLAG_* */
+  uint32_t flags;
+  /**
+   * The frame buffer count requested for one st40 pipeline rx session,
+   * should be in range [2, ST40P_FB_MAX_COUNT],
+   */
+  uint16_t framebuff_cnt;
+  /** The udw buffer size of one frame, leave as 0 to use ST40P_DEFAULT_UDW_BUFF_SIZE */
+  uint32_t udw_buff_size;
+  /**
+   * Callback when frame available in the lib.
+   * And only non-block method can be used within this callback as it run from lcore
+   * tasklet routine.
+   */
+  int (*notify_frame_available)(void* priv);
+};
+
+/**
+ * Create one tx st2110-40 pipeline session.
+ *
+ * @param mt
+ *   The handle to the media transport device context.
+ * @param ops
+ *   The pointer to the structure describing how to create a tx
+ * st2110-40 pipeline session.
+ * @return
+ *   - NULL on error.
+ *   - Otherwise, the handle to the tx st2110-40 pipeline session.
+ */
+st40p_tx_handle st40p_tx_create(mtl_handle mt, struct st40p_tx_ops* ops);
+
+/**
+ * Free the tx st2110-40 pipeline session.
+ *
+ * @param handle
+ *   The handle to the tx st2110-40 pipeline session.
+ * @return
+ *   - 0: Success, tx st2110-40 pipeline session freed.
+ *   - <0: Error code of the tx st2110-40 pipeline session free.
+ */
+int st40p_tx_free(st40p_tx_handle handle);
+
+/**
+ * Get one tx frame from the tx st2110-40 pipeline session.
+ * The meta_num and udw_data_size of the frame are reset to zero by lib.
+ * Call st40p_tx_put_frame to return the frame to session.
+ *
+ * @param handle
+ *   The handle to the tx st2110-40 pipeline session.
+ * @return
+ *   - NULL if no available frame in the session.
+ *   - Otherwise, the frame pointer.
+ */
+struct st40p_frame* st40p_tx_get_frame(st40p_tx_handle handle);
+
+/**
+ * Put back the frame which get by st40p_tx_get_frame to the tx
+ * st2110-40 pipeline session.
+ *
+ * @param handle
+ *   The handle to the tx st2110-40 pipeline session.
+ * @param frame
+ *   The frame pointer by st40p_tx_get_frame.
+ * @return
+ *   - 0 if successful.
+ *   - <0: Error code if put fail.
+ */
+int st40p_tx_put_frame(st40p_tx_handle handle, struct st40p_frame* frame);
+
+/**
+ * Append one ANC packet to the frame which get by st40p_tx_get_frame.
+ * The udw are copied to the udw_buf of the frame.
+ *
+ * @param frame
+ *   The frame pointer by st40p_tx_get_frame.
+ * @param meta
+ *   The ANC packet meta, the udw_size is used and udw_offset is ignored.
+ * @param udw
+ *   The user data words of the ANC packet, 8 bits value for each udw.
+ * @return
+ *   - 0 if successful.
+ *   - <0: Error code if no space in the frame.
+ */
+int st40p_frame_add_anc(struct st40p_frame* frame, struct st40_meta* meta,
+                        const uint8_t* udw);
+
+/**
+ * Create one rx st2110-40 pipeline session.
+ *
+ * @param mt
+ *   The handle to the media transport device context.
+ * @param ops
+ *   The pointer to the structure describing how to create a rx
+ * st2110-40 pipeline session.
+ * @return
+ *   - NULL on error.
+ *   - Otherwise, the handle to the rx st2110-40 pipeline session.
+ */
+st40p_rx_handle st40p_rx_create(mtl_handle mt, struct st40p_rx_ops* ops);
+
+/**
+ * Free the rx st2110-40 pipeline session.
+ *
+ * @param handle
+ *   The handle to the rx st2110-40 pipeline session.
+ * @return
+ *   - 0: Success, rx st2110-40 pipeline session freed.
+ *   - <0: Error code of the rx st2110-40 pipeline session free.
+ */
+int st40p_rx_free(st40p_rx_handle handle);
+
+/**
+ * Get one rx frame from the rx st2110-40 pipeline session.
+ * Call st40p_rx_put_frame to return the frame to session.
+ *
+ * @param handle
+ *   The handle to the rx st2110-40 pipeline session.
+ * @return
+ *   - NULL if no available frame in the session.
+ *   - Otherwise, the frame pointer.
+ */
+struct st40p_frame* st40p_rx_get_frame(st40p_rx_handle handle);
+
+/**
+ * Put back the frame which get by st40p_rx_get_frame to the rx
+ * st2110-40 pipeline session.
+ *
+ * @param handle
+ *   The handle to the rx st2110-40 pipeline session.
+ * @param frame
+ *   The frame pointer by st40p_rx_get_frame.
+ * @return
+ *   - 0 if successful.
+ *   - <0: Error code if put fail.
+ */
+int st40p_rx_put_frame(st40p_rx_handle handle, struct st40p_frame* frame);
+
+/**
+ * Get the queue meta attached to rx st2110-40 pipeline session.
+ *
+ * @param handle
+ *   The handle to the rx st2110-40 pipeline session.
+ * @param meta
+ *   the rx queue meta info.
+ * @return
+ *   - 0: Success.
+ *   - <0: Error code.
+ */
+int st40p_rx_get_queue_meta(st40p_rx_handle handle, struct st_queue_meta* meta);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
@@ -134,6 +134,8 @@ struct st_rx_source_info {
   uint8_t sip_addr[MTL_PORT_MAX][MTL_IP_ADDR_LEN];
   /** UDP port number */
   uint16_t udp_port[MTL_PORT_MAX];
+  /** Optional. The sender IP of the multicast for SSM, leave as 0 for any source */
+  uint8_t mcast_sip_addr[MTL_PORT_MAX][MTL_IP_ADDR_LEN];
 };
 
 /**
@@ -1279,6 +1279,35 @@ int st31_am824_to_aes3(struct st31_am824* sf_am824, struct st31_aes3* sf_aes3,
 int st31_aes3_to_am824(struct st31_aes3* sf_aes3, struct st31_am824* sf_am824,
                        uint16_t subframes);
 
+/**
+ * Convert st2110-30/31(audio) samples between PCM8, PCM16, PCM24 and AM824 formats.
+ * PCM samples are big endian as on the wire, AM824 subframes follow the
+ * layout of struct st31_am824.
+ *
+ * @param src
+ *   Point to the source samples.
+ * @param src_fmt
+ *   The format of the source samples.
+ * @param dst
+ *   Point to the destination samples.
+ * @param dst_fmt
+ *   The format of the destination samples.
+ * @param channel
+ *   The channel number, samples are interleaved per channel.
+ * @param samples
+ *   The samples number of single channel.
+ * @param am824_frame_idx
+ *   Only used if dst_fmt is ST31_FMT_AM824, the AES3 frame index inside the 192 frames
+ *   block, updated on return for the next call. Leave to NULL to always start a new
+ *   block.
+ * @return
+ *   - 0 if successful.
+ *   - <0: Error code if convert fail.
+ */
+int st30_pcm_convert(const void* src, enum st30_fmt src_fmt, void* dst,
+                     enum st30_fmt dst_fmt, uint16_t channel, uint32_t samples,
+                     uint32_t* am824_frame_idx);
+
 #if defined(__cplusplus)
 }
 #endif
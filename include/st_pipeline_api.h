@@ -608,7 +608,11 @@ struct st_tx_port {
   uint8_t dip_addr[MTL_SESSION_PORT_MAX][MTL_IP_ADDR_LEN];
   /** Pcie BDF path like 0000:af:00.0, should align to BDF of mtl_init */
   char port[MTL_SESSION_PORT_MAX][MTL_PORT_MAX_LEN];
-  /** 1 or 2, num of ports this session attached to */
+  /**
+   * 1 or 2, num of ports this session attached to.
+   * 2 for st2022-7 redundant, the frame is converted and packetized once and the
+   * payload is shared by both ports, each port has its own pacing.
+   */
   uint8_t num_port;
   /** UDP source port number, leave as 0 to use same port as dst */
   uint16_t udp_src_port[MTL_SESSION_PORT_MAX];
@@ -622,6 +626,11 @@ struct st_tx_port {
 struct st_rx_port {
   /** source IP address of sender */
   uint8_t sip_addr[MTL_SESSION_PORT_MAX][MTL_IP_ADDR_LEN];
+  /**
+   * Optional. The sender IP of the multicast for the SSM(source specific multicast)
+   * join, leave as 0 to receive from any source.
+   */
+  uint8_t mcast_sip_addr[MTL_SESSION_PORT_MAX][MTL_IP_ADDR_LEN];
   /** 1 or 2, num of ports this session attached to */
   uint8_t num_port;
   /** Pcie BDF path like 0000:af:00.0, should align to BDF of mtl_init */
@@ -9,6 +9,13 @@
 #include "st2110/st_rx_video_session.h"
 #include "st2110/st_tx_video_session.h"
 
+/* max video sessions migrated in one admin period */
+#define MT_ADMIN_MIGRATE_MAX (4)
+/* max tasklets moved in one balance pass */
+#define MT_ADMIN_BALANCE_MOVES_MAX (4)
+/* the sch is overloaded if the load is higher than the socket average by this margin */
+#define MT_ADMIN_BALANCE_MARGIN (0.1)
+
 static inline struct mt_admin* mt_get_admin(struct mtl_main_impl* impl) {
   return &impl->admin;
 }
@@ -136,6 +143,8 @@ static int tx_video_migrate_to(struct mtl_main_impl* impl,
 
   info("%s, session(%d,%d,%f) move to (%d,%d)\n", __func__, from_midx, from_idx,
        tx_video_session_get_cpu_busy(s), to_midx, i);
+  /* not pick it again in this period */
+  tx_video_session_clear_cpu_busy(s);
 
   return 0;
 }
@@ -178,7 +187,7 @@ static int admin_tx_video_migrate(struct mtl_main_impl* impl, bool* migrated) {
 
   dbg("%s, find one busy session(%d,%d)\n", __func__, from_sch->idx, busy_s->idx);
   struct mt_sch_impl* to_sch =
-      mt_sch_get(impl, quota_mbs, from_sch->type, MT_SCH_MASK_ALL);
+      mt_sch_get(impl, quota_mbs, from_sch->type, MT_SCH_MASK_ALL, from_sch->socket_id);
   if (!to_sch) {
     err("%s, no idle sch for session(%d,%d)\n", __func__, from_sch->idx, busy_s->idx);
     return -EIO;
@@ -252,6 +261,8 @@ static int rx_video_migrate_to(struct mtl_main_impl* impl,
 
   info("%s, session(%d,%d,%f) move to (%d,%d)\n", __func__, from_midx, from_idx,
        rx_video_session_get_cpu_busy(s), to_midx, i);
+  /* not pick it again in this period */
+  rx_video_session_clear_cpu_busy(s);
 
   return 0;
 }
@@ -294,7 +305,7 @@ static int admin_rx_video_migrate(struct mtl_main_impl* impl, bool* migrated) {
 
   dbg("%s, find one busy session(%d,%d)\n", __func__, from_sch->idx, busy_s->idx);
   struct mt_sch_impl* to_sch =
-      mt_sch_get(impl, quota_mbs, from_sch->type, MT_SCH_MASK_ALL);
+      mt_sch_get(impl, quota_mbs, from_sch->type, MT_SCH_MASK_ALL, from_sch->socket_id);
   if (!to_sch) {
     err("%s, no idle sch for session(%d,%d)\n", __func__, from_sch->idx, busy_s->idx);
     return -EIO;
@@ -315,6 +326,82 @@ static int admin_rx_video_migrate(struct mtl_main_impl* impl, bool* migrated) {
   return 0;
 }
 
+static int admin_cal_sch_load(struct mtl_main_impl* impl) {
+  struct mt_admin* admin = mt_get_admin(impl);
+  uint64_t tsc = rte_get_tsc_cycles();
+  uint64_t period_cycles = tsc - admin->balance_tsc;
+  bool first = !admin->balance_tsc;
+  struct mt_sch_impl* sch;
+
+  admin->balance_tsc = tsc;
+  if (first) return -EIO; /* no measure period yet */
+
+  for (int sch_idx = 0; sch_idx < MT_MAX_SCH_NUM; sch_idx++) {
+    sch = mt_sch_instance(impl, sch_idx);
+    if (!mt_sch_started(sch)) continue;
+    mt_sch_cal_load(sch, period_cycles);
+  }
+
+  return 0;
+}
+
+/* move the tasklets from the most loaded sch to the least loaded one on same socket */
+static int admin_tasklet_balance(struct mtl_main_impl* impl) {
+  struct mt_sch_impl* sch;
+  struct mt_sch_impl* busy_sch;
+  struct mt_sch_impl* idle_sch;
+  float load_sum, moved;
+  int sch_num, moves = 0;
+  /* the busy sch which has nothing to give, skip it for the next busiest */
+  bool stuck[MT_MAX_SCH_NUM] = {false};
+
+  while (moves < MT_ADMIN_BALANCE_MOVES_MAX) {
+    busy_sch = NULL;
+    for (int sch_idx = 0; sch_idx < MT_MAX_SCH_NUM; sch_idx++) {
+      sch = mt_sch_instance(impl, sch_idx);
+      if (!mt_sch_started(sch)) continue;
+      if (stuck[sch_idx]) continue;
+      if (!busy_sch || (sch->load > busy_sch->load)) busy_sch = sch;
+    }
+    if (!busy_sch) break;
+
+    idle_sch = NULL;
+    load_sum = 0;
+    sch_num = 0;
+    for (int sch_idx = 0; sch_idx < MT_MAX_SCH_NUM; sch_idx++) {
+      sch = mt_sch_instance(impl, sch_idx);
+      if (!mt_sch_started(sch)) continue;
+      if (sch->socket_id != busy_sch->socket_id) continue;
+      load_sum += sch->load;
+      sch_num++;
+      if (sch == busy_sch) continue;
+      /* a rx video only sch takes no other tasklets */
+      if (sch->type != MT_SCH_TYPE_DEFAULT) continue;
+      if (!idle_sch || (sch->load < idle_sch->load)) idle_sch = sch;
+    }
+    /* balanced already, the rest are less loaded */
+    if (busy_sch->load <= (load_sum / sch_num + MT_ADMIN_BALANCE_MARGIN)) break;
+    if (!idle_sch) {
+      stuck[busy_sch->idx] = true;
+      continue;
+    }
+
+    /* half of the gap at most, not make the idle one to be the busy one */
+    moved =
+        mt_sch_steal_tasklet(idle_sch, busy_sch, (busy_sch->load - idle_sch->load) / 2);
+    if (moved <= 0) {
+      stuck[busy_sch->idx] = true;
+      continue;
+    }
+    busy_sch->load -= moved;
+    idle_sch->load += moved;
+    moves++;
+  }
+
+  if (moves) info("%s, %d tasklets moved\n", __func__, moves);
+  return moves;
+}
+
 static void admin_wakeup_thread(struct mt_admin* admin) {
   mt_pthread_mutex_lock(&admin->admin_wake_mutex);
   mt_pthread_cond_signal(&admin->admin_wake_cond);
@@ -335,16 +422,27 @@ static int admin_func(struct mtl_main_impl* impl) {
 
   admin_cal_cpu_busy(impl);
 
-  bool migrated = false;
-  /* only one migrate(both tx and rx) for this period */
-  if (mt_has_tx_video_migrate(impl)) {
-    admin_tx_video_migrate(impl, &migrated);
-  }
-  if (!migrated && mt_has_rx_video_migrate(impl)) {
-    admin_rx_video_migrate(impl, &migrated);
+  int migrated_cnt = 0;
+  /* several migrate(both tx and rx) for this period */
+  for (int i = 0; i < MT_ADMIN_MIGRATE_MAX; i++) {
+    bool migrated = false;
+    if (mt_has_tx_video_migrate(impl)) {
+      admin_tx_video_migrate(impl, &migrated);
+    }
+    if (!migrated && mt_has_rx_video_migrate(impl)) {
+      admin_rx_video_migrate(impl, &migrated);
+    }
+    if (!migrated) break;
+    migrated_cnt++;
   }
 
-  if (migrated) admin_clear_cpu_busy(impl);
+  if (migrated_cnt) admin_clear_cpu_busy(impl);
+
+  if (mt_sch_has_load_measure(impl)) {
+    /* the load is also used by the admission of MTL_FLAG_SCH_QUOTA_AUTO */
+    if ((admin_cal_sch_load(impl) >= 0) && mt_has_tasklet_balance(impl))
+      admin_tasklet_balance(impl);
+  }
 
   rte_eal_alarm_set(admin->period_us, admin_alarm_handler, impl);
 
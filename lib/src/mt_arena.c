@@ -0,0 +1,231 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include "mt_arena.h"
+
+// #define DEBUG
+#include "mt_log.h"
+#include "mt_stat.h"
+
+/* the min frame size and the min step between two size classes */
+#define ARENA_MIN_SIZE (4096)
+
+static inline struct mt_arena_mgr* mt_get_arena(struct mtl_main_impl* impl) {
+  return &impl->arena;
+}
+
+size_t mt_arena_class_size(size_t size) {
+  size_t step;
+
+  if (size <= ARENA_MIN_SIZE) return ARENA_MIN_SIZE;
+  /* 8 classes between each power of 2, the waste is less than 12.5% */
+  step = RTE_MAX(rte_align64prevpow2(size) / 8, ARENA_MIN_SIZE);
+  return RTE_ALIGN_CEIL(size, step);
+}
+
+static struct mt_arena_class* arena_find_class(struct mt_arena_mgr* mgr, size_t size,
+                                               int soc_id) {
+  struct mt_arena_class* cls;
+
+  for (int i = 0; i < mgr->nb_classes; i++) {
+    cls = &mgr->classes[i];
+    if ((cls->size == size) && (cls->soc_id == soc_id)) return cls;
+  }
+
+  if (mgr->nb_classes >= MT_ARENA_CLASS_MAX) {
+    err("%s, all classes are used, size %" PRIu64 "\n", __func__, size);
+    return NULL;
+  }
+  cls = &mgr->classes[mgr->nb_classes];
+  cls->parent = mgr;
+  cls->size = size;
+  cls->soc_id = soc_id;
+  MT_TAILQ_INIT(&cls->free_list);
+  cls->nb_free = 0;
+  cls->nb_total = 0;
+  mgr->nb_classes++;
+  info("%s(%d), new class size %" PRIu64 " on socket %d\n", __func__,
+       mgr->nb_classes - 1, size, soc_id);
+  return cls;
+}
+
+static struct mt_arena_frame* arena_frame_alloc(struct mt_arena_class* cls) {
+  struct mt_arena_frame* frame;
+
+  frame = mt_rte_zmalloc_socket(sizeof(*frame), cls->soc_id);
+  if (!frame) return NULL;
+
+  frame->addr = mt_rte_zmalloc_socket(cls->size, cls->soc_id);
+  if (!frame->addr) {
+    mt_rte_free(frame);
+    return NULL;
+  }
+  /* resolve the iova once, no lookup for each session create */
+  frame->iova = rte_malloc_virt2iova(frame->addr);
+  frame->parent = cls;
+  cls->nb_total++;
+  return frame;
+}
+
+static void arena_frame_free(struct mt_arena_class* cls, struct mt_arena_frame* frame) {
+  mt_rte_free(frame->addr);
+  mt_rte_free(frame);
+  cls->nb_total--;
+}
+
+/* free all the cached frames on the socket, return the freed bytes */
+static size_t arena_trim(struct mt_arena_mgr* mgr, int soc_id) {
+  struct mt_arena_class* cls;
+  struct mt_arena_frame* frame;
+  size_t freed = 0;
+
+  for (int i = 0; i < mgr->nb_classes; i++) {
+    cls = &mgr->classes[i];
+    if (cls->soc_id != soc_id) continue;
+    while ((frame = MT_TAILQ_FIRST(&cls->free_list))) {
+      MT_TAILQ_REMOVE(&cls->free_list, frame, next);
+      cls->nb_free--;
+      freed += cls->size;
+      arena_frame_free(cls, frame);
+    }
+  }
+
+  if (freed) mgr->stat_trim++;
+  mgr->free_bytes -= freed;
+  return freed;
+}
+
+static int arena_stat(void* priv) {
+  struct mt_arena_mgr* mgr = priv;
+  struct mt_arena_class* cls;
+
+  mt_pthread_mutex_lock(&mgr->mutex);
+  for (int i = 0; i < mgr->nb_classes; i++) {
+    cls = &mgr->classes[i];
+    if (!cls->nb_total) continue;
+    notice("ARENA(%d), size %" PRIu64 " soc %d, frames %d free %d, get %" PRIu64
+           " reuse %" PRIu64 "\n",
+           i, cls->size, cls->soc_id, cls->nb_total, cls->nb_free, cls->stat_get,
+           cls->stat_reuse);
+  }
+  if (mgr->nb_classes)
+    notice("ARENA: cached %" PRIu64 " bytes, trim %" PRIu64 "\n", mgr->free_bytes,
+           mgr->stat_trim);
+  mt_pthread_mutex_unlock(&mgr->mutex);
+
+  return 0;
+}
+
+struct mt_arena_frame* mt_arena_get(struct mtl_main_impl* impl, size_t size, int soc_id,
+                                    struct mt_arena_quota* quota) {
+  struct mt_arena_mgr* mgr = mt_get_arena(impl);
+  size_t cls_size = mt_arena_class_size(size);
+  struct mt_arena_class* cls;
+  struct mt_arena_frame* frame;
+  bool reuse = false;
+
+  mt_pthread_mutex_lock(&mgr->mutex);
+
+  if (quota && quota->max_bytes && (quota->used_bytes + cls_size > quota->max_bytes)) {
+    err("%s, over quota, used %" PRIu64 " max %" PRIu64 "\n", __func__,
+        quota->used_bytes, quota->max_bytes);
+    mt_pthread_mutex_unlock(&mgr->mutex);
+    return NULL;
+  }
+
+  cls = arena_find_class(mgr, cls_size, soc_id);
+  if (!cls) {
+    mt_pthread_mutex_unlock(&mgr->mutex);
+    return NULL;
+  }
+
+  frame = MT_TAILQ_FIRST(&cls->free_list);
+  if (frame) {
+    MT_TAILQ_REMOVE(&cls->free_list, frame, next);
+    cls->nb_free--;
+    mgr->free_bytes -= cls_size;
+    cls->stat_reuse++;
+    reuse = true;
+  } else {
+    frame = arena_frame_alloc(cls);
+    /* give back the cached frames of other classes and retry */
+    if (!frame && arena_trim(mgr, soc_id)) frame = arena_frame_alloc(cls);
+    if (!frame) {
+      err("%s, frame malloc fail, size %" PRIu64 " soc %d\n", __func__, cls_size,
+          soc_id);
+      mt_pthread_mutex_unlock(&mgr->mutex);
+      return NULL;
+    }
+  }
+
+  frame->quota = quota;
+  if (quota) quota->used_bytes += cls_size;
+  cls->stat_get++;
+  mt_pthread_mutex_unlock(&mgr->mutex);
+
+  /* same as a new rte_zmalloc */
+  if (reuse) memset(frame->addr, 0, cls_size);
+  dbg("%s, frame %p size %" PRIu64 " reuse %s\n", __func__, frame->addr, cls_size,
+      reuse ? "yes" : "no");
+  return frame;
+}
+
+int mt_arena_put(struct mt_arena_frame* frame) {
+  struct mt_arena_class* cls = frame->parent;
+  struct mt_arena_mgr* mgr = cls->parent;
+
+  mt_pthread_mutex_lock(&mgr->mutex);
+  if (frame->quota) {
+    frame->quota->used_bytes -= cls->size;
+    frame->quota = NULL;
+  }
+  if (mgr->free_bytes + cls->size > MT_ARENA_FREE_MAX_BYTES) {
+    /* over the high-water, give the memory back to the heap */
+    dbg("%s, free frame %p, cached %" PRIu64 "\n", __func__, frame->addr,
+        mgr->free_bytes);
+    arena_frame_free(cls, frame);
+    mgr->stat_trim++;
+  } else {
+    /* lifo, the hot one is reused first */
+    MT_TAILQ_INSERT_HEAD(&cls->free_list, frame, next);
+    cls->nb_free++;
+    mgr->free_bytes += cls->size;
+  }
+  mt_pthread_mutex_unlock(&mgr->mutex);
+
+  return 0;
+}
+
+int mt_arena_init(struct mtl_main_impl* impl) {
+  struct mt_arena_mgr* mgr = mt_get_arena(impl);
+
+  mt_pthread_mutex_init(&mgr->mutex, NULL);
+  mgr->nb_classes = 0;
+  mgr->free_bytes = 0;
+  mgr->stat_trim = 0;
+  mt_stat_register(impl, arena_stat, mgr);
+
+  return 0;
+}
+
+int mt_arena_uinit(struct mtl_main_impl* impl) {
+  struct mt_arena_mgr* mgr = mt_get_arena(impl);
+  struct mt_arena_class* cls;
+
+  mt_stat_unregister(impl, arena_stat, mgr);
+
+  for (int i = 0; i < mgr->nb_classes; i++) {
+    cls = &mgr->classes[i];
+    if (cls->nb_free != cls->nb_total) {
+      warn("%s(%d), %d frames still in use, size %" PRIu64 "\n", __func__, i,
+           cls->nb_total - cls->nb_free, cls->size);
+    }
+    arena_trim(mgr, cls->soc_id);
+  }
+  mgr->nb_classes = 0;
+
+  mt_pthread_mutex_destroy(&mgr->mutex);
+
+  return 0;
+}
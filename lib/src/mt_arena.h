@@ -0,0 +1,29 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _MT_LIB_ARENA_HEAD_H_
+#define _MT_LIB_ARENA_HEAD_H_
+
+#include "mt_main.h"
+
+int mt_arena_init(struct mtl_main_impl* impl);
+int mt_arena_uinit(struct mtl_main_impl* impl);
+
+/* the size class a frame of size is placed in */
+size_t mt_arena_class_size(size_t size);
+
+/* set the quota to hold nb_frames of size */
+static inline void mt_arena_quota_init(struct mt_arena_quota* quota, int nb_frames,
+                                       size_t size) {
+  quota->max_bytes = mt_arena_class_size(size) * nb_frames;
+  quota->used_bytes = 0;
+}
+
+/* get a zeroed frame, the quota(can be NULL) is charged */
+struct mt_arena_frame* mt_arena_get(struct mtl_main_impl* impl, size_t size, int soc_id,
+                                    struct mt_arena_quota* quota);
+/* give back the frame, it's cached for reuse unless the arena is over the high-water */
+int mt_arena_put(struct mt_arena_frame* frame);
+
+#endif
@@ -7,10 +7,29 @@
 #include "mt_dev.h"
 //#define DEBUG
 #include "mt_log.h"
+#include "mt_stat.h"
 #include "mt_util.h"
 
 #define ARP_REQ_PERIOD_MS (500)
 #define ARP_REQ_PERIOD_US (ARP_REQ_PERIOD_MS * 1000)
+/* the poll step of the blocking get mac */
+#define ARP_WAIT_STEP_MS (10)
+
+/* the initial buckets, power of 2 */
+#define ARP_BUCKETS_INIT (64)
+/* grow the buckets if the avg chain is longer than this */
+#define ARP_BUCKET_LOAD (2)
+
+/* the mac is refreshed if no reply for this time */
+#define ARP_REACHABLE_NS (30ull * NS_PER_S)
+/* max refresh requests before the stale neighbor is removed */
+#define ARP_REFRESH_MAX (6)
+/* the stale neighbor without any lookup for this time is removed */
+#define ARP_GC_NS (300ull * NS_PER_S)
+/* the unresolved neighbor without any lookup for this time is removed */
+#define ARP_INCOMPLETE_GC_NS (10ull * NS_PER_S)
+/* the queued pkts are dropped after this requests without reply */
+#define ARP_PENDING_MAX_REQ (6)
 
 static int arp_start_arp_timer(struct mt_arp_impl* arp_impl);
 
@@ -19,16 +38,135 @@ static inline struct mt_arp_impl* get_arp(struct mtl_main_impl* impl,
   return impl->arp[port];
 }
 
-static void arp_reset(struct mt_arp_impl* arp) {
-  struct mt_arp_entry* entry = NULL;
+static inline uint32_t arp_hash(struct mt_arp_impl* arp, uint32_t ip) {
+  uint32_t h = ip * 0x9e3779b1;
 
-  for (int i = 0; i > MT_ARP_ENTRY_MAX; i++) {
-    entry = &arp->entries[i];
+  return (h ^ (h >> 16)) & arp->bucket_mask;
+}
+
+/* all below arp_entry_* helpers need the arp mutex */
+static struct mt_arp_entry* arp_entry_find(struct mt_arp_impl* arp, uint32_t ip) {
+  struct mt_arp_entry* entry = arp->buckets[arp_hash(arp, ip)];
+
+  while (entry) {
+    if (entry->ip == ip) return entry;
+    entry = entry->next;
+  }
+
+  return NULL;
+}
+
+static int arp_buckets_grow(struct mt_arp_impl* arp) {
+  uint32_t old_cnt = arp->bucket_mask + 1;
+  uint32_t new_cnt = old_cnt * 2;
+  struct mt_arp_entry** old_buckets = arp->buckets;
+  struct mt_arp_entry** buckets;
+  struct mt_arp_entry* entry;
+  struct mt_arp_entry* next;
+
+  buckets = mt_rte_zmalloc_socket(sizeof(*buckets) * new_cnt, arp->soc_id);
+  if (!buckets) {
+    warn("%s(%d), buckets malloc fail for %u\n", __func__, arp->port, new_cnt);
+    return -ENOMEM;
+  }
+
+  arp->buckets = buckets;
+  arp->bucket_mask = new_cnt - 1;
+  for (uint32_t i = 0; i < old_cnt; i++) {
+    entry = old_buckets[i];
+    while (entry) {
+      next = entry->next;
+      uint32_t h = arp_hash(arp, entry->ip);
+      entry->next = buckets[h];
+      buckets[h] = entry;
+      entry = next;
+    }
+  }
+  mt_rte_free(old_buckets);
+
+  info("%s(%d), %u buckets for %u entries\n", __func__, arp->port, new_cnt,
+       arp->entry_cnt);
+  return 0;
+}
 
-    rte_atomic32_set(&entry->mac_ready, 0);
-    entry->ip = 0;
-    memset(&entry->ea, 0, sizeof(entry->ea));
+static struct mt_arp_entry* arp_entry_add(struct mt_arp_impl* arp, uint32_t ip) {
+  struct mt_arp_entry* entry;
+  uint32_t h;
+
+  if (arp->entry_cnt >= MT_ARP_ENTRY_MAX) {
+    err("%s(%d), arp table full\n", __func__, arp->port);
+    return NULL;
+  }
+  /* the old table is still usable if the grow fail */
+  if (arp->entry_cnt >= (arp->bucket_mask + 1) * ARP_BUCKET_LOAD)
+    arp_buckets_grow(arp);
+
+  entry = mt_rte_zmalloc_socket(sizeof(*entry), arp->soc_id);
+  if (!entry) {
+    err("%s(%d), entry malloc fail\n", __func__, arp->port);
+    return NULL;
+  }
+  entry->ip = ip;
+  entry->state = MT_ARP_INCOMPLETE;
+  entry->used_ns = mt_get_monotonic_time();
+
+  h = arp_hash(arp, ip);
+  entry->next = arp->buckets[h];
+  arp->buckets[h] = entry;
+  arp->entry_cnt++;
+  return entry;
+}
+
+static void arp_entry_drop_pending(struct mt_arp_impl* arp, struct mt_arp_entry* entry) {
+  if (!entry->pending_cnt) return;
+
+  rte_pktmbuf_free_bulk(entry->pending, entry->pending_cnt);
+  arp->stat_queue_drop += entry->pending_cnt;
+  entry->pending_cnt = 0;
+}
+
+static void arp_entry_free(struct mt_arp_impl* arp, struct mt_arp_entry* entry) {
+  arp_entry_drop_pending(arp, entry);
+  mt_rte_free(entry);
+  arp->entry_cnt--;
+}
+
+/* send the queued pkts once the mac is resolved */
+static void arp_entry_flush_pending(struct mt_arp_impl* arp, struct mt_arp_entry* entry) {
+  struct rte_ether_hdr* eth;
+  uint16_t tx;
+
+  if (!entry->pending_cnt) return;
+
+  for (uint16_t i = 0; i < entry->pending_cnt; i++) {
+    eth = rte_pktmbuf_mtod(entry->pending[i], struct rte_ether_hdr*);
+    rte_ether_addr_copy(&entry->ea, mt_eth_d_addr(eth));
+  }
+  tx = mt_dev_tx_sys_queue_burst(arp->parent, arp->port, entry->pending,
+                                 entry->pending_cnt);
+  if (tx < entry->pending_cnt) {
+    rte_pktmbuf_free_bulk(entry->pending + tx, entry->pending_cnt - tx);
+    arp->stat_queue_drop += entry->pending_cnt - tx;
   }
+  dbg("%s(%d), %u pkts sent\n", __func__, arp->port, tx);
+  entry->pending_cnt = 0;
+}
+
+static void arp_entry_update(struct mt_arp_impl* arp, struct mt_arp_entry* entry,
+                             struct rte_ether_addr* ea) {
+  if ((entry->state != MT_ARP_INCOMPLETE) && !rte_is_same_ether_addr(&entry->ea, ea)) {
+    uint8_t ip[MTL_IP_ADDR_LEN];
+    mt_u32_to_ip(entry->ip, ip);
+    warn("%s(%d), mac changed for %d.%d.%d.%d\n", __func__, arp->port, ip[0], ip[1],
+         ip[2], ip[3]);
+    arp->stat_mac_change++;
+  }
+
+  rte_ether_addr_copy(ea, &entry->ea);
+  entry->state = MT_ARP_REACHABLE;
+  entry->update_ns = mt_get_monotonic_time();
+  entry->req_cnt = 0;
+  arp_entry_flush_pending(arp, entry);
 }
 
 static bool arp_is_valid_hdr(struct rte_arp_hdr* hdr) {
@@ -42,10 +180,31 @@ static bool arp_is_valid_hdr(struct rte_arp_hdr* hdr) {
   return true;
 }
 
+/*
+ * refresh the known neighbor from any arp it sent, include the gratuitous one, unknown
+ * neighbors are not added to keep the table for the peers we talk to.
+ */
+static int arp_learn_sender(struct mt_arp_impl* arp, struct rte_arp_hdr* hdr) {
+  uint32_t sip = hdr->arp_data.arp_sip;
+  struct mt_arp_entry* entry;
+
+  if (!sip) return 0; /* arp probe */
+  if (sip == hdr->arp_data.arp_tip) arp->stat_garp++;
+
+  mt_pthread_mutex_lock(&arp->mutex);
+  entry = arp_entry_find(arp, sip);
+  if (entry) arp_entry_update(arp, entry, &hdr->arp_data.arp_sha);
+  mt_pthread_mutex_unlock(&arp->mutex);
+
+  return entry ? 1 : 0;
+}
+
 static int arp_receive_request(struct mtl_main_impl* impl, struct rte_arp_hdr* request,
                                enum mtl_port port) {
   if (!arp_is_valid_hdr(request)) return -EINVAL;
 
+  arp_learn_sender(get_arp(impl, port), request);
+
   if (request->arp_data.arp_tip != *(uint32_t*)mt_sip_addr(impl, port)) {
     dbg("%s(%d), not our arp\n", __func__, port);
     return -EINVAL;
@@ -93,8 +252,16 @@ static int arp_receive_request(struct mtl_main_impl* impl, struct rte_arp_hdr* r
 
 static int arp_receive_reply(struct mtl_main_impl* impl, struct rte_arp_hdr* reply,
                              enum mtl_port port) {
+  struct mt_arp_impl* arp_impl = get_arp(impl, port);
+
   if (!arp_is_valid_hdr(reply)) return -EINVAL;
 
+  /* the gratuitous reply is a broadcast to all */
+  if (reply->arp_data.arp_sip == reply->arp_data.arp_tip) {
+    arp_learn_sender(arp_impl, reply);
+    return 0;
+  }
+
   if (reply->arp_data.arp_tip != *(uint32_t*)mt_sip_addr(impl, port)) {
     dbg("%s(%d), not our arp\n", __func__, port);
     return -EINVAL;
@@ -106,28 +273,13 @@ static int arp_receive_reply(struct mtl_main_impl* impl, struct rte_arp_hdr* rep
             __func__, port, ip[0], ip[1], ip[2], ip[3], addr_bytes[0], addr_bytes[1],
             addr_bytes[2], addr_bytes[3], addr_bytes[4], addr_bytes[5]);
 
-  struct mt_arp_impl* arp_impl = get_arp(impl, port);
-  struct mt_arp_entry* entry = NULL;
-
   /* check if our request */
-  mt_pthread_mutex_lock(&arp_impl->mutex);
-  int i;
-  for (i = 0; i < MT_ARP_ENTRY_MAX; i++) {
-    entry = &arp_impl->entries[i];
-
-    if (entry->ip == reply->arp_data.arp_sip) break;
-  }
-  if (i >= MT_ARP_ENTRY_MAX) {
+  if (!arp_learn_sender(arp_impl, reply)) {
     err_once("%s(%d), not our arp request, from %d.%d.%d.%d\n", __func__, port, ip[0],
              ip[1], ip[2], ip[3]);
-    mt_pthread_mutex_unlock(&arp_impl->mutex);
     return -EINVAL;
   }
-
-  /* save to arp table */
-  memcpy(entry->ea.addr_bytes, reply->arp_data.arp_sha.addr_bytes, RTE_ETHER_ADDR_LEN);
-  rte_atomic32_set(&entry->mac_ready, 1);
-  mt_pthread_mutex_unlock(&arp_impl->mutex);
+  arp_impl->stat_reply++;
 
   return 0;
 }
@@ -166,21 +318,55 @@ static int arp_send_req(struct mtl_main_impl* impl, enum mtl_port port, uint32_t
     return -EIO;
   }
 
+  get_arp(impl, port)->stat_req++;
   dbg("%s(%d), ip 0x%x\n", __func__, port, ip);
   return 0;
 }
 
-static int arp_get_result(struct mt_arp_impl* arp_impl, struct mt_arp_entry* entry,
-                          int timeout_ms) {
+/* copy the mac if resolved, add the entry and send the request if not known */
+static int arp_lookup(struct mt_arp_impl* arp_impl, uint32_t ip,
+                      struct rte_ether_addr* ea) {
+  struct mtl_main_impl* impl = arp_impl->parent;
+  enum mtl_port port = arp_impl->port;
+  struct mt_arp_entry* entry;
+  int ret = -EIO;
+
+  mt_pthread_mutex_lock(&arp_impl->mutex);
+  entry = arp_entry_find(arp_impl, ip);
+  if (!entry) {
+    entry = arp_entry_add(arp_impl, ip);
+    if (!entry) {
+      mt_pthread_mutex_unlock(&arp_impl->mutex);
+      return -ENOMEM;
+    }
+    uint8_t addr[MTL_IP_ADDR_LEN];
+    mt_u32_to_ip(ip, addr);
+    info("%s(%d), %d.%d.%d.%d alloc, %u entries\n", __func__, port, addr[0], addr[1],
+         addr[2], addr[3], arp_impl->entry_cnt);
+    arp_send_req(impl, port, ip); /* send the first arp request packet */
+  }
+  entry->used_ns = mt_get_monotonic_time();
+  if (entry->state != MT_ARP_INCOMPLETE) {
+    rte_ether_addr_copy(&entry->ea, ea);
+    ret = 0;
+  }
+  mt_pthread_mutex_unlock(&arp_impl->mutex);
+
+  /* start the timer to send arp again or refresh */
+  if (ret < 0) arp_start_arp_timer(arp_impl);
+  return ret;
+}
+
+static int arp_get_result(struct mt_arp_impl* arp_impl, uint32_t ip,
+                          struct rte_ether_addr* ea, int timeout_ms) {
   enum mtl_port port = arp_impl->port;
   int retry = 0;
   int max_retry = 0;
-  int sleep_interval_ms = 500;
 
-  if (timeout_ms) max_retry = (timeout_ms / sleep_interval_ms) + 1;
+  if (timeout_ms) max_retry = (timeout_ms / ARP_WAIT_STEP_MS) + 1;
 
   /* wait the arp result */
-  while (!rte_atomic32_read(&entry->mac_ready)) {
+  while (arp_lookup(arp_impl, ip, ea) < 0) {
     if (mt_aborted(arp_impl->parent)) {
       err("%s(%d), cache fail as user aborted\n", __func__, port);
       return -EIO;
@@ -190,13 +376,13 @@ static int arp_get_result(struct mt_arp_impl* arp_impl, struct mt_arp_entry* ent
         err("%s(%d), cache fail as timeout to %d ms\n", __func__, port, timeout_ms);
       return -EIO;
     }
-    mt_sleep_ms(sleep_interval_ms);
+    mt_sleep_ms(ARP_WAIT_STEP_MS);
     retry++;
-    if (0 == (retry % 10)) {
-      uint8_t ip[MTL_IP_ADDR_LEN];
-      mt_u32_to_ip(entry->ip, ip);
-      info("%s(%d), cache waiting arp from %d.%d.%d.%d\n", __func__, port, ip[0], ip[1],
-           ip[2], ip[3]);
+    if (0 == (retry % (5000 / ARP_WAIT_STEP_MS))) {
+      uint8_t addr[MTL_IP_ADDR_LEN];
+      mt_u32_to_ip(ip, addr);
+      info("%s(%d), cache waiting arp from %d.%d.%d.%d\n", __func__, port, addr[0],
+           addr[1], addr[2], addr[3]);
     }
   }
 
@@ -204,30 +390,80 @@ static int arp_get_result(struct mt_arp_impl* arp_impl, struct mt_arp_entry* ent
   return 0;
 }
 
+/* return true if the entry should be removed */
+static bool arp_entry_age(struct mt_arp_impl* arp_impl, struct mt_arp_entry* entry,
+                          uint64_t now) {
+  struct mtl_main_impl* impl = arp_impl->parent;
+  enum mtl_port port = arp_impl->port;
+
+  switch (entry->state) {
+    case MT_ARP_INCOMPLETE:
+      if (entry->pending_cnt && (entry->req_cnt >= ARP_PENDING_MAX_REQ))
+        arp_entry_drop_pending(arp_impl, entry);
+      /* no one wait it */
+      if (!entry->pending_cnt && ((now - entry->used_ns) > ARP_INCOMPLETE_GC_NS))
+        return true;
+      /* has request but not get arp reply */
+      arp_send_req(impl, port, entry->ip);
+      entry->req_cnt++;
+      break;
+    case MT_ARP_REACHABLE:
+      if ((now - entry->update_ns) > ARP_REACHABLE_NS) {
+        /* keep use the mac but refresh it */
+        entry->state = MT_ARP_STALE;
+        entry->req_cnt = 0;
+        arp_send_req(impl, port, entry->ip);
+        entry->req_cnt++;
+      }
+      break;
+    case MT_ARP_STALE:
+      /* not used anymore or the neighbor is gone */
+      if ((now - entry->used_ns) > ARP_GC_NS) return true;
+      if (entry->req_cnt >= ARP_REFRESH_MAX) return true;
+      arp_send_req(impl, port, entry->ip);
+      entry->req_cnt++;
+      break;
+    default:
+      break;
+  }
+
+  return false;
+}
+
 static void arp_timer_cb(void* param) {
   struct mt_arp_impl* arp_impl = param;
-  struct mt_arp_entry* entry = NULL;
+  struct mt_arp_entry** prev;
+  struct mt_arp_entry* entry;
   enum mtl_port port = arp_impl->port;
-  struct mtl_main_impl* impl = arp_impl->parent;
-  int pending = 0;
+  uint64_t now = mt_get_monotonic_time();
+  uint32_t entry_cnt;
 
   dbg("%s(%d), start\n", __func__, port);
   mt_pthread_mutex_lock(&arp_impl->mutex);
-  for (int i = 0; i < MT_ARP_ENTRY_MAX; i++) {
-    entry = &arp_impl->entries[i];
-
-    if (entry->ip && !rte_atomic32_read(&entry->mac_ready)) {
-      /* has request but not get arp reply */
-      arp_send_req(impl, port, entry->ip);
-      pending++;
+  for (uint32_t i = 0; i <= arp_impl->bucket_mask; i++) {
+    prev = &arp_impl->buckets[i];
+    while ((entry = *prev)) {
+      if (arp_entry_age(arp_impl, entry, now)) {
+        uint8_t ip[MTL_IP_ADDR_LEN];
+        mt_u32_to_ip(entry->ip, ip);
+        info("%s(%d), %d.%d.%d.%d expired, state %d\n", __func__, port, ip[0], ip[1],
+             ip[2], ip[3], entry->state);
+        *prev = entry->next;
+        arp_entry_free(arp_impl, entry);
+        arp_impl->stat_expired++;
+        continue;
+      }
+      prev = &entry->next;
     }
   }
+  entry_cnt = arp_impl->entry_cnt;
   arp_impl->timer_active = false;
   mt_pthread_mutex_unlock(&arp_impl->mutex);
 
-  if (pending > 0) {
+  /* keep the timer for the aging and refresh */
+  if (entry_cnt > 0) {
     arp_start_arp_timer(arp_impl);
-    dbg("%s(%d), start arp timer for %d req\n", __func__, port, pending);
+    dbg("%s(%d), start arp timer for %u entries\n", __func__, port, entry_cnt);
   }
 }
 
@@ -249,6 +485,33 @@ static int arp_start_arp_timer(struct mt_arp_impl* arp_impl) {
   return ret;
 }
 
+static int arp_stat(void* priv) {
+  struct mt_arp_impl* arp = priv;
+  enum mtl_port port = arp->port;
+
+  if (!arp->entry_cnt && !arp->stat_req) return 0;
+
+  notice("ARP(%d): %u entries %u buckets, req %u reply %u garp %u expired %u\n", port,
+         arp->entry_cnt, arp->bucket_mask + 1, arp->stat_req, arp->stat_reply,
+         arp->stat_garp, arp->stat_expired);
+  arp->stat_req = 0;
+  arp->stat_reply = 0;
+  arp->stat_garp = 0;
+  arp->stat_expired = 0;
+  if (arp->stat_queued || arp->stat_queue_drop) {
+    notice("ARP(%d): pkts queued %u dropped %u\n", port, arp->stat_queued,
+           arp->stat_queue_drop);
+    arp->stat_queued = 0;
+    arp->stat_queue_drop = 0;
+  }
+  if (arp->stat_mac_change) {
+    notice("ARP(%d): mac changed %u\n", port, arp->stat_mac_change);
+    arp->stat_mac_change = 0;
+  }
+
+  return 0;
+}
+
 int mt_arp_parse(struct mtl_main_impl* impl, struct rte_arp_hdr* hdr,
                  enum mtl_port port) {
   switch (ntohs(hdr->arp_opcode)) {
@@ -268,56 +531,47 @@ int mt_arp_parse(struct mtl_main_impl* impl, struct rte_arp_hdr* hdr,
 
 int mt_arp_cni_get_mac(struct mtl_main_impl* impl, struct rte_ether_addr* ea,
                        enum mtl_port port, uint32_t ip, int timeout_ms) {
+  return arp_get_result(get_arp(impl, port), ip, ea, timeout_ms);
+}
+
+uint16_t mt_arp_cni_queue(struct mtl_main_impl* impl, enum mtl_port port, uint32_t ip,
+                          struct rte_mbuf** pkts, uint16_t nb_pkts) {
   struct mt_arp_impl* arp_impl = get_arp(impl, port);
-  struct mt_arp_entry* entry = NULL;
-  int ret;
+  struct rte_mempool* sys_pool = mt_get_tx_mempool(impl, port);
+  struct mt_arp_entry* entry;
+  struct rte_mbuf* pkt;
+  uint16_t queued = 0;
 
   mt_pthread_mutex_lock(&arp_impl->mutex);
-  int i;
-  for (i = 0; i < MT_ARP_ENTRY_MAX; i++) {
-    entry = &arp_impl->entries[i];
-
-    if (entry->ip == ip) { /* arp request sent already */
-      mt_pthread_mutex_unlock(&arp_impl->mutex);
-      goto get_result;
-    }
-  }
-
-  /* not sent, try find one empty slot */
-  for (i = 0; i < MT_ARP_ENTRY_MAX; i++) {
-    entry = &arp_impl->entries[i];
-
-    /* find a empty slot */
-    if (entry->ip == 0) break;
+  entry = arp_entry_find(arp_impl, ip);
+  if (!entry) { /* the caller should lookup it first */
+    mt_pthread_mutex_unlock(&arp_impl->mutex);
+    err("%s(%d), no arp entry for 0x%x\n", __func__, port, ip);
+    return 0;
   }
-  if (i >= MT_ARP_ENTRY_MAX) {
-    warn("%s(%d), reset arp\n", __func__, port);
-    /* arp table full, flush it, do we need extra protect? */
-    arp_reset(arp_impl);
-    i = 0;
+  while ((queued < nb_pkts) && (entry->pending_cnt < MT_ARP_PENDING_MAX)) {
+    pkt = pkts[queued];
+    /*
+     * the pkts are sent on the sys queue and stay in its ring until the nic cleans
+     * them, maybe after the owner pool(e.g. a mudp socket one) is freed, hold a copy.
+     */
+    if (pkt->pool != sys_pool) {
+      pkt = rte_pktmbuf_copy(pkts[queued], sys_pool, 0, UINT32_MAX);
+      if (!pkt) {
+        dbg("%s(%d), pkt copy fail\n", __func__, port);
+        break;
+      }
+      rte_pktmbuf_free(pkts[queued]);
+    }
+    entry->pending[entry->pending_cnt++] = pkt;
+    queued++;
   }
-  entry = &arp_impl->entries[i];
-  entry->ip = ip;
-  rte_atomic32_set(&entry->mac_ready, 0);
+  arp_impl->stat_queued += queued;
+  /* the reply may arrive already */
+  if (entry->state != MT_ARP_INCOMPLETE) arp_entry_flush_pending(arp_impl, entry);
   mt_pthread_mutex_unlock(&arp_impl->mutex);
 
-  uint8_t addr[MTL_IP_ADDR_LEN];
-  mt_u32_to_ip(ip, addr);
-  info("%s(%d), %d.%d.%d.%d alloc at %d\n", __func__, port, addr[0], addr[1], addr[2],
-       addr[3], i);
-
-  /* arp and wait the reply */
-  arp_send_req(impl, port, ip);  /* send the first arp request packet */
-  arp_start_arp_timer(arp_impl); /* start the timer to monitor if send arp again */
-
-get_result:
-  /* wait the arp result */
-  ret = arp_get_result(arp_impl, entry, timeout_ms);
-  if (ret >= 0) {
-    /* ready now, copy the mac addr arp result */
-    memcpy(ea->addr_bytes, entry->ea.addr_bytes, RTE_ETHER_ADDR_LEN);
-  }
-  return ret;
+  return queued;
 }
 
 int mt_arp_init(struct mtl_main_impl* impl) {
@@ -334,7 +588,20 @@ int mt_arp_init(struct mtl_main_impl* impl) {
 
     mt_pthread_mutex_init(&arp->mutex, NULL);
     arp->port = i;
+    arp->soc_id = socket;
     arp->parent = impl;
+    arp->buckets =
+        mt_rte_zmalloc_socket(sizeof(*arp->buckets) * ARP_BUCKETS_INIT, socket);
+    if (!arp->buckets) {
+      err("%s(%d), buckets malloc fail\n", __func__, i);
+      mt_pthread_mutex_destroy(&arp->mutex);
+      mt_rte_free(arp);
+      mt_arp_uinit(impl);
+      return -ENOMEM;
+    }
+    arp->bucket_mask = ARP_BUCKETS_INIT - 1;
+
+    mt_stat_register(impl, arp_stat, arp);
 
     /* assign arp instance */
     impl->arp[i] = arp;
@@ -345,11 +612,22 @@ int mt_arp_init(struct mtl_main_impl* impl) {
 
 int mt_arp_uinit(struct mtl_main_impl* impl) {
   int num_ports = mt_num_ports(impl);
+  struct mt_arp_entry* entry;
 
   for (int i = 0; i < num_ports; i++) {
     struct mt_arp_impl* arp = get_arp(impl, i);
     if (!arp) continue;
 
+    mt_stat_unregister(impl, arp_stat, arp);
+    rte_eal_alarm_cancel(arp_timer_cb, arp);
+
+    for (uint32_t b = 0; b <= arp->bucket_mask; b++) {
+      while ((entry = arp->buckets[b])) {
+        arp->buckets[b] = entry->next;
+        arp_entry_free(arp, entry);
+      }
+    }
+    mt_rte_free(arp->buckets);
     mt_pthread_mutex_destroy(&arp->mutex);
 
     /* free the memory */
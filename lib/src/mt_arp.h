@@ -11,6 +11,12 @@ int mt_arp_parse(struct mtl_main_impl* impl, struct rte_arp_hdr* hdr, enum mtl_p
 
 int mt_arp_cni_get_mac(struct mtl_main_impl* impl, struct rte_ether_addr* ea,
                        enum mtl_port port, uint32_t ip, int timeout_ms);
+/*
+ * queue the pkts to a resolving ip, return the number of accepted pkts, the accepted
+ * pkts are consumed and any not from the sys tx pool is replaced by a sys pool copy.
+ */
+uint16_t mt_arp_cni_queue(struct mtl_main_impl* impl, enum mtl_port port, uint32_t ip,
+                          struct rte_mbuf** pkts, uint16_t nb_pkts);
 
 int mt_arp_init(struct mtl_main_impl* impl);
 int mt_arp_uinit(struct mtl_main_impl* impl);
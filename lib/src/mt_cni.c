@@ -20,6 +20,19 @@
 #include "mt_tap.h"
 #include "mt_util.h"
 
+/* the hw rx timestamp in the mbuf if MTL_FLAG_CNI_RX_TIMESTAMP, else 0 */
+static inline uint64_t cni_rx_hw_ts(struct mtl_main_impl* impl, struct rte_mbuf* m,
+                                    enum mtl_port port) {
+  struct mt_cni_impl* cni = mt_get_cni(impl);
+
+  if (!impl->dynflag_rx_timestamp || !(m->ol_flags & impl->dynflag_rx_timestamp))
+    return 0;
+  if (!mt_has_cni_rx_timestamp(impl)) return 0;
+
+  cni->stat_ctrl_hw_ts[port]++;
+  return *RTE_MBUF_DYNFIELD(m, impl->dynfield_offset, rte_mbuf_timestamp_t*);
+}
+
 static int cni_rx_handle(struct mtl_main_impl* impl, struct rte_mbuf* m,
                          enum mtl_port port) {
   struct mt_ptp_impl* ptp = mt_get_ptp(impl, port);
@@ -49,8 +62,10 @@ static int cni_rx_handle(struct mtl_main_impl* impl, struct rte_mbuf* m,
   dbg("%s(%d), ether_type 0x%x\n", __func__, port, ether_type);
   switch (ether_type) {
     case RTE_ETHER_TYPE_1588:
+      if (!ptp) break; /* no ptp on this port */
       ptp_hdr = rte_pktmbuf_mtod_offset(m, struct mt_ptp_header*, hdr_offset);
-      mt_ptp_parse(ptp, ptp_hdr, vlan, MT_PTP_L2, m->timesync, NULL);
+      mt_ptp_parse(ptp, ptp_hdr, vlan, MT_PTP_L2, m->timesync,
+                   cni_rx_hw_ts(impl, m, port), NULL);
       break;
     case RTE_ETHER_TYPE_ARP:
       arp_hdr = rte_pktmbuf_mtod_offset(m, struct rte_arp_hdr*, hdr_offset);
@@ -63,7 +78,8 @@ static int cni_rx_handle(struct mtl_main_impl* impl, struct rte_mbuf* m,
       if (ptp && (src_port == MT_PTP_UDP_EVENT_PORT ||
                   src_port == MT_PTP_UDP_GEN_PORT)) { /* ptp pkt*/
         ptp_hdr = rte_pktmbuf_mtod_offset(m, struct mt_ptp_header*, hdr_offset);
-        mt_ptp_parse(ptp, ptp_hdr, vlan, MT_PTP_L4, m->timesync, ipv4_hdr);
+        mt_ptp_parse(ptp, ptp_hdr, vlan, MT_PTP_L4, m->timesync,
+                     cni_rx_hw_ts(impl, m, port), ipv4_hdr);
       } else if (dhcp && src_port == MT_DHCP_UDP_SERVER_PORT) { /* dhcp pkt */
         dhcp_hdr = rte_pktmbuf_mtod_offset(m, struct mt_dhcp_hdr*, hdr_offset);
         mt_dhcp_parse(impl, dhcp_hdr, port);
@@ -77,46 +93,89 @@ static int cni_rx_handle(struct mtl_main_impl* impl, struct rte_mbuf* m,
   return 0;
 }
 
+/* the control lane, drain the ptp queues of all ports within the ctrl budget */
+static int cni_ctrl_lane(struct mtl_main_impl* impl, struct mt_cni_impl* cni) {
+  struct rte_mbuf* pkts_rx[ST_CNI_RX_BURST_SIZE];
+  struct mt_ptp_impl* ptp;
+  uint16_t rx, budget;
+  int done = 0;
+
+  for (int i = 0; i < cni->num_ports; i++) {
+    ptp = mt_get_ptp(impl, i);
+    if (!ptp || !ptp->rx_queue) continue;
+
+    budget = cni->budget[MT_CNI_CLASS_CTRL];
+    while (budget) {
+      rx = mt_dev_rx_burst(ptp->rx_queue, pkts_rx, RTE_MIN(budget, ST_CNI_RX_BURST_SIZE));
+      if (!rx) break;
+      cni->eth_rx_cnt[i] += rx;
+      cni->stat_ctrl_pkts[i] += rx;
+      for (uint16_t ri = 0; ri < rx; ri++) cni_rx_handle(impl, pkts_rx[ri], i);
+      mt_free_mbufs(&pkts_rx[0], rx);
+      done += rx;
+      budget -= rx;
+    }
+    if (!budget) cni->stat_budget_out[MT_CNI_CLASS_CTRL]++;
+  }
+
+  return done;
+}
+
 static int cni_traffic(struct mtl_main_impl* impl) {
   struct mt_cni_impl* cni = mt_get_cni(impl);
-  int num_ports = mt_num_ports(impl);
+  int num_ports = cni->num_ports;
   struct rte_mbuf* pkts_rx[ST_CNI_RX_BURST_SIZE];
-  uint16_t rx;
-  struct mt_ptp_impl* ptp;
+  uint16_t rx, budget;
   bool done = true;
 
-  for (int i = 0; i < num_ports; i++) {
-    ptp = mt_get_ptp(impl, i);
+  /* the ptp first, and again after each burst of others to bound the delay of sync */
+  if (cni_ctrl_lane(impl, cni) > 0) done = false;
 
-    /* rx from ptp rx queue */
-    if (ptp && ptp->rx_queue) {
-      rx = mt_dev_rx_burst(ptp->rx_queue, pkts_rx, ST_CNI_RX_BURST_SIZE);
-      if (rx > 0) {
-        cni->eth_rx_cnt[i] += rx;
-        for (uint16_t ri = 0; ri < rx; ri++) cni_rx_handle(impl, pkts_rx[ri], i);
-        mt_free_mbufs(&pkts_rx[0], rx);
-        done = false;
-      }
-    }
+  for (int i = 0; i < num_ports; i++) {
     mt_tap_handle(impl, i);
+    /* the tsq pkts left staged as the nic was full at the last burst */
+    if (mt_shared_queue(impl, i)) mt_tsq_flush_pending(impl, i);
     /* rx from cni rx queue */
     if (cni->rx_q[i]) {
-      rx = mt_dev_rx_burst(cni->rx_q[i], pkts_rx, ST_CNI_RX_BURST_SIZE);
-      if (rx > 0) {
+      budget = cni->budget[MT_CNI_CLASS_SYS];
+      while (budget) {
+        rx = mt_dev_rx_burst(cni->rx_q[i], pkts_rx,
+                             RTE_MIN(budget, ST_CNI_RX_BURST_SIZE));
+        if (!rx) break;
         cni->eth_rx_cnt[i] += rx;
+        /* the arp and ptp are handled before pass to kni */
         for (uint16_t ri = 0; ri < rx; ri++) cni_rx_handle(impl, pkts_rx[ri], i);
         mt_kni_handle(impl, i, pkts_rx, rx);
         mt_free_mbufs(&pkts_rx[0], rx);
+        budget -= rx;
         done = false;
+        cni_ctrl_lane(impl, cni);
       }
+      if (!budget) cni->stat_budget_out[MT_CNI_CLASS_SYS]++;
     }
     /* trigger rsq rx */
     if (cni->rsq[i]) {
-      mt_rsq_burst(cni->rsq[i], ST_CNI_RX_BURST_SIZE);
+      budget = cni->budget[MT_CNI_CLASS_SHARED];
+      while (budget) {
+        rx = mt_rsq_burst(cni->rsq[i], RTE_MIN(budget, ST_CNI_RX_BURST_SIZE));
+        if (!rx) break;
+        budget -= rx;
+        done = false;
+        cni_ctrl_lane(impl, cni);
+      }
+      if (!budget) cni->stat_budget_out[MT_CNI_CLASS_SHARED]++;
     }
     /* trigger rss rx */
     if (cni->rss[i]) {
-      mt_rss_burst(cni->rss[i], ST_CNI_RX_BURST_SIZE);
+      budget = cni->budget[MT_CNI_CLASS_SHARED];
+      while (budget) {
+        rx = mt_rss_burst(cni->rss[i], RTE_MIN(budget, ST_CNI_RX_BURST_SIZE));
+        if (!rx) break;
+        budget -= rx;
+        done = false;
+        cni_ctrl_lane(impl, cni);
+      }
+      if (!budget) cni->stat_budget_out[MT_CNI_CLASS_SHARED]++;
     }
   }
 
@@ -129,8 +188,8 @@ static void* cni_traffic_thread(void* arg) {
 
   info("%s, start\n", __func__);
   while (rte_atomic32_read(&cni->stop_thread) == 0) {
-    cni_traffic(impl);
-    mt_sleep_ms(1);
+    /* no sleep if the budget is used out */
+    if (cni_traffic(impl) == MT_TASKLET_ALL_DONE) mt_sleep_ms(1);
   }
   info("%s, stop\n", __func__);
 
@@ -292,6 +351,18 @@ static int cni_stat(void* priv) {
   for (int i = 0; i < num_ports; i++) {
     notice("CNI(%d): eth_rx_cnt %d \n", i, cni->eth_rx_cnt[i]);
     cni->eth_rx_cnt[i] = 0;
+    if (cni->stat_ctrl_pkts[i]) {
+      notice("CNI(%d): ctrl pkts %u hw ts %u\n", i, cni->stat_ctrl_pkts[i],
+             cni->stat_ctrl_hw_ts[i]);
+      cni->stat_ctrl_pkts[i] = 0;
+      cni->stat_ctrl_hw_ts[i] = 0;
+    }
+  }
+  uint32_t* out = cni->stat_budget_out;
+  if (out[MT_CNI_CLASS_CTRL] || out[MT_CNI_CLASS_SYS] || out[MT_CNI_CLASS_SHARED]) {
+    notice("CNI: budget used out, ctrl %u sys %u shared %u\n", out[MT_CNI_CLASS_CTRL],
+           out[MT_CNI_CLASS_SYS], out[MT_CNI_CLASS_SHARED]);
+    memset(out, 0, sizeof(cni->stat_budget_out));
   }
 
   return 0;
@@ -307,6 +378,9 @@ int mt_cni_init(struct mtl_main_impl* impl) {
   if (!cni->used) return 0;
 
   cni->lcore_tasklet = (p->flags & MTL_FLAG_CNI_THREAD) ? false : true;
+  cni->budget[MT_CNI_CLASS_CTRL] = ST_CNI_CTRL_BUDGET;
+  cni->budget[MT_CNI_CLASS_SYS] = ST_CNI_SYS_BUDGET;
+  cni->budget[MT_CNI_CLASS_SHARED] = ST_CNI_SHARED_BUDGET;
   rte_atomic32_set(&cni->stop_thread, 0);
 
   ret = mt_kni_init(impl);
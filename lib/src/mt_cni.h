@@ -8,6 +8,10 @@
 #include "mt_main.h"
 
 #define ST_CNI_RX_BURST_SIZE (32)
+/* max pkts of each class in one cni round, see enum mt_cni_class */
+#define ST_CNI_CTRL_BUDGET (64)
+#define ST_CNI_SYS_BUDGET (ST_CNI_RX_BURST_SIZE * 2)
+#define ST_CNI_SHARED_BUDGET (ST_CNI_RX_BURST_SIZE * 4)
 
 int mt_cni_init(struct mtl_main_impl* impl);
 int mt_cni_uinit(struct mtl_main_impl* impl);
@@ -14,6 +14,7 @@
 #include "mt_socket.h"
 #include "mt_stat.h"
 #include "mt_util.h"
+#include "st2110/st_quota.h"
 
 static struct mt_rx_flow_rsp* dev_if_create_rx_flow(struct mt_interface* inf, uint16_t q,
                                                     struct mt_rx_flow* flow);
@@ -69,6 +70,18 @@ static const struct mt_dev_driver_info dev_drvs[] = {
         .drv_type = MT_DRV_ENA,
         .flow_type = MT_FLOW_NONE,
     },
+    {
+        .name = "net_ring",
+        .port_type = MT_PORT_LOOPBACK,
+        .drv_type = MT_DRV_RING,
+        .flow_type = MT_FLOW_NONE,
+    },
+    {
+        .name = "net_pcap",
+        .port_type = MT_PORT_PCAP,
+        .drv_type = MT_DRV_PCAP,
+        .flow_type = MT_FLOW_NONE,
+    },
 };
 
 static int parse_driver_info(const char* driver, enum mt_port_type* port,
@@ -216,13 +229,77 @@ static void* dev_stat_thread(void* arg) {
   return NULL;
 }
 
+static void dev_free_loopback(struct mtl_init_params* p,
+                              struct mt_kport_info* kport_info) {
+  int num_ports = RTE_MIN(p->num_ports, MTL_PORT_MAX);
+
+  for (int i = 0; i < num_ports; i++) {
+    if (kport_info->loopback_ring[i]) {
+      rte_ring_free(kport_info->loopback_ring[i]);
+      kport_info->loopback_ring[i] = NULL;
+    }
+  }
+}
+
+/*
+ * The loopback ports are crossed by rings, the tx of P is the rx of R and the tx of R
+ * is the rx of P. A single loopback port receive the pkts sent by itself.
+ */
+static int dev_create_loopback(struct mtl_init_params* p,
+                               struct mt_kport_info* kport_info) {
+  int num_ports = RTE_MIN(p->num_ports, MTL_PORT_MAX);
+  int lb_ports[MTL_PORT_MAX];
+  int nb_lb = 0;
+  char name[RTE_RING_NAMESIZE];
+  struct rte_ring* rx_ring;
+  struct rte_ring* tx_ring;
+  int i, peer, port_id;
+
+  for (i = 0; i < num_ports; i++) {
+    if (p->pmd[i] == MTL_PMD_DPDK_LOOPBACK) lb_ports[nb_lb++] = i;
+  }
+
+  for (int j = 0; j < nb_lb; j++) {
+    i = lb_ports[j];
+    snprintf(name, sizeof(name), "MT_LOOPBACK_P%d", i);
+    /* multi producer/consumer as the sys and session pkts may share the ring */
+    tx_ring = rte_ring_create(name, MT_DEV_LOOPBACK_RING_SIZE, rte_socket_id(), 0);
+    if (!tx_ring) {
+      err("%s(%d), ring %s create fail\n", __func__, i, name);
+      dev_free_loopback(p, kport_info);
+      return -ENOMEM;
+    }
+    kport_info->loopback_ring[i] = tx_ring;
+  }
+
+  for (int j = 0; j < nb_lb; j++) {
+    i = lb_ports[j];
+    peer = lb_ports[(j + 1) % nb_lb];
+    tx_ring = kport_info->loopback_ring[i];
+    rx_ring = kport_info->loopback_ring[peer];
+    snprintf(name, sizeof(name), "loopback%d", i);
+    port_id = rte_eth_from_rings(name, &rx_ring, 1, &tx_ring, 1, rte_socket_id());
+    if (port_id < 0) {
+      err("%s(%d), loopback port create fail %d\n", __func__, i, port_id);
+      dev_free_loopback(p, kport_info);
+      return port_id;
+    }
+    /* save port name */
+    rte_eth_dev_get_name_by_port(port_id, kport_info->port[i]);
+    info("%s(%d), %s, rx from the tx of port %d\n", __func__, i, kport_info->port[i],
+         peer);
+  }
+
+  return 0;
+}
+
 static int dev_eal_init(struct mtl_init_params* p, struct mt_kport_info* kport_info) {
   char* argv[MT_EAL_MAX_ARGS];
   int argc, ret;
   int num_ports = RTE_MIN(p->num_ports, MTL_PORT_MAX);
   static bool eal_initted = false; /* eal cann't re-enter in one process */
   bool has_afxdp = false;
-  char port_params[MTL_PORT_MAX][2 * MTL_PORT_MAX_LEN];
+  char port_params[MTL_PORT_MAX][MT_EAL_PORT_PARAM_LEN];
   char* port_param;
   int pci_ports = 0;
 
@@ -242,24 +319,54 @@ static int dev_eal_init(struct mtl_init_params* p, struct mt_kport_info* kport_i
   argc++;
 
   for (int i = 0; i < num_ports; i++) {
+    /* the loopback ports are created from rings after the eal init */
+    if (p->pmd[i] == MTL_PMD_DPDK_LOOPBACK) continue;
+
     if (p->pmd[i] == MTL_PMD_DPDK_AF_XDP) {
       argv[argc] = "--vdev";
       has_afxdp = true;
+    } else if (p->pmd[i] == MTL_PMD_DPDK_PCAP) {
+      argv[argc] = "--vdev";
     } else {
       argv[argc] = "-a";
       pci_ports++;
     }
     argc++;
     port_param = port_params[i];
-    memset(port_param, 0, 2 * MTL_PORT_MAX_LEN);
+    memset(port_param, 0, MT_EAL_PORT_PARAM_LEN);
     if (p->pmd[i] == MTL_PMD_DPDK_AF_XDP) {
-      snprintf(port_param, 2 * MTL_PORT_MAX_LEN,
-               "net_af_xdp%d,iface=%s,start_queue=%u,queue_count=%u", i, p->port[i],
-               p->xdp_info[i].start_queue, p->xdp_info[i].queue_count);
+      struct mtl_af_xdp_params* xdp = &p->xdp_info[i];
+      int len = snprintf(port_param, MT_EAL_PORT_PARAM_LEN,
+                         "net_af_xdp%d,iface=%s,start_queue=%u,queue_count=%u", i,
+                         p->port[i], xdp->start_queue, xdp->queue_count);
+      /* the queue sockets tuning, left to the pmd default if not set */
+      if (xdp->busy_poll_disable)
+        len += snprintf(port_param + len, MT_EAL_PORT_PARAM_LEN - len, ",busy_budget=0");
+      else if (xdp->busy_budget)
+        len += snprintf(port_param + len, MT_EAL_PORT_PARAM_LEN - len,
+                        ",busy_budget=%u", xdp->busy_budget);
+      if (xdp->shared_umem)
+        len += snprintf(port_param + len, MT_EAL_PORT_PARAM_LEN - len, ",shared_umem=1");
+      if (xdp->force_copy)
+        len += snprintf(port_param + len, MT_EAL_PORT_PARAM_LEN - len, ",force_copy=1");
+      if (xdp->xdp_prog[0])
+        snprintf(port_param + len, MT_EAL_PORT_PARAM_LEN - len, ",xdp_prog=%s",
+                 xdp->xdp_prog);
       /* save port name */
       snprintf(kport_info->port[i], MTL_PORT_MAX_LEN, "net_af_xdp%d", i);
+    } else if (p->pmd[i] == MTL_PMD_DPDK_PCAP) {
+      struct mtl_pcap_params* pcap = &p->pcap_info[i];
+      int len = snprintf(port_param, MT_EAL_PORT_PARAM_LEN, "net_pcap%d", i);
+      /* net_pcap use a dummy rx without rx_pcap and drop the tx without tx_pcap */
+      if (pcap->rx_file[0])
+        len += snprintf(port_param + len, MT_EAL_PORT_PARAM_LEN - len, ",rx_pcap=%s",
+                        pcap->rx_file);
+      if (pcap->tx_file[0])
+        snprintf(port_param + len, MT_EAL_PORT_PARAM_LEN - len, ",tx_pcap=%s",
+                 pcap->tx_file);
+      snprintf(kport_info->port[i], MTL_PORT_MAX_LEN, "net_pcap%d", i);
     } else {
-      snprintf(port_param, 2 * MTL_PORT_MAX_LEN, "%s", p->port[i]);
+      snprintf(port_param, MT_EAL_PORT_PARAM_LEN, "%s", p->port[i]);
     }
     info("%s(%d), port_param: %s\n", __func__, i, port_param);
     argv[argc] = port_param;
@@ -336,7 +443,7 @@ static int dev_eal_init(struct mtl_init_params* p, struct mt_kport_info* kport_i
   if (ret < 0) return ret;
   eal_initted = true;
 
-  return 0;
+  return dev_create_loopback(p, kport_info);
 }
 
 int dev_rx_runtime_queue_start(struct mtl_main_impl* impl, enum mtl_port port) {
@@ -375,8 +482,15 @@ static int dev_flush_rx_queue(struct mt_interface* inf, struct mt_rx_queue* queu
 #define ST_ROOT_NODE_ID 256
 #define ST_DEFAULT_NODE_ID 246
 #define ST_DEFAULT_RL_BPS (1024 * 1024 * 1024 / 8) /* 1g bit per second */
+/* shaper rate granularity, sessions with near rates share one profile */
+#define ST_RL_BPS_GRANULARITY (1000 * 1000 / 8) /* 1m bit per second */
 
-static int dev_rl_init_root(struct mt_interface* inf, uint32_t shaper_profile_id) {
+static inline uint64_t dev_rl_bps_round(uint64_t bps) {
+  return (bps + ST_RL_BPS_GRANULARITY - 1) / ST_RL_BPS_GRANULARITY *
+         ST_RL_BPS_GRANULARITY;
+}
+
+static int dev_rl_init_root(struct mt_interface* inf, struct mt_rl_shaper* shaper) {
   uint16_t port_id = inf->port_id;
   enum mtl_port port = inf->port;
   int ret;
@@ -389,7 +503,7 @@ static int dev_rl_init_root(struct mt_interface* inf, uint32_t shaper_profile_id
   memset(&np, 0, sizeof(np));
 
   /* root node */
-  np.shaper_profile_id = shaper_profile_id;
+  np.shaper_profile_id = shaper->shaper_profile_id;
   np.nonleaf.n_sp_priorities = 1;
   ret = rte_tm_node_add(port_id, ST_ROOT_NODE_ID, -1, 0, 1, 0, &np, &error);
   if (ret < 0) {
@@ -404,9 +518,12 @@ static int dev_rl_init_root(struct mt_interface* inf, uint32_t shaper_profile_id
   if (ret < 0) {
     err("%s(%d), node add error: (%d)%s\n", __func__, port, ret,
         mt_msg_safe(error.message));
+    rte_tm_node_delete(port_id, ST_ROOT_NODE_ID, &error);
     return ret;
   }
 
+  /* the root keeps the profile in use for the port lifetime */
+  shaper->ref_cnt++;
   inf->tx_rl_root_active = true;
   return 0;
 }
@@ -437,18 +554,21 @@ static struct mt_rl_shaper* dev_rl_shaper_add(struct mt_interface* inf, uint64_t
       return NULL;
     }
 
-    ret = dev_rl_init_root(inf, shaper_profile_id);
+    shapers[i].rl_bps = bps;
+    shapers[i].shaper_profile_id = shaper_profile_id;
+    shapers[i].idx = i;
+    shapers[i].ref_cnt = 0;
+
+    ret = dev_rl_init_root(inf, &shapers[i]);
     if (ret < 0) {
       err("%s(%d), root init error %d\n", __func__, port, ret);
       rte_tm_shaper_profile_delete(port_id, shaper_profile_id, &error);
+      shapers[i].rl_bps = 0;
       return NULL;
     }
 
     info("%s(%d), bps %" PRIu64 " on shaper %d\n", __func__, port, bps,
          shaper_profile_id);
-    shapers[i].rl_bps = bps;
-    shapers[i].shaper_profile_id = shaper_profile_id;
-    shapers[i].idx = i;
     return &shapers[i];
   }
 
@@ -456,14 +576,52 @@ static struct mt_rl_shaper* dev_rl_shaper_add(struct mt_interface* inf, uint64_t
   return NULL;
 }
 
+/* get a ref to the shaper profile of bps, create one if no match */
 static struct mt_rl_shaper* dev_rl_shaper_get(struct mt_interface* inf, uint64_t bps) {
   struct mt_rl_shaper* shapers = &inf->tx_rl_shapers[0];
+  struct mt_rl_shaper* shaper = NULL;
 
+  bps = dev_rl_bps_round(bps);
   for (int i = 0; i < MT_MAX_RL_ITEMS; i++) {
-    if (bps == shapers[i].rl_bps) return &shapers[i];
+    if (bps == shapers[i].rl_bps) {
+      shaper = &shapers[i];
+      break;
+    }
   }
 
-  return dev_rl_shaper_add(inf, bps);
+  if (!shaper) shaper = dev_rl_shaper_add(inf, bps);
+  if (shaper) shaper->ref_cnt++;
+  return shaper;
+}
+
+/* put the ref, the profile is deleted once no node linked to it */
+static int dev_rl_shaper_put(struct mt_interface* inf, struct mt_rl_shaper* shaper) {
+  uint16_t port_id = inf->port_id;
+  enum mtl_port port = inf->port;
+  struct rte_tm_error error;
+  int ret;
+
+  if (!shaper->ref_cnt) {
+    err("%s(%d), shaper %d not in use\n", __func__, port, shaper->shaper_profile_id);
+    return -EIO;
+  }
+
+  shaper->ref_cnt--;
+  if (shaper->ref_cnt) return 0;
+
+  memset(&error, 0, sizeof(error));
+  ret = rte_tm_shaper_profile_delete(port_id, shaper->shaper_profile_id, &error);
+  if (ret < 0) {
+    /* keep the slot reserved, the profile id is still known by the pmd */
+    warn("%s(%d), shaper %d delete fail %d(%s)\n", __func__, port,
+         shaper->shaper_profile_id, ret, mt_msg_safe(error.message));
+    return ret;
+  }
+
+  info("%s(%d), shaper %d(%" PRIu64 ") released\n", __func__, port,
+       shaper->shaper_profile_id, shaper->rl_bps);
+  shaper->rl_bps = 0;
+  return 0;
 }
 
 static int dev_init_ratelimit_vf(struct mt_interface* inf) {
@@ -494,6 +652,7 @@ static int dev_init_ratelimit_vf(struct mt_interface* inf) {
     if (ret < 0) {
       err("%s(%d), q %d add fail %d(%s)\n", __func__, port, q, ret,
           mt_msg_safe(error.message));
+      dev_rl_shaper_put(inf, shaper);
       return ret;
     }
     tx_queue->rl_shapers_mapping = shaper->idx;
@@ -510,11 +669,38 @@ static int dev_init_ratelimit_vf(struct mt_interface* inf) {
   return ret;
 }
 
+/* hitless switch of the running node to the new profile, no re-commit */
+static int dev_tx_queue_update_rl_shaper(struct mt_interface* inf, uint16_t queue,
+                                         struct mt_rl_shaper* shaper,
+                                         struct mt_rl_shaper* old_shaper, uint64_t bps) {
+  struct mt_tx_queue* tx_queue = &inf->tx_queues[queue];
+  struct rte_tm_error error;
+  int ret;
+
+  memset(&error, 0, sizeof(error));
+  ret = rte_tm_node_shaper_update(inf->port_id, queue, shaper->shaper_profile_id, &error);
+  if (ret < 0) {
+    dbg("%s(%d), q %d shaper update fail %d(%s)\n", __func__, inf->port, queue, ret,
+        mt_msg_safe(error.message));
+    return ret;
+  }
+
+  tx_queue->rl_shapers_mapping = shaper->idx;
+  dev_rl_shaper_put(inf, old_shaper);
+  tx_queue->bps = bps;
+  info("%s(%d), q %d update to shaper id %d(%" PRIu64 ")\n", __func__, inf->port, queue,
+       shaper->shaper_profile_id, shaper->rl_bps);
+  return 0;
+}
+
+/* caller should hold tx_queues_mutex if the port is already running */
 static int dev_tx_queue_set_rl_rate(struct mt_interface* inf, uint16_t queue,
                                     uint64_t bytes_per_sec) {
   uint16_t port_id = inf->port_id;
   enum mtl_port port = inf->port;
   struct mt_tx_queue* tx_queue = &inf->tx_queues[queue];
+  struct mt_rl_shaper* shapers = &inf->tx_rl_shapers[0];
+  struct mt_rl_shaper* old_shaper = NULL;
   uint64_t bps = bytes_per_sec;
   int ret;
   struct rte_tm_error error;
@@ -527,40 +713,51 @@ static int dev_tx_queue_set_rl_rate(struct mt_interface* inf, uint16_t queue,
     bps = ST_DEFAULT_RL_BPS;
   }
 
-  /* not changed */
-  if (bps == tx_queue->bps) return 0;
-
-  /* delete old queue node */
   if (tx_queue->rl_shapers_mapping >= 0) {
+    old_shaper = &shapers[tx_queue->rl_shapers_mapping];
+    /* not changed, or the same shaper bucket */
+    if (dev_rl_bps_round(bps) == old_shaper->rl_bps) {
+      tx_queue->bps = bps;
+      return 0;
+    }
+  }
+
+  shaper = dev_rl_shaper_get(inf, bps);
+  if (!shaper) {
+    err("%s(%d), rl shaper get fail for q %d\n", __func__, port, queue);
+    return -EIO;
+  }
+
+  if (old_shaper) {
+    if (dev_tx_queue_update_rl_shaper(inf, queue, shaper, old_shaper, bps) >= 0)
+      return 0;
+
+    /* re-link the node to the new profile */
     ret = rte_tm_node_delete(port_id, queue, &error);
     if (ret < 0) {
       err("%s(%d), node %d delete fail %d(%s)\n", __func__, port, queue, ret,
           mt_msg_safe(error.message));
+      dev_rl_shaper_put(inf, shaper);
       return ret;
     }
     tx_queue->rl_shapers_mapping = -1;
+    dev_rl_shaper_put(inf, old_shaper);
   }
 
-  if (bps) {
-    shaper = dev_rl_shaper_get(inf, bps);
-    if (!shaper) {
-      err("%s(%d), rl shaper get fail for q %d\n", __func__, port, queue);
-      return -EIO;
-    }
-    memset(&qp, 0, sizeof(qp));
-    qp.shaper_profile_id = shaper->shaper_profile_id;
-    qp.leaf.cman = RTE_TM_CMAN_TAIL_DROP;
-    qp.leaf.wred.wred_profile_id = RTE_TM_WRED_PROFILE_ID_NONE;
-    ret = rte_tm_node_add(port_id, queue, ST_DEFAULT_NODE_ID, 0, 1, 2, &qp, &error);
-    if (ret < 0) {
-      err("%s(%d), q %d add fail %d(%s)\n", __func__, port, queue, ret,
-          mt_msg_safe(error.message));
-      return ret;
-    }
-    tx_queue->rl_shapers_mapping = shaper->idx;
-    info("%s(%d), q %d link to shaper id %d(%" PRIu64 ")\n", __func__, port, queue,
-         shaper->shaper_profile_id, shaper->rl_bps);
+  memset(&qp, 0, sizeof(qp));
+  qp.shaper_profile_id = shaper->shaper_profile_id;
+  qp.leaf.cman = RTE_TM_CMAN_TAIL_DROP;
+  qp.leaf.wred.wred_profile_id = RTE_TM_WRED_PROFILE_ID_NONE;
+  ret = rte_tm_node_add(port_id, queue, ST_DEFAULT_NODE_ID, 0, 1, 2, &qp, &error);
+  if (ret < 0) {
+    err("%s(%d), q %d add fail %d(%s)\n", __func__, port, queue, ret,
+        mt_msg_safe(error.message));
+    dev_rl_shaper_put(inf, shaper);
+    return ret;
   }
+  tx_queue->rl_shapers_mapping = shaper->idx;
+  info("%s(%d), q %d link to shaper id %d(%" PRIu64 ")\n", __func__, port, queue,
+       shaper->shaper_profile_id, shaper->rl_bps);
 
   mt_pthread_mutex_lock(&inf->vf_cmd_mutex);
   ret = rte_tm_hierarchy_commit(port_id, 1, &error);
@@ -575,6 +772,37 @@ static int dev_tx_queue_set_rl_rate(struct mt_interface* inf, uint16_t queue,
   return 0;
 }
 
+/*
+ * move an idle queue back to the default rate only if the pmd can do it hitless, else
+ * keep the node linked to the old profile, the next get re-link it with the new rate.
+ */
+static int dev_tx_queue_reset_rl_rate(struct mt_interface* inf, uint16_t queue) {
+  struct mt_tx_queue* tx_queue = &inf->tx_queues[queue];
+  struct mt_rl_shaper* shapers = &inf->tx_rl_shapers[0];
+  struct mt_rl_shaper* old_shaper;
+  struct mt_rl_shaper* shaper = NULL;
+  uint64_t bps = dev_rl_bps_round(ST_DEFAULT_RL_BPS);
+  int ret;
+
+  if (tx_queue->rl_shapers_mapping < 0) return 0;
+  old_shaper = &shapers[tx_queue->rl_shapers_mapping];
+  if (bps == old_shaper->rl_bps) return 0;
+
+  /* only the existing default profile, no profile add on a running port */
+  for (int i = 0; i < MT_MAX_RL_ITEMS; i++) {
+    if (bps == shapers[i].rl_bps) {
+      shaper = &shapers[i];
+      break;
+    }
+  }
+  if (!shaper) return -ENOENT;
+
+  shaper->ref_cnt++;
+  ret = dev_tx_queue_update_rl_shaper(inf, queue, shaper, old_shaper, ST_DEFAULT_RL_BPS);
+  if (ret < 0) dev_rl_shaper_put(inf, shaper);
+  return ret;
+}
+
 static struct rte_flow* dev_rx_queue_create_flow_raw(struct mt_interface* inf, uint16_t q,
                                                      struct mt_rx_flow* flow) {
   struct rte_flow_error error;
@@ -1248,7 +1476,7 @@ static int dev_filelock_unlock(struct mtl_main_impl* impl) {
   return 0;
 }
 
-int mt_dev_get_lcore(struct mtl_main_impl* impl, unsigned int* lcore) {
+int mt_dev_get_lcore(struct mtl_main_impl* impl, int socket, unsigned int* lcore) {
   unsigned int cur_lcore = 0;
   int ret;
   struct mt_lcore_shm* lcore_shm = impl->lcore_shm;
@@ -1262,8 +1490,8 @@ int mt_dev_get_lcore(struct mtl_main_impl* impl, unsigned int* lcore) {
   do {
     cur_lcore = rte_get_next_lcore(cur_lcore, 1, 0);
 
-    if ((cur_lcore < RTE_MAX_LCORE) && mt_socket_match(rte_lcore_to_socket_id(cur_lcore),
-                                                       mt_socket_id(impl, MTL_PORT_P))) {
+    if ((cur_lcore < RTE_MAX_LCORE) &&
+        mt_socket_match(rte_lcore_to_socket_id(cur_lcore), socket)) {
       if (!lcore_shm->lcores_active[cur_lcore]) {
         *lcore = cur_lcore;
         lcore_shm->lcores_active[cur_lcore] = true;
@@ -1271,7 +1499,7 @@ int mt_dev_get_lcore(struct mtl_main_impl* impl, unsigned int* lcore) {
         rte_atomic32_inc(&impl->lcore_cnt);
         impl->local_lcores_active[cur_lcore] = true;
         ret = dev_filelock_unlock(impl);
-        info("%s, available lcore %d\n", __func__, cur_lcore);
+        info("%s, available lcore %d on socket %d\n", __func__, cur_lcore, socket);
         if (ret < 0) {
           err("%s, dev_filelock_unlock fail\n", __func__);
           return ret;
@@ -1282,7 +1510,7 @@ int mt_dev_get_lcore(struct mtl_main_impl* impl, unsigned int* lcore) {
   } while (cur_lcore < RTE_MAX_LCORE);
 
   dev_filelock_unlock(impl);
-  err("%s, fail to find lcore\n", __func__);
+  err("%s, fail to find lcore on socket %d\n", __func__, socket);
   return -EIO;
 }
 
@@ -1458,6 +1686,76 @@ err_unlock:
   return ret;
 }
 
+static int dev_if_uinit_pcap_replay(struct mt_interface* inf) {
+  struct mt_pcap_replay* replay = inf->pcap_replay;
+
+  if (!replay) return 0;
+
+  /* free the pkts not due yet */
+  if (replay->idx < replay->nb_pkts)
+    rte_pktmbuf_free_bulk(&replay->pkts[replay->idx], replay->nb_pkts - replay->idx);
+  mt_rte_free(replay);
+  inf->pcap_replay = NULL;
+
+  return 0;
+}
+
+static int dev_if_init_pcap_replay(struct mt_interface* inf) {
+  struct mt_pcap_replay* replay;
+
+  /* net_pcap carry the timestamp of the file in the rx timestamp dynfield */
+  if (!(inf->feature & MT_IF_FEATURE_RX_OFFLOAD_TIMESTAMP)) {
+    warn("%s(%d), no rx timestamp on the pcap port, replay at max speed\n", __func__,
+         inf->port);
+    return 0;
+  }
+
+  replay = mt_rte_zmalloc_socket(sizeof(*replay), inf->socket_id);
+  if (!replay) {
+    err("%s(%d), replay malloc fail\n", __func__, inf->port);
+    return -ENOMEM;
+  }
+  inf->pcap_replay = replay;
+
+  info("%s(%d), replay at the original timestamps\n", __func__, inf->port);
+  return 0;
+}
+
+uint16_t mt_dev_pcap_replay_burst(struct mt_interface* inf, uint16_t q,
+                                  struct rte_mbuf** rx_pkts, uint16_t nb_pkts) {
+  struct mt_pcap_replay* replay = inf->pcap_replay;
+  struct mtl_main_impl* impl = inf->parent;
+  struct rte_mbuf* pkt;
+  uint64_t now, pkt_ns;
+  uint16_t rx = 0;
+
+  if (replay->idx >= replay->nb_pkts) {
+    replay->nb_pkts =
+        rte_eth_rx_burst(inf->port_id, q, replay->pkts, MT_PCAP_REPLAY_BURST);
+    replay->idx = 0;
+    if (!replay->nb_pkts) return 0;
+  }
+
+  now = mt_get_tsc(impl);
+  while ((replay->idx < replay->nb_pkts) && (rx < nb_pkts)) {
+    pkt = replay->pkts[replay->idx];
+    pkt_ns = *RTE_MBUF_DYNFIELD(pkt, impl->dynfield_offset, rte_mbuf_timestamp_t*);
+    if (!replay->base_tsc) {
+      /* the first pkt anchor the time of the file to the tsc */
+      replay->base_pkt_ns = pkt_ns;
+      replay->base_tsc = now;
+    }
+    /* hold the pkt until the same distance to the first pkt as in the file */
+    if ((pkt_ns > replay->base_pkt_ns) &&
+        (pkt_ns - replay->base_pkt_ns > now - replay->base_tsc))
+      break;
+    rx_pkts[rx++] = pkt;
+    replay->idx++;
+  }
+
+  return rx;
+}
+
 static int dev_if_uinit_rx_queues(struct mt_interface* inf) {
   enum mtl_port port = inf->port;
   struct mt_rx_queue* rx_queue;
@@ -1602,6 +1900,16 @@ static int dev_if_init_pacing(struct mt_interface* inf) {
   enum mtl_port port = inf->port;
   int ret;
 
+  if ((inf->drv_type == MT_DRV_RING) || (inf->drv_type == MT_DRV_PCAP)) {
+    /* no rl on the virtual port, the shaping is emulated by the tsc pacing */
+    if (ST21_TX_PACING_WAY_RL == inf->tx_pacing_way)
+      warn("%s(%d), rl not support on virtual port, use tsc\n", __func__, port);
+    if ((ST21_TX_PACING_WAY_AUTO == inf->tx_pacing_way) ||
+        (ST21_TX_PACING_WAY_RL == inf->tx_pacing_way))
+      inf->tx_pacing_way = ST21_TX_PACING_WAY_TSC;
+    return 0;
+  }
+
   if ((ST21_TX_PACING_WAY_AUTO == inf->tx_pacing_way) ||
       (ST21_TX_PACING_WAY_RL == inf->tx_pacing_way)) {
     /* VF require all q config with RL */
@@ -1651,6 +1959,9 @@ static struct mt_rx_flow_rsp* dev_if_create_rx_flow(struct mt_interface* inf, ui
       return NULL;
     }
     rsp->flow_id = ret;
+  } else if (mt_pmd_is_virtual(impl, port)) {
+    /* no hw flow, the rsq steer the pkts by the udp port */
+    dbg("%s(%d), skip flow for virtual queue %d\n", __func__, port, q);
   } else {
     struct rte_flow* r_flow;
 
@@ -1748,7 +2059,9 @@ int mt_dev_set_tx_bps(struct mtl_main_impl* impl, enum mtl_port port, uint16_t q
   }
 
   if (inf->tx_pacing_way == ST21_TX_PACING_WAY_RL) {
+    mt_pthread_mutex_lock(&inf->tx_queues_mutex);
     dev_tx_queue_set_rl_rate(inf, q, bytes_per_sec);
+    mt_pthread_mutex_unlock(&inf->tx_queues_mutex);
   }
 
   return 0;
@@ -1946,7 +2259,15 @@ int mt_dev_put_tx_queue(struct mtl_main_impl* impl, struct mt_tx_queue* queue) {
     return -EIO;
   }
 
+  mt_pthread_mutex_lock(&inf->tx_queues_mutex);
+  /* back to the default rate to release the shaper ref, no hierarchy re-commit here */
+  if (inf->tx_pacing_way == ST21_TX_PACING_WAY_RL) {
+    int ret = dev_tx_queue_reset_rl_rate(inf, queue_id);
+    if (ret < 0)
+      dbg("%s(%d), q %d keep the rl shaper, %d\n", __func__, port, queue_id, ret);
+  }
   tx_queue->active = false;
+  mt_pthread_mutex_unlock(&inf->tx_queues_mutex);
   info("%s(%d), q %d\n", __func__, port, queue_id);
   return 0;
 }
@@ -2079,6 +2400,14 @@ int mt_dev_create(struct mtl_main_impl* impl) {
     /* default: max ST_QUOTA_TX1080P_PER_SCH sessions 1080p@60fps for tx */
     data_quota_mbs_per_sch =
         ST_QUOTA_TX1080P_PER_SCH * st20_1080p59_yuv422_10bit_bandwidth_mps();
+    if (mt_has_sch_quota_auto(impl)) {
+      ret = st_quota_calibrate(impl, &data_quota_mbs_per_sch);
+      if (ret < 0) {
+        warn("%s, quota calibrate fail %d, use the default quota\n", __func__, ret);
+        data_quota_mbs_per_sch =
+            ST_QUOTA_TX1080P_PER_SCH * st20_1080p59_yuv422_10bit_bandwidth_mps();
+      }
+    }
   }
   ret = mt_sch_mrg_init(impl, data_quota_mbs_per_sch);
   if (ret < 0) {
@@ -2087,7 +2416,8 @@ int mt_dev_create(struct mtl_main_impl* impl) {
   }
 
   /* create system sch */
-  impl->main_sch = mt_sch_get(impl, 0, MT_SCH_TYPE_DEFAULT, MT_SCH_MASK_ALL);
+  impl->main_sch = mt_sch_get(impl, 0, MT_SCH_TYPE_DEFAULT, MT_SCH_MASK_ALL,
+                              mt_socket_id(impl, MTL_PORT_P));
   if (ret < 0) {
     err("%s, get sch fail\n", __func__);
     goto err_exit;
@@ -2214,7 +2544,15 @@ int dev_arp_mac(struct mtl_main_impl* impl, uint8_t dip[MTL_IP_ADDR_LEN],
 
   dbg("%s(%d), start to get mac for ip %d.%d.%d.%d\n", __func__, port, dip[0], dip[1],
       dip[2], dip[3]);
-  if (mt_pmd_is_kernel(impl, port)) {
+  if (mt_pmd_is_virtual(impl, port)) {
+    /* no peer to answer, use the mac of the loopback port owning the ip if any */
+    uint32_t ip = mt_ip_to_u32(dip);
+    for (int i = 0; i < mt_num_ports(impl); i++) {
+      if (mt_pmd_is_loopback(impl, i) && (ip == mt_ip_to_u32(mt_sip_addr(impl, i))))
+        return rte_eth_macaddr_get(mt_port_id(impl, i), ea);
+    }
+    return rte_eth_macaddr_get(mt_port_id(impl, port), ea);
+  } else if (mt_pmd_is_kernel(impl, port)) {
     ret = mt_socket_get_mac(impl, mt_get_user_params(impl)->port[port], dip, ea,
                             timeout_ms);
     if (ret < 0) {
@@ -2259,6 +2597,26 @@ int mt_dev_dst_ip_mac(struct mtl_main_impl* impl, uint8_t dip[MTL_IP_ADDR_LEN],
   return ret;
 }
 
+int mt_dev_dst_ip_queue(struct mtl_main_impl* impl, uint8_t dip[MTL_IP_ADDR_LEN],
+                        enum mtl_port port, struct rte_mbuf** pkts, uint16_t nb_pkts) {
+  uint8_t* next_hop = dip;
+
+  /* the kernel resolve the neighbor itself */
+  if (mt_pmd_is_kernel(impl, port)) return -ENOTSUP;
+  if (mt_is_multicast_ip(dip)) return -EINVAL;
+
+  if (!mt_is_lan_ip(dip, mt_sip_addr(impl, port), mt_sip_netmask(impl, port))) {
+    next_hop = mt_sip_gateway(impl, port);
+    if (!mt_ip_to_u32(next_hop)) {
+      err("%s(%d), ip %d.%d.%d.%d is wan but no gateway support\n", __func__, port,
+          dip[0], dip[1], dip[2], dip[3]);
+      return -EIO;
+    }
+  }
+
+  return mt_arp_cni_queue(impl, port, mt_ip_to_u32(next_hop), pkts, nb_pkts);
+}
+
 int mt_dev_if_uinit(struct mtl_main_impl* impl) {
   int num_ports = mt_num_ports(impl), ret;
   struct mt_interface* inf;
@@ -2271,6 +2629,7 @@ int mt_dev_if_uinit(struct mtl_main_impl* impl) {
       inf->pad = NULL;
     }
 
+    dev_if_uinit_pcap_replay(inf);
     dev_if_uinit_tx_queues(inf);
     dev_if_uinit_rx_queues(inf);
 
@@ -2296,6 +2655,8 @@ int mt_dev_if_uinit(struct mtl_main_impl* impl) {
 
     dev_close_port(inf);
   }
+  /* the rings are freed after all the loopback ports are closed */
+  dev_free_loopback(mt_get_user_params(impl), &impl->kport_info);
 
   return 0;
 }
@@ -2313,7 +2674,7 @@ int mt_dev_if_init(struct mtl_main_impl* impl) {
     inf = mt_if(impl, i);
     dev_info = &inf->dev_info;
 
-    if (mt_pmd_is_kernel(impl, i))
+    if (p->pmd[i] != MTL_PMD_DPDK_USER)
       port = impl->kport_info.port[i];
     else
       port = p->port[i];
@@ -2358,8 +2719,14 @@ int mt_dev_if_init(struct mtl_main_impl* impl) {
     }
 
     inf->rss_mode = p->rss_mode;
-    /* enable rss if no flow support */
-    if (inf->flow_type == MT_FLOW_NONE && inf->rss_mode == MTL_RSS_MODE_NONE) {
+    if (mt_pmd_is_virtual(impl, i)) {
+      /* no rss on virtual port, the flows are steered by the shared rx queue */
+      if (inf->rss_mode != MTL_RSS_MODE_NONE)
+        warn("%s(%d), rss mode %d ignored for virtual port\n", __func__, i,
+             inf->rss_mode);
+      inf->rss_mode = MTL_RSS_MODE_NONE;
+    } else if (inf->flow_type == MT_FLOW_NONE && inf->rss_mode == MTL_RSS_MODE_NONE) {
+      /* enable rss if no flow support */
       if (inf->drv_type == MT_DRV_ENA)
         inf->rss_mode = MTL_RSS_MODE_L3_L4; /* only rss l3 and l4 support */
       else
@@ -2372,6 +2739,11 @@ int mt_dev_if_init(struct mtl_main_impl* impl) {
       inf->max_tx_queues = p->xdp_info[i].queue_count;
       inf->max_rx_queues = inf->max_tx_queues;
       inf->system_rx_queues_end = 0;
+    } else if (mt_pmd_is_virtual(impl, i)) {
+      /* loopback: the pkts sent on queue n come back on queue n, pcap: one file */
+      inf->max_tx_queues = 1;
+      inf->max_rx_queues = 1;
+      inf->system_rx_queues_end = 0;
     } else {
       if (mt_udp_transport(impl, i)) {
         inf->max_tx_queues = impl->user_tx_queues_cnt;
@@ -2424,6 +2796,11 @@ int mt_dev_if_init(struct mtl_main_impl* impl) {
     if (dev_info->tx_offload_capa & DEV_TX_OFFLOAD_MULTI_SEGS)
       inf->feature |= MT_IF_FEATURE_TX_MULTI_SEGS;
 #endif
+    /*
+     * no nic to gather the segments on virtual port, the chained pkts reach the rx
+     * as is and the rx path expect single segment pkts, so tx copy mode is used.
+     */
+    if (mt_pmd_is_virtual(impl, i)) inf->feature &= ~MT_IF_FEATURE_TX_MULTI_SEGS;
 
 #if RTE_VERSION >= RTE_VERSION_NUM(22, 3, 0, 0)
     if (dev_info->tx_offload_capa & RTE_ETH_TX_OFFLOAD_IPV4_CKSUM)
@@ -2433,7 +2810,8 @@ int mt_dev_if_init(struct mtl_main_impl* impl) {
       inf->feature |= MT_IF_FEATURE_TX_OFFLOAD_IPV4_CKSUM;
 #endif
 
-    if (mt_has_ebu(impl) &&
+    if ((mt_has_ebu(impl) || mt_has_cni_rx_timestamp(impl) ||
+         (mt_pmd_is_pcap(impl, i) && p->pcap_info[i].rx_realtime)) &&
 #if RTE_VERSION >= RTE_VERSION_NUM(22, 3, 0, 0)
         (dev_info->rx_offload_capa & RTE_ETH_RX_OFFLOAD_TIMESTAMP)
 #else
@@ -2441,7 +2819,8 @@ int mt_dev_if_init(struct mtl_main_impl* impl) {
 #endif
     ) {
       if (!impl->dynfield_offset) {
-        ret = rte_mbuf_dyn_rx_timestamp_register(&impl->dynfield_offset, NULL);
+        ret = rte_mbuf_dyn_rx_timestamp_register(&impl->dynfield_offset,
+                                                 &impl->dynflag_rx_timestamp);
         if (ret < 0) {
           err("%s, rte_mbuf_dyn_rx_timestamp_register fail\n", __func__);
           return ret;
@@ -2516,6 +2895,14 @@ int mt_dev_if_init(struct mtl_main_impl* impl) {
       return -ENOMEM;
     }
 
+    if (mt_pmd_is_pcap(impl, i) && p->pcap_info[i].rx_realtime) {
+      ret = dev_if_init_pcap_replay(inf);
+      if (ret < 0) {
+        mt_dev_if_uinit(impl);
+        return ret;
+      }
+    }
+
     info("%s(%d), port_id %d port_type %d drv_type %d\n", __func__, i, port_id,
          inf->port_type, inf->drv_type);
     info("%s(%d), dev_capa 0x%" PRIx64 ", offload 0x%" PRIx64 ":0x%" PRIx64
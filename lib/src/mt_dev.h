@@ -19,6 +19,10 @@
 #define MT_DEV_TIMEOUT_ZERO (0)
 
 #define MT_EAL_MAX_ARGS (32)
+/* the vdev args of a pcap port carry two file paths */
+#define MT_EAL_PORT_PARAM_LEN (2 * MTL_PORT_MAX_LEN + 2 * MTL_PCAP_PATH_MAX_LEN)
+/* the ring size between two loopback ports */
+#define MT_DEV_LOOPBACK_RING_SIZE (4096)
 
 int mt_dev_get_socket(const char* port);
 
@@ -33,6 +37,12 @@ int mt_dev_stop(struct mtl_main_impl* impl);
 
 int mt_dev_dst_ip_mac(struct mtl_main_impl* impl, uint8_t dip[MTL_IP_ADDR_LEN],
                       struct rte_ether_addr* ea, enum mtl_port port, int timeout_ms);
+/*
+ * queue the pkts until the mac of dip resolved, the d_addr is filled and send on the
+ * sys tx queue then. Return the number of accepted pkts, the caller free the rest.
+ */
+int mt_dev_dst_ip_queue(struct mtl_main_impl* impl, uint8_t dip[MTL_IP_ADDR_LEN],
+                        enum mtl_port port, struct rte_mbuf** pkts, uint16_t nb_pkts);
 
 struct mt_tx_queue* mt_dev_get_tx_queue(struct mtl_main_impl* impl, enum mtl_port port,
                                         uint64_t bytes_per_sec);
@@ -68,13 +78,24 @@ static inline uint16_t mt_dev_rx_burst(struct mt_rx_queue* queue,
   return rte_eth_rx_burst(queue->port_id, queue->queue_id, rx_pkts, nb_pkts);
 }
 
+/* rx on a pcap port which replay at the original timestamps of the file */
+uint16_t mt_dev_pcap_replay_burst(struct mt_interface* inf, uint16_t q,
+                                  struct rte_mbuf** rx_pkts, uint16_t nb_pkts);
+static inline uint16_t mt_dev_rx_port_burst(struct mt_interface* inf, uint16_t q,
+                                            struct rte_mbuf** rx_pkts,
+                                            const uint16_t nb_pkts) {
+  if (inf->pcap_replay) return mt_dev_pcap_replay_burst(inf, q, rx_pkts, nb_pkts);
+  return rte_eth_rx_burst(inf->port_id, q, rx_pkts, nb_pkts);
+}
+
 int mt_dev_if_init(struct mtl_main_impl* impl);
 int mt_dev_if_uinit(struct mtl_main_impl* impl);
 int mt_dev_if_post_init(struct mtl_main_impl* impl);
 int mt_dev_if_pre_uinit(struct mtl_main_impl* impl);
 
 int mt_dev_put_lcore(struct mtl_main_impl* impl, unsigned int lcore);
-int mt_dev_get_lcore(struct mtl_main_impl* impl, unsigned int* lcore);
+/* get one free lcore on the numa socket */
+int mt_dev_get_lcore(struct mtl_main_impl* impl, int socket, unsigned int* lcore);
 bool mt_dev_lcore_valid(struct mtl_main_impl* impl, unsigned int lcore);
 
 int mt_dev_tsc_done_action(struct mtl_main_impl* impl);
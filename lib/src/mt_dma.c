@@ -7,125 +7,6 @@
 #include "mt_log.h"
 #include "mt_stat.h"
 
-static inline struct mt_map_mgr* mt_get_map_mgr(struct mtl_main_impl* impl) {
-  return &impl->map_mgr;
-}
-
-int mt_map_add(struct mtl_main_impl* impl, struct mt_map_item* item) {
-  struct mt_map_mgr* mgr = mt_get_map_mgr(impl);
-  void* start = item->vaddr;
-  void* end = start + item->size;
-  struct mt_map_item* i_item;
-  void* i_start;
-  void* i_end;
-  mtl_iova_t iova_base = 0x10000; /* assume user IOVA start from 1M */
-  mtl_iova_t iova_end;
-
-  mt_pthread_mutex_lock(&mgr->mutex);
-
-  /* first check if any conflict with exist mapping */
-  for (int i = 0; i < MT_MAP_MAX_ITEMS; i++) {
-    i_item = mgr->items[i];
-    if (!i_item) continue;
-    i_start = i_item->vaddr;
-    i_end = i_start + i_item->size;
-    if ((start >= i_start) && (start <= i_end)) {
-      err("%s, invalid start %p i_start %p i_end %p\n", __func__, start, i_start, i_end);
-      mt_pthread_mutex_unlock(&mgr->mutex);
-      return -EINVAL;
-    }
-    if ((end >= i_start) && (end <= i_end)) {
-      err("%s, invalid end %p i_start %p i_end %p\n", __func__, start, i_start, i_end);
-      mt_pthread_mutex_unlock(&mgr->mutex);
-      return -EINVAL;
-    }
-    /* simply set iova_base to max iova in previous item */
-    iova_end = i_item->iova + i_item->size;
-    if (iova_end > iova_base) iova_base = iova_end;
-  }
-  item->iova = iova_base;
-
-  /* find empty slot and insert */
-  for (int i = 0; i < MT_MAP_MAX_ITEMS; i++) {
-    i_item = mgr->items[i];
-    if (i_item) continue;
-    i_item = mt_rte_zmalloc_socket(sizeof(*i_item), mt_socket_id(impl, MTL_PORT_P));
-    if (!i_item) {
-      err("%s, i_item malloc fail\n", __func__);
-      mt_pthread_mutex_unlock(&mgr->mutex);
-      return -EINVAL;
-    }
-    *i_item = *item;
-    mgr->items[i] = i_item;
-    mt_pthread_mutex_unlock(&mgr->mutex);
-    info("%s(%d), start %p end %p iova 0x%" PRIx64 "\n", __func__, i, start, end,
-         i_item->iova);
-    return 0;
-  }
-
-  err("%s, no space, all items are used\n", __func__);
-  mt_pthread_mutex_unlock(&mgr->mutex);
-  return -EIO;
-}
-
-int mt_map_remove(struct mtl_main_impl* impl, struct mt_map_item* item) {
-  struct mt_map_mgr* mgr = mt_get_map_mgr(impl);
-  void* start = item->vaddr;
-  void* end = start + item->size;
-  struct mt_map_item* i_item;
-  void* i_start;
-  void* i_end;
-
-  mt_pthread_mutex_lock(&mgr->mutex);
-
-  /* find slot and delete */
-  for (int i = 0; i < MT_MAP_MAX_ITEMS; i++) {
-    i_item = mgr->items[i];
-    if (!i_item) continue;
-    i_start = i_item->vaddr;
-    i_end = i_start + i_item->size;
-    if ((start == i_start) && (end == i_end) && (item->iova == i_item->iova)) {
-      info("%s(%d), start %p end %p iova 0x%" PRIx64 "\n", __func__, i, start, end,
-           i_item->iova);
-      mt_rte_free(i_item);
-      mgr->items[i] = NULL;
-      mt_pthread_mutex_unlock(&mgr->mutex);
-      return 0;
-    }
-  }
-
-  err("%s, unknown items start %p end %p iova %" PRIx64 "\n", __func__, start, end,
-      item->iova);
-  mt_pthread_mutex_unlock(&mgr->mutex);
-  return -EIO;
-}
-
-int mt_map_init(struct mtl_main_impl* impl) {
-  struct mt_map_mgr* mgr = mt_get_map_mgr(impl);
-
-  mt_pthread_mutex_init(&mgr->mutex, NULL);
-
-  return 0;
-}
-
-int mt_map_uinit(struct mtl_main_impl* impl) {
-  struct mt_map_mgr* mgr = mt_get_map_mgr(impl);
-  struct mt_map_item* item;
-
-  for (int i = 0; i < MT_MAP_MAX_ITEMS; i++) {
-    item = mgr->items[i];
-    if (item) {
-      warn("%s(%d), still active, vaddr %p\n", __func__, i, item->vaddr);
-      mt_rte_free(item);
-      mgr->items[i] = NULL;
-    }
-  }
-
-  mt_pthread_mutex_destroy(&mgr->mutex);
-
-  return 0;
-}
-
 /* dma dev only available from DPDK 21.11 */
 #if RTE_VERSION >= RTE_VERSION_NUM(21, 11, 0, 0)
 #include <rte_dmadev.h>
@@ -254,6 +135,7 @@ static int dma_hw_start(struct mtl_main_impl* impl, struct mt_dma_dev* dev,
   }
 
   /* perform the copy ops check */
+  dev->nb_cpl_cached = 0;
   return dma_copy_test(impl, &dev->lenders[0], 0, 32);
 }
 
@@ -273,15 +155,27 @@ static int dma_stat(void* priv) {
   int idx = dev->idx;
   struct rte_dma_stats stats;
   uint64_t avg_nb_inflight = 0;
+  uint64_t now = mt_get_monotonic_time();
+  double time_sec = (double)(now - dev->stat_last_ns) / NS_PER_S;
 
   rte_dma_stats_get(dev_id, 0, &stats);
   rte_dma_stats_reset(dev_id, 0);
   if (dev->stat_commit_sum)
     avg_nb_inflight = dev->stat_inflight_sum / dev->stat_commit_sum;
-  dev->stat_inflight_sum = 0;
-  dev->stat_commit_sum = 0;
+  /* the measured load for the lender assignment */
+  dev->load_q = avg_nb_inflight;
+  if (time_sec > 0) dev->load_bps = (double)dev->stat_bytes * 8 / time_sec;
   notice("DMA(%d), s %" PRIu64 " c %" PRIu64 " e %" PRIu64 " avg q %" PRIu64 "\n", idx,
          stats.submitted, stats.completed, stats.errors, avg_nb_inflight);
+  notice("DMA(%d), sessions %u load %fMb/s, hw poll %" PRIu64 " cpl %" PRIu64 "\n", idx,
+         dev->nb_session, (double)dev->load_bps / 1000 / 1000, dev->stat_hw_poll,
+         dev->stat_cpl);
+  dev->stat_inflight_sum = 0;
+  dev->stat_commit_sum = 0;
+  dev->stat_bytes = 0;
+  dev->stat_hw_poll = 0;
+  dev->stat_cpl = 0;
+  dev->stat_last_ns = now;
 
   return 0;
 }
@@ -297,7 +191,7 @@ static int dma_sw_init(struct mtl_main_impl* impl, struct mt_dma_dev* dev) {
   snprintf(ring_name, 32, "RX-DMA-BORROW-RING-D%d", idx);
   flags = RING_F_SP_ENQ | RING_F_SC_DEQ;
   count = dev->nb_desc;
-  ring = rte_ring_create(ring_name, count, mt_socket_id(impl, MTL_PORT_P), flags);
+  ring = rte_ring_create(ring_name, count, dev->soc_id, flags);
   if (!ring) {
     err("%s(%d), rte_ring_create fail\n", __func__, idx);
     return -ENOMEM;
@@ -307,13 +201,22 @@ static int dma_sw_init(struct mtl_main_impl* impl, struct mt_dma_dev* dev) {
   dev->inflight_enqueue_idx = 0;
   dev->inflight_dequeue_idx = 0;
   dev->inflight_mbufs = mt_rte_zmalloc_socket(sizeof(*dev->inflight_mbufs) * dev->nb_desc,
-                                              mt_socket_id(impl, MTL_PORT_P));
+                                              dev->soc_id);
   if (!dev->inflight_mbufs) {
     err("%s(%d), inflight_mbufs alloc fail\n", __func__, idx);
     return -ENOMEM;
   }
 #endif
   dev->nb_inflight = 0;
+  dev->nb_cpl_cached = 0;
+  dev->load_bps = 0;
+  dev->load_q = 0;
+  dev->stat_inflight_sum = 0;
+  dev->stat_commit_sum = 0;
+  dev->stat_bytes = 0;
+  dev->stat_hw_poll = 0;
+  dev->stat_cpl = 0;
+  dev->stat_last_ns = mt_get_monotonic_time();
 
   mt_stat_register(impl, dma_stat, dev);
 
@@ -363,10 +266,46 @@ static int dma_free(struct mtl_main_impl* impl, struct mt_dma_dev* dev) {
   return 0;
 }
 
+/* busy if the avg queue depth of last period is over 3/4 of the ring */
+static inline bool dma_busy(struct mt_dma_dev* dev) {
+  return dev->load_q >= (dev->nb_desc * 3 / 4);
+}
+
+/* if a has less load than b */
+static bool dma_less_load(struct mt_dma_dev* a, struct mt_dma_dev* b) {
+  bool a_busy = dma_busy(a), b_busy = dma_busy(b);
+
+  if (a_busy != b_busy) return b_busy;
+  if (a->load_bps != b->load_bps) return a->load_bps < b->load_bps;
+  return a->nb_session < b->nb_session;
+}
+
+static struct mtl_dma_lender_dev* dma_lender_attach(struct mt_dma_dev* dev,
+                                                    struct mt_dma_request_req* req) {
+  struct mtl_dma_lender_dev* lender_dev;
+
+  for (int render = 0; render < dev->max_shared; render++) {
+    lender_dev = &dev->lenders[render];
+    if (lender_dev->active) continue;
+
+    lender_dev->active = true;
+    lender_dev->nb_borrowed = 0;
+    lender_dev->priv = req->priv;
+    lender_dev->cb = req->drop_mbuf_cb;
+    /* expect the new lender has the avg load, till the next measurement */
+    if (dev->nb_session) dev->load_bps += dev->load_bps / dev->nb_session;
+    dev->nb_session++;
+    return lender_dev;
+  }
+
+  return NULL;
+}
+
 struct mtl_dma_lender_dev* mt_dma_request_dev(struct mtl_main_impl* impl,
                                               struct mt_dma_request_req* req) {
   struct mt_dma_mgr* mgr = mt_get_dma_mgr(impl);
   struct mt_dma_dev* dev;
+  struct mt_dma_dev* best = NULL;
   struct mtl_dma_lender_dev* lender_dev;
   int idx, ret;
 
@@ -376,37 +315,17 @@ struct mtl_dma_lender_dev* mt_dma_request_dev(struct mtl_main_impl* impl,
   if (!nb_desc) nb_desc = 128;
 
   mt_pthread_mutex_lock(&mgr->mutex);
-  /* first try to find a shared dma */
-  for (idx = 0; idx < MTL_DMA_DEV_MAX; idx++) {
-    dev = &mgr->devs[idx];
-    if (dev->active && (dev->sch_idx == req->sch_idx) &&
-        (dev->soc_id == req->socket_id) && (dev->nb_session < dev->max_shared)) {
-      for (int render = 0; render < dev->max_shared; render++) {
-        lender_dev = &dev->lenders[render];
-        if (!lender_dev->active) {
-          lender_dev->active = true;
-          lender_dev->nb_borrowed = 0;
-          lender_dev->priv = req->priv;
-          lender_dev->cb = req->drop_mbuf_cb;
-          dev->nb_session++;
-          mt_pthread_mutex_unlock(&mgr->mutex);
-          info("%s(%d), shared dma with id %u\n", __func__, idx, render);
-          return lender_dev;
-        }
-      }
-    }
-  }
-  /* now try to create a new dma */
+  /* first try to start an idle dma, spread the sessions to all channels */
   for (idx = 0; idx < MTL_DMA_DEV_MAX; idx++) {
     dev = &mgr->devs[idx];
     if (dev->usable && !dev->active && (dev->soc_id == req->socket_id)) {
+      dev->nb_desc = nb_desc;
       ret = dma_hw_start(impl, dev, nb_desc);
       if (ret < 0) {
         err("%s(%d), dma hw start fail %d\n", __func__, idx, ret);
         dev->usable = false; /* mark to un-usable */
         continue;
       }
-      dev->nb_desc = nb_desc;
       dev->sch_idx = req->sch_idx;
       dev->max_shared = RTE_MIN(req->max_shared, MT_DMA_MAX_SESSIONS);
       ret = dma_sw_init(impl, dev);
@@ -415,12 +334,7 @@ struct mtl_dma_lender_dev* mt_dma_request_dev(struct mtl_main_impl* impl,
         dma_hw_stop(dev);
         continue;
       }
-      lender_dev = &dev->lenders[0];
-      lender_dev->active = true;
-      lender_dev->nb_borrowed = 0;
-      lender_dev->priv = req->priv;
-      lender_dev->cb = req->drop_mbuf_cb;
-      dev->nb_session++;
+      lender_dev = dma_lender_attach(dev, req);
       dev->active = true;
       rte_atomic32_inc(&mgr->num_dma_dev_active);
       mt_pthread_mutex_unlock(&mgr->mutex);
@@ -429,6 +343,23 @@ struct mtl_dma_lender_dev* mt_dma_request_dev(struct mtl_main_impl* impl,
       return lender_dev;
     }
   }
+  /* no idle one, share the least loaded dma on the same sch */
+  for (idx = 0; idx < MTL_DMA_DEV_MAX; idx++) {
+    dev = &mgr->devs[idx];
+    if (!dev->active || (dev->sch_idx != req->sch_idx) ||
+        (dev->soc_id != req->socket_id) || (dev->nb_session >= dev->max_shared))
+      continue;
+    if (!best || dma_less_load(dev, best)) best = dev;
+  }
+  if (best) {
+    lender_dev = dma_lender_attach(best, req);
+    if (lender_dev) {
+      mt_pthread_mutex_unlock(&mgr->mutex);
+      info("%s(%d), shared dma with id %u, load %" PRIu64 " q %u\n", __func__, best->idx,
+           lender_dev->lender_id, best->load_bps, best->load_q);
+      return lender_dev;
+    }
+  }
   mt_pthread_mutex_unlock(&mgr->mutex);
 
   err("%s, fail to find free dev\n", __func__);
@@ -462,13 +393,17 @@ int mt_dma_free_dev(struct mtl_main_impl* impl, struct mtl_dma_lender_dev* dev)
 int mt_dma_copy(struct mtl_dma_lender_dev* dev, rte_iova_t dst, rte_iova_t src,
                 uint32_t length) {
   struct mt_dma_dev* dma_dev = dev->parent;
-  return rte_dma_copy(dma_dev->dev_id, 0, src, dst, length, 0);
+  int ret = rte_dma_copy(dma_dev->dev_id, 0, src, dst, length, 0);
+  if (ret >= 0) dma_dev->stat_bytes += length;
+  return ret;
 }
 
 int mt_dma_fill(struct mtl_dma_lender_dev* dev, rte_iova_t dst, uint64_t pattern,
                 uint32_t length) {
   struct mt_dma_dev* dma_dev = dev->parent;
-  return rte_dma_fill(dma_dev->dev_id, 0, pattern, dst, length, 0);
+  int ret = rte_dma_fill(dma_dev->dev_id, 0, pattern, dst, length, 0);
+  if (ret >= 0) dma_dev->stat_bytes += length;
+  return ret;
 }
 
 int mt_dma_submit(struct mtl_dma_lender_dev* dev) {
@@ -481,7 +416,21 @@ int mt_dma_submit(struct mtl_dma_lender_dev* dev) {
 uint16_t mt_dma_completed(struct mtl_dma_lender_dev* dev, uint16_t nb_cpls,
                           uint16_t* last_idx, bool* has_error) {
   struct mt_dma_dev* dma_dev = dev->parent;
-  return rte_dma_completed(dma_dev->dev_id, 0, nb_cpls, NULL, NULL);
+  uint16_t nb_dq;
+
+  /*
+   * the lenders of one dma are on the same sch, poll the hw only after all the
+   * completions of last poll are consumed, one poll serves all the lenders.
+   */
+  if (!dma_dev->nb_cpl_cached) {
+    dma_dev->nb_cpl_cached =
+        rte_dma_completed(dma_dev->dev_id, 0, dma_dev->nb_desc, NULL, NULL);
+    dma_dev->stat_hw_poll++;
+  }
+  nb_dq = RTE_MIN(nb_cpls, dma_dev->nb_cpl_cached);
+  dma_dev->nb_cpl_cached -= nb_dq;
+  dma_dev->stat_cpl += nb_dq;
+  return nb_dq;
 }
 
 int mt_dma_borrow_mbuf(struct mtl_dma_lender_dev* dev, struct rte_mbuf* mbuf) {
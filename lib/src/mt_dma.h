@@ -68,9 +68,4 @@ static inline int mt_dma_dev_id(struct mtl_dma_lender_dev* dev) {
   return dev->parent->idx;
 }
 
-int mt_map_init(struct mtl_main_impl* impl);
-int mt_map_uinit(struct mtl_main_impl* impl);
-int mt_map_add(struct mtl_main_impl* impl, struct mt_map_item* item);
-int mt_map_remove(struct mtl_main_impl* impl, struct mt_map_item* item);
-
 #endif
@@ -28,6 +28,10 @@ enum mt_handle_type {
   MT_ST22_HANDLE_DEV_ENCODE = 27,
   MT_ST22_HANDLE_DEV_DECODE = 28,
   MT_ST20_HANDLE_DEV_CONVERT = 29,
+  MT_ST30_HANDLE_PIPELINE_TX = 30,
+  MT_ST30_HANDLE_PIPELINE_RX = 31,
+  MT_ST40_HANDLE_PIPELINE_TX = 32,
+  MT_ST40_HANDLE_PIPELINE_RX = 33,
 
   MT_HANDLE_UDMA = 40,
   MT_HANDLE_UDP = 41,
@@ -42,4 +46,24 @@ struct mt_udp_hdr {
   struct rte_udp_hdr udp;   /* size: 8 */
 } __attribute__((__packed__)) __rte_aligned(2);
 
+/* the bytes a session can take from the frame arena */
+struct mt_arena_quota {
+  size_t max_bytes; /* 0 means no limit */
+  size_t used_bytes;
+};
+
+/* log-linear buckets, 8 sub buckets in each power of 2, the error is less than 12.5% */
+#define MT_HIST_SUB_BITS (3)
+#define MT_HIST_SUB_CNT (1 << MT_HIST_SUB_BITS)
+/* up to 2^36 ns(~68s), the larger value is counted in the last bucket */
+#define MT_HIST_MAX_BITS (36)
+#define MT_HIST_BUCKETS ((MT_HIST_MAX_BITS - MT_HIST_SUB_BITS + 1) * MT_HIST_SUB_CNT)
+
+/* latency histogram in ns, single writer, the stat thread read and clear it */
+struct mt_hist {
+  uint32_t buckets[MT_HIST_BUCKETS];
+  uint64_t cnt;
+  uint64_t max;
+};
+
 #endif
@@ -5,6 +5,7 @@
 #include "mt_main.h"
 
 #include "mt_admin.h"
+#include "mt_arena.h"
 #include "mt_arp.h"
 #include "mt_cni.h"
 #include "mt_config.h"
@@ -12,6 +13,7 @@
 #include "mt_dhcp.h"
 #include "mt_dma.h"
 #include "mt_log.h"
+#include "mt_map.h"
 #include "mt_mcast.h"
 #include "mt_ptp.h"
 #include "mt_rss.h"
@@ -20,6 +22,7 @@
 #include "mt_shared_rss.h"
 #include "mt_socket.h"
 #include "mt_stat.h"
+#include "mt_telemetry.h"
 #include "mt_util.h"
 #include "st2110/pipeline/st_plugin.h"
 #include "st2110/st_ancillary_transmitter.h"
@@ -188,6 +191,12 @@ static int mt_main_create(struct mtl_main_impl* impl) {
     return ret;
   }
 
+  ret = mt_arena_init(impl);
+  if (ret < 0) {
+    err("%s, mt_arena_init fail %d\n", __func__, ret);
+    return ret;
+  }
+
   ret = mt_arp_init(impl);
   if (ret < 0) {
     err("%s, mt_arp_init fail %d\n", __func__, ret);
@@ -236,6 +245,12 @@ static int mt_main_create(struct mtl_main_impl* impl) {
     return ret;
   }
 
+  ret = mt_telemetry_init(impl);
+  if (ret < 0) {
+    err("%s, mt_telemetry_init fail %d\n", __func__, ret);
+    return ret;
+  }
+
   pthread_create(&impl->tsc_cal_tid, NULL, mt_calibrate_tsc, impl);
 
   info("%s, succ\n", __func__);
@@ -248,6 +263,7 @@ static int mt_main_free(struct mtl_main_impl* impl) {
     impl->tsc_cal_tid = 0;
   }
 
+  mt_telemetry_uinit(impl);
   mt_ptp_uinit(impl);
   mt_dhcp_uinit(impl);
   mt_config_uinit(impl);
@@ -257,6 +273,7 @@ static int mt_main_free(struct mtl_main_impl* impl) {
   mt_arp_uinit(impl);
   mt_mcast_uinit(impl);
 
+  mt_arena_uinit(impl);
   mt_map_uinit(impl);
   mt_dma_uinit(impl);
   mt_dev_if_pre_uinit(impl);
@@ -309,13 +326,23 @@ static int mt_user_params_check(struct mtl_init_params* p) {
         err("%s(%d), invalid start_queue %u\n", __func__, i, p->xdp_info[i].start_queue);
         return -EINVAL;
       }
+      if (p->xdp_info[i].xdp_prog[0] && access(p->xdp_info[i].xdp_prog, R_OK) < 0) {
+        err("%s(%d), xdp prog %s not readable\n", __func__, i, p->xdp_info[i].xdp_prog);
+        return -EINVAL;
+      }
       ret = mt_socket_get_if_ip(p->port[i], if_ip, if_netmask);
       if (ret < 0) {
         err("%s(%d), get ip fail from if %s for P port\n", __func__, i, p->port[i]);
         return ret;
       }
     }
-    if (p->net_proto[i] == MTL_PROTO_STATIC && p->pmd[i] == MTL_PMD_DPDK_USER) {
+    /* loopback and pcap check */
+    if ((pmd == MTL_PMD_DPDK_LOOPBACK || pmd == MTL_PMD_DPDK_PCAP) &&
+        p->net_proto[i] != MTL_PROTO_STATIC) {
+      err("%s(%d), virtual port only support static ip\n", __func__, i);
+      return -EINVAL;
+    }
+    if (p->net_proto[i] == MTL_PROTO_STATIC && p->pmd[i] != MTL_PMD_DPDK_AF_XDP) {
       ip = p->sip_addr[i];
       ret = mt_ip_addr_check(ip);
       if (ret < 0) {
@@ -450,7 +477,7 @@ mtl_handle mtl_init(struct mtl_init_params* p) {
     inf = mt_if(impl, i);
     inf->parent = impl;
 
-    if (p->pmd[i] != MTL_PMD_DPDK_USER) {
+    if (p->pmd[i] == MTL_PMD_DPDK_AF_XDP) {
       uint8_t if_ip[MTL_IP_ADDR_LEN];
       uint8_t if_netmask[MTL_IP_ADDR_LEN];
       uint8_t if_gateway[MTL_IP_ADDR_LEN];
@@ -470,7 +497,7 @@ mtl_handle mtl_init(struct mtl_init_params* p) {
           rte_memcpy(impl->user_para.gateway[i], if_gateway, MTL_IP_ADDR_LEN);
         }
       }
-    } else { /* MTL_PMD_DPDK_USER */
+    } else { /* MTL_PMD_DPDK_USER, LOOPBACK or PCAP */
       uint32_t netmask = mt_ip_to_u32(impl->user_para.netmask[i]);
       if (!netmask) { /* set to default if user not set a netmask */
         impl->user_para.netmask[i][0] = 255;
@@ -647,7 +674,7 @@ int mtl_get_lcore(mtl_handle mt, unsigned int* lcore) {
     return -EIO;
   }
 
-  return mt_dev_get_lcore(impl, lcore);
+  return mt_dev_get_lcore(impl, mt_socket_id(impl, MTL_PORT_P), lcore);
 }
 
 int mtl_put_lcore(mtl_handle mt, unsigned int lcore) {
@@ -968,6 +995,22 @@ int mtl_get_stats(mtl_handle mt, struct mtl_stats* stats) {
   return 0;
 }
 
+int mtl_metrics_snapshot(mtl_handle mt, struct mtl_metric* metrics, int max) {
+  struct mtl_main_impl* impl = mt;
+
+  if (impl->type != MT_HANDLE_MAIN) {
+    err("%s, invalid type %d\n", __func__, impl->type);
+    return -EIO;
+  }
+
+  if (metrics && (max <= 0)) {
+    err("%s, invalid max %d\n", __func__, max);
+    return -EINVAL;
+  }
+
+  return mt_metric_snapshot(impl, metrics, max);
+}
+
 int mtl_sch_enable_sleep(mtl_handle mt, int sch_idx, bool enable) {
   struct mtl_main_impl* impl = mt;
 
@@ -1033,6 +1076,22 @@ uint64_t mtl_ptp_read_time(mtl_handle mt) {
   return ptp;
 }
 
+int mtl_ptp_get_master(mtl_handle mt, enum mtl_port port,
+                       struct mtl_ptp_master_info* info) {
+  struct mtl_main_impl* impl = mt;
+
+  if (impl->type != MT_HANDLE_MAIN) {
+    err("%s, invalid type %d\n", __func__, impl->type);
+    return -EIO;
+  }
+  if (port >= mt_num_ports(impl)) {
+    err("%s, invalid port %d\n", __func__, port);
+    return -EINVAL;
+  }
+
+  return mt_ptp_get_master(impl, port, info);
+}
+
 mtl_udma_handle mtl_udma_create(mtl_handle mt, uint16_t nb_desc, enum mtl_port port) {
   struct mtl_main_impl* impl = mt;
   struct mt_dma_request_req req;
@@ -7,6 +7,7 @@
 #include <rte_alarm.h>
 #include <rte_arp.h>
 #include <rte_errno.h>
+#include <rte_eth_ring.h>
 #include <rte_ethdev.h>
 #include <rte_thash.h>
 #ifdef MTL_HAS_KNI
@@ -39,15 +40,33 @@
 /* max RL items */
 #define MT_MAX_RL_ITEMS (64)
 
-#define MT_ARP_ENTRY_MAX (60)
+/* max neighbors of one port */
+#define MT_ARP_ENTRY_MAX (16 * 1024)
+/* max tx pkts queued on one unresolved neighbor */
+#define MT_ARP_PENDING_MAX (16)
 
-#define MT_MCAST_GROUP_MAX (60)
+/* max mcast groups of one port */
+#define MT_MCAST_GROUP_MAX (4 * 1024)
+/* hash buckets of the mcast groups, power of 2 */
+#define MT_MCAST_GROUP_HASH_SIZE (256)
+/* max ssm sources of one mcast group */
+#define MT_MCAST_SOURCE_MAX (16)
+/* max pending leave records wait the next report */
+#define MT_MCAST_LEAVE_MAX (256)
 
 #define MT_DMA_MAX_SESSIONS (16)
 /* if use rte ring for dma enqueue/dequeue */
 #define MT_DMA_RTE_RING (1)
 
-#define MT_MAP_MAX_ITEMS (256)
+#define MT_MAP_MAX_ITEMS (4096)
+/* the iova range for user dma map, 39 bits is the min address width of iommu */
+#define MT_MAP_IOVA_START (0x10000)
+#define MT_MAP_IOVA_END (UINT64_C(1) << 39)
+
+/* max size classes of the frame arena */
+#define MT_ARENA_CLASS_MAX (64)
+/* high-water of the cached free frames, the frame put above it is freed directly */
+#define MT_ARENA_FREE_MAX_BYTES (UINT64_C(256) << 20)
 
 #define MT_IP_DONT_FRAGMENT_FLAG (0x0040)
 
@@ -100,6 +119,8 @@ enum mt_port_type {
   MT_PORT_VF,
   MT_PORT_PF,
   MT_PORT_AF_XDP,
+  MT_PORT_LOOPBACK,
+  MT_PORT_PCAP,
 };
 
 enum mt_driver_type {
@@ -111,6 +132,8 @@ enum mt_driver_type {
   MT_DRV_E1000_IGB, /* e1000 igb, net_e1000_igb */
   MT_DRV_IGC,       /* igc, net_igc */
   MT_DRV_ENA,       /* ena, net_ena */
+  MT_DRV_RING,      /* loopback, net_ring */
+  MT_DRV_PCAP,      /* pcap file, net_pcap */
 };
 
 enum mt_flow_type {
@@ -130,6 +153,35 @@ enum mt_ptp_addr_mode {
   MT_PTP_UNICAST_ADDR,
 };
 
+#define MT_PTP_FOREIGN_MASTER_MAX (8)
+
+/* the announce dataset of one master seen on the port, for bmca */
+struct mt_ptp_foreign_master {
+  bool used;
+  struct mt_ptp_port_id port_id; /* the sender port */
+  uint8_t domain_number;
+  uint8_t priority1;
+  uint8_t priority2;
+  uint8_t clock_class;
+  uint8_t clock_accuracy;
+  uint16_t offset_scaled_log_variance;
+  struct mt_ptp_clock_id gm_identity;
+  uint16_t steps_removed;
+  int16_t utc_offset;
+  enum mt_ptp_l_mode mode;
+  struct mt_ptp_ipv4_udp ipv4_udp; /* the announce ip hdr for l4 */
+  uint64_t receipt_timeout_ns;     /* from the announce interval */
+  uint64_t last_ns;                /* monotonic time of last announce */
+  uint32_t announce_cnt;           /* continuous announce for qualification */
+};
+
+enum mt_ptp_metric {
+  MT_PTP_METRIC_SYNC = 0,
+  MT_PTP_METRIC_OFFSET_NS,     /* the last offset to the master */
+  MT_PTP_METRIC_PATH_DELAY_NS, /* the last mean path delay */
+  MT_PTP_METRIC_MAX,
+};
+
 struct mt_ptp_impl {
   struct mtl_main_impl* impl;
   enum mtl_port port;
@@ -139,6 +191,12 @@ struct mt_ptp_impl {
   struct rte_mempool* mbuf_pool;
 
   uint8_t mcast_group_addr[MTL_IP_ADDR_LEN]; /* 224.0.1.129 */
+  /* all the masters seen on this port, include other domains */
+  struct mt_ptp_foreign_master foreign[MT_PTP_FOREIGN_MASTER_MAX];
+  struct mt_ptp_foreign_master* master; /* the one selected by bmca */
+  bool domain_fixed;                    /* only follow the masters on domain_number */
+  uint8_t domain_number;
+  uint32_t master_changes;
   bool master_initialized;
   struct mt_ptp_port_id master_port_id;
   struct rte_ether_addr master_addr;
@@ -177,6 +235,9 @@ struct mt_ptp_impl {
   double coefficient_result_max;
   int32_t coefficient_result_cnt;
 
+  /* the servo framework, NULL for the default coefficient average */
+  struct mt_ptp_servo* servo;
+
   /* pi controller */
   bool use_pi;        /* use pi controller */
   double kp;          /* proportional gain */
@@ -202,6 +263,7 @@ struct mt_ptp_impl {
   int32_t stat_result_err;
   int32_t stat_sync_timeout_err;
   int32_t stat_sync_cnt;
+  struct mt_metric_group* metrics; /* see enum mt_ptp_metric */
 };
 
 struct mt_cni_priv {
@@ -209,9 +271,19 @@ struct mt_cni_priv {
   enum mtl_port port;
 };
 
+/* the traffic class of cni, served in this priority order */
+enum mt_cni_class {
+  MT_CNI_CLASS_CTRL = 0, /* the ptp queue, polled again after each burst of others */
+  MT_CNI_CLASS_SYS,      /* the cni sys queue, arp/dhcp and kni */
+  MT_CNI_CLASS_SHARED,   /* the shared rsq/rss queue */
+  MT_CNI_CLASS_MAX,
+};
+
 struct mt_cni_impl {
   bool used; /* if enable cni */
   int num_ports;
+  /* max pkts of each class in one cni round, the rest are left to next round */
+  uint16_t budget[MT_CNI_CLASS_MAX];
 
   struct mt_rx_queue* rx_q[MTL_PORT_MAX];   /* cni rx queue */
   struct mt_rsq_entry* rsq[MTL_PORT_MAX];   /* cni rsq queue */
@@ -224,6 +296,9 @@ struct mt_cni_impl {
   struct mt_sch_tasklet_impl* tasklet;
   /* stat */
   int eth_rx_cnt[MTL_PORT_MAX];
+  uint32_t stat_ctrl_pkts[MTL_PORT_MAX];
+  uint32_t stat_ctrl_hw_ts[MTL_PORT_MAX];
+  uint32_t stat_budget_out[MT_CNI_CLASS_MAX];
 
 #ifdef MTL_HAS_KNI
   bool has_kni_kmod;
@@ -246,25 +321,84 @@ struct mt_cni_impl {
 #endif
 };
 
+enum mt_arp_state {
+  MT_ARP_INCOMPLETE = 0, /* request sent, no reply yet */
+  MT_ARP_REACHABLE,      /* reply received in ARP_REACHABLE_NS */
+  MT_ARP_STALE,          /* the mac is still used, refresh request sent */
+};
+
 struct mt_arp_entry {
+  struct mt_arp_entry* next; /* hash chain */
   uint32_t ip;
   struct rte_ether_addr ea;
-  rte_atomic32_t mac_ready;
+  enum mt_arp_state state;
+  uint64_t update_ns; /* monotonic time of last reply */
+  uint64_t used_ns;   /* monotonic time of last lookup */
+  uint32_t req_cnt;   /* requests since last reply */
+  /* tx pkts wait the resolve, see mt_arp_cni_queue */
+  uint16_t pending_cnt;
+  struct rte_mbuf* pending[MT_ARP_PENDING_MAX];
 };
 
 struct mt_arp_impl {
   pthread_mutex_t mutex; /* arp impl protect */
-  struct mt_arp_entry entries[MT_ARP_ENTRY_MAX];
+  /* hash table of the neighbors, grow with the entries */
+  struct mt_arp_entry** buckets;
+  uint32_t bucket_mask; /* bucket cnt - 1 */
+  uint32_t entry_cnt;
   bool timer_active;
   enum mtl_port port;
+  int soc_id;
   struct mtl_main_impl* parent;
+
+  /* stat */
+  uint32_t stat_req;
+  uint32_t stat_reply;
+  uint32_t stat_garp;
+  uint32_t stat_mac_change;
+  uint32_t stat_expired;
+  uint32_t stat_queued;
+  uint32_t stat_queue_drop;
+};
+
+struct mt_mcast_source {
+  uint32_t ip;
+  uint32_t ref_cnt;
+};
+
+struct mt_mcast_group {
+  struct mt_mcast_group* next; /* hash chain */
+  uint32_t ip;
+  /* the any source(ASM) joins, the group is in exclude mode if not zero */
+  uint32_t ref_cnt;
+  /* the SSM(S,G) joins, used in include mode */
+  uint16_t source_num;
+  struct mt_mcast_source sources[MT_MCAST_SOURCE_MAX];
+};
+
+/* the leave state change wait the next report, source 0 for the whole group */
+struct mt_mcast_leave {
+  uint32_t group;
+  uint32_t source;
 };
 
 struct mt_mcast_impl {
   pthread_mutex_t group_mutex;
-  uint32_t group_ip[MT_MCAST_GROUP_MAX];
-  uint32_t group_ref_cnt[MT_MCAST_GROUP_MAX];
-  uint16_t group_num;
+  struct mt_mcast_group* groups[MT_MCAST_GROUP_HASH_SIZE];
+  uint32_t group_num;
+  struct mt_mcast_leave leaves[MT_MCAST_LEAVE_MAX];
+  uint16_t leave_num;
+  enum mtl_port port;
+  int soc_id;
+  struct mtl_main_impl* parent;
+  /* report rate limit */
+  bool report_pending; /* the report alarm is set */
+  uint64_t last_report_ns;
+
+  /* stat */
+  uint32_t stat_report_pkts;
+  uint32_t stat_report_records;
+  uint32_t stat_report_limited;
 };
 
 enum mt_dhcp_status {
@@ -317,6 +451,11 @@ struct mt_sch_tasklet_ops {
    * leave to zero if you don't know.
    */
   uint64_t advice_sleep_us;
+  /*
+   * the tasklet has no lcore affinity and can be moved to another sch by the balancer,
+   * see MTL_FLAG_TASKLET_BALANCE.
+   */
+  bool migratable;
 };
 
 struct mt_sch_tasklet_impl {
@@ -332,6 +471,18 @@ struct mt_sch_tasklet_impl {
   uint64_t stat_sum_time_us;
   uint64_t stat_time_cnt;
   uint32_t stat_min_time_us;
+  /* the tail of the handler time, with MTL_FLAG_TASKLET_TIME_MEASURE */
+  struct mt_hist stat_time_hist;
+
+  /* cycles and pending loops measured by the sch for the balancer */
+  uint64_t stat_cycles;
+  uint64_t stat_pending;
+  /* the values at last balance pass */
+  uint64_t balance_cycles;
+  uint64_t balance_pending;
+  /* result of last balance period */
+  float load; /* cpu ratio */
+  uint64_t pending_loops;
 };
 
 enum mt_sch_type {
@@ -345,12 +496,20 @@ typedef uint64_t mt_sch_mask_t;
 /* all sch */
 #define MT_SCH_MASK_ALL ((mt_sch_mask_t)-1)
 
+enum mt_sch_metric {
+  MT_SCH_METRIC_LOOPS = 0,
+  MT_SCH_METRIC_SLEEP_NS,
+  MT_SCH_METRIC_SLEEP_RATIO, /* in percent */
+  MT_SCH_METRIC_MAX,
+};
+
 struct mt_sch_impl {
   pthread_mutex_t mutex; /* protect sch context */
   struct mt_sch_tasklet_impl** tasklet;
   int nb_tasklets;     /* the number of tasklet in current sch */
   int max_tasklet_idx; /* max tasklet index */
   unsigned int lcore;
+  int socket_id; /* numa socket for the lcore and tasklets, follow the session ports */
   bool run_in_thread; /* Run the tasklet inside one thread instead of a pinned lcore. */
   pthread_t tid;      /* thread id for run_in_thread */
 
@@ -392,6 +551,13 @@ struct mt_sch_impl {
   uint32_t stat_sleep_cnt;
   uint64_t stat_sleep_ns_min;
   uint64_t stat_sleep_ns_max;
+  /* time of each loop, with MTL_FLAG_TASKLET_TIME_MEASURE */
+  struct mt_hist stat_loop_hist;
+  /* valid when active, see enum mt_sch_metric */
+  struct mt_metric_group* metrics;
+
+  /* measured cpu ratio of all tasklets in last balance period */
+  float load;
 };
 
 struct mt_sch_mgr {
@@ -399,6 +565,13 @@ struct mt_sch_mgr {
   /* active sch cnt */
   rte_atomic32_t sch_cnt;
   pthread_mutex_t mgr_mutex; /* protect sch mgr */
+
+  /* the per pkt cost measured at init, see MTL_FLAG_SCH_QUOTA_AUTO */
+  bool quota_calibrated;
+  uint32_t tx_pkt_cycles;
+  uint32_t rx_pkt_cycles;  /* without the payload copy */
+  uint32_t rx_copy_cycles; /* the payload copy if no dma */
+  float load_per_mbs;      /* cpu ratio of 1 mb/s st20 tx */
 };
 
 struct mt_pacing_train_result {
@@ -407,9 +580,10 @@ struct mt_pacing_train_result {
 };
 
 struct mt_rl_shaper {
-  uint64_t rl_bps; /* input, byte per sec */
+  uint64_t rl_bps; /* input, byte per sec, rounded to the shaper granularity */
   uint32_t shaper_profile_id;
   int idx;
+  uint32_t ref_cnt; /* queue nodes(and root) linked to this profile */
 };
 
 typedef int (*mt_rsq_mbuf_cb)(void* priv, struct rte_mbuf** mbuf, uint16_t nb);
@@ -466,6 +640,19 @@ struct mt_tx_queue {
   uint64_t bps;           /* bytes per sec for rate limit */
 };
 
+#define MT_PCAP_REPLAY_BURST (32)
+
+/* the state of a pcap port replay at the original timestamps */
+struct mt_pcap_replay {
+  /* pkts read from the file but not due yet */
+  struct rte_mbuf* pkts[MT_PCAP_REPLAY_BURST];
+  uint16_t nb_pkts;
+  uint16_t idx;
+  /* the timestamp of the first pkt in the file and the tsc it was delivered */
+  uint64_t base_pkt_ns;
+  uint64_t base_tsc;
+};
+
 struct mt_interface {
   struct mtl_main_impl* parent;
   enum mtl_port port;
@@ -530,6 +717,9 @@ struct mt_interface {
   uint64_t real_time_base;
 
   struct mt_dev_stats* dev_stats; /* for nic without reset func */
+
+  /* MTL_PMD_DPDK_PCAP with rx_realtime only */
+  struct mt_pcap_replay* pcap_replay;
 };
 
 struct mt_lcore_shm {
@@ -571,8 +761,17 @@ struct mt_dma_dev {
   uint16_t inflight_dequeue_idx;
   struct rte_mbuf** inflight_mbufs;
 #endif
+  /* completed in hw but not yet consumed by lenders, to batch the hw poll */
+  uint16_t nb_cpl_cached;
+  /* the load in last stat period, for the lender assignment */
+  uint64_t load_bps;
+  uint16_t load_q; /* avg queue depth */
   uint64_t stat_inflight_sum;
   uint64_t stat_commit_sum;
+  uint64_t stat_bytes;
+  uint64_t stat_hw_poll;
+  uint64_t stat_cpl;
+  uint64_t stat_last_ns;
 };
 
 struct mt_dma_mgr {
@@ -597,11 +796,26 @@ struct mt_admin {
   pthread_cond_t admin_wake_cond;
   pthread_mutex_t admin_wake_mutex;
   rte_atomic32_t admin_stop;
+  uint64_t balance_tsc; /* tsc cycles of last balance pass */
+};
+
+struct mt_telemetry {
+  uint32_t period_ms;
+  int shm_id;
+  struct mtl_telemetry_shm* shm;
+  /* the update is built here then copied to shm, keep the seqlock window short */
+  struct mtl_telemetry_shm* staging;
+  pthread_t tid;
+  pthread_cond_t wake_cond;
+  pthread_mutex_t wake_mutex;
+  rte_atomic32_t stop;
 };
 
 struct mt_kport_info {
-  /* dpdk port name for kernel port(MTL_PMD_DPDK_AF_XDP) */
+  /* dpdk port name for vdev port(MTL_PMD_DPDK_AF_XDP, LOOPBACK and PCAP) */
   char port[MTL_PORT_MAX][MTL_PORT_MAX_LEN];
+  /* the ring carry the tx pkts of a loopback port, the rx ring of the peer port */
+  struct rte_ring* loopback_ring[MTL_PORT_MAX];
 };
 
 struct mt_map_item {
@@ -610,9 +824,63 @@ struct mt_map_item {
   mtl_iova_t iova; /* iova address */
 };
 
+/* the node of the avl interval tree keyed by vaddr */
+struct mt_map_node {
+  struct mt_map_item item;
+  void* max_end; /* the max vaddr end in this subtree */
+  int height;
+  struct mt_map_node* left;
+  struct mt_map_node* right;
+};
+
+/* a free iova range [start, end) */
+struct mt_map_hole {
+  mtl_iova_t start;
+  mtl_iova_t end;
+};
+
 struct mt_map_mgr {
-  pthread_mutex_t mutex;
-  struct mt_map_item* items[MT_MAP_MAX_ITEMS];
+  pthread_mutex_t mutex; /* protect all below */
+  struct mt_map_node* root;
+  int nb_items;
+  /* free iova holes sorted by start, no adjacent holes */
+  struct mt_map_hole* holes;
+  int nb_holes;
+  /* stat */
+  uint64_t stat_iova_reuse;
+};
+
+/* a frame handle of the arena, owned by one session */
+struct mt_arena_frame {
+  void* addr;
+  rte_iova_t iova; /* resolved at alloc time */
+  struct mt_arena_class* parent;
+  struct mt_arena_quota* quota; /* the owner charged for this frame */
+  /* linked in the free list of the class */
+  MT_TAILQ_ENTRY(mt_arena_frame) next;
+};
+
+MT_TAILQ_HEAD(mt_arena_frames_list, mt_arena_frame);
+
+struct mt_arena_class {
+  struct mt_arena_mgr* parent;
+  size_t size; /* frame size of this class */
+  int soc_id;
+  struct mt_arena_frames_list free_list;
+  int nb_free;
+  int nb_total; /* free and in use */
+  /* stat */
+  uint64_t stat_get;
+  uint64_t stat_reuse;
+};
+
+struct mt_arena_mgr {
+  pthread_mutex_t mutex; /* protect all below */
+  struct mt_arena_class classes[MT_ARENA_CLASS_MAX];
+  int nb_classes;
+  size_t free_bytes; /* the bytes cached in all free lists */
+  /* stat */
+  uint64_t stat_trim;
 };
 
 struct mt_var_params {
@@ -636,9 +904,39 @@ struct mt_stat_item {
 /* List of stat items */
 MT_TAILQ_HEAD(mt_stat_items_list, mt_stat_item);
 
+/* max metrics in one metric group */
+#define MT_METRIC_GROUP_MAX (8)
+
+struct mt_metric_desc {
+  const char* name;
+  enum mtl_metric_type type;
+};
+
+/* the counters of one lcore, one cache line to avoid the false sharing */
+struct mt_metric_slot {
+  uint64_t v[MT_METRIC_GROUP_MAX];
+} __rte_cache_aligned;
+
+struct mt_metric_group {
+  char name[MTL_METRIC_NAME_MAX];
+  const struct mt_metric_desc* descs;
+  int nb_descs;
+  /* per lcore counters, the last one is shared by all the non-EAL threads */
+  struct mt_metric_slot* slots;
+  int64_t gauges[MT_METRIC_GROUP_MAX];
+  /* linked list */
+  MT_TAILQ_ENTRY(mt_metric_group) next;
+};
+/* List of metric groups */
+MT_TAILQ_HEAD(mt_metric_groups_list, mt_metric_group);
+
 struct mt_stat_mgr {
   pthread_mutex_t mutex;
   struct mt_stat_items_list head;
+  /* metric groups, the lock is for register and snapshot only, never on data path */
+  pthread_mutex_t metric_mutex;
+  struct mt_metric_groups_list metric_head;
+  int nb_metrics;
 };
 
 struct mt_dev_stats {
@@ -692,6 +990,13 @@ struct mt_rsq_entry {
 };
 MT_TAILQ_HEAD(mt_rsq_entrys_list, mt_rsq_entry);
 
+enum mt_rsq_metric {
+  MT_RSQ_METRIC_PKTS_RECV = 0,
+  MT_RSQ_METRIC_PKTS_DELIVER,
+  MT_RSQ_METRIC_ENTRIES,
+  MT_RSQ_METRIC_MAX,
+};
+
 struct mt_rsq_queue {
   uint16_t port_id;
   uint16_t queue_id;
@@ -702,6 +1007,7 @@ struct mt_rsq_queue {
   /* stat */
   int stat_pkts_recv;
   int stat_pkts_deliver;
+  struct mt_metric_group* metrics; /* see enum mt_rsq_metric */
 };
 
 struct mt_rsq_impl {
@@ -727,11 +1033,26 @@ struct mt_tsq_entry {
   struct mt_tsq_flow flow;
   struct mt_tsq_impl* parent;
   struct rte_mempool* tx_pool;
+  /* the pkts rejected by mt_tsq_burst as the staging ring full */
+  uint64_t stat_backpressure;
   /* linked list */
   MT_TAILQ_ENTRY(mt_tsq_entry) next;
 };
 MT_TAILQ_HEAD(mt_tsq_entrys_list, mt_tsq_entry);
 
+enum mt_tsq_metric {
+  MT_TSQ_METRIC_PKTS_SEND = 0,
+  MT_TSQ_METRIC_ENTRIES,
+  MT_TSQ_METRIC_FLUSHES,
+  MT_TSQ_METRIC_BACKPRESSURE,
+  MT_TSQ_METRIC_MAX,
+};
+
+/* the max pkts of one tx burst when draining the staging ring */
+#define MT_TSQ_FLUSH_BURST (128)
+/* the tx burst retries for a full nic before leaving the pkts to the next flush */
+#define MT_TSQ_FLUSH_RETRY (32)
+
 struct mt_tsq_queue {
   uint16_t port_id;
   uint16_t queue_id;
@@ -740,10 +1061,20 @@ struct mt_tsq_queue {
   /* List of rsq entry */
   struct mt_tsq_entrys_list head;
   pthread_mutex_t mutex;
-  pthread_mutex_t tx_mutex;
   rte_atomic32_t entry_cnt;
+  /* mpsc staging ring, all entries enqueue lock free */
+  struct rte_ring* stage_ring;
+  /* the single flusher which drain the staging ring to the nic */
+  rte_spinlock_t flush_lock;
+  /* dequeued from the staging ring but not accepted by the nic, under flush_lock */
+  struct rte_mbuf* pending[MT_TSQ_FLUSH_BURST];
+  uint16_t pending_idx;
+  uint16_t nb_pending;
   /* stat */
   int stat_pkts_send;
+  int stat_flushes;
+  int stat_backpressure;
+  struct mt_metric_group* metrics; /* see enum mt_tsq_metric */
 };
 
 struct mt_tsq_impl {
@@ -811,6 +1142,9 @@ struct mtl_main_impl {
   /* admin context */
   struct mt_admin admin;
 
+  /* telemetry shm context */
+  struct mt_telemetry telemetry;
+
   /* cni context */
   struct mt_cni_impl cni;
 
@@ -873,10 +1207,12 @@ struct mtl_main_impl {
 
   /* rx timestamp register */
   int dynfield_offset;
+  uint64_t dynflag_rx_timestamp;
 
   struct mt_dma_mgr dma_mgr;
 
   struct mt_map_mgr map_mgr;
+  struct mt_arena_mgr arena;
 
   uint16_t pkt_udp_suggest_max_size;
   uint16_t rx_pool_data_size;
@@ -919,10 +1255,10 @@ static inline enum mtl_pmd_type mt_pmd_type(struct mtl_main_impl* impl,
 }
 
 static inline bool mt_pmd_is_kernel(struct mtl_main_impl* impl, enum mtl_port port) {
-  if (MTL_PMD_DPDK_USER == mt_get_user_params(impl)->pmd[port])
-    return false;
-  else
+  if (MTL_PMD_DPDK_AF_XDP == mt_get_user_params(impl)->pmd[port])
     return true;
+  else
+    return false;
 }
 
 static inline bool mt_pmd_is_af_xdp(struct mtl_main_impl* impl, enum mtl_port port) {
@@ -932,6 +1268,25 @@ static inline bool mt_pmd_is_af_xdp(struct mtl_main_impl* impl, enum mtl_port po
     return false;
 }
 
+static inline bool mt_pmd_is_loopback(struct mtl_main_impl* impl, enum mtl_port port) {
+  if (MTL_PMD_DPDK_LOOPBACK == mt_get_user_params(impl)->pmd[port])
+    return true;
+  else
+    return false;
+}
+
+static inline bool mt_pmd_is_pcap(struct mtl_main_impl* impl, enum mtl_port port) {
+  if (MTL_PMD_DPDK_PCAP == mt_get_user_params(impl)->pmd[port])
+    return true;
+  else
+    return false;
+}
+
+/* sw port without a NIC behind: one queue, no hw flow, no rl and no phc */
+static inline bool mt_pmd_is_virtual(struct mtl_main_impl* impl, enum mtl_port port) {
+  return mt_pmd_is_loopback(impl, port) || mt_pmd_is_pcap(impl, port);
+}
+
 static inline int mt_num_ports(struct mtl_main_impl* impl) {
   return RTE_MIN(mt_get_user_params(impl)->num_ports, MTL_PORT_MAX);
 }
@@ -984,6 +1339,27 @@ static inline bool mt_has_ebu(struct mtl_main_impl* impl) {
     return false;
 }
 
+static inline bool mt_has_cni_rx_timestamp(struct mtl_main_impl* impl) {
+  if (mt_get_user_params(impl)->flags & MTL_FLAG_CNI_RX_TIMESTAMP)
+    return true;
+  else
+    return false;
+}
+
+static inline bool mt_has_frame_arena(struct mtl_main_impl* impl) {
+  if (mt_get_user_params(impl)->flags & MTL_FLAG_FRAME_ARENA)
+    return true;
+  else
+    return false;
+}
+
+static inline bool mt_has_telemetry_shm(struct mtl_main_impl* impl) {
+  if (mt_get_user_params(impl)->flags & MTL_FLAG_TELEMETRY_SHM)
+    return true;
+  else
+    return false;
+}
+
 static inline bool mt_has_rxv_separate_sch(struct mtl_main_impl* impl) {
   if (mt_get_user_params(impl)->flags & MTL_FLAG_RX_SEPARATE_VIDEO_LCORE)
     return true;
@@ -991,6 +1367,20 @@ static inline bool mt_has_rxv_separate_sch(struct mtl_main_impl* impl) {
     return false;
 }
 
+static inline bool mt_has_tasklet_balance(struct mtl_main_impl* impl) {
+  if (mt_get_user_params(impl)->flags & MTL_FLAG_TASKLET_BALANCE)
+    return true;
+  else
+    return false;
+}
+
+static inline bool mt_has_sch_quota_auto(struct mtl_main_impl* impl) {
+  if (mt_get_user_params(impl)->flags & MTL_FLAG_SCH_QUOTA_AUTO)
+    return true;
+  else
+    return false;
+}
+
 static inline bool mt_has_tx_video_migrate(struct mtl_main_impl* impl) {
   if (mt_get_user_params(impl)->flags & MTL_FLAG_TX_VIDEO_MIGRATE)
     return true;
@@ -1084,6 +1474,9 @@ static inline bool mt_st2110_transport(struct mtl_main_impl* impl, enum mtl_port
 static inline bool mt_shared_queue(struct mtl_main_impl* impl, enum mtl_port port) {
   if (mt_get_user_params(impl)->flags & MTL_FLAG_SHARED_QUEUE)
     return true;
+  /* virtual port has only one queue, the flows are steered by the rsq */
+  else if (mt_pmd_is_virtual(impl, port))
+    return true;
   else
     return false;
 }
@@ -0,0 +1,333 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include "mt_map.h"
+
+// #define DEBUG
+#include "mt_log.h"
+#include "mt_stat.h"
+
+static inline struct mt_map_mgr* mt_get_map_mgr(struct mtl_main_impl* impl) {
+  return &impl->map_mgr;
+}
+
+static inline void* map_node_end(struct mt_map_node* node) {
+  return node->item.vaddr + node->item.size;
+}
+
+static inline int map_node_height(struct mt_map_node* node) {
+  return node ? node->height : 0;
+}
+
+static void map_node_update(struct mt_map_node* node) {
+  void* max_end = map_node_end(node);
+
+  node->height = 1 + RTE_MAX(map_node_height(node->left), map_node_height(node->right));
+  if (node->left && (node->left->max_end > max_end)) max_end = node->left->max_end;
+  if (node->right && (node->right->max_end > max_end)) max_end = node->right->max_end;
+  node->max_end = max_end;
+}
+
+static struct mt_map_node* map_rotate_right(struct mt_map_node* node) {
+  struct mt_map_node* left = node->left;
+
+  node->left = left->right;
+  left->right = node;
+  map_node_update(node);
+  map_node_update(left);
+  return left;
+}
+
+static struct mt_map_node* map_rotate_left(struct mt_map_node* node) {
+  struct mt_map_node* right = node->right;
+
+  node->right = right->left;
+  right->left = node;
+  map_node_update(node);
+  map_node_update(right);
+  return right;
+}
+
+static struct mt_map_node* map_balance(struct mt_map_node* node) {
+  int bf;
+
+  map_node_update(node);
+  bf = map_node_height(node->left) - map_node_height(node->right);
+  if (bf > 1) {
+    if (map_node_height(node->left->left) < map_node_height(node->left->right))
+      node->left = map_rotate_left(node->left);
+    return map_rotate_right(node);
+  }
+  if (bf < -1) {
+    if (map_node_height(node->right->right) < map_node_height(node->right->left))
+      node->right = map_rotate_right(node->right);
+    return map_rotate_left(node);
+  }
+  return node;
+}
+
+static struct mt_map_node* map_insert(struct mt_map_node* root, struct mt_map_node* node) {
+  if (!root) return node;
+
+  if (node->item.vaddr < root->item.vaddr)
+    root->left = map_insert(root->left, node);
+  else
+    root->right = map_insert(root->right, node);
+  return map_balance(root);
+}
+
+static struct mt_map_node* map_remove_min(struct mt_map_node* root,
+                                          struct mt_map_node** min) {
+  if (!root->left) {
+    *min = root;
+    return root->right;
+  }
+  root->left = map_remove_min(root->left, min);
+  return map_balance(root);
+}
+
+static struct mt_map_node* map_remove(struct mt_map_node* root, void* vaddr,
+                                      struct mt_map_node** out) {
+  struct mt_map_node *left, *right, *min;
+
+  if (!root) return NULL;
+
+  if (vaddr < root->item.vaddr) {
+    root->left = map_remove(root->left, vaddr, out);
+  } else if (vaddr > root->item.vaddr) {
+    root->right = map_remove(root->right, vaddr, out);
+  } else {
+    *out = root;
+    left = root->left;
+    right = root->right;
+    if (!right) return left;
+    right = map_remove_min(right, &min);
+    min->left = left;
+    min->right = right;
+    return map_balance(min);
+  }
+  return map_balance(root);
+}
+
+static struct mt_map_node* map_find(struct mt_map_node* node, void* vaddr) {
+  while (node) {
+    if (vaddr == node->item.vaddr) return node;
+    node = (vaddr < node->item.vaddr) ? node->left : node->right;
+  }
+  return NULL;
+}
+
+/* find any node overlap with [start, end) */
+static struct mt_map_node* map_find_overlap(struct mt_map_node* node, void* start,
+                                            void* end) {
+  struct mt_map_node* found;
+
+  if (!node || (node->max_end <= start)) return NULL;
+
+  found = map_find_overlap(node->left, start, end);
+  if (found) return found;
+  if (node->item.vaddr >= end) return NULL; /* all in right start after end */
+  if (map_node_end(node) > start) return node;
+  return map_find_overlap(node->right, start, end);
+}
+
+static void map_free_tree(struct mt_map_node* node) {
+  if (!node) return;
+
+  map_free_tree(node->left);
+  map_free_tree(node->right);
+  warn("%s, still active, vaddr %p size %" PRIu64 "\n", __func__, node->item.vaddr,
+       node->item.size);
+  mt_rte_free(node);
+}
+
+/* first fit, the low holes are the freed ranges so they get reused first */
+static int map_iova_alloc(struct mt_map_mgr* mgr, size_t size, mtl_iova_t* iova) {
+  struct mt_map_hole* hole;
+
+  for (int i = 0; i < mgr->nb_holes; i++) {
+    hole = &mgr->holes[i];
+    if ((hole->end - hole->start) < size) continue;
+
+    *iova = hole->start;
+    hole->start += size;
+    if (i < (mgr->nb_holes - 1)) mgr->stat_iova_reuse++;
+    if (hole->start == hole->end) {
+      memmove(hole, hole + 1, sizeof(*hole) * (mgr->nb_holes - i - 1));
+      mgr->nb_holes--;
+    }
+    return 0;
+  }
+
+  return -ENOMEM;
+}
+
+static void map_iova_free(struct mt_map_mgr* mgr, mtl_iova_t iova, size_t size) {
+  mtl_iova_t end = iova + size;
+  struct mt_map_hole* holes = mgr->holes;
+  int lo = 0, hi = mgr->nb_holes, mid;
+  bool merge_prev, merge_next;
+
+  /* the first hole start after iova */
+  while (lo < hi) {
+    mid = (lo + hi) / 2;
+    if (holes[mid].start < iova)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  merge_prev = (lo > 0) && (holes[lo - 1].end == iova);
+  merge_next = (lo < mgr->nb_holes) && (holes[lo].start == end);
+  if (merge_prev && merge_next) {
+    holes[lo - 1].end = holes[lo].end;
+    memmove(&holes[lo], &holes[lo + 1], sizeof(*holes) * (mgr->nb_holes - lo - 1));
+    mgr->nb_holes--;
+  } else if (merge_prev) {
+    holes[lo - 1].end = end;
+  } else if (merge_next) {
+    holes[lo].start = iova;
+  } else {
+    /* never overflow as the holes is at most nb_items + 1 */
+    memmove(&holes[lo + 1], &holes[lo], sizeof(*holes) * (mgr->nb_holes - lo));
+    holes[lo].start = iova;
+    holes[lo].end = end;
+    mgr->nb_holes++;
+  }
+}
+
+static int map_stat(void* priv) {
+  struct mt_map_mgr* mgr = priv;
+
+  mt_pthread_mutex_lock(&mgr->mutex);
+  if (mgr->nb_items) {
+    notice("MAP: items %d holes %d iova reuse %" PRIu64 "\n", mgr->nb_items,
+           mgr->nb_holes, mgr->stat_iova_reuse);
+  }
+  mt_pthread_mutex_unlock(&mgr->mutex);
+  return 0;
+}
+
+int mt_map_add(struct mtl_main_impl* impl, struct mt_map_item* item) {
+  struct mt_map_mgr* mgr = mt_get_map_mgr(impl);
+  void* start = item->vaddr;
+  void* end = start + item->size;
+  struct mt_map_node* node;
+  mtl_iova_t iova;
+  int ret;
+
+  if (!item->size) {
+    err("%s, invalid size for %p\n", __func__, start);
+    return -EINVAL;
+  }
+
+  mt_pthread_mutex_lock(&mgr->mutex);
+
+  if (mgr->nb_items >= MT_MAP_MAX_ITEMS) {
+    err("%s, no space, all items are used\n", __func__);
+    mt_pthread_mutex_unlock(&mgr->mutex);
+    return -EIO;
+  }
+
+  /* first check if any conflict with exist mapping */
+  node = map_find_overlap(mgr->root, start, end);
+  if (node) {
+    err("%s, invalid start %p end %p, conflict with i_start %p i_end %p\n", __func__,
+        start, end, node->item.vaddr, map_node_end(node));
+    mt_pthread_mutex_unlock(&mgr->mutex);
+    return -EINVAL;
+  }
+
+  node = mt_rte_zmalloc_socket(sizeof(*node), mt_socket_id(impl, MTL_PORT_P));
+  if (!node) {
+    err("%s, node malloc fail\n", __func__);
+    mt_pthread_mutex_unlock(&mgr->mutex);
+    return -ENOMEM;
+  }
+
+  ret = map_iova_alloc(mgr, item->size, &iova);
+  if (ret < 0) {
+    err("%s, no iova space for size %" PRIu64 "\n", __func__, item->size);
+    mt_rte_free(node);
+    mt_pthread_mutex_unlock(&mgr->mutex);
+    return ret;
+  }
+  item->iova = iova;
+
+  node->item = *item;
+  node->height = 1;
+  node->max_end = end;
+  mgr->root = map_insert(mgr->root, node);
+  mgr->nb_items++;
+  mt_pthread_mutex_unlock(&mgr->mutex);
+
+  info("%s, start %p end %p iova 0x%" PRIx64 "\n", __func__, start, end, iova);
+  return 0;
+}
+
+int mt_map_remove(struct mtl_main_impl* impl, struct mt_map_item* item) {
+  struct mt_map_mgr* mgr = mt_get_map_mgr(impl);
+  void* start = item->vaddr;
+  void* end = start + item->size;
+  struct mt_map_node* node = NULL;
+
+  mt_pthread_mutex_lock(&mgr->mutex);
+
+  node = map_find(mgr->root, start);
+  if (!node || (node->item.size != item->size) || (node->item.iova != item->iova)) {
+    err("%s, unknown items start %p end %p iova %" PRIx64 "\n", __func__, start, end,
+        item->iova);
+    mt_pthread_mutex_unlock(&mgr->mutex);
+    return -EIO;
+  }
+
+  mgr->root = map_remove(mgr->root, start, &node);
+  map_iova_free(mgr, node->item.iova, node->item.size);
+  mgr->nb_items--;
+  mt_pthread_mutex_unlock(&mgr->mutex);
+
+  info("%s, start %p end %p iova 0x%" PRIx64 "\n", __func__, start, end, item->iova);
+  mt_rte_free(node);
+  return 0;
+}
+
+int mt_map_init(struct mtl_main_impl* impl) {
+  struct mt_map_mgr* mgr = mt_get_map_mgr(impl);
+
+  /* n items split the iova space into n + 1 holes at most */
+  mgr->holes = mt_rte_zmalloc_socket(sizeof(*mgr->holes) * (MT_MAP_MAX_ITEMS + 1),
+                                     mt_socket_id(impl, MTL_PORT_P));
+  if (!mgr->holes) {
+    err("%s, holes malloc fail\n", __func__);
+    return -ENOMEM;
+  }
+  mgr->holes[0].start = MT_MAP_IOVA_START;
+  mgr->holes[0].end = MT_MAP_IOVA_END;
+  mgr->nb_holes = 1;
+  mgr->root = NULL;
+  mgr->nb_items = 0;
+
+  mt_pthread_mutex_init(&mgr->mutex, NULL);
+  mt_stat_register(impl, map_stat, mgr);
+
+  return 0;
+}
+
+int mt_map_uinit(struct mtl_main_impl* impl) {
+  struct mt_map_mgr* mgr = mt_get_map_mgr(impl);
+
+  if (!mgr->holes) return 0; /* not init */
+
+  mt_stat_unregister(impl, map_stat, mgr);
+
+  map_free_tree(mgr->root);
+  mgr->root = NULL;
+  mgr->nb_items = 0;
+  mt_rte_free(mgr->holes);
+  mgr->holes = NULL;
+
+  mt_pthread_mutex_destroy(&mgr->mutex);
+
+  return 0;
+}
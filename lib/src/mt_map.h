@@ -0,0 +1,18 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _MT_LIB_MAP_HEAD_H_
+#define _MT_LIB_MAP_HEAD_H_
+
+#include "mt_main.h"
+
+int mt_map_init(struct mtl_main_impl* impl);
+int mt_map_uinit(struct mtl_main_impl* impl);
+
+/* insert the vaddr range and pick a free iova for it, result in item->iova */
+int mt_map_add(struct mtl_main_impl* impl, struct mt_map_item* item);
+/* remove the vaddr range and give back the iova */
+int mt_map_remove(struct mtl_main_impl* impl, struct mt_map_item* item);
+
+#endif
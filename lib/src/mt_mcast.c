@@ -7,6 +7,7 @@
 #include "mt_dev.h"
 #include "mt_log.h"
 #include "mt_socket.h"
+#include "mt_stat.h"
 #include "mt_util.h"
 
 #define MT_MCAST_POOL_INC (32)
@@ -17,7 +18,8 @@ static inline struct mt_mcast_impl* get_mcast(struct mtl_main_impl* impl,
 }
 
 /* Computing the Internet Checksum based on rfc1071 */
-static uint16_t mcast_msg_checksum(enum mcast_msg_type type, void* msg, uint16_t num) {
+static uint16_t mcast_msg_checksum(enum mcast_msg_type type, void* msg,
+                                   size_t records_len) {
   size_t size = 0;
 
   switch (type) {
@@ -25,8 +27,7 @@ static uint16_t mcast_msg_checksum(enum mcast_msg_type type, void* msg, uint16_t
       size = sizeof(struct mcast_mb_query_v3);
       break;
     case MEMBERSHIP_REPORT_V3:
-      size = (sizeof(struct mcast_mb_report_v3_wo_gr) +
-              num * sizeof(struct mcast_group_record));
+      size = sizeof(struct mcast_mb_report_v3_wo_gr) + records_len;
       break;
     default:
       err("%s, wrong mcast msg type: %d\n", __func__, type);
@@ -39,13 +40,21 @@ static uint16_t mcast_msg_checksum(enum mcast_msg_type type, void* msg, uint16_t
 /* group record shaping, refer to RFC3376 - 4.2.4 */
 static inline void mcast_create_group_record(uint32_t group_addr,
                                              enum mcast_group_record_type type,
-                                             struct mcast_group_record* group_record) {
+                                             struct mcast_group_record* group_record,
+                                             uint32_t* sources, uint16_t num_sources) {
+  uint32_t* source_addr = (uint32_t*)&group_record[1];
+
   group_record->record_type = type;
   group_record->aux_data_len = 0;
-  group_record->num_sources = 0;  // not specify source
+  group_record->num_sources = htons(num_sources);
   group_record->multicast_addr = group_addr;
-  // group_record.source_addr = 0;
-  // group_record.auxiliary_data = 0;
+  for (uint16_t i = 0; i < num_sources; i++) source_addr[i] = sources[i];
+}
+
+static inline uint32_t mcast_group_hash(uint32_t group_addr) {
+  uint32_t h = group_addr * 0x9e3779b1;
+
+  return (h ^ (h >> 16)) & (MT_MCAST_GROUP_HASH_SIZE - 1);
 }
 
 /* 224.0.0.22 */
@@ -120,27 +129,21 @@ int mcast_membership_general_query(struct mtl_main_impl* impl, enum mtl_port por
   return 0;
 }
 
-/* membership report shaping, refer to RFC3376 - 4.2 */
-static int mcast_membership_report(struct mtl_main_impl* impl,
-                                   enum mcast_group_record_type type,
-                                   enum mtl_port port) {
-  struct mt_mcast_impl* mcast = get_mcast(impl, port);
-  uint16_t group_num = mcast->group_num;
+/* the report pkts in building, a new pkt is used if the records exceed the mtu */
+struct mcast_report_ctx {
+  struct rte_mbuf* pkt;
+  struct mcast_mb_report_v3_wo_gr* mb_report;
+  size_t records_len;
+  uint16_t num_records;
+};
+
+static int mcast_report_alloc(struct mtl_main_impl* impl, enum mtl_port port,
+                              struct mcast_report_ctx* ctx) {
   struct rte_mbuf* pkt;
   struct rte_ether_hdr* eth_hdr;
   struct rte_ipv4_hdr* ip_hdr;
   struct mcast_mb_report_v3_wo_gr* mb_report;
-  struct mcast_group_record* group_records;
   size_t hdr_offset = 0;
-  size_t mb_report_len = sizeof(struct mcast_mb_report_v3_wo_gr) +
-                         group_num * sizeof(struct mcast_group_record);
-
-  if (group_num <= 0) {
-    dbg("%s(%d), no group to join\n", __func__, port);
-    return 0;
-  }
-
-  dbg("%s(%d), group_num: %d\n", __func__, port, group_num);
 
   pkt = rte_pktmbuf_alloc(mt_get_tx_mempool(impl, port));
   if (!pkt) {
@@ -160,7 +163,6 @@ static int mcast_membership_report(struct mtl_main_impl* impl,
   ip_hdr->type_of_service = IP_IGMP_DSCP_VALUE;
   ip_hdr->fragment_offset = MT_IP_DONT_FRAGMENT_FLAG;
   ip_hdr->hdr_checksum = 0;
-  ip_hdr->total_length = htons(sizeof(struct rte_ipv4_hdr) + mb_report_len);
   ip_hdr->next_proto_id = IGMP_PROTOCOL;
   ip_hdr->src_addr = *(uint32_t*)mt_sip_addr(impl, port);
   inet_pton(AF_INET, IGMP_REPORT_IP, &ip_hdr->dst_addr);
@@ -171,20 +173,41 @@ static int mcast_membership_report(struct mtl_main_impl* impl,
   mb_report->reserved_1 = 0x00;
   mb_report->checksum = 0x00;
   mb_report->reserved_2 = 0x00;
-  mb_report->num_group_records = htons(group_num);
-  hdr_offset += sizeof(struct mcast_mb_report_v3_wo_gr);
-  group_records = rte_pktmbuf_mtod_offset(pkt, struct mcast_group_record*, hdr_offset);
-  for (int i = 0; i < group_num; i++) {
-    mcast_create_group_record(mcast->group_ip[i], type, &group_records[i]);
-  }
-  uint16_t checksum = mcast_msg_checksum(MEMBERSHIP_REPORT_V3, mb_report, group_num);
+
+  ctx->pkt = pkt;
+  ctx->mb_report = mb_report;
+  ctx->records_len = 0;
+  ctx->num_records = 0;
+  return 0;
+}
+
+static int mcast_report_send(struct mtl_main_impl* impl, enum mtl_port port,
+                             struct mcast_report_ctx* ctx) {
+  struct mt_mcast_impl* mcast = get_mcast(impl, port);
+  struct rte_mbuf* pkt = ctx->pkt;
+  struct mcast_mb_report_v3_wo_gr* mb_report = ctx->mb_report;
+  size_t mb_report_len = sizeof(*mb_report) + ctx->records_len;
+  struct rte_ipv4_hdr* ip_hdr;
+
+  if (!pkt) return 0;
+  ctx->pkt = NULL;
+
+  dbg("%s(%d), num_records: %u\n", __func__, port, ctx->num_records);
+  mb_report->num_group_records = htons(ctx->num_records);
+  uint16_t checksum =
+      mcast_msg_checksum(MEMBERSHIP_REPORT_V3, mb_report, ctx->records_len);
   if (checksum <= 0) {
     err("%s, err checksum %d\n", __func__, checksum);
+    rte_pktmbuf_free(pkt);
     return -EIO;
   }
   dbg("%s, checksum %d\n", __func__, checksum);
   mb_report->checksum = htons(checksum);
 
+  ip_hdr =
+      rte_pktmbuf_mtod_offset(pkt, struct rte_ipv4_hdr*, sizeof(struct rte_ether_hdr));
+  ip_hdr->total_length = htons(sizeof(struct rte_ipv4_hdr) + mb_report_len);
+
   mt_mbuf_init_ipv4(pkt);
   pkt->pkt_len = pkt->l2_len + pkt->l3_len + mb_report_len;
   pkt->data_len = pkt->pkt_len;
@@ -203,9 +226,90 @@ static int mcast_membership_report(struct mtl_main_impl* impl,
     return -EIO;
   }
 
+  mcast->stat_report_pkts++;
+  mcast->stat_report_records += ctx->num_records;
+  return 0;
+}
+
+static int mcast_report_add(struct mtl_main_impl* impl, enum mtl_port port,
+                            struct mcast_report_ctx* ctx,
+                            enum mcast_group_record_type type, uint32_t group_addr,
+                            uint32_t* sources, uint16_t num_sources) {
+  size_t record_len = sizeof(struct mcast_group_record) + num_sources * sizeof(*sources);
+  int ret;
+
+  /* no space in current pkt */
+  if (ctx->pkt && (sizeof(*ctx->mb_report) + ctx->records_len + record_len >
+                   IGMP_REPORT_MAX_LEN)) {
+    ret = mcast_report_send(impl, port, ctx);
+    if (ret < 0) return ret;
+  }
+  if (!ctx->pkt) {
+    ret = mcast_report_alloc(impl, port, ctx);
+    if (ret < 0) return ret;
+  }
+
+  struct mcast_group_record* group_record =
+      (struct mcast_group_record*)((uint8_t*)&ctx->mb_report[1] + ctx->records_len);
+  mcast_create_group_record(group_addr, type, group_record, sources, num_sources);
+  ctx->records_len += record_len;
+  ctx->num_records++;
   return 0;
 }
 
+/* membership report shaping, refer to RFC3376 - 4.2 */
+static int mcast_membership_report(struct mtl_main_impl* impl, enum mtl_port port) {
+  struct mt_mcast_impl* mcast = get_mcast(impl, port);
+  struct mcast_report_ctx ctx;
+  struct mt_mcast_group* group;
+  struct mt_mcast_leave* leave;
+  uint32_t sources[MT_MCAST_SOURCE_MAX];
+  int ret = 0;
+
+  memset(&ctx, 0, sizeof(ctx));
+  mt_pthread_mutex_lock(&mcast->group_mutex);
+  if (!mcast->group_num && !mcast->leave_num) {
+    mt_pthread_mutex_unlock(&mcast->group_mutex);
+    dbg("%s(%d), no group to join\n", __func__, port);
+    return 0;
+  }
+
+  dbg("%s(%d), group_num: %u\n", __func__, port, mcast->group_num);
+  /* current state records */
+  for (int i = 0; i < MT_MCAST_GROUP_HASH_SIZE && ret >= 0; i++) {
+    for (group = mcast->groups[i]; group && ret >= 0; group = group->next) {
+      if (group->ref_cnt) { /* any source */
+        ret = mcast_report_add(impl, port, &ctx, MCAST_MODE_IS_EXCLUDE, group->ip, NULL,
+                               0);
+        continue;
+      }
+      for (uint16_t s = 0; s < group->source_num; s++)
+        sources[s] = group->sources[s].ip;
+      ret = mcast_report_add(impl, port, &ctx, MCAST_MODE_IS_INCLUDE, group->ip,
+                             sources, group->source_num);
+    }
+  }
+  /* state change records for the leave */
+  for (uint16_t i = 0; i < mcast->leave_num && ret >= 0; i++) {
+    leave = &mcast->leaves[i];
+    if (leave->source)
+      ret = mcast_report_add(impl, port, &ctx, MCAST_BLOCK_OLD_SOURCES, leave->group,
+                             &leave->source, 1);
+    else
+      ret = mcast_report_add(impl, port, &ctx, MCAST_CHANGE_TO_INCLUDE_MODE,
+                             leave->group, NULL, 0);
+  }
+  mcast->leave_num = 0;
+  mcast->last_report_ns = mt_get_monotonic_time();
+  mt_pthread_mutex_unlock(&mcast->group_mutex);
+
+  if (ret < 0) {
+    if (ctx.pkt) rte_pktmbuf_free(ctx.pkt);
+    return ret;
+  }
+  return mcast_report_send(impl, port, &ctx);
+}
+
 static void mcast_membership_report_cb(void* param) {
   struct mtl_main_impl* impl = (struct mtl_main_impl*)param;
   int num_ports = mt_num_ports(impl);
@@ -213,7 +317,7 @@ static void mcast_membership_report_cb(void* param) {
 
   for (int port = 0; port < num_ports; port++) {
     if (!mt_pmd_is_kernel(impl, port)) {
-      ret = mcast_membership_report(impl, MCAST_MODE_IS_EXCLUDE, port);
+      ret = mcast_membership_report(impl, port);
       if (ret < 0) {
         err("%s(%d), mcast_membership_report fail %d\n", __func__, port, ret);
       }
@@ -224,6 +328,63 @@ static void mcast_membership_report_cb(void* param) {
   if (ret < 0) err("%s, set igmp alarm fail %d\n", __func__, ret);
 }
 
+static void mcast_state_change_cb(void* param) {
+  struct mt_mcast_impl* mcast = param;
+  enum mtl_port port = mcast->port;
+  int ret;
+
+  mt_pthread_mutex_lock(&mcast->group_mutex);
+  mcast->report_pending = false;
+  mt_pthread_mutex_unlock(&mcast->group_mutex);
+
+  ret = mcast_membership_report(mcast->parent, port);
+  if (ret < 0) err("%s(%d), mcast_membership_report fail %d\n", __func__, port, ret);
+}
+
+/*
+ * report the state change, rate limited to one report every IGMP_REPORT_MIN_INTERVAL_MS
+ * and all the join/leave in the interval are merged to it.
+ */
+static int mcast_state_change(struct mt_mcast_impl* mcast) {
+  uint64_t interval_us = IGMP_REPORT_MIN_INTERVAL_MS * 1000;
+  uint64_t elapsed_us;
+  uint64_t delay_us = 1;
+  int ret = 0;
+
+  if (mt_pmd_is_kernel(mcast->parent, mcast->port)) return 0;
+
+  mt_pthread_mutex_lock(&mcast->group_mutex);
+  if (mcast->report_pending) {
+    mcast->stat_report_limited++;
+    mt_pthread_mutex_unlock(&mcast->group_mutex);
+    return 0;
+  }
+  elapsed_us = (mt_get_monotonic_time() - mcast->last_report_ns) / NS_PER_US;
+  if (elapsed_us < interval_us) delay_us = interval_us - elapsed_us;
+  ret = rte_eal_alarm_set(delay_us, mcast_state_change_cb, mcast);
+  if (ret >= 0)
+    mcast->report_pending = true;
+  else
+    err("%s(%d), set report alarm fail %d\n", __func__, mcast->port, ret);
+  mt_pthread_mutex_unlock(&mcast->group_mutex);
+
+  return ret;
+}
+
+static int mcast_stat(void* priv) {
+  struct mt_mcast_impl* mcast = priv;
+
+  if (!mcast->group_num && !mcast->stat_report_pkts) return 0;
+
+  notice("MCAST(%d): %u groups, report pkts %u records %u limited %u\n", mcast->port,
+         mcast->group_num, mcast->stat_report_pkts, mcast->stat_report_records,
+         mcast->stat_report_limited);
+  mcast->stat_report_pkts = 0;
+  mcast->stat_report_records = 0;
+  mcast->stat_report_limited = 0;
+  return 0;
+}
+
 static int mcast_addr_pool_extend(struct mt_interface* inf) {
   struct rte_ether_addr* mc_list;
   size_t mc_list_size;
@@ -327,6 +488,10 @@ int mt_mcast_init(struct mtl_main_impl* impl) {
     }
 
     mt_pthread_mutex_init(&mcast->group_mutex, NULL);
+    mcast->port = i;
+    mcast->soc_id = socket;
+    mcast->parent = impl;
+    mt_stat_register(impl, mcast_stat, mcast);
 
     /* assign arp instance */
     impl->mcast[i] = mcast;
@@ -342,11 +507,24 @@ int mt_mcast_init(struct mtl_main_impl* impl) {
 
 int mt_mcast_uinit(struct mtl_main_impl* impl) {
   int num_ports = mt_num_ports(impl);
+  struct mt_mcast_group* group;
+
+  int ret = rte_eal_alarm_cancel(mcast_membership_report_cb, impl);
+  if (ret < 0) err("%s, alarm cancel fail %d\n", __func__, ret);
 
   for (int i = 0; i < num_ports; i++) {
     struct mt_mcast_impl* mcast = get_mcast(impl, i);
     if (!mcast) continue;
 
+    rte_eal_alarm_cancel(mcast_state_change_cb, mcast);
+    mt_stat_unregister(impl, mcast_stat, mcast);
+
+    for (int b = 0; b < MT_MCAST_GROUP_HASH_SIZE; b++) {
+      while ((group = mcast->groups[b])) {
+        mcast->groups[b] = group->next;
+        mt_rte_free(group);
+      }
+    }
     mt_pthread_mutex_destroy(&mcast->group_mutex);
 
     /* free the memory */
@@ -354,99 +532,218 @@ int mt_mcast_uinit(struct mtl_main_impl* impl) {
     impl->mcast[i] = NULL;
   }
 
-  int ret = rte_eal_alarm_cancel(mcast_membership_report_cb, impl);
-  if (ret < 0) err("%s, alarm cancel fail %d\n", __func__, ret);
-
   dbg("%s, succ\n", __func__);
   return 0;
 }
 
-/* add a group address to the group ip list */
-int mt_mcast_join(struct mtl_main_impl* impl, uint32_t group_addr, enum mtl_port port) {
+/* below mcast_group_* helpers need the group mutex */
+static struct mt_mcast_group* mcast_group_find(struct mt_mcast_impl* mcast,
+                                               uint32_t group_addr) {
+  struct mt_mcast_group* group = mcast->groups[mcast_group_hash(group_addr)];
+
+  while (group) {
+    if (group->ip == group_addr) return group;
+    group = group->next;
+  }
+
+  return NULL;
+}
+
+static struct mt_mcast_group* mcast_group_add(struct mt_mcast_impl* mcast,
+                                              uint32_t group_addr) {
+  struct mt_mcast_group* group;
+  uint32_t h;
+
+  if (mcast->group_num >= MT_MCAST_GROUP_MAX) {
+    err("%s(%d), reach max multicast group number %u\n", __func__, mcast->port,
+        mcast->group_num);
+    return NULL;
+  }
+
+  group = mt_rte_zmalloc_socket(sizeof(*group), mcast->soc_id);
+  if (!group) {
+    err("%s(%d), group malloc fail\n", __func__, mcast->port);
+    return NULL;
+  }
+  group->ip = group_addr;
+
+  h = mcast_group_hash(group_addr);
+  group->next = mcast->groups[h];
+  mcast->groups[h] = group;
+  mcast->group_num++;
+  return group;
+}
+
+static void mcast_group_del(struct mt_mcast_impl* mcast, struct mt_mcast_group* group) {
+  struct mt_mcast_group** prev = &mcast->groups[mcast_group_hash(group->ip)];
+
+  while (*prev) {
+    if (*prev == group) {
+      *prev = group->next;
+      mcast->group_num--;
+      mt_rte_free(group);
+      return;
+    }
+    prev = &(*prev)->next;
+  }
+}
+
+static struct mt_mcast_source* mcast_group_source(struct mt_mcast_group* group,
+                                                  uint32_t source_addr) {
+  for (uint16_t i = 0; i < group->source_num; i++) {
+    if (group->sources[i].ip == source_addr) return &group->sources[i];
+  }
+
+  return NULL;
+}
+
+static void mcast_leave_record(struct mt_mcast_impl* mcast, uint32_t group_addr,
+                               uint32_t source_addr) {
+  /* the switch will timeout it anyway if no space */
+  if (mcast->leave_num >= MT_MCAST_LEAVE_MAX) {
+    dbg("%s(%d), leave records full\n", __func__, mcast->port);
+    return;
+  }
+
+  mcast->leaves[mcast->leave_num].group = group_addr;
+  mcast->leaves[mcast->leave_num].source = source_addr;
+  mcast->leave_num++;
+}
+
+/* add a group address to the group list */
+int mt_mcast_join(struct mtl_main_impl* impl, uint32_t group_addr, uint32_t source_addr,
+                  enum mtl_port port) {
   struct mt_mcast_impl* mcast = get_mcast(impl, port);
   struct rte_ether_addr mcast_mac;
   struct mt_interface* inf = mt_if(impl, port);
-  int group_num = mcast->group_num;
+  struct mt_mcast_group* group;
+  struct mt_mcast_source* source = NULL;
   uint8_t* ip = (uint8_t*)&group_addr;
+  uint8_t* sip = (uint8_t*)&source_addr;
+  bool new_group = false;
+  bool new_source = false;
   int ret;
 
-  if (group_num >= MT_MCAST_GROUP_MAX) {
-    err("%s, reach max multicast group number!\n", __func__);
-    return -EIO;
-  }
-
   mt_pthread_mutex_lock(&mcast->group_mutex);
-  for (int i = 0; i < group_num; ++i) {
-    if (mcast->group_ip[i] == group_addr) {
-      mcast->group_ref_cnt[i]++;
+  group = mcast_group_find(mcast, group_addr);
+  if (!group) {
+    if (mt_pmd_is_kernel(impl, port)) {
+      /* the kernel join is any source */
+      ret = mt_socket_join_mcast(impl, port, group_addr);
+      if (ret < 0) {
+        mt_pthread_mutex_unlock(&mcast->group_mutex);
+        err("%s(%d), fail(%d) to join socket group %d.%d.%d.%d\n", __func__, port, ret,
+            ip[0], ip[1], ip[2], ip[3]);
+        return ret;
+      }
+    }
+    group = mcast_group_add(mcast, group_addr);
+    if (!group) {
+      if (mt_pmd_is_kernel(impl, port)) mt_socket_drop_mcast(impl, port, group_addr);
       mt_pthread_mutex_unlock(&mcast->group_mutex);
-      info("%s(%d), group %d.%d.%d.%d ref cnt %u\n", __func__, port, ip[0], ip[1], ip[2],
-           ip[3], mcast->group_ref_cnt[i]);
-      return 0;
+      return -ENOMEM;
     }
+    new_group = true;
   }
-  if (mt_pmd_is_kernel(impl, port)) {
-    ret = mt_socket_join_mcast(impl, port, group_addr);
-    if (ret < 0) {
-      mt_pthread_mutex_unlock(&mcast->group_mutex);
-      err("%s(%d), fail(%d) to join socket group %d.%d.%d.%d\n", __func__, port, ret,
+
+  if (source_addr) {
+    source = mcast_group_source(group, source_addr);
+    if (source) {
+      source->ref_cnt++;
+    } else if (group->source_num < MT_MCAST_SOURCE_MAX) {
+      source = &group->sources[group->source_num++];
+      source->ip = source_addr;
+      source->ref_cnt = 1;
+      new_source = true;
+    } else {
+      err("%s(%d), reach max source number for group %d.%d.%d.%d\n", __func__, port,
           ip[0], ip[1], ip[2], ip[3]);
-      return ret;
+      if (new_group) mcast_group_del(mcast, group);
+      mt_pthread_mutex_unlock(&mcast->group_mutex);
+      return -ENOSPC;
     }
+    info("%s(%d), group %d.%d.%d.%d source %d.%d.%d.%d ref cnt %u\n", __func__, port,
+         ip[0], ip[1], ip[2], ip[3], sip[0], sip[1], sip[2], sip[3], source->ref_cnt);
+  } else {
+    group->ref_cnt++;
+    if (!new_group)
+      info("%s(%d), group %d.%d.%d.%d ref cnt %u\n", __func__, port, ip[0], ip[1], ip[2],
+           ip[3], group->ref_cnt);
   }
-  mcast->group_ip[group_num] = group_addr;
-  mcast->group_ref_cnt[group_num] = 1;
-  mcast->group_num++;
   mt_pthread_mutex_unlock(&mcast->group_mutex);
 
-  /* add mcast mac to interface */
-  mt_mcast_ip_to_mac(ip, &mcast_mac);
-  mcast_inf_add_mac(inf, &mcast_mac);
-
-  /* report to switch to join group */
-  if (!mt_pmd_is_kernel(impl, port)) {
-    mcast_membership_report(impl, MCAST_MODE_IS_EXCLUDE, port);
+  if (new_group) {
+    /* add mcast mac to interface */
+    mt_mcast_ip_to_mac(ip, &mcast_mac);
+    mcast_inf_add_mac(inf, &mcast_mac);
+    info("%s(%d), new group %d.%d.%d.%d\n", __func__, port, ip[0], ip[1], ip[2], ip[3]);
   }
 
-  info("%s(%d), new group %d.%d.%d.%d\n", __func__, port, ip[0], ip[1], ip[2], ip[3]);
+  /* report to switch to join group, only a new source or group change the state */
+  if (new_group || new_source) mcast_state_change(mcast);
   return 0;
 }
 
-/* not implement fast leave report for IGMPv3, just stop sending join report, */
-/* after a while the switch will delete the port in the multicast group */
-int mt_mcast_leave(struct mtl_main_impl* impl, uint32_t group_addr, enum mtl_port port) {
+int mt_mcast_leave(struct mtl_main_impl* impl, uint32_t group_addr, uint32_t source_addr,
+                   enum mtl_port port) {
   struct mt_mcast_impl* mcast = get_mcast(impl, port);
-  int group_num = mcast->group_num;
   struct mt_interface* inf = mt_if(impl, port);
   uint8_t* ip = (uint8_t*)&group_addr;
   struct rte_ether_addr mcast_mac;
+  struct mt_mcast_group* group;
+  struct mt_mcast_source* source;
+  bool changed = false;
 
   mt_pthread_mutex_lock(&mcast->group_mutex);
-  /* search the group ip list and delete the addr */
-  for (int i = 0; i < group_num; ++i) {
-    if (mcast->group_ip[i] == group_addr) {
-      dbg("%s, found group ip in the group list, delete it\n", __func__);
-      mcast->group_ref_cnt[i]--;
-      info("%s(%d), group %d.%d.%d.%d ref cnt %u\n", __func__, port, ip[0], ip[1], ip[2],
-           ip[3], mcast->group_ref_cnt[i]);
-      if (mcast->group_ref_cnt[i]) {
-        mt_pthread_mutex_unlock(&mcast->group_mutex);
-        return 0;
-      }
-      mcast->group_ip[i] = mcast->group_ip[group_num - 1];
-      mcast->group_num--;
-      if (mt_pmd_is_kernel(impl, port)) {
-        mt_socket_drop_mcast(impl, port, group_addr);
-      }
+  group = mcast_group_find(mcast, group_addr);
+  if (!group) {
+    mt_pthread_mutex_unlock(&mcast->group_mutex);
+    warn("%s, group ip not found, nothing to delete\n", __func__);
+    return 0;
+  }
+
+  if (source_addr) {
+    source = mcast_group_source(group, source_addr);
+    if (!source) {
       mt_pthread_mutex_unlock(&mcast->group_mutex);
-      /* remove mcast mac from interface */
-      mt_mcast_ip_to_mac(ip, &mcast_mac);
-      mcast_inf_remove_mac(inf, &mcast_mac);
+      warn("%s(%d), source not found, nothing to delete\n", __func__, port);
       return 0;
     }
+    source->ref_cnt--;
+    if (!source->ref_cnt) {
+      /* move the last one to this slot */
+      *source = group->sources[group->source_num - 1];
+      group->source_num--;
+      /* block the source if still in include mode */
+      if (!group->ref_cnt && group->source_num) {
+        mcast_leave_record(mcast, group_addr, source_addr);
+        changed = true;
+      }
+    }
+  } else if (group->ref_cnt) {
+    group->ref_cnt--;
+  }
+  info("%s(%d), group %d.%d.%d.%d ref cnt %u sources %u\n", __func__, port, ip[0], ip[1],
+       ip[2], ip[3], group->ref_cnt, group->source_num);
+
+  if (group->ref_cnt || group->source_num) {
+    mt_pthread_mutex_unlock(&mcast->group_mutex);
+    if (changed) mcast_state_change(mcast);
+    return 0;
+  }
+
+  dbg("%s, found group ip in the group list, delete it\n", __func__);
+  mcast_group_del(mcast, group);
+  /* IGMPv3 leave: change to include mode with no source */
+  mcast_leave_record(mcast, group_addr, 0);
+  if (mt_pmd_is_kernel(impl, port)) {
+    mt_socket_drop_mcast(impl, port, group_addr);
   }
   mt_pthread_mutex_unlock(&mcast->group_mutex);
-  warn("%s, group ip not found, nothing to delete\n", __func__);
+  /* remove mcast mac from interface */
+  mt_mcast_ip_to_mac(ip, &mcast_mac);
+  mcast_inf_remove_mac(inf, &mcast_mac);
+  mcast_state_change(mcast);
   return 0;
 }
 
@@ -460,7 +757,7 @@ int mt_mcast_restore(struct mtl_main_impl* impl, enum mtl_port port) {
     for (uint32_t i = 0; i < inf->mcast_nb; i++)
       rte_eth_dev_mac_addr_add(port_id, &inf->mcast_mac_lists[i], 0);
   }
-  mcast_membership_report(impl, MCAST_MODE_IS_EXCLUDE, port);
+  mcast_membership_report(impl, port);
   return 0;
 }
 
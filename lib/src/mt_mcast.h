@@ -15,6 +15,10 @@
 #define IGMP_QUERY_IP "224.0.0.1"
 #define IGMP_JOIN_GROUP_PERIOD_S (10)
 #define IGMP_JOIN_GROUP_PERIOD_US (IGMP_JOIN_GROUP_PERIOD_S * US_PER_S)
+/* min interval between two state change reports, the join/leave in it are merged */
+#define IGMP_REPORT_MIN_INTERVAL_MS (100)
+/* max igmp msg len in one report pkt, split to more pkts if more records */
+#define IGMP_REPORT_MAX_LEN (MTL_MTU_MAX_BYTES - sizeof(struct rte_ipv4_hdr))
 
 enum mcast_msg_type {
   MEMBERSHIP_QUERY = 0x11,
@@ -74,8 +78,11 @@ struct mcast_mb_query_v3 {
 
 int mt_mcast_init(struct mtl_main_impl* impl);
 int mt_mcast_uinit(struct mtl_main_impl* impl);
-int mt_mcast_join(struct mtl_main_impl* impl, uint32_t group_addr, enum mtl_port port);
-int mt_mcast_leave(struct mtl_main_impl* impl, uint32_t group_addr, enum mtl_port port);
+/* source_addr is the sender for the SSM(S,G) join, 0 for any source */
+int mt_mcast_join(struct mtl_main_impl* impl, uint32_t group_addr, uint32_t source_addr,
+                  enum mtl_port port);
+int mt_mcast_leave(struct mtl_main_impl* impl, uint32_t group_addr, uint32_t source_addr,
+                   enum mtl_port port);
 int mt_mcast_restore(struct mtl_main_impl* impl, enum mtl_port port);
 int mt_mcast_l2_join(struct mtl_main_impl* impl, struct rte_ether_addr* addr,
                      enum mtl_port port);
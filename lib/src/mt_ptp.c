@@ -9,6 +9,7 @@
 // #define DEBUG
 #include "mt_log.h"
 #include "mt_mcast.h"
+#include "mt_ptp_servo.h"
 #include "mt_sch.h"
 #include "mt_stat.h"
 #include "mt_util.h"
@@ -29,6 +30,12 @@ static char* ptp_mode_strs[MT_PTP_MAX_MODE] = {
     "l4",
 };
 
+static const struct mt_metric_desc ptp_metric_descs[MT_PTP_METRIC_MAX] = {
+    [MT_PTP_METRIC_SYNC] = {"sync", MTL_METRIC_COUNTER},
+    [MT_PTP_METRIC_OFFSET_NS] = {"offset_ns", MTL_METRIC_GAUGE},
+    [MT_PTP_METRIC_PATH_DELAY_NS] = {"path_delay_ns", MTL_METRIC_GAUGE},
+};
+
 static inline char* ptp_mode_str(enum mt_ptp_l_mode mode) { return ptp_mode_strs[mode]; }
 
 static inline uint64_t ptp_net_tmstamp_to_ns(struct mt_ptp_tmstamp* ts) {
@@ -193,11 +200,22 @@ static void ptp_result_reset(struct mt_ptp_impl* ptp) {
   ptp->expect_result_avg = 0;
 }
 
+/* no sync in time, keep the clock running with the freq of the servo */
+static void ptp_servo_holdover(struct mt_ptp_impl* ptp) {
+  ptp->coefficient = mt_ptp_servo_holdover(ptp->servo, mt_get_monotonic_time());
+}
+
 static void ptp_monitor_handler(void* param) {
   struct mt_ptp_impl* ptp = param;
   uint64_t expect_result_period_us = ptp->expect_result_period_ns / 1000;
 
   ptp->stat_sync_timeout_err++;
+  if (ptp->servo) {
+    ptp_servo_holdover(ptp);
+    if (expect_result_period_us)
+      rte_eal_alarm_set(expect_result_period_us, ptp_monitor_handler, ptp);
+    return;
+  }
   if (ptp->expect_result_avg && expect_result_period_us) {
     ptp_adjust_delta(ptp, ptp->expect_result_avg);
     dbg("%s(%d), next timer %" PRIu64 "\n", __func__, ptp->port, expect_result_period_us);
@@ -212,7 +230,11 @@ static void ptp_sync_timeout_handler(void* param) {
   ptp_expect_result_clear(ptp);
   ptp_t_result_clear(ptp);
   ptp->stat_sync_timeout_err++;
-  if (ptp->expect_result_avg) {
+  if (ptp->servo) {
+    ptp_servo_holdover(ptp);
+    if (expect_result_period_us)
+      rte_eal_alarm_set(expect_result_period_us, ptp_monitor_handler, ptp);
+  } else if (ptp->expect_result_avg) {
     ptp_adjust_delta(ptp, ptp->expect_result_avg);
     dbg("%s(%d), next timer %" PRIu64 "\n", __func__, ptp->port, expect_result_period_us);
     if (expect_result_period_us) {
@@ -221,7 +243,65 @@ static void ptp_sync_timeout_handler(void* param) {
   }
 }
 
+/* the offset with the filtered path delay, the servo do the outlier and freq */
+static int ptp_servo_result(struct mt_ptp_impl* ptp) {
+  struct mt_ptp_servo* servo = ptp->servo;
+  int64_t t21 = (int64_t)ptp->t2 - ptp->t1;
+  int64_t t43 = (int64_t)ptp->t4 - ptp->t3;
+  int64_t path_delay, offset, adj;
+  uint64_t local_ns = ptp->t2 - ptp->ptp_delta;
+  double coefficient;
+  uint64_t now;
+  int ret;
+
+  /* cancel the monitor */
+  rte_eal_alarm_cancel(ptp_sync_timeout_handler, ptp);
+  rte_eal_alarm_cancel(ptp_monitor_handler, ptp);
+
+  ret = mt_ptp_servo_delay(servo, (t21 + t43) / 2, &path_delay);
+  if (ret < 0) {
+    dbg("%s(%d), invalid path delay %" PRId64 "\n", __func__, ptp->port,
+        (t21 + t43) / 2);
+    ptp->stat_result_err++;
+    ptp_t_result_clear(ptp);
+    return ret;
+  }
+  ptp->stat_path_delay_min = RTE_MIN(path_delay, ptp->stat_path_delay_min);
+  ptp->stat_path_delay_max = RTE_MAX(path_delay, ptp->stat_path_delay_max);
+  ptp->stat_path_delay_cnt++;
+  ptp->stat_path_delay_sum += path_delay;
+  mt_metric_set(ptp->metrics, MT_PTP_METRIC_PATH_DELAY_NS, path_delay);
+
+  /* local - master */
+  offset = t21 - path_delay;
+  ret = mt_ptp_servo_sample(servo, local_ns, offset, offset - ptp->ptp_delta, &adj,
+                            &coefficient);
+  ptp_t_result_clear(ptp);
+  if (ret < 0) {
+    ptp->stat_result_err++;
+    return ret;
+  }
+  ptp->stat_correct_delta_min = RTE_MIN(offset, ptp->stat_correct_delta_min);
+  ptp->stat_correct_delta_max = RTE_MAX(offset, ptp->stat_correct_delta_max);
+  ptp->stat_correct_delta_cnt++;
+  ptp->stat_correct_delta_sum += labs(offset);
+  mt_metric_set(ptp->metrics, MT_PTP_METRIC_OFFSET_NS, offset);
+
+  ptp_adjust_delta(ptp, adj);
+  ptp->coefficient = coefficient;
+  ptp->last_sync_ts = ptp_get_raw_time(ptp);
+
+  /* the sync period for the holdover monitor */
+  now = mt_get_monotonic_time();
+  if (ptp->expect_result_start_ns)
+    ptp->expect_result_period_ns = now - ptp->expect_result_start_ns;
+  ptp->expect_result_start_ns = now;
+  return 0;
+}
+
 static int ptp_parse_result(struct mt_ptp_impl* ptp) {
+  if (ptp->servo) return ptp_servo_result(ptp);
+
   int64_t delta = ((int64_t)ptp->t4 - ptp->t3) - ((int64_t)ptp->t2 - ptp->t1);
   int64_t path_delay = ((int64_t)ptp->t2 - ptp->t1) + ((int64_t)ptp->t4 - ptp->t3);
   uint64_t abs_delta, expect_delta;
@@ -246,6 +326,8 @@ static int ptp_parse_result(struct mt_ptp_impl* ptp) {
   ptp->stat_path_delay_max = RTE_MAX(path_delay, ptp->stat_path_delay_max);
   ptp->stat_path_delay_cnt++;
   ptp->stat_path_delay_sum += labs(path_delay);
+  mt_metric_set(ptp->metrics, MT_PTP_METRIC_OFFSET_NS, correct_delta);
+  mt_metric_set(ptp->metrics, MT_PTP_METRIC_PATH_DELAY_NS, path_delay);
 
   /* cancel the monitor */
   rte_eal_alarm_cancel(ptp_sync_timeout_handler, ptp);
@@ -443,7 +525,7 @@ static void ptp_delay_req_handler(void* param) {
 #endif
 
 static int ptp_parse_sync(struct mt_ptp_impl* ptp, struct mt_ptp_sync_msg* msg, bool vlan,
-                          enum mt_ptp_l_mode mode, uint16_t timesync) {
+                          enum mt_ptp_l_mode mode, uint16_t timesync, uint64_t hw_rx_ns) {
   struct timespec timestamp;
   int ret;
   uint16_t port_id = ptp->port_id;
@@ -451,6 +533,7 @@ static int ptp_parse_sync(struct mt_ptp_impl* ptp, struct mt_ptp_sync_msg* msg,
 #define RX_MAX_DELTA (1 * 1000 * 1000) /* 1ms */
 
   ptp->stat_sync_cnt++;
+  mt_metric_add(ptp->metrics, MT_PTP_METRIC_SYNC, 1);
 
   uint64_t monitor_period_us = ptp->expect_result_period_ns / 1000 / 2;
   if (monitor_period_us) {
@@ -466,10 +549,14 @@ static int ptp_parse_sync(struct mt_ptp_impl* ptp, struct mt_ptp_sync_msg* msg,
     rte_eal_alarm_set(monitor_period_us, ptp_sync_timeout_handler, ptp);
   }
 
-  ptp_timesync_lock(ptp);
-  ret = rte_eth_timesync_read_rx_timestamp(port_id, &timestamp, timesync);
-  if (ret >= 0) rx_ns = mt_timespec_to_ns(&timestamp);
-  ptp_timesync_unlock(ptp);
+  if (hw_rx_ns) { /* already in the mbuf, raw nic time without the adjust delta */
+    rx_ns = hw_rx_ns + ptp->ptp_delta;
+  } else {
+    ptp_timesync_lock(ptp);
+    ret = rte_eth_timesync_read_rx_timestamp(port_id, &timestamp, timesync);
+    if (ret >= 0) rx_ns = mt_timespec_to_ns(&timestamp);
+    ptp_timesync_unlock(ptp);
+  }
 
 #if MT_PTP_CHECK_TX_TIME_STAMP
   uint64_t ptp_ns = 0, delta;
@@ -519,34 +606,126 @@ static int ptp_parse_follow_up(struct mt_ptp_impl* ptp,
   return 0;
 }
 
-static int ptp_parse_announce(struct mt_ptp_impl* ptp, struct mt_ptp_announce_msg* msg,
-                              enum mt_ptp_l_mode mode, struct mt_ptp_ipv4_udp* ipv4_hdr) {
-  enum mtl_port port = ptp->port;
+static inline bool ptp_foreign_master_stale(struct mt_ptp_foreign_master* fm,
+                                            uint64_t now) {
+  return (now - fm->last_ns) > fm->receipt_timeout_ns;
+}
+
+static void ptp_print_foreign_master(enum mtl_port port, const char* tag,
+                                     struct mt_ptp_foreign_master* fm) {
+  uint8_t* id = &fm->gm_identity.id[0];
+  info(
+      "%s(%d), domain %u prio1 %u class %u accuracy 0x%x variance 0x%x prio2 %u "
+      "steps %u, gm: %02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x\n",
+      tag, port, fm->domain_number, fm->priority1, fm->clock_class, fm->clock_accuracy,
+      fm->offset_scaled_log_variance, fm->priority2, fm->steps_removed, id[0], id[1],
+      id[2], id[3], id[4], id[5], id[6], id[7]);
+}
+
+/* IEEE 1588 dataset comparison, <0 if a is better than b */
+static int ptp_bmca_compare(struct mt_ptp_foreign_master* a,
+                            struct mt_ptp_foreign_master* b) {
+  int gm_cmp = memcmp(&a->gm_identity, &b->gm_identity, sizeof(a->gm_identity));
+
+  if (gm_cmp) {
+    if (a->priority1 != b->priority1) return a->priority1 - b->priority1;
+    if (a->clock_class != b->clock_class) return a->clock_class - b->clock_class;
+    if (a->clock_accuracy != b->clock_accuracy)
+      return a->clock_accuracy - b->clock_accuracy;
+    if (a->offset_scaled_log_variance != b->offset_scaled_log_variance)
+      return a->offset_scaled_log_variance - b->offset_scaled_log_variance;
+    if (a->priority2 != b->priority2) return a->priority2 - b->priority2;
+    return gm_cmp;
+  }
+
+  /* same grandmaster, the shorter path then the sender identity */
+  if (a->steps_removed != b->steps_removed) return a->steps_removed - b->steps_removed;
+  return memcmp(&a->port_id, &b->port_id, sizeof(a->port_id));
+}
+
+static struct mt_ptp_foreign_master* ptp_bmca_best(struct mt_ptp_impl* ptp,
+                                                   uint64_t now) {
+  struct mt_ptp_foreign_master* best = NULL;
+  struct mt_ptp_foreign_master* fm;
+
+  for (int i = 0; i < MT_PTP_FOREIGN_MASTER_MAX; i++) {
+    fm = &ptp->foreign[i];
+    if (!fm->used) continue;
+    if (ptp_foreign_master_stale(fm, now)) continue;
+    if (ptp->domain_fixed && (fm->domain_number != ptp->domain_number)) continue;
+    /* a new master need the qualification, the first one is used directly */
+    if (ptp->master && (fm != ptp->master) &&
+        (fm->announce_cnt < MT_PTP_FOREIGN_MASTER_THRESHOLD))
+      continue;
+    if (!best || (ptp_bmca_compare(fm, best) < 0)) best = fm;
+  }
+
+  return best;
+}
+
+/* the slot for the announce sender, reuse the stale or the oldest one if full */
+static struct mt_ptp_foreign_master* ptp_foreign_master_get(struct mt_ptp_impl* ptp,
+                                                            struct mt_ptp_port_id* id,
+                                                            uint64_t now) {
+  struct mt_ptp_foreign_master* fm;
+  struct mt_ptp_foreign_master* slot = NULL;
 
-  if (!ptp->master_initialized) {
-    ptp->master_initialized = true;
-    ptp->master_utc_offset = ntohs(msg->current_utc_offset);
-    rte_memcpy(&ptp->master_port_id, &msg->hdr.source_port_identity,
-               sizeof(ptp->master_port_id));
-    rte_memcpy(&ptp->master_addr.addr_bytes[0], &ptp->master_port_id.clock_identity.id[0],
-               3);
-    rte_memcpy(&ptp->master_addr.addr_bytes[3], &ptp->master_port_id.clock_identity.id[5],
-               3);
-    info("%s(%d), master initialized, mode %s utc_offset %d domain_number %d\n", __func__,
-         port, ptp_mode_str(mode), ptp->master_utc_offset, msg->hdr.domain_number);
-    ptp_print_port_id(port, &ptp->master_port_id);
-    if (mode == MT_PTP_L4) {
-      struct mt_ptp_ipv4_udp* dst_udp = &ptp->dst_udp;
-
-      rte_memcpy(dst_udp, ipv4_hdr, sizeof(*dst_udp));
-      rte_memcpy(&dst_udp->ip.src_addr, &ptp->sip_addr[0], MTL_IP_ADDR_LEN);
-      dst_udp->ip.total_length =
-          htons(sizeof(struct mt_ptp_ipv4_udp) + sizeof(struct mt_ptp_sync_msg));
-      dst_udp->ip.hdr_checksum = 0;
-      dst_udp->udp.dgram_len =
-          htons(sizeof(struct rte_udp_hdr) + sizeof(struct mt_ptp_sync_msg));
+  for (int i = 0; i < MT_PTP_FOREIGN_MASTER_MAX; i++) {
+    fm = &ptp->foreign[i];
+    if (fm->used && ptp_port_id_equal(&fm->port_id, id)) return fm;
+  }
+
+  for (int i = 0; i < MT_PTP_FOREIGN_MASTER_MAX; i++) {
+    fm = &ptp->foreign[i];
+    if (fm == ptp->master) continue; /* never evict the current master */
+    if (!fm->used || ptp_foreign_master_stale(fm, now)) {
+      slot = fm;
+      break;
     }
+    if (!slot || (fm->last_ns < slot->last_ns)) slot = fm;
+  }
 
+  memset(slot, 0, sizeof(*slot));
+  slot->used = true;
+  rte_memcpy(&slot->port_id, id, sizeof(slot->port_id));
+  return slot;
+}
+
+static void ptp_set_master(struct mt_ptp_impl* ptp, struct mt_ptp_foreign_master* fm) {
+  enum mtl_port port = ptp->port;
+  bool first = !ptp->master_initialized;
+
+  ptp->master = fm;
+  ptp->master_initialized = true;
+  ptp->master_utc_offset = fm->utc_offset;
+  if (!ptp->domain_fixed) {
+    /* follow the domain of first master */
+    ptp->domain_fixed = true;
+    ptp->domain_number = fm->domain_number;
+  }
+  rte_memcpy(&ptp->master_port_id, &fm->port_id, sizeof(ptp->master_port_id));
+  rte_memcpy(&ptp->master_addr.addr_bytes[0], &ptp->master_port_id.clock_identity.id[0],
+             3);
+  rte_memcpy(&ptp->master_addr.addr_bytes[3], &ptp->master_port_id.clock_identity.id[5],
+             3);
+  info("%s(%d), master %s, mode %s utc_offset %d domain_number %d\n", __func__, port,
+       first ? "initialized" : "changed", ptp_mode_str(fm->mode), ptp->master_utc_offset,
+       fm->domain_number);
+  ptp_print_port_id(port, &ptp->master_port_id);
+  ptp_print_foreign_master(port, __func__, fm);
+  if (fm->mode == MT_PTP_L4) {
+    struct mt_ptp_ipv4_udp* dst_udp = &ptp->dst_udp;
+
+    rte_memcpy(dst_udp, &fm->ipv4_udp, sizeof(*dst_udp));
+    rte_memcpy(&dst_udp->ip.src_addr, &ptp->sip_addr[0], MTL_IP_ADDR_LEN);
+    dst_udp->ip.total_length =
+        htons(sizeof(struct mt_ptp_ipv4_udp) + sizeof(struct mt_ptp_sync_msg));
+    dst_udp->ip.hdr_checksum = 0;
+    dst_udp->udp.dgram_len =
+        htons(sizeof(struct rte_udp_hdr) + sizeof(struct mt_ptp_sync_msg));
+  }
+
+  if (first) {
     /* point ptp fn to eth phc */
     if (mt_ptp_tsc_source(ptp->impl))
       warn("%s(%d), skip as ptp force to tsc\n", __func__, port);
@@ -554,8 +733,59 @@ static int ptp_parse_announce(struct mt_ptp_impl* ptp, struct mt_ptp_announce_ms
       warn("%s(%d), skip as user provide ptp source already\n", __func__, port);
     else
       mt_if(ptp->impl, port)->ptp_get_time_fn = ptp_from_eth;
+    return;
   }
 
+  /* drop the pending sync of the old master, the clock keep the freq */
+#if MT_PTP_USE_TX_TIMER
+  rte_eal_alarm_cancel(ptp_delay_req_handler, ptp);
+#endif
+  rte_eal_alarm_cancel(ptp_sync_timeout_handler, ptp);
+  rte_eal_alarm_cancel(ptp_monitor_handler, ptp);
+  ptp_t_result_clear(ptp);
+  ptp_expect_result_clear(ptp);
+  ptp_result_reset(ptp);
+  if (ptp->servo) mt_ptp_servo_reset(ptp->servo);
+  ptp->master_changes++;
+}
+
+static int ptp_parse_announce(struct mt_ptp_impl* ptp, struct mt_ptp_announce_msg* msg,
+                              enum mt_ptp_l_mode mode, struct mt_ptp_ipv4_udp* ipv4_hdr) {
+  uint64_t now = mt_get_monotonic_time();
+  struct mt_ptp_foreign_master* fm;
+  struct mt_ptp_foreign_master* best;
+  int8_t log_interval;
+
+  fm = ptp_foreign_master_get(ptp, &msg->hdr.source_port_identity, now);
+  if (fm->announce_cnt && ptp_foreign_master_stale(fm, now)) fm->announce_cnt = 0;
+  fm->announce_cnt++;
+  fm->last_ns = now;
+  fm->domain_number = msg->hdr.domain_number;
+  fm->priority1 = msg->grandmaster_priority1;
+  fm->priority2 = msg->grandmaster_priority2;
+  fm->clock_class = msg->grandmaster_clock_quality.clock_class;
+  fm->clock_accuracy = msg->grandmaster_clock_quality.clock_accuracy;
+  fm->offset_scaled_log_variance =
+      ntohs(msg->grandmaster_clock_quality.offset_scaled_log_variance);
+  rte_memcpy(&fm->gm_identity, &msg->grandmaster_identity, sizeof(fm->gm_identity));
+  fm->steps_removed = ntohs(msg->steps_removed);
+  fm->utc_offset = ntohs(msg->current_utc_offset);
+  fm->mode = mode;
+  if (mode == MT_PTP_L4) rte_memcpy(&fm->ipv4_udp, ipv4_hdr, sizeof(fm->ipv4_udp));
+  /* the receipt timeout is 3 announce interval */
+  log_interval = RTE_MIN(RTE_MAX(msg->hdr.log_message_interval, -3), 4);
+  fm->receipt_timeout_ns = MT_PTP_ANNOUNCE_RECEIPT_TIMEOUT * (uint64_t)NS_PER_S;
+  if (log_interval >= 0)
+    fm->receipt_timeout_ns <<= log_interval;
+  else
+    fm->receipt_timeout_ns >>= -log_interval;
+
+  /* the utc offset or the quality may change on current master */
+  if (fm == ptp->master) ptp->master_utc_offset = fm->utc_offset;
+
+  best = ptp_bmca_best(ptp, now);
+  if (best && (best != ptp->master)) ptp_set_master(ptp, best);
+
   return 0;
 }
 
@@ -685,6 +915,11 @@ static int ptp_init(struct mtl_main_impl* impl, struct mt_ptp_impl* ptp,
     info("%s(%d), use pi controller, kp %e, ki %e\n", __func__, port, ptp->kp, ptp->ki);
 
   struct mtl_init_params* p = mt_get_user_params(impl);
+  if (p->flags & MTL_FLAG_PTP_DOMAIN) {
+    ptp->domain_fixed = true;
+    ptp->domain_number = p->ptp_domain_number;
+    info("%s(%d), follow domain %u\n", __func__, port, ptp->domain_number);
+  }
   if (p->flags & MTL_FLAG_PTP_UNICAST_ADDR) {
     ptp->master_addr_mode = MT_PTP_UNICAST_ADDR;
     info("%s(%d), MT_PTP_UNICAST_ADDR\n", __func__, port);
@@ -724,13 +959,32 @@ static int ptp_init(struct mtl_main_impl* impl, struct mt_ptp_impl* ptp,
   }
 
   /* join mcast */
-  ret = mt_mcast_join(impl, mt_ip_to_u32(ptp->mcast_group_addr), port);
+  ret = mt_mcast_join(impl, mt_ip_to_u32(ptp->mcast_group_addr), 0, port);
   if (ret < 0) {
     err("%s(%d), join ptp multicast group fail\n", __func__, port);
     return ret;
   }
   mt_mcast_l2_join(impl, &ptp_l2_multicast_eaddr, port);
 
+  if (p->ptp_servo != MTL_PTP_SERVO_DEFAULT) {
+    ptp->servo = mt_rte_zmalloc_socket(sizeof(*ptp->servo), mt_socket_id(impl, port));
+    if (!ptp->servo) {
+      err("%s(%d), servo malloc fail\n", __func__, port);
+      return -ENOMEM;
+    }
+    ret = mt_ptp_servo_init(ptp->servo, p->ptp_servo, p->ptp_delay_filter,
+                            p->ptp_delay_filter_len);
+    if (ret < 0) {
+      err("%s(%d), servo init fail %d\n", __func__, port, ret);
+      mt_rte_free(ptp->servo);
+      ptp->servo = NULL;
+      return ret;
+    }
+    info("%s(%d), linreg servo, delay filter %s len %d\n", __func__, port,
+         (p->ptp_delay_filter == MTL_PTP_DELAY_FILTER_MIN) ? "min" : "median",
+         ptp->servo->delay_len);
+  }
+
   info("%s(%d), rx queue %d, sip: %d.%d.%d.%d\n", __func__, port,
        mt_dev_rx_queue_id(ptp->rx_queue), ip[0], ip[1], ip[2], ip[3]);
   return 0;
@@ -746,10 +1000,15 @@ static int ptp_uinit(struct mtl_main_impl* impl, struct mt_ptp_impl* ptp) {
   rte_eal_alarm_cancel(ptp_sync_timeout_handler, ptp);
   rte_eal_alarm_cancel(ptp_monitor_handler, ptp);
 
+  if (ptp->servo) {
+    mt_rte_free(ptp->servo);
+    ptp->servo = NULL;
+  }
+
   if (!mt_if_has_ptp(impl, port)) return 0;
 
   mt_mcast_l2_leave(impl, &ptp_l2_multicast_eaddr, port);
-  mt_mcast_leave(impl, mt_ip_to_u32(ptp->mcast_group_addr), port);
+  mt_mcast_leave(impl, mt_ip_to_u32(ptp->mcast_group_addr), 0, port);
 
   if (ptp->rx_queue) {
     mt_dev_put_rx_queue(impl, ptp->rx_queue);
@@ -761,7 +1020,7 @@ static int ptp_uinit(struct mtl_main_impl* impl, struct mt_ptp_impl* ptp) {
 }
 
 int mt_ptp_parse(struct mt_ptp_impl* ptp, struct mt_ptp_header* hdr, bool vlan,
-                 enum mt_ptp_l_mode mode, uint16_t timesync,
+                 enum mt_ptp_l_mode mode, uint16_t timesync, uint64_t hw_rx_ns,
                  struct mt_ptp_ipv4_udp* ipv4_hdr) {
   enum mtl_port port = ptp->port;
 
@@ -788,7 +1047,7 @@ int mt_ptp_parse(struct mt_ptp_impl* ptp, struct mt_ptp_header* hdr, bool vlan,
 
   switch (hdr->message_type) {
     case PTP_SYNC:
-      ptp_parse_sync(ptp, (struct mt_ptp_sync_msg*)hdr, vlan, mode, timesync);
+      ptp_parse_sync(ptp, (struct mt_ptp_sync_msg*)hdr, vlan, mode, timesync, hw_rx_ns);
       break;
     case PTP_FOLLOW_UP:
       ptp_parse_follow_up(ptp, (struct mt_ptp_follow_up_msg*)hdr);
@@ -869,6 +1128,27 @@ static int ptp_stat(void* priv) {
            ptp->stat_rx_sync_err, ptp->stat_tx_sync_err, ptp->stat_result_err);
   if (ptp->stat_sync_timeout_err)
     notice("PTP(%d): sync timeout %d\n", port, ptp->stat_sync_timeout_err);
+  uint64_t now = mt_get_monotonic_time();
+  struct mt_ptp_foreign_master* fm;
+  for (int i = 0; i < MT_PTP_FOREIGN_MASTER_MAX; i++) {
+    fm = &ptp->foreign[i];
+    if (!fm->used) continue;
+    notice("PTP(%d): %s%d, domain %u prio1 %u class %u prio2 %u steps %u%s\n", port,
+           (fm == ptp->master) ? "master" : "foreign", i, fm->domain_number,
+           fm->priority1, fm->clock_class, fm->priority2, fm->steps_removed,
+           ptp_foreign_master_stale(fm, now) ? " stale" : "");
+  }
+  if (ptp->master_changes)
+    notice("PTP(%d): master changes %u\n", port, ptp->master_changes);
+  if (ptp->servo) {
+    struct mt_ptp_servo* servo = ptp->servo;
+    notice("PTP(%d): servo %s, freq %.3fppb rms %.1fns, outlier %u reset %u hold %u\n",
+           port, mt_ptp_servo_state_name(servo), servo->freq * 1e9, servo->rms,
+           servo->stat_outlier, servo->stat_reset, servo->stat_holdover);
+    servo->stat_outlier = 0;
+    servo->stat_reset = 0;
+    servo->stat_holdover = 0;
+  }
   ptp_stat_clear(ptp);
 
   return 0;
@@ -877,11 +1157,14 @@ static int ptp_stat(void* priv) {
 int mt_ptp_init(struct mtl_main_impl* impl) {
   int num_ports = mt_num_ports(impl);
   int socket = mt_socket_id(impl, MTL_PORT_P);
+  char name[MTL_METRIC_NAME_MAX];
   int ret;
 
   for (int i = 0; i < num_ports; i++) {
     /* no ptp for kernel based pmd */
     if (mt_pmd_is_kernel(impl, i)) continue;
+    /* no phc on virtual port, the ptp time follow the system time */
+    if (mt_pmd_is_virtual(impl, i)) continue;
 
     struct mt_ptp_impl* ptp = mt_rte_zmalloc_socket(sizeof(*ptp), socket);
     if (!ptp) {
@@ -899,6 +1182,9 @@ int mt_ptp_init(struct mtl_main_impl* impl) {
     }
 
     mt_stat_register(impl, ptp_stat, ptp);
+    snprintf(name, sizeof(name), "ptp.%d", i);
+    ptp->metrics = mt_metric_register(impl, name, ptp_metric_descs, MT_PTP_METRIC_MAX,
+                                      socket);
 
     /* assign arp instance */
     impl->ptp[i] = ptp;
@@ -916,6 +1202,10 @@ int mt_ptp_uinit(struct mtl_main_impl* impl) {
     if (!ptp) continue;
 
     mt_stat_unregister(impl, ptp_stat, ptp);
+    if (ptp->metrics) {
+      mt_metric_unregister(impl, ptp->metrics);
+      ptp->metrics = NULL;
+    }
 
     ptp_uinit(impl, ptp);
 
@@ -936,6 +1226,43 @@ uint64_t mt_mbuf_hw_time_stamp(struct mtl_main_impl* impl, struct rte_mbuf* mbuf
   struct mt_ptp_impl* ptp = mt_get_ptp(impl, port);
   uint64_t time_stamp =
       *RTE_MBUF_DYNFIELD(mbuf, impl->dynfield_offset, rte_mbuf_timestamp_t*);
+  /* no phc on virtual port, the pcap port carry the capture time of the file */
+  if (!ptp) return time_stamp;
   time_stamp += ptp->ptp_delta;
   return ptp_correct_ts(ptp, time_stamp);
-}
\ No newline at end of file
+}
+
+int mt_ptp_get_master(struct mtl_main_impl* impl, enum mtl_port port,
+                      struct mtl_ptp_master_info* info) {
+  struct mt_ptp_impl* ptp = mt_get_ptp(impl, port);
+  struct mt_ptp_foreign_master* fm;
+
+  if (!ptp || !mt_if_has_ptp(impl, port)) {
+    err("%s(%d), no built-in ptp\n", __func__, port);
+    return -EINVAL;
+  }
+  fm = ptp->master;
+  if (!fm) {
+    dbg("%s(%d), no master selected\n", __func__, port);
+    return -EIO;
+  }
+
+  memset(info, 0, sizeof(*info));
+  rte_memcpy(info->gm_identity, &fm->gm_identity, sizeof(info->gm_identity));
+  rte_memcpy(info->master_identity, &fm->port_id.clock_identity,
+             sizeof(info->master_identity));
+  info->master_port_number = ntohs(fm->port_id.port_number);
+  info->domain_number = fm->domain_number;
+  info->priority1 = fm->priority1;
+  info->priority2 = fm->priority2;
+  info->clock_class = fm->clock_class;
+  info->clock_accuracy = fm->clock_accuracy;
+  info->offset_scaled_log_variance = fm->offset_scaled_log_variance;
+  info->steps_removed = fm->steps_removed;
+  info->utc_offset = fm->utc_offset;
+  for (int i = 0; i < MT_PTP_FOREIGN_MASTER_MAX; i++) {
+    if (ptp->foreign[i].used) info->foreign_master_cnt++;
+  }
+  info->master_changes = ptp->master_changes;
+  return 0;
+}
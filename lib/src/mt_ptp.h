@@ -11,6 +11,10 @@
 #define MT_PTP_DELAY_REQ_MONITOR_US (1000 * 1)
 #define MT_PTP_DELAY_STEP_US (10)
 #define MT_PTP_CLOCK_IDENTITY_MAGIC (0xfeff)
+/* announce interval count without announce before the master is stale */
+#define MT_PTP_ANNOUNCE_RECEIPT_TIMEOUT (3)
+/* announce count before a new master is qualified */
+#define MT_PTP_FOREIGN_MASTER_THRESHOLD (2)
 
 #define MT_PTP_STAT_INTERVAL_S (10) /* 10s */
 #define MT_PTP_STAT_INTERVAL_US (MT_PTP_STAT_INTERVAL_S * US_PER_S)
@@ -110,8 +114,12 @@ static inline struct mt_ptp_impl* mt_get_ptp(struct mtl_main_impl* impl,
 int mt_ptp_init(struct mtl_main_impl* impl);
 int mt_ptp_uinit(struct mtl_main_impl* impl);
 
+int mt_ptp_get_master(struct mtl_main_impl* impl, enum mtl_port port,
+                      struct mtl_ptp_master_info* info);
+
+/* hw_rx_ns is the hw rx timestamp from the mbuf, 0 to read it with the timesync index */
 int mt_ptp_parse(struct mt_ptp_impl* ptp, struct mt_ptp_header* hdr, bool vlan,
-                 enum mt_ptp_l_mode mode, uint16_t timesync,
+                 enum mt_ptp_l_mode mode, uint16_t timesync, uint64_t hw_rx_ns,
                  struct mt_ptp_ipv4_udp* ipv4_hdr);
 
 #endif
@@ -0,0 +1,203 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include "mt_ptp_servo.h"
+
+#include <math.h>
+
+// #define DEBUG
+#include "mt_log.h"
+
+static int64_t servo_delay_min(struct mt_ptp_servo* s) {
+  int64_t min = s->delay_win[0];
+
+  for (int i = 1; i < s->delay_cnt; i++) min = RTE_MIN(min, s->delay_win[i]);
+  return min;
+}
+
+static int64_t servo_delay_median(struct mt_ptp_servo* s) {
+  int64_t sorted[MT_PTP_DELAY_FILTER_MAX];
+  int n = s->delay_cnt;
+  int64_t v;
+  int j;
+
+  /* insertion sort, the window is small */
+  for (int i = 0; i < n; i++) {
+    v = s->delay_win[i];
+    for (j = i; (j > 0) && (sorted[j - 1] > v); j--) sorted[j] = sorted[j - 1];
+    sorted[j] = v;
+  }
+
+  if (n & 0x1) return sorted[n / 2];
+  return (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+}
+
+int mt_ptp_servo_delay(struct mt_ptp_servo* s, int64_t path_delay, int64_t* filtered) {
+  /* the timestamp is broken */
+  if (path_delay < 0) return -EINVAL;
+
+  s->delay_win[s->delay_idx] = path_delay;
+  s->delay_idx = (s->delay_idx + 1) % s->delay_len;
+  if (s->delay_cnt < s->delay_len) s->delay_cnt++;
+
+  if (s->delay_filter == MTL_PTP_DELAY_FILTER_MIN)
+    *filtered = servo_delay_min(s);
+  else
+    *filtered = servo_delay_median(s);
+
+  dbg("%s, path delay %" PRId64 " filtered %" PRId64 "\n", __func__, path_delay,
+      *filtered);
+  return 0;
+}
+
+static void servo_linreg_fit(struct mt_ptp_servo* s) {
+  int n = s->points_cnt;
+  /* relative to the latest point to keep the precision of double */
+  int latest = (s->points_idx + MT_PTP_LINREG_POINTS - 1) % MT_PTP_LINREG_POINTS;
+  struct mt_ptp_servo_point* ref = &s->points[latest];
+  double mx = 0, my = 0, sxx = 0, sxy = 0, dx, dy, r, rss = 0;
+  double intercept;
+
+  for (int i = 0; i < n; i++) {
+    mx += (double)(s->points[i].x - ref->x);
+    my += (double)(s->points[i].y - ref->y);
+  }
+  mx /= n;
+  my /= n;
+  for (int i = 0; i < n; i++) {
+    dx = (double)(s->points[i].x - ref->x) - mx;
+    dy = (double)(s->points[i].y - ref->y) - my;
+    sxx += dx * dx;
+    sxy += dx * dy;
+  }
+  if (sxx <= 0) return; /* all points at same time */
+
+  s->slope = sxy / sxx;
+  intercept = my - s->slope * mx;
+  for (int i = 0; i < n; i++) {
+    r = (double)(s->points[i].y - ref->y) -
+        (intercept + s->slope * (double)(s->points[i].x - ref->x));
+    rss += r * r;
+  }
+  s->rms = sqrt(rss / n);
+}
+
+/* the raw offset at local_ns predicted by the regression */
+static int64_t servo_linreg_predict(struct mt_ptp_servo* s, uint64_t local_ns) {
+  int latest = (s->points_idx + MT_PTP_LINREG_POINTS - 1) % MT_PTP_LINREG_POINTS;
+  struct mt_ptp_servo_point* ref = &s->points[latest];
+  double mx = 0, my = 0;
+  int n = s->points_cnt;
+
+  for (int i = 0; i < n; i++) {
+    mx += (double)(s->points[i].x - ref->x);
+    my += (double)(s->points[i].y - ref->y);
+  }
+  mx /= n;
+  my /= n;
+  return ref->y + (int64_t)(my + s->slope * ((double)((int64_t)local_ns - ref->x) - mx));
+}
+
+static void servo_linreg_add(struct mt_ptp_servo* s, uint64_t local_ns,
+                             int64_t raw_offset) {
+  s->points[s->points_idx].x = local_ns;
+  s->points[s->points_idx].y = raw_offset;
+  s->points_idx = (s->points_idx + 1) % MT_PTP_LINREG_POINTS;
+  if (s->points_cnt < MT_PTP_LINREG_POINTS) s->points_cnt++;
+  if (s->points_cnt >= 2) servo_linreg_fit(s);
+}
+
+int mt_ptp_servo_sample(struct mt_ptp_servo* s, uint64_t local_ns, int64_t offset,
+                        int64_t raw_offset, int64_t* adj, double* coefficient) {
+  bool from_holdover = (s->state == MT_PTP_SERVO_HOLDOVER);
+  int64_t predict, residual, gate;
+
+  if ((s->points_cnt >= MT_PTP_LINREG_MIN_POINTS) && !from_holdover) {
+    predict = servo_linreg_predict(s, local_ns);
+    residual = raw_offset - predict;
+    gate = RTE_MAX(MT_PTP_SERVO_OUTLIER_K * s->rms, MT_PTP_SERVO_OUTLIER_MIN_NS);
+    if (labs(residual) > gate) {
+      s->stat_outlier++;
+      s->outlier_cnt++;
+      dbg("%s, outlier residual %" PRId64 " gate %" PRId64 "\n", __func__, residual,
+          gate);
+      if (s->outlier_cnt <= MT_PTP_SERVO_OUTLIER_MAX) return -EIO;
+      /* too many continuous outliers, the master or the path is changed */
+      info("%s, reset as continuous outliers, residual %" PRId64 "\n", __func__,
+           residual);
+      mt_ptp_servo_reset(s);
+      s->stat_reset++;
+    }
+  }
+  s->outlier_cnt = 0;
+
+  servo_linreg_add(s, local_ns, raw_offset);
+  if (s->points_cnt >= MT_PTP_LINREG_MIN_POINTS) {
+    s->slope = RTE_MIN(RTE_MAX(s->slope, -MT_PTP_SERVO_MAX_FREQ), MT_PTP_SERVO_MAX_FREQ);
+    s->freq = s->slope;
+    /* use the smoothed offset if it's close, else step to the measured one */
+    if (labs(offset) < MT_PTP_SERVO_STEP_NS)
+      *adj = -(offset + (servo_linreg_predict(s, local_ns) - raw_offset));
+    else
+      *adj = -offset;
+    if (s->state != MT_PTP_SERVO_LOCKED)
+      info("%s, locked, freq %.3fppb rms %.1fns\n", __func__, s->freq * 1e9, s->rms);
+    s->state = MT_PTP_SERVO_LOCKED;
+  } else {
+    *adj = -offset;
+  }
+
+  *coefficient = 1.0 - s->freq;
+  return 0;
+}
+
+double mt_ptp_servo_holdover(struct mt_ptp_servo* s, uint64_t now_ns) {
+  if (s->state == MT_PTP_SERVO_LOCKED) {
+    s->state = MT_PTP_SERVO_HOLDOVER;
+    s->holdover_start_ns = now_ns;
+    s->stat_holdover++;
+    info("%s, enter holdover with freq %.3fppb\n", __func__, s->freq * 1e9);
+  } else if ((s->state == MT_PTP_SERVO_HOLDOVER) &&
+             ((now_ns - s->holdover_start_ns) > MT_PTP_SERVO_HOLDOVER_MAX_NS)) {
+    /* the regression is too old, relearn but keep the freq as the start point */
+    warn("%s, holdover timeout, freq %.3fppb\n", __func__, s->freq * 1e9);
+    mt_ptp_servo_reset(s);
+  }
+
+  return 1.0 - s->freq;
+}
+
+void mt_ptp_servo_reset(struct mt_ptp_servo* s) {
+  s->state = MT_PTP_SERVO_UNLOCKED;
+  s->points_cnt = 0;
+  s->points_idx = 0;
+  s->slope = s->freq;
+  s->rms = 0;
+  s->outlier_cnt = 0;
+  s->holdover_start_ns = 0;
+}
+
+int mt_ptp_servo_init(struct mt_ptp_servo* s, enum mtl_ptp_servo type,
+                      enum mtl_ptp_delay_filter filter, int delay_len) {
+  if ((type <= MTL_PTP_SERVO_DEFAULT) || (type >= MTL_PTP_SERVO_MAX)) {
+    err("%s, invalid servo type %d\n", __func__, type);
+    return -EINVAL;
+  }
+  if (filter >= MTL_PTP_DELAY_FILTER_MAX) {
+    err("%s, invalid delay filter %d\n", __func__, filter);
+    return -EINVAL;
+  }
+  if (!delay_len) delay_len = MT_PTP_DELAY_FILTER_DEFAULT;
+  if ((delay_len < 0) || (delay_len > MT_PTP_DELAY_FILTER_MAX)) {
+    err("%s, invalid delay filter len %d\n", __func__, delay_len);
+    return -EINVAL;
+  }
+
+  memset(s, 0, sizeof(*s));
+  s->type = type;
+  s->delay_filter = filter;
+  s->delay_len = delay_len;
+  mt_ptp_servo_reset(s);
+  return 0;
+}
@@ -0,0 +1,94 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _MT_LIB_PTP_SERVO_HEAD_H_
+#define _MT_LIB_PTP_SERVO_HEAD_H_
+
+#include "mt_main.h"
+
+#define MT_PTP_DELAY_FILTER_MAX (64)
+#define MT_PTP_DELAY_FILTER_DEFAULT (16)
+#define MT_PTP_LINREG_POINTS (16)
+/* min points before the regression is used */
+#define MT_PTP_LINREG_MIN_POINTS (4)
+/* step the phase directly if the offset bigger than this */
+#define MT_PTP_SERVO_STEP_NS (20 * 1000)
+/* the offset outlier gate: max(MT_PTP_SERVO_OUTLIER_K * rms, MIN) */
+#define MT_PTP_SERVO_OUTLIER_K (4)
+#define MT_PTP_SERVO_OUTLIER_MIN_NS (1000)
+/* reset the regression if too many continuous outliers, the master may step */
+#define MT_PTP_SERVO_OUTLIER_MAX (8)
+/* max frequency error of the local clock, 500ppm */
+#define MT_PTP_SERVO_MAX_FREQ (500e-6)
+/* unlock the servo if no sync for this time */
+#define MT_PTP_SERVO_HOLDOVER_MAX_NS (60ull * NS_PER_S)
+
+enum mt_ptp_servo_state {
+  MT_PTP_SERVO_UNLOCKED = 0,
+  MT_PTP_SERVO_LOCKED,
+  MT_PTP_SERVO_HOLDOVER,
+};
+
+struct mt_ptp_servo_point {
+  int64_t x; /* local time */
+  int64_t y; /* offset of the free running local clock to master */
+};
+
+struct mt_ptp_servo {
+  enum mtl_ptp_servo type;
+  enum mt_ptp_servo_state state;
+
+  /* path delay filter */
+  enum mtl_ptp_delay_filter delay_filter;
+  int delay_len;
+  int delay_cnt;
+  int delay_idx;
+  int64_t delay_win[MT_PTP_DELAY_FILTER_MAX];
+
+  /* linear regression of offset over local time */
+  struct mt_ptp_servo_point points[MT_PTP_LINREG_POINTS];
+  int points_cnt;
+  int points_idx;
+  double slope;    /* freq error of local to master */
+  double rms;      /* rms of the residual */
+  int outlier_cnt; /* continuous outlier */
+
+  /* holdover model */
+  double freq;                /* the last good freq error, used in holdover */
+  uint64_t holdover_start_ns; /* monotonic time */
+
+  /* stat */
+  uint32_t stat_outlier;
+  uint32_t stat_reset;
+  uint32_t stat_holdover;
+};
+
+int mt_ptp_servo_init(struct mt_ptp_servo* s, enum mtl_ptp_servo type,
+                      enum mtl_ptp_delay_filter filter, int delay_len);
+void mt_ptp_servo_reset(struct mt_ptp_servo* s);
+
+/* push one path delay sample and get the filtered one, <0 if the sample is invalid */
+int mt_ptp_servo_delay(struct mt_ptp_servo* s, int64_t path_delay, int64_t* filtered);
+
+/*
+ * feed one offset sample, offset is local - master and raw_offset is the offset with all
+ * the phase adjustment removed, local_ns is also the time without adjustment. Return <0
+ * if rejected as outlier, else the phase adjustment in adj and the freq ratio of master
+ * to local in coefficient.
+ */
+int mt_ptp_servo_sample(struct mt_ptp_servo* s, uint64_t local_ns, int64_t offset,
+                        int64_t raw_offset, int64_t* adj, double* coefficient);
+
+/*
+ * no sync in time, keep the last freq, return the freq ratio of master to local.
+ * now_ns is the monotonic time.
+ */
+double mt_ptp_servo_holdover(struct mt_ptp_servo* s, uint64_t now_ns);
+
+static inline const char* mt_ptp_servo_state_name(struct mt_ptp_servo* s) {
+  static const char* names[] = {"unlocked", "locked", "holdover"};
+  return names[s->state];
+}
+
+#endif
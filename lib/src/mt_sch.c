@@ -10,6 +10,12 @@
 #include "st2110/st_rx_video_session.h"
 #include "st2110/st_tx_video_session.h"
 
+static const struct mt_metric_desc sch_metric_descs[MT_SCH_METRIC_MAX] = {
+    [MT_SCH_METRIC_LOOPS] = {"loops", MTL_METRIC_COUNTER},
+    [MT_SCH_METRIC_SLEEP_NS] = {"sleep_ns", MTL_METRIC_COUNTER},
+    [MT_SCH_METRIC_SLEEP_RATIO] = {"sleep_ratio", MTL_METRIC_GAUGE},
+};
+
 static inline void sch_mgr_lock(struct mt_sch_mgr* mgr) {
   mt_pthread_mutex_lock(&mgr->mgr_mutex);
 }
@@ -76,6 +82,7 @@ static int sch_tasklet_sleep(struct mtl_main_impl* impl, struct mt_sch_impl* sch
   uint64_t delta = end - start;
   sch->stat_sleep_ns += delta;
   sch->stat_sleep_cnt++;
+  mt_metric_add(sch->metrics, MT_SCH_METRIC_SLEEP_NS, delta);
   sch->stat_sleep_ns_min = RTE_MIN(delta, sch->stat_sleep_ns_min);
   sch->stat_sleep_ns_max = RTE_MAX(delta, sch->stat_sleep_ns_max);
   /* cal cpu sleep ratio on every 5s */
@@ -88,6 +95,7 @@ static int sch_tasklet_sleep(struct mtl_main_impl* impl, struct mt_sch_impl* sch
         sch->sleep_ratio_start_ns);
     sch->sleep_ratio_score =
         (float)sch->sleep_ratio_sleep_ns * 100.0 / sleep_ratio_dur_ns;
+    mt_metric_set(sch->metrics, MT_SCH_METRIC_SLEEP_RATIO, sch->sleep_ratio_score);
     sch->sleep_ratio_sleep_ns = 0;
     sch->sleep_ratio_start_ns = end;
   }
@@ -103,7 +111,9 @@ static int sch_tasklet_func(void* args) {
   struct mt_sch_tasklet_ops* ops;
   struct mt_sch_tasklet_impl* tasklet;
   bool time_measure = mt_has_tasklet_time_measure(impl);
-  uint64_t tsc_s = 0;
+  bool balance = mt_sch_has_load_measure(impl);
+  uint64_t tsc_s = 0, cycles_s = 0, loop_tsc_s = 0;
+  int rv;
 
   num_tasklet = sch->max_tasklet_idx;
   info("%s(%d), start with %d tasklets\n", __func__, idx, num_tasklet);
@@ -127,27 +137,38 @@ static int sch_tasklet_func(void* args) {
   while (rte_atomic32_read(&sch->request_stop) == 0) {
     int pending = MT_TASKLET_ALL_DONE;
 
+    mt_metric_add(sch->metrics, MT_SCH_METRIC_LOOPS, 1);
+    if (time_measure) loop_tsc_s = mt_get_tsc(impl);
     num_tasklet = sch->max_tasklet_idx;
     for (i = 0; i < num_tasklet; i++) {
       tasklet = sch->tasklet[i];
       if (!tasklet) continue;
       if (tasklet->request_exit) {
-        tasklet->ack_exit = true;
         sch->tasklet[i] = NULL;
+        tasklet->ack_exit = true;
         dbg("%s(%d), tasklet %s(%d) exit\n", __func__, idx, tasklet->name, i);
         continue;
       }
       ops = &tasklet->ops;
       if (time_measure) tsc_s = mt_get_tsc(impl);
-      pending += ops->handler(ops->priv);
+      if (balance) cycles_s = rte_get_tsc_cycles();
+      rv = ops->handler(ops->priv);
+      pending += rv;
+      if (balance) {
+        tasklet->stat_cycles += rte_get_tsc_cycles() - cycles_s;
+        if (rv != MT_TASKLET_ALL_DONE) tasklet->stat_pending++;
+      }
       if (time_measure) {
-        uint32_t delta_us = (mt_get_tsc(impl) - tsc_s) / 1000;
+        uint64_t delta_ns = mt_get_tsc(impl) - tsc_s;
+        uint32_t delta_us = delta_ns / 1000;
+        mt_hist_add(&tasklet->stat_time_hist, delta_ns);
         tasklet->stat_max_time_us = RTE_MAX(tasklet->stat_max_time_us, delta_us);
         tasklet->stat_min_time_us = RTE_MIN(tasklet->stat_min_time_us, delta_us);
         tasklet->stat_sum_time_us += delta_us;
         tasklet->stat_time_cnt++;
       }
     }
+    if (time_measure) mt_hist_add(&sch->stat_loop_hist, mt_get_tsc(impl) - loop_tsc_s);
     if (sch->allow_sleep && (pending == MT_TASKLET_ALL_DONE)) {
       sch_tasklet_sleep(impl, sch);
     }
@@ -188,7 +209,7 @@ static int sch_start(struct mt_sch_impl* sch) {
   rte_atomic32_set(&sch->stopped, 0);
 
   if (!sch->run_in_thread) {
-    ret = mt_dev_get_lcore(sch->parent, &sch->lcore);
+    ret = mt_dev_get_lcore(sch->parent, sch->socket_id, &sch->lcore);
     if (ret < 0) {
       err("%s(%d), get lcore fail %d\n", __func__, idx, ret);
       sch_unlock(sch);
@@ -206,7 +227,8 @@ static int sch_start(struct mt_sch_impl* sch) {
 
   rte_atomic32_set(&sch->started, 1);
   if (!sch->run_in_thread)
-    info("%s(%d), succ on lcore %u\n", __func__, idx, sch->lcore);
+    info("%s(%d), succ on lcore %u socket %d\n", __func__, idx, sch->lcore,
+         sch->socket_id);
   else
     info("%s(%d), succ on tid %" PRIu64 "\n", __func__, idx, sch->tid);
   sch_unlock(sch);
@@ -244,8 +266,10 @@ static int sch_stop(struct mt_sch_impl* sch) {
 }
 
 static struct mt_sch_impl* sch_request(struct mtl_main_impl* impl, enum mt_sch_type type,
-                                       mt_sch_mask_t mask) {
+                                       mt_sch_mask_t mask, int socket) {
   struct mt_sch_impl* sch;
+  struct mt_sch_tasklet_impl** tasklet;
+  char name[MTL_METRIC_NAME_MAX];
 
   for (int sch_idx = 0; sch_idx < MT_MAX_SCH_NUM; sch_idx++) {
     /* mask check */
@@ -255,7 +279,23 @@ static struct mt_sch_impl* sch_request(struct mtl_main_impl* impl, enum mt_sch_t
 
     sch_lock(sch);
     if (!mt_sch_is_active(sch)) { /* find one free sch */
+      if (sch->socket_id != socket) {
+        /* move the tasklet array to the socket of the sessions */
+        tasklet = mt_rte_zmalloc_socket(sizeof(*tasklet) * sch->nb_tasklets, socket);
+        if (!tasklet) {
+          err("%s(%d), tasklet malloc fail on socket %d\n", __func__, sch_idx, socket);
+          sch_unlock(sch);
+          return NULL;
+        }
+        mt_rte_free(sch->tasklet);
+        sch->tasklet = tasklet;
+        sch->socket_id = socket;
+      }
       sch->type = type;
+      sch->load = 0;
+      snprintf(name, sizeof(name), "sch.%d", sch_idx);
+      sch->metrics = mt_metric_register(impl, name, sch_metric_descs,
+                                        MT_SCH_METRIC_MAX, sch->socket_id);
       rte_atomic32_inc(&sch->active);
       rte_atomic32_inc(&mt_sch_get_mgr(impl)->sch_cnt);
       sch_unlock(sch);
@@ -283,6 +323,10 @@ static int sch_free(struct mt_sch_impl* sch) {
       mt_sch_unregister_tasklet(sch->tasklet[i]);
     }
   }
+  if (sch->metrics) {
+    mt_metric_unregister(sch->parent, sch->metrics);
+    sch->metrics = NULL;
+  }
   rte_atomic32_dec(&mt_sch_get_mgr(sch->parent)->sch_cnt);
   rte_atomic32_dec(&sch->active);
   sch_unlock(sch);
@@ -330,6 +374,26 @@ static bool sch_is_capable(struct mt_sch_impl* sch, int quota_mbs,
     return true;
 }
 
+/* if the sch has enough room for the quota */
+static bool sch_has_quota(struct mt_sch_impl* sch, int quota_mbs) {
+  if (!sch->data_quota_mbs_total) return true;
+  if ((sch->data_quota_mbs_total + quota_mbs) <= sch->data_quota_mbs_limit) return true;
+  return false;
+}
+
+/* the estimated cpu load of the quota, 0 if the quota is not calibrated */
+static float sch_quota_load(struct mt_sch_mgr* mgr, int quota_mbs) {
+  if (!mgr->quota_calibrated) return 0;
+  return quota_mbs * mgr->load_per_mbs;
+}
+
+/* admission by the measured load, keep some headroom for the burst */
+static bool sch_has_headroom(struct mt_sch_impl* sch, float quota_load) {
+  if (!quota_load) return true;
+  if ((sch->load + quota_load) <= MT_SCH_LOAD_TARGET) return true;
+  return false;
+}
+
 static void sch_tasklet_stat_clear(struct mt_sch_tasklet_impl* tasklet) {
   tasklet->stat_max_time_us = 0;
   tasklet->stat_min_time_us = (uint32_t)-1;
@@ -343,8 +407,11 @@ static int sch_stat(void* priv) {
   struct mt_sch_tasklet_impl* tasklet;
   int idx = sch->idx;
   uint32_t avg_us;
+  char hist[128];
 
   if (mt_has_tasklet_time_measure(sch->parent)) {
+    if (mt_hist_summary(&sch->stat_loop_hist, hist, sizeof(hist)))
+      notice("SCH(%d): loop %s\n", idx, hist);
     for (int i = 0; i < num_tasklet; i++) {
       tasklet = sch->tasklet[i];
       if (!tasklet) continue;
@@ -355,9 +422,15 @@ static int sch_stat(void* priv) {
                avg_us, tasklet->stat_max_time_us, tasklet->stat_min_time_us);
         sch_tasklet_stat_clear(tasklet);
       }
+      if (mt_hist_summary(&tasklet->stat_time_hist, hist, sizeof(hist)))
+        notice("SCH(%d): tasklet %s, %s\n", idx, tasklet->name, hist);
     }
   }
 
+  if (mt_sch_has_load_measure(sch->parent)) {
+    notice("SCH(%d): load %f on socket %d\n", idx, sch->load, sch->socket_id);
+  }
+
   if (sch->allow_sleep) {
     notice("SCH(%d): sleep %fms(ratio:%f), cnt %u, min %" PRIu64 "us, max %" PRIu64
            "us\n",
@@ -376,60 +449,163 @@ static int sch_stat(void* priv) {
   return 0;
 }
 
-int mt_sch_unregister_tasklet(struct mt_sch_tasklet_impl* tasklet) {
-  struct mt_sch_impl* sch = tasklet->sch;
+/* remove the tasklet from the sch, call with sch lock */
+static int sch_tasklet_detach(struct mt_sch_impl* sch,
+                              struct mt_sch_tasklet_impl* tasklet) {
   int sch_idx = sch->idx;
   int idx = tasklet->idx;
 
-  sch_lock(sch);
-
   if (sch->tasklet[idx] != tasklet) {
     err("%s(%d), invalid tasklet on %d\n", __func__, sch_idx, idx);
-    sch_unlock(sch);
     return -EIO;
   }
 
   if (mt_sch_started(sch)) {
     int retry = 0;
     /* wait sch ack this exit */
-    dbg("%s(%d), tasklet %s(%d) runtime unregistered\n", __func__, sch_idx, tasklet->name,
-        idx);
+    dbg("%s(%d), tasklet %s(%d) runtime detach\n", __func__, sch_idx, tasklet->name, idx);
     tasklet->ack_exit = false;
     tasklet->request_exit = true;
     do {
       mt_sleep_ms(1);
       retry++;
       if (retry > 1000) {
-        err("%s(%d), tasklet %s(%d) runtime unregistered timeout\n", __func__, sch_idx,
+        err("%s(%d), tasklet %s(%d) runtime detach timeout\n", __func__, sch_idx,
             tasklet->name, idx);
-        sch_unlock(sch);
+        tasklet->request_exit = false;
         return -EIO;
       }
     } while (!tasklet->ack_exit);
-    info("%s(%d), tasklet %s(%d) unregistered, retry %d\n", __func__, sch_idx,
-         tasklet->name, idx, retry);
+    tasklet->request_exit = false;
+    dbg("%s(%d), tasklet %s(%d) detached, retry %d\n", __func__, sch_idx, tasklet->name,
+        idx, retry);
   } else {
     /* safe to directly remove */
     sch->tasklet[idx] = NULL;
-    info("%s(%d), tasklet %s(%d) unregistered\n", __func__, sch_idx, tasklet->name, idx);
   }
 
-  mt_rte_free(tasklet);
-
   int max_idx = 0;
   for (int i = 0; i < sch->nb_tasklets; i++) {
     if (sch->tasklet[i]) max_idx = i + 1;
   }
   sch->max_tasklet_idx = max_idx;
+  return 0;
+}
+
+int mt_sch_unregister_tasklet(struct mt_sch_tasklet_impl* tasklet) {
+  struct mt_sch_impl* sch = tasklet->sch;
+  int ret;
+
+  sch_lock(sch);
+  /* the balancer may move it to another sch before we get the lock */
+  while (tasklet->sch != sch) {
+    sch_unlock(sch);
+    sch = tasklet->sch;
+    sch_lock(sch);
+  }
+
+  ret = sch_tasklet_detach(sch, tasklet);
+  if (ret < 0) {
+    err("%s(%d), tasklet %s(%d) detach fail %d\n", __func__, sch->idx, tasklet->name,
+        tasklet->idx, ret);
+    sch_unlock(sch);
+    return ret;
+  }
+  info("%s(%d), tasklet %s(%d) unregistered\n", __func__, sch->idx, tasklet->name,
+       tasklet->idx);
+  sch_unlock(sch);
+
+  mt_rte_free(tasklet);
+  return 0;
+}
+
+int mt_sch_cal_load(struct mt_sch_impl* sch, uint64_t period_cycles) {
+  struct mt_sch_tasklet_impl* tasklet;
+  uint64_t cycles;
+  float load = 0;
 
+  if (!period_cycles) return -EINVAL;
+
+  sch_lock(sch);
+  for (int i = 0; i < sch->max_tasklet_idx; i++) {
+    tasklet = sch->tasklet[i];
+    if (!tasklet) continue;
+    cycles = tasklet->stat_cycles;
+    tasklet->load = (float)(cycles - tasklet->balance_cycles) / period_cycles;
+    tasklet->balance_cycles = cycles;
+    tasklet->pending_loops = tasklet->stat_pending - tasklet->balance_pending;
+    tasklet->balance_pending += tasklet->pending_loops;
+    load += tasklet->load;
+  }
+  sch->load = load;
   sch_unlock(sch);
+
+  dbg("%s(%d), load %f\n", __func__, sch->idx, load);
   return 0;
 }
 
+float mt_sch_steal_tasklet(struct mt_sch_impl* to_sch, struct mt_sch_impl* from_sch,
+                           float max_load) {
+  struct mt_sch_tasklet_impl* tasklet;
+  struct mt_sch_tasklet_impl* steal = NULL;
+  bool steal_pending = false, pending;
+  int ret, i;
+
+  if (from_sch == to_sch) return 0;
+  /* the start callback is not called again on the new sch */
+  if (!mt_sch_started(from_sch) || !mt_sch_started(to_sch)) return 0;
+
+  sch_lock(to_sch);
+  for (i = 0; i < to_sch->nb_tasklets; i++) {
+    if (!to_sch->tasklet[i]) break;
+  }
+  if (i >= to_sch->nb_tasklets) {
+    dbg("%s(%d), no space on this sch\n", __func__, to_sch->idx);
+    sch_unlock(to_sch);
+    return 0;
+  }
+
+  sch_lock(from_sch);
+  /* the one with pending work first, then the heaviest one within max_load */
+  for (int j = 0; j < from_sch->max_tasklet_idx; j++) {
+    tasklet = from_sch->tasklet[j];
+    if (!tasklet || !tasklet->ops.migratable) continue;
+    if ((tasklet->load <= 0) || (tasklet->load > max_load)) continue;
+    pending = tasklet->pending_loops > 0;
+    if (steal && (steal_pending && !pending)) continue;
+    if (steal && (steal_pending == pending) && (tasklet->load <= steal->load)) continue;
+    steal = tasklet;
+    steal_pending = pending;
+  }
+  if (!steal) {
+    sch_unlock(from_sch);
+    sch_unlock(to_sch);
+    return 0;
+  }
+
+  ret = sch_tasklet_detach(from_sch, steal);
+  if (ret < 0) {
+    err("%s(%d), tasklet %s detach fail %d\n", __func__, from_sch->idx, steal->name, ret);
+    sch_unlock(from_sch);
+    sch_unlock(to_sch);
+    return 0;
+  }
+  steal->sch = to_sch;
+  sch_unlock(from_sch);
+
+  steal->idx = i;
+  to_sch->tasklet[i] = steal;
+  to_sch->max_tasklet_idx = RTE_MAX(to_sch->max_tasklet_idx, i + 1);
+  sch_unlock(to_sch);
+
+  info("%s, tasklet %s(load %f%s) move from sch %d to sch %d\n", __func__, steal->name,
+       steal->load, steal_pending ? " pending" : "", from_sch->idx, to_sch->idx);
+  return steal->load;
+}
+
 struct mt_sch_tasklet_impl* mt_sch_register_tasklet(
     struct mt_sch_impl* sch, struct mt_sch_tasklet_ops* tasklet_ops) {
   int idx = sch->idx;
-  struct mtl_main_impl* impl = sch->parent;
   struct mt_sch_tasklet_impl* tasklet;
 
   sch_lock(sch);
@@ -439,7 +615,7 @@ struct mt_sch_tasklet_impl* mt_sch_register_tasklet(
     if (sch->tasklet[i]) continue;
 
     /* find one empty tasklet slot */
-    tasklet = mt_rte_zmalloc_socket(sizeof(*tasklet), mt_socket_id(impl, MTL_PORT_P));
+    tasklet = mt_rte_zmalloc_socket(sizeof(*tasklet), sch->socket_id);
     if (!tasklet) {
       err("%s(%d), tasklet malloc fail on %d\n", __func__, idx, i);
       sch_unlock(sch);
@@ -484,6 +660,7 @@ int mt_sch_mrg_init(struct mtl_main_impl* impl, int data_quota_mbs_limit) {
     mt_pthread_mutex_init(&sch->mutex, NULL);
     sch->parent = impl;
     sch->idx = sch_idx;
+    sch->socket_id = socket;
     rte_atomic32_set(&sch->started, 0);
     rte_atomic32_set(&sch->ref_cnt, 0);
     rte_atomic32_set(&sch->active, 0);
@@ -563,8 +740,7 @@ int mt_sch_add_quota(struct mt_sch_impl* sch, int quota_mbs) {
 
   sch_lock(sch);
   /* either the first quota request or sch is capable the quota */
-  if (!sch->data_quota_mbs_total ||
-      ((sch->data_quota_mbs_total + quota_mbs) <= sch->data_quota_mbs_limit)) {
+  if (sch_has_quota(sch, quota_mbs)) {
     /* find one sch capable with quota */
     sch->data_quota_mbs_total += quota_mbs;
     info("%s(%d:%d), quota %d total now %d\n", __func__, idx, sch->type, quota_mbs,
@@ -608,10 +784,13 @@ int mt_sch_put(struct mt_sch_impl* sch, int quota_mbs) {
 }
 
 struct mt_sch_impl* mt_sch_get(struct mtl_main_impl* impl, int quota_mbs,
-                               enum mt_sch_type type, mt_sch_mask_t mask) {
+                               enum mt_sch_type type, mt_sch_mask_t mask, int socket) {
   int ret, idx;
   struct mt_sch_impl* sch;
+  struct mt_sch_impl* least = NULL;
   struct mt_sch_mgr* mgr = mt_sch_get_mgr(impl);
+  bool balance = mt_has_tasklet_balance(impl);
+  float quota_load = sch_quota_load(mgr, quota_mbs);
 
   sch_mgr_lock(mgr);
 
@@ -620,23 +799,45 @@ struct mt_sch_impl* mt_sch_get(struct mtl_main_impl* impl, int quota_mbs,
     sch = mt_sch_instance(impl, idx);
     /* mask check */
     if (!(mask & MTL_BIT64(idx))) continue;
+    /* numa check, the lcore should be local to the nic */
+    if (sch->socket_id != socket) continue;
     /* active and busy check */
     if (!mt_sch_is_active(sch) || sch->cpu_busy) continue;
     /* quota check */
     if (!sch_is_capable(sch, quota_mbs, type)) continue;
+    /* no headroom by the measured load, try next or a new one */
+    if (!sch_has_headroom(sch, quota_load)) continue;
+    if (balance) {
+      /* place to the least loaded one by the measured cycles */
+      if (!sch_has_quota(sch, quota_mbs)) continue;
+      if (!least || (sch->load < least->load)) least = sch;
+      continue;
+    }
     ret = mt_sch_add_quota(sch, quota_mbs);
     if (ret >= 0) {
-      info("%s(%d), succ with quota_mbs %d\n", __func__, idx, quota_mbs);
+      info("%s(%d), succ with quota_mbs %d socket %d\n", __func__, idx, quota_mbs,
+           socket);
+      sch->load += quota_load; /* until next measure */
       rte_atomic32_inc(&sch->ref_cnt);
       sch_mgr_unlock(mgr);
       return sch;
     }
   }
 
+  if (least && (mt_sch_add_quota(least, quota_mbs) >= 0)) {
+    info("%s(%d), succ with quota_mbs %d socket %d load %f\n", __func__, least->idx,
+         quota_mbs, socket, least->load);
+    least->load += quota_load;
+    rte_atomic32_inc(&least->ref_cnt);
+    sch_mgr_unlock(mgr);
+    return least;
+  }
+
   /* no quota, try to create one */
-  sch = sch_request(impl, type, mask);
+  sch = sch_request(impl, type, mask, socket);
   if (!sch) {
-    err("%s, no free sch\n", __func__);
+    err("%s, no free sch for socket %d, quota_mbs %d load %f\n", __func__, socket,
+        quota_mbs, quota_load);
     sch_mgr_unlock(mgr);
     return NULL;
   }
@@ -660,6 +861,7 @@ struct mt_sch_impl* mt_sch_get(struct mtl_main_impl* impl, int quota_mbs,
     }
   }
 
+  sch->load = quota_load;
   rte_atomic32_inc(&sch->ref_cnt);
   sch_mgr_unlock(mgr);
   return sch;
@@ -7,6 +7,9 @@
 
 #include "mt_main.h"
 
+/* the sch is full if the measured load reach this ratio, see MTL_FLAG_SCH_QUOTA_AUTO */
+#define MT_SCH_LOAD_TARGET (0.85)
+
 static inline struct mt_sch_mgr* mt_sch_get_mgr(struct mtl_main_impl* impl) {
   return &impl->sch_mgr;
 }
@@ -47,6 +50,20 @@ struct mt_sch_tasklet_impl* mt_sch_register_tasklet(
     struct mt_sch_impl* sch, struct mt_sch_tasklet_ops* tasklet_ops);
 int mt_sch_unregister_tasklet(struct mt_sch_tasklet_impl* tasklet);
 
+/* if the cycles of each tasklet are measured in the sch loop */
+static inline bool mt_sch_has_load_measure(struct mtl_main_impl* impl) {
+  return mt_has_tasklet_balance(impl) || mt_has_sch_quota_auto(impl);
+}
+
+/* update the tasklet and sch load from the cycles measured in last period */
+int mt_sch_cal_load(struct mt_sch_impl* sch, uint64_t period_cycles);
+/*
+ * move one migratable tasklet with load <= max_load from from_sch to to_sch, prefer the
+ * ones reported pending work. Return the load moved, 0 if nothing moved.
+ */
+float mt_sch_steal_tasklet(struct mt_sch_impl* to_sch, struct mt_sch_impl* from_sch,
+                           float max_load);
+
 static inline void mt_tasklet_set_sleep(struct mt_sch_tasklet_impl* tasklet,
                                         uint64_t advice_sleep_us) {
   tasklet->ops.advice_sleep_us = advice_sleep_us;
@@ -54,8 +71,9 @@ static inline void mt_tasklet_set_sleep(struct mt_sch_tasklet_impl* tasklet,
 
 int mt_sch_add_quota(struct mt_sch_impl* sch, int quota_mbs);
 
+/* get one sch with lcore and tasklets on the numa socket of the session ports */
 struct mt_sch_impl* mt_sch_get(struct mtl_main_impl* impl, int quota_mbs,
-                               enum mt_sch_type type, mt_sch_mask_t mask);
+                               enum mt_sch_type type, mt_sch_mask_t mask, int socket);
 int mt_sch_put(struct mt_sch_impl* sch, int quota_mbs);
 
 int mt_sch_start_all(struct mtl_main_impl* impl);
@@ -65,4 +83,13 @@ static inline void mt_sch_set_cpu_busy(struct mt_sch_impl* sch, bool busy) {
   sch->cpu_busy = busy;
 }
 
+/* hold the sch from the free, for the reader outside the sch thread */
+static inline void mt_sch_lock(struct mt_sch_impl* sch) {
+  mt_pthread_mutex_lock(&sch->mutex);
+}
+
+static inline void mt_sch_unlock(struct mt_sch_impl* sch) {
+  mt_pthread_mutex_unlock(&sch->mutex);
+}
+
 #endif
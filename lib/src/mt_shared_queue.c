@@ -14,6 +14,12 @@ static inline struct mt_rsq_impl* rsq_ctx_get(struct mtl_main_impl* impl,
   return impl->rsq[port];
 }
 
+static const struct mt_metric_desc rsq_metric_descs[MT_RSQ_METRIC_MAX] = {
+    [MT_RSQ_METRIC_PKTS_RECV] = {"pkts_recv", MTL_METRIC_COUNTER},
+    [MT_RSQ_METRIC_PKTS_DELIVER] = {"pkts_deliver", MTL_METRIC_COUNTER},
+    [MT_RSQ_METRIC_ENTRIES] = {"entries", MTL_METRIC_GAUGE},
+};
+
 static int rsq_stat_dump(void* priv) {
   struct mt_rsq_impl* rsq = priv;
   struct mt_rsq_queue* s;
@@ -56,6 +62,10 @@ static int rsq_uinit(struct mt_rsq_impl* rsq) {
         MT_TAILQ_REMOVE(&rsq_queue->head, entry, next);
         rsq_entry_free(entry);
       }
+      if (rsq_queue->metrics) {
+        mt_metric_unregister(rsq->parent, rsq_queue->metrics);
+        rsq_queue->metrics = NULL;
+      }
       mt_pthread_mutex_destroy(&rsq_queue->mutex);
     }
     mt_rte_free(rsq->rsq_queues);
@@ -71,6 +81,7 @@ static int rsq_init(struct mtl_main_impl* impl, struct mt_rsq_impl* rsq) {
   enum mtl_port port = rsq->port;
   int soc_id = mt_socket_id(impl, port);
   struct mt_rsq_queue* rsq_queue;
+  char name[MTL_METRIC_NAME_MAX];
 
   rsq->rsq_queues =
       mt_rte_zmalloc_socket(sizeof(*rsq->rsq_queues) * rsq->max_rsq_queues, soc_id);
@@ -86,6 +97,9 @@ static int rsq_init(struct mtl_main_impl* impl, struct mt_rsq_impl* rsq) {
     rte_atomic32_set(&rsq_queue->entry_cnt, 0);
     mt_pthread_mutex_init(&rsq_queue->mutex, NULL);
     MT_TAILQ_INIT(&rsq_queue->head);
+    snprintf(name, sizeof(name), "rsq.%d.%u", port, q);
+    rsq_queue->metrics =
+        mt_metric_register(impl, name, rsq_metric_descs, MT_RSQ_METRIC_MAX, soc_id);
   }
 
   int ret = mt_stat_register(impl, rsq_stat_dump, rsq);
@@ -147,6 +161,8 @@ struct mt_rsq_entry* mt_rsq_get(struct mtl_main_impl* impl, enum mtl_port port,
   /* todo: insert rsq entry by rbtree? */
   MT_TAILQ_INSERT_HEAD(&rsq_queue->head, entry, next);
   rte_atomic32_inc(&rsq_queue->entry_cnt);
+  mt_metric_set(rsq_queue->metrics, MT_RSQ_METRIC_ENTRIES,
+                rte_atomic32_read(&rsq_queue->entry_cnt));
   mt_pthread_mutex_unlock(&rsq_queue->mutex);
 
   uint8_t* ip = flow->dip_addr;
@@ -162,6 +178,8 @@ int mt_rsq_put(struct mt_rsq_entry* entry) {
   mt_pthread_mutex_lock(&rsq_queue->mutex);
   MT_TAILQ_REMOVE(&rsq_queue->head, entry, next);
   rte_atomic32_dec(&rsq_queue->entry_cnt);
+  mt_metric_set(rsq_queue->metrics, MT_RSQ_METRIC_ENTRIES,
+                rte_atomic32_read(&rsq_queue->entry_cnt));
   mt_pthread_mutex_unlock(&rsq_queue->mutex);
 
   rsq_entry_free(entry);
@@ -179,9 +197,10 @@ uint16_t mt_rsq_burst(struct mt_rsq_entry* entry, uint16_t nb_pkts) {
   struct rte_udp_hdr* udp;
 
   mt_pthread_mutex_lock(&rsq_queue->mutex);
-  rx = rte_eth_rx_burst(rsq_queue->port_id, q, pkts, nb_pkts);
+  rx = mt_dev_rx_port_burst(mt_if(rsqm->parent, rsqm->port), q, pkts, nb_pkts);
   if (rx) dbg("%s(%u), rx pkts %u\n", __func__, q, rx);
   rsq_queue->stat_pkts_recv += rx;
+  mt_metric_add(rsq_queue->metrics, MT_RSQ_METRIC_PKTS_RECV, rx);
   for (uint16_t i = 0; i < rx; i++) {
     hdr = rte_pktmbuf_mtod(pkts[i], struct mt_udp_hdr*);
     udp = &hdr->udp;
@@ -193,11 +212,13 @@ uint16_t mt_rsq_burst(struct mt_rsq_entry* entry, uint16_t nb_pkts) {
       if (rsq_entry->dst_port_net == udp->dst_port) {
         rsq_entry->flow.cb(rsq_entry->flow.priv, &pkts[i], 1);
         rsq_queue->stat_pkts_deliver++;
+        mt_metric_add(rsq_queue->metrics, MT_RSQ_METRIC_PKTS_DELIVER, 1);
         break;
       }
       if (rsq_entry->flow.sys_queue) { /* sys flow is always in last pos */
         rsq_entry->flow.cb(rsq_entry->flow.priv, &pkts[i], 1);
         rsq_queue->stat_pkts_deliver++;
+        mt_metric_add(rsq_queue->metrics, MT_RSQ_METRIC_PKTS_DELIVER, 1);
         break;
       }
     }
@@ -253,6 +274,13 @@ static inline struct mt_tsq_impl* tsq_ctx_get(struct mtl_main_impl* impl,
   return impl->tsq[port];
 }
 
+static const struct mt_metric_desc tsq_metric_descs[MT_TSQ_METRIC_MAX] = {
+    [MT_TSQ_METRIC_PKTS_SEND] = {"pkts_send", MTL_METRIC_COUNTER},
+    [MT_TSQ_METRIC_ENTRIES] = {"entries", MTL_METRIC_GAUGE},
+    [MT_TSQ_METRIC_FLUSHES] = {"flushes", MTL_METRIC_COUNTER},
+    [MT_TSQ_METRIC_BACKPRESSURE] = {"backpressure", MTL_METRIC_COUNTER},
+};
+
 static int tsq_stat_dump(void* priv) {
   struct mt_tsq_impl* tsq = priv;
   struct mt_tsq_queue* s;
@@ -260,9 +288,15 @@ static int tsq_stat_dump(void* priv) {
   for (uint16_t q = 0; q < tsq->max_tsq_queues; q++) {
     s = &tsq->tsq_queues[q];
     if (s->stat_pkts_send) {
-      notice("%s(%d,%u), entries %d, pkt send %d\n", __func__, tsq->port, q,
-             rte_atomic32_read(&s->entry_cnt), s->stat_pkts_send);
+      notice("%s(%d,%u), entries %d, pkt send %d by %d flushes\n", __func__, tsq->port,
+             q, rte_atomic32_read(&s->entry_cnt), s->stat_pkts_send, s->stat_flushes);
       s->stat_pkts_send = 0;
+      s->stat_flushes = 0;
+    }
+    if (s->stat_backpressure) {
+      warn("%s(%d,%u), %d pkts rejected as staging ring full\n", __func__, tsq->port, q,
+           s->stat_backpressure);
+      s->stat_backpressure = 0;
     }
   }
 
@@ -288,12 +322,30 @@ static int tsq_uinit(struct mt_tsq_impl* tsq) {
         MT_TAILQ_REMOVE(&tsq_queue->head, entry, next);
         tsq_entry_free(entry);
       }
+      if (tsq_queue->stage_ring) {
+        struct rte_mbuf* pkts[MT_TSQ_FLUSH_BURST];
+        unsigned int n;
+
+        /* the pkts not sent yet */
+        if (tsq_queue->nb_pending)
+          rte_pktmbuf_free_bulk(&tsq_queue->pending[tsq_queue->pending_idx],
+                                tsq_queue->nb_pending);
+        tsq_queue->nb_pending = 0;
+        while ((n = rte_ring_sc_dequeue_burst(tsq_queue->stage_ring, (void**)pkts,
+                                              MT_TSQ_FLUSH_BURST, NULL)))
+          rte_pktmbuf_free_bulk(pkts, n);
+        rte_ring_free(tsq_queue->stage_ring);
+        tsq_queue->stage_ring = NULL;
+      }
       if (tsq_queue->tx_pool) {
         mt_mempool_free(tsq_queue->tx_pool);
         tsq_queue->tx_pool = NULL;
       }
+      if (tsq_queue->metrics) {
+        mt_metric_unregister(tsq->parent, tsq_queue->metrics);
+        tsq_queue->metrics = NULL;
+      }
       mt_pthread_mutex_destroy(&tsq_queue->mutex);
-      mt_pthread_mutex_destroy(&tsq_queue->tx_mutex);
     }
     mt_rte_free(tsq->tsq_queues);
     tsq->tsq_queues = NULL;
@@ -308,6 +360,7 @@ static int tsq_init(struct mtl_main_impl* impl, struct mt_tsq_impl* tsq) {
   enum mtl_port port = tsq->port;
   int soc_id = mt_socket_id(impl, port);
   struct mt_tsq_queue* tsq_queue;
+  char name[MTL_METRIC_NAME_MAX];
 
   tsq->tsq_queues =
       mt_rte_zmalloc_socket(sizeof(*tsq->tsq_queues) * tsq->max_tsq_queues, soc_id);
@@ -322,8 +375,11 @@ static int tsq_init(struct mtl_main_impl* impl, struct mt_tsq_impl* tsq) {
     tsq_queue->port_id = mt_port_id(impl, port);
     rte_atomic32_set(&tsq_queue->entry_cnt, 0);
     mt_pthread_mutex_init(&tsq_queue->mutex, NULL);
-    mt_pthread_mutex_init(&tsq_queue->tx_mutex, NULL);
+    rte_spinlock_init(&tsq_queue->flush_lock);
     MT_TAILQ_INIT(&tsq_queue->head);
+    snprintf(name, sizeof(name), "tsq.%d.%u", port, q);
+    tsq_queue->metrics =
+        mt_metric_register(impl, name, tsq_metric_descs, MT_TSQ_METRIC_MAX, soc_id);
   }
 
   int ret = mt_stat_register(impl, tsq_stat_dump, tsq);
@@ -374,10 +430,13 @@ struct mt_tsq_entry* mt_tsq_get(struct mtl_main_impl* impl, enum mtl_port port,
   mt_pthread_mutex_lock(&tsq_queue->mutex);
   if (!tsq_queue->tx_pool) {
     char pool_name[32];
+    uint16_t nb_tx_desc = mt_if_nb_tx_desc(impl, port);
+    /* the nic ring, the stage ring, the pending burst and the headroom for lcore cache */
+    unsigned int n = nb_tx_desc * 2 + MT_TSQ_FLUSH_BURST + 512;
     snprintf(pool_name, 32, "TSQ-P%d-Q%u", port, q);
-    struct rte_mempool* pool =
-        mt_mempool_create(impl, port, pool_name, mt_if_nb_tx_desc(impl, port) + 512,
-                          MT_MBUF_CACHE_SIZE, 0, MTL_MTU_MAX_BYTES);
+    struct rte_mempool* pool = mt_mempool_create(impl, port, pool_name, n,
+                                                 MT_MBUF_CACHE_SIZE, 0,
+                                                 MTL_MTU_MAX_BYTES);
     if (!pool) {
       err("%s(%d:%u), mempool create fail\n", __func__, port, q);
       mt_pthread_mutex_unlock(&tsq_queue->mutex);
@@ -386,8 +445,25 @@ struct mt_tsq_entry* mt_tsq_get(struct mtl_main_impl* impl, enum mtl_port port,
     }
     tsq_queue->tx_pool = pool;
   }
+  if (!tsq_queue->stage_ring) {
+    char ring_name[32];
+    /* multi-producer for all entries and single-consumer for the flusher */
+    unsigned int flags = RING_F_SC_DEQ | RING_F_EXACT_SZ;
+    snprintf(ring_name, 32, "TSQ-RING-P%d-Q%u", port, q);
+    struct rte_ring* ring = rte_ring_create(ring_name, mt_if_nb_tx_desc(impl, port),
+                                            mt_socket_id(impl, port), flags);
+    if (!ring) {
+      err("%s(%d:%u), stage ring create fail\n", __func__, port, q);
+      mt_pthread_mutex_unlock(&tsq_queue->mutex);
+      mt_rte_free(entry);
+      return NULL;
+    }
+    tsq_queue->stage_ring = ring;
+  }
   MT_TAILQ_INSERT_HEAD(&tsq_queue->head, entry, next);
   rte_atomic32_inc(&tsq_queue->entry_cnt);
+  mt_metric_set(tsq_queue->metrics, MT_TSQ_METRIC_ENTRIES,
+                rte_atomic32_read(&tsq_queue->entry_cnt));
   mt_pthread_mutex_unlock(&tsq_queue->mutex);
 
   entry->tx_pool = tsq_queue->tx_pool;
@@ -405,24 +481,101 @@ int mt_tsq_put(struct mt_tsq_entry* entry) {
   mt_pthread_mutex_lock(&tsq_queue->mutex);
   MT_TAILQ_REMOVE(&tsq_queue->head, entry, next);
   rte_atomic32_dec(&tsq_queue->entry_cnt);
+  mt_metric_set(tsq_queue->metrics, MT_TSQ_METRIC_ENTRIES,
+                rte_atomic32_read(&tsq_queue->entry_cnt));
   mt_pthread_mutex_unlock(&tsq_queue->mutex);
 
   tsq_entry_free(entry);
   return 0;
 }
 
+/* send the pending pkts, then drain the staging ring until empty or the nic full */
+static bool tsq_queue_drain(struct mt_tsq_queue* tsq_queue) {
+  int retry = 0;
+  uint16_t tx;
+
+  while (true) {
+    if (!tsq_queue->nb_pending) {
+      tsq_queue->pending_idx = 0;
+      tsq_queue->nb_pending =
+          rte_ring_sc_dequeue_burst(tsq_queue->stage_ring, (void**)tsq_queue->pending,
+                                    MT_TSQ_FLUSH_BURST, NULL);
+      if (!tsq_queue->nb_pending) return true; /* all sent */
+    }
+
+    tx = rte_eth_tx_burst(tsq_queue->port_id, tsq_queue->queue_id,
+                          &tsq_queue->pending[tsq_queue->pending_idx],
+                          tsq_queue->nb_pending);
+    tsq_queue->pending_idx += tx;
+    tsq_queue->nb_pending -= tx;
+    tsq_queue->stat_pkts_send += tx;
+    mt_metric_add(tsq_queue->metrics, MT_TSQ_METRIC_PKTS_SEND, tx);
+    if (tx) {
+      retry = 0;
+    } else {
+      retry++;
+      if (retry > MT_TSQ_FLUSH_RETRY) return false; /* nic full */
+    }
+  }
+}
+
+/*
+ * Only one flusher at a time, the others return once the pkts are staged. The flusher
+ * check the staging ring again after the unlock, so the pkts staged by the one which
+ * fail the trylock are never left behind unless the nic is full, in which case they
+ * are sent by the next burst or the periodic mt_tsq_flush_pending from the cni.
+ */
+static void tsq_queue_flush(struct mt_tsq_queue* tsq_queue) {
+  bool drained;
+
+  do {
+    if (!rte_spinlock_trylock(&tsq_queue->flush_lock)) return;
+    drained = tsq_queue_drain(tsq_queue);
+    tsq_queue->stat_flushes++;
+    mt_metric_add(tsq_queue->metrics, MT_TSQ_METRIC_FLUSHES, 1);
+    rte_spinlock_unlock(&tsq_queue->flush_lock);
+  } while (drained && !rte_ring_empty(tsq_queue->stage_ring));
+}
+
+static inline bool tsq_queue_has_pending(struct mt_tsq_queue* tsq_queue) {
+  return tsq_queue->nb_pending || !rte_ring_empty(tsq_queue->stage_ring);
+}
+
+int mt_tsq_flush_pending(struct mtl_main_impl* impl, enum mtl_port port) {
+  struct mt_tsq_impl* tsqm = tsq_ctx_get(impl, port);
+  struct mt_tsq_queue* tsq_queue;
+  int pending = 0;
+
+  if (!tsqm || !tsqm->tsq_queues) return 0;
+
+  for (uint16_t q = 0; q < tsqm->max_tsq_queues; q++) {
+    tsq_queue = &tsqm->tsq_queues[q];
+    /* the unlocked check is only a hint, the flush recheck under the flush lock */
+    if (!tsq_queue->stage_ring || !tsq_queue_has_pending(tsq_queue)) continue;
+    tsq_queue_flush(tsq_queue);
+    if (tsq_queue_has_pending(tsq_queue)) pending++;
+  }
+
+  return pending;
+}
+
 uint16_t mt_tsq_burst(struct mt_tsq_entry* entry, struct rte_mbuf** tx_pkts,
                       uint16_t nb_pkts) {
   struct mt_tsq_impl* tsqm = entry->parent;
   struct mt_tsq_queue* tsq_queue = &tsqm->tsq_queues[entry->queue_id];
-  uint16_t tx;
-
-  mt_pthread_mutex_lock(&tsq_queue->tx_mutex);
-  tx = rte_eth_tx_burst(tsq_queue->port_id, tsq_queue->queue_id, tx_pkts, nb_pkts);
-  tsq_queue->stat_pkts_send += tx;
-  mt_pthread_mutex_unlock(&tsq_queue->tx_mutex);
+  uint16_t staged;
+
+  staged = rte_ring_mp_enqueue_burst(tsq_queue->stage_ring, (void**)tx_pkts, nb_pkts,
+                                     NULL);
+  if (staged < nb_pkts) {
+    /* the caller keep the rejected pkts, report to the entry */
+    entry->stat_backpressure += nb_pkts - staged;
+    tsq_queue->stat_backpressure += nb_pkts - staged;
+    mt_metric_add(tsq_queue->metrics, MT_TSQ_METRIC_BACKPRESSURE, nb_pkts - staged);
+  }
+  tsq_queue_flush(tsq_queue);
 
-  return tx;
+  return staged;
 }
 
 uint16_t mt_tsq_burst_busy(struct mtl_main_impl* impl, struct mt_tsq_entry* entry,
@@ -472,9 +625,9 @@ int mt_tsq_set_bps(struct mtl_main_impl* impl, struct mt_tsq_entry* entry,
   struct mt_tsq_queue* tsq_queue = &tsqm->tsq_queues[entry->queue_id];
   uint16_t q = entry->queue_id;
 
-  mt_pthread_mutex_lock(&tsq_queue->tx_mutex);
+  rte_spinlock_lock(&tsq_queue->flush_lock);
   mt_dev_set_tx_bps(impl, port, q, bytes_per_sec);
-  mt_pthread_mutex_unlock(&tsq_queue->tx_mutex);
+  rte_spinlock_unlock(&tsq_queue->flush_lock);
 
   return 0;
 }
@@ -38,5 +38,7 @@ uint16_t mt_tsq_burst_busy(struct mtl_main_impl* impl, struct mt_tsq_entry* entr
 int mt_tsq_flush(struct mtl_main_impl* impl, struct mt_tsq_entry* entry,
                  struct rte_mbuf* pad);
 int mt_tsq_put(struct mt_tsq_entry* entry);
+/* send the pkts left staged on the port, return the number of queues still pending */
+int mt_tsq_flush_pending(struct mtl_main_impl* impl, enum mtl_port port);
 
 #endif
@@ -201,8 +201,9 @@ int mt_srss_init(struct mtl_main_impl* impl) {
       return ret;
     }
 
-    struct mt_sch_impl* sch = mt_sch_get(impl, mt_if(impl, i)->link_speed,
-                                         MT_SCH_TYPE_DEFAULT, MT_SCH_MASK_ALL);
+    struct mt_sch_impl* sch =
+        mt_sch_get(impl, mt_if(impl, i)->link_speed, MT_SCH_TYPE_DEFAULT,
+                   MT_SCH_MASK_ALL, mt_socket_id(impl, i));
     if (!sch) {
       err("%s(%d), get sch fail\n", __func__, i);
       mt_srss_uinit(impl);
@@ -62,11 +62,145 @@ int mt_stat_unregister(struct mtl_main_impl* impl, mt_stat_cb_t cb, void* priv)
   return -EIO;
 }
 
+struct mt_metric_group* mt_metric_register(struct mtl_main_impl* impl, const char* name,
+                                           const struct mt_metric_desc* descs,
+                                           int nb_descs, int soc_id) {
+  struct mt_stat_mgr* mgr = get_stat_mgr(impl);
+  struct mt_metric_group* group;
+
+  if ((nb_descs <= 0) || (nb_descs > MT_METRIC_GROUP_MAX)) {
+    err("%s(%s), invalid nb_descs %d\n", __func__, name, nb_descs);
+    return NULL;
+  }
+
+  group = mt_rte_zmalloc_socket(sizeof(*group), soc_id);
+  if (!group) {
+    err("%s(%s), group malloc fail\n", __func__, name);
+    return NULL;
+  }
+  group->slots =
+      mt_rte_zmalloc_socket(sizeof(*group->slots) * (RTE_MAX_LCORE + 1), soc_id);
+  if (!group->slots) {
+    err("%s(%s), slots malloc fail\n", __func__, name);
+    mt_rte_free(group);
+    return NULL;
+  }
+  snprintf(group->name, sizeof(group->name), "%s", name);
+  group->descs = descs;
+  group->nb_descs = nb_descs;
+
+  mt_pthread_mutex_lock(&mgr->metric_mutex);
+  MT_TAILQ_INSERT_TAIL(&mgr->metric_head, group, next);
+  mgr->nb_metrics += nb_descs;
+  mt_pthread_mutex_unlock(&mgr->metric_mutex);
+
+  dbg("%s(%s), succ with %d metrics\n", __func__, name, nb_descs);
+  return group;
+}
+
+int mt_metric_unregister(struct mtl_main_impl* impl, struct mt_metric_group* group) {
+  struct mt_stat_mgr* mgr = get_stat_mgr(impl);
+
+  mt_pthread_mutex_lock(&mgr->metric_mutex);
+  MT_TAILQ_REMOVE(&mgr->metric_head, group, next);
+  mgr->nb_metrics -= group->nb_descs;
+  mt_pthread_mutex_unlock(&mgr->metric_mutex);
+
+  mt_rte_free(group->slots);
+  mt_rte_free(group);
+  return 0;
+}
+
+uint64_t mt_metric_counter(struct mt_metric_group* group, int id) {
+  uint64_t sum = 0;
+
+  if (!group) return 0;
+  for (int lcore = 0; lcore <= RTE_MAX_LCORE; lcore++)
+    sum += __atomic_load_n(&group->slots[lcore].v[id], __ATOMIC_RELAXED);
+  return sum;
+}
+
+/* the first value of a bucket */
+static uint64_t hist_bucket_value(int idx) {
+  int shift;
+
+  if (idx < MT_HIST_SUB_CNT) return idx;
+  shift = (idx >> MT_HIST_SUB_BITS) - 1;
+  return (uint64_t)(MT_HIST_SUB_CNT + (idx & (MT_HIST_SUB_CNT - 1))) << shift;
+}
+
+uint64_t mt_hist_percentile(struct mt_hist* hist, int permille) {
+  uint64_t target, sum = 0;
+
+  if (!hist->cnt) return 0;
+  target = (hist->cnt * permille + 999) / 1000;
+  for (int i = 0; i < MT_HIST_BUCKETS; i++) {
+    sum += hist->buckets[i];
+    /* report the upper edge of the bucket, never above the real max */
+    if (sum >= target) return RTE_MIN(hist_bucket_value(i + 1) - 1, hist->max);
+  }
+  return hist->max;
+}
+
+uint64_t mt_hist_summary(struct mt_hist* hist, char* buf, size_t size) {
+  struct mt_hist copy;
+
+  /* work on a copy as the writer may be still running */
+  rte_memcpy(&copy, hist, sizeof(copy));
+  memset(hist, 0, sizeof(*hist));
+  if (!copy.cnt) return 0;
+
+  snprintf(buf, size, "cnt %" PRIu64 " p50 %.1fus p99 %.1fus p99.9 %.1fus max %.1fus",
+           copy.cnt, (double)mt_hist_percentile(&copy, 500) / NS_PER_US,
+           (double)mt_hist_percentile(&copy, 990) / NS_PER_US,
+           (double)mt_hist_percentile(&copy, 999) / NS_PER_US,
+           (double)copy.max / NS_PER_US);
+  return copy.cnt;
+}
+
+int mt_metric_snapshot(struct mtl_main_impl* impl, struct mtl_metric* metrics, int max) {
+  struct mt_stat_mgr* mgr = get_stat_mgr(impl);
+  struct mt_metric_group* group;
+  const struct mt_metric_desc* desc;
+  struct mtl_metric* metric;
+  int cnt = 0;
+
+  mt_pthread_mutex_lock(&mgr->metric_mutex);
+  if (!metrics) { /* query the number only */
+    cnt = mgr->nb_metrics;
+    mt_pthread_mutex_unlock(&mgr->metric_mutex);
+    return cnt;
+  }
+
+  MT_TAILQ_FOREACH(group, &mgr->metric_head, next) {
+    for (int id = 0; id < group->nb_descs; id++) {
+      if (cnt >= max) goto out;
+      desc = &group->descs[id];
+      metric = &metrics[cnt];
+      snprintf(metric->name, sizeof(metric->name), "%s.%s", group->name, desc->name);
+      metric->type = desc->type;
+      if (desc->type == MTL_METRIC_GAUGE) {
+        metric->gauge = mt_metric_gauge(group, id);
+      } else {
+        metric->counter = mt_metric_counter(group, id);
+      }
+      cnt++;
+    }
+  }
+
+out:
+  mt_pthread_mutex_unlock(&mgr->metric_mutex);
+  return cnt;
+}
+
 int mt_stat_init(struct mtl_main_impl* impl) {
   struct mt_stat_mgr* mgr = get_stat_mgr(impl);
 
   mt_pthread_mutex_init(&mgr->mutex, NULL);
   MT_TAILQ_INIT(&mgr->head);
+  mt_pthread_mutex_init(&mgr->metric_mutex, NULL);
+  MT_TAILQ_INIT(&mgr->metric_head);
+  mgr->nb_metrics = 0;
 
   return 0;
 }
@@ -74,6 +208,7 @@ int mt_stat_init(struct mtl_main_impl* impl) {
 int mt_stat_uinit(struct mtl_main_impl* impl) {
   struct mt_stat_mgr* mgr = get_stat_mgr(impl);
   struct mt_stat_item* item;
+  struct mt_metric_group* group;
 
   /* check if any not unregister */
   while ((item = MT_TAILQ_FIRST(&mgr->head))) {
@@ -82,7 +217,13 @@ int mt_stat_uinit(struct mtl_main_impl* impl) {
     mt_free(item);
   }
 
+  while ((group = MT_TAILQ_FIRST(&mgr->metric_head))) {
+    warn("%s, metric group %s not unregister\n", __func__, group->name);
+    mt_metric_unregister(impl, group);
+  }
+
   mt_pthread_mutex_destroy(&mgr->mutex);
+  mt_pthread_mutex_destroy(&mgr->metric_mutex);
 
   return 0;
 }
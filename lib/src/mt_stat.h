@@ -14,4 +14,65 @@ int mt_stat_dump(struct mtl_main_impl* impl);
 int mt_stat_register(struct mtl_main_impl* impl, mt_stat_cb_t cb, void* priv);
 int mt_stat_unregister(struct mtl_main_impl* impl, mt_stat_cb_t cb, void* priv);
 
+/* register a group of metrics, the descs must be valid until unregister */
+struct mt_metric_group* mt_metric_register(struct mtl_main_impl* impl, const char* name,
+                                           const struct mt_metric_desc* descs,
+                                           int nb_descs, int soc_id);
+int mt_metric_unregister(struct mtl_main_impl* impl, struct mt_metric_group* group);
+int mt_metric_snapshot(struct mtl_main_impl* impl, struct mtl_metric* metrics, int max);
+
+/* add to a MTL_METRIC_COUNTER, lock free as each lcore has its own slot */
+static inline void mt_metric_add(struct mt_metric_group* group, int id, uint64_t v) {
+  unsigned int lcore = rte_lcore_id();
+  uint64_t* counter;
+
+  if (!group) return;
+  if (lcore >= RTE_MAX_LCORE) { /* non-EAL threads */
+    __atomic_fetch_add(&group->slots[RTE_MAX_LCORE].v[id], v, __ATOMIC_RELAXED);
+    return;
+  }
+  /* single writer, a relaxed store is enough for the snapshot reader */
+  counter = &group->slots[lcore].v[id];
+  __atomic_store_n(counter, *counter + v, __ATOMIC_RELAXED);
+}
+
+/* the sum of a MTL_METRIC_COUNTER from all lcores, 0 for a NULL group */
+uint64_t mt_metric_counter(struct mt_metric_group* group, int id);
+
+static inline int64_t mt_metric_gauge(struct mt_metric_group* group, int id) {
+  if (!group) return 0;
+  return __atomic_load_n(&group->gauges[id], __ATOMIC_RELAXED);
+}
+
+/* set a MTL_METRIC_GAUGE */
+static inline void mt_metric_set(struct mt_metric_group* group, int id, int64_t v) {
+  if (!group) return;
+  __atomic_store_n(&group->gauges[id], v, __ATOMIC_RELAXED);
+}
+
+/* record one sample in ns, no lock as each hist has only one writer */
+static inline void mt_hist_add(struct mt_hist* hist, uint64_t ns) {
+  int idx, msb, shift;
+
+  if (ns < MT_HIST_SUB_CNT) {
+    idx = ns;
+  } else {
+    msb = 63 - __builtin_clzll(ns);
+    if (msb >= MT_HIST_MAX_BITS) {
+      idx = MT_HIST_BUCKETS - 1;
+    } else {
+      shift = msb - MT_HIST_SUB_BITS;
+      idx = ((shift + 1) << MT_HIST_SUB_BITS) + ((ns >> shift) & (MT_HIST_SUB_CNT - 1));
+    }
+  }
+  hist->buckets[idx]++;
+  hist->cnt++;
+  if (ns > hist->max) hist->max = ns;
+}
+
+/* the value in ns which permille of the samples are below, 999 for p99.9 */
+uint64_t mt_hist_percentile(struct mt_hist* hist, int permille);
+/* format p50/p99/p99.9/max to buf and clear the hist, return the number of samples */
+uint64_t mt_hist_summary(struct mt_hist* hist, char* buf, size_t size);
+
 #endif
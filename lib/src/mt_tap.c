@@ -898,7 +898,7 @@ int mt_tap_init(struct mtl_main_impl* impl) {
 
   rte_atomic32_set(&cni->stop_tap, 0);
   tap_ctx->has_lcore = false;
-  ret = mt_dev_get_lcore(impl, &lcore);
+  ret = mt_dev_get_lcore(impl, mt_socket_id(impl, MTL_PORT_P), &lcore);
   if (ret < 0) {
     err("%s, get lcore fail %d\n", __func__, ret);
     mt_tap_uinit(impl);
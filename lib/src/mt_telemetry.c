@@ -0,0 +1,344 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include "mt_telemetry.h"
+
+// #define DEBUG
+#include "mt_log.h"
+#include "mt_ptp.h"
+#include "mt_sch.h"
+#include "mt_stat.h"
+#include "st2110/st_rx_video_session.h"
+#include "st2110/st_tx_video_session.h"
+
+static inline struct mt_telemetry* mt_get_telemetry(struct mtl_main_impl* impl) {
+  return &impl->telemetry;
+}
+
+static void telemetry_fill_tx_video(struct mtl_telemetry_shm* t,
+                                    struct mt_sch_impl* sch) {
+  struct st_tx_video_sessions_mgr* mgr = &sch->tx_video_mgr;
+  struct st_tx_video_session_impl* s;
+  struct mtl_telemetry_session* ts;
+
+  mt_pthread_mutex_lock(&sch->tx_video_mgr_mutex);
+  if (!sch->tx_video_init) {
+    mt_pthread_mutex_unlock(&sch->tx_video_mgr_mutex);
+    return;
+  }
+  for (int j = 0; j < mgr->max_idx; j++) {
+    if (t->nb_sessions >= MTL_TELEMETRY_SESSION_MAX) break;
+    s = tx_video_session_get(mgr, j);
+    if (!s) continue;
+    ts = &t->sessions[t->nb_sessions++];
+    memset(ts, 0, sizeof(*ts));
+    snprintf(ts->name, sizeof(ts->name), "%s", s->ops_name);
+    ts->type = (s->s_type == MT_ST22_HANDLE_TX_VIDEO) ? MTL_TELEMETRY_ST22_TX
+                                                      : MTL_TELEMETRY_ST20_TX;
+    ts->num_port = s->ops.num_port;
+    ts->idx = s->idx;
+    ts->sch_idx = sch->idx;
+    ts->width = s->ops.width;
+    ts->height = s->ops.height;
+    ts->frames = mt_metric_counter(s->metrics, ST_TX_VIDEO_METRIC_FRAMES);
+    ts->pkts = mt_metric_counter(s->metrics, ST_TX_VIDEO_METRIC_PKTS_BURST);
+    ts->drops = mt_metric_counter(s->metrics, ST_TX_VIDEO_METRIC_EPOCH_DROP);
+    tx_video_session_put(mgr, j);
+  }
+  mt_pthread_mutex_unlock(&sch->tx_video_mgr_mutex);
+}
+
+static void telemetry_fill_ebu(struct mtl_telemetry_ebu* ebu,
+                               struct st_rx_video_ebu_result* result) {
+  /* negative in the warm up frames */
+  if (result->ebu_result_num <= 0) return;
+
+  ebu->frames = result->ebu_result_num;
+  ebu->compliance_narrow = result->compliance_narrow;
+  ebu->compliance_wide = result->compliance - result->compliance_narrow;
+  ebu->compliance_fail = result->ebu_result_num - result->compliance;
+}
+
+static void telemetry_fill_rx_video(struct mtl_telemetry_shm* t,
+                                    struct mt_sch_impl* sch) {
+  struct st_rx_video_sessions_mgr* mgr = &sch->rx_video_mgr;
+  struct st_rx_video_session_impl* s;
+  struct mtl_telemetry_session* ts;
+
+  mt_pthread_mutex_lock(&sch->rx_video_mgr_mutex);
+  if (!sch->rx_video_init) {
+    mt_pthread_mutex_unlock(&sch->rx_video_mgr_mutex);
+    return;
+  }
+  for (int j = 0; j < mgr->max_idx; j++) {
+    if (t->nb_sessions >= MTL_TELEMETRY_SESSION_MAX) break;
+    s = rx_video_session_get(mgr, j);
+    if (!s) continue;
+    ts = &t->sessions[t->nb_sessions++];
+    memset(ts, 0, sizeof(*ts));
+    snprintf(ts->name, sizeof(ts->name), "%s", s->ops_name);
+    ts->type = s->st22_info ? MTL_TELEMETRY_ST22_RX : MTL_TELEMETRY_ST20_RX;
+    ts->num_port = s->ops.num_port;
+    ts->idx = s->idx;
+    ts->sch_idx = sch->idx;
+    ts->width = s->ops.width;
+    ts->height = s->ops.height;
+    ts->frames = mt_metric_counter(s->metrics, ST_RX_VIDEO_METRIC_FRAMES_RECEIVED);
+    ts->pkts = mt_metric_counter(s->metrics, ST_RX_VIDEO_METRIC_PKTS_RECEIVED);
+    ts->drops = mt_metric_counter(s->metrics, ST_RX_VIDEO_METRIC_FRAMES_DROPPED);
+    ts->pkts_out_of_order =
+        mt_metric_counter(s->metrics, ST_RX_VIDEO_METRIC_PKTS_OUT_OF_ORDER);
+    ts->pkts_redundant = mt_metric_counter(s->metrics, ST_RX_VIDEO_METRIC_PKTS_REDUNDANT);
+    if (mt_has_ebu(sch->parent)) telemetry_fill_ebu(&ts->ebu, &s->ebu_result);
+    rx_video_session_put(mgr, j);
+  }
+  mt_pthread_mutex_unlock(&sch->rx_video_mgr_mutex);
+}
+
+static void telemetry_fill_sch(struct mtl_telemetry_shm* t, struct mt_sch_impl* sch) {
+  struct mtl_telemetry_sch* ts;
+  int nb_tasklets = 0;
+
+  /* sch_free unregister the metrics under the sch lock */
+  mt_sch_lock(sch);
+  if (!mt_sch_is_active(sch) || !sch->metrics) {
+    mt_sch_unlock(sch);
+    return;
+  }
+
+  ts = &t->schs[t->nb_schs++];
+  for (int i = 0; i < sch->max_tasklet_idx; i++) {
+    if (sch->tasklet[i]) nb_tasklets++;
+  }
+
+  ts->idx = sch->idx;
+  ts->lcore = sch->run_in_thread ? -1 : (int32_t)sch->lcore;
+  ts->nb_tasklets = nb_tasklets;
+  ts->sleep_ratio = mt_metric_gauge(sch->metrics, MT_SCH_METRIC_SLEEP_RATIO);
+  ts->load = sch->load;
+  ts->loops = mt_metric_counter(sch->metrics, MT_SCH_METRIC_LOOPS);
+  ts->sleep_ns = mt_metric_counter(sch->metrics, MT_SCH_METRIC_SLEEP_NS);
+  mt_sch_unlock(sch);
+}
+
+static void telemetry_fill_ptp(struct mtl_main_impl* impl, struct mtl_telemetry_shm* t) {
+  int num_ports = mt_num_ports(impl);
+  struct mt_ptp_impl* ptp;
+  struct mtl_telemetry_ptp* tp;
+
+  t->nb_ports = num_ports;
+  for (int i = 0; i < num_ports; i++) {
+    tp = &t->ptp[i];
+    memset(tp, 0, sizeof(*tp));
+    ptp = mt_get_ptp(impl, i);
+    if (!ptp) continue;
+    tp->active = 1;
+    tp->master_initialized = ptp->master_initialized ? 1 : 0;
+    tp->sync = mt_metric_counter(ptp->metrics, MT_PTP_METRIC_SYNC);
+    tp->offset_ns = mt_metric_gauge(ptp->metrics, MT_PTP_METRIC_OFFSET_NS);
+    tp->path_delay_ns = mt_metric_gauge(ptp->metrics, MT_PTP_METRIC_PATH_DELAY_NS);
+  }
+}
+
+static void telemetry_fill_dma(struct mtl_main_impl* impl, struct mtl_telemetry_shm* t) {
+  struct mt_dma_mgr* mgr = mt_get_dma_mgr(impl);
+  struct mt_dma_dev* dev;
+  struct mtl_telemetry_dma* td;
+
+  mt_pthread_mutex_lock(&mgr->mutex);
+  for (int i = 0; i < mgr->num_dma_dev; i++) {
+    dev = &mgr->devs[i];
+    if (!dev->active) continue;
+    td = &t->dma[t->nb_dmas++];
+    td->idx = dev->idx;
+    td->sch_idx = dev->sch_idx;
+    td->nb_session = dev->nb_session;
+    td->nb_inflight = dev->nb_inflight;
+    td->load_q = dev->load_q;
+    td->load_bps = dev->load_bps;
+  }
+  mt_pthread_mutex_unlock(&mgr->mutex);
+}
+
+static int telemetry_update(struct mtl_main_impl* impl) {
+  struct mt_telemetry* tele = mt_get_telemetry(impl);
+  struct mtl_telemetry_shm* t = tele->staging;
+  struct mtl_telemetry_shm* shm = tele->shm;
+  struct mt_sch_impl* sch;
+  uint32_t seq;
+
+  t->nb_sessions = 0;
+  t->nb_schs = 0;
+  t->nb_dmas = 0;
+  for (int sch_idx = 0; sch_idx < MT_MAX_SCH_NUM; sch_idx++) {
+    sch = mt_sch_instance(impl, sch_idx);
+    if (!mt_sch_is_active(sch)) continue;
+    telemetry_fill_sch(t, sch);
+    telemetry_fill_tx_video(t, sch);
+    telemetry_fill_rx_video(t, sch);
+  }
+  telemetry_fill_ptp(impl, t);
+  telemetry_fill_dma(impl, t);
+  t->update_ns = mt_get_real_time();
+
+  /* seqlock write, only the copy is inside the odd window */
+  seq = shm->seq;
+  __atomic_store_n(&shm->seq, seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  shm->update_ns = t->update_ns;
+  shm->nb_sessions = t->nb_sessions;
+  shm->nb_schs = t->nb_schs;
+  shm->nb_ports = t->nb_ports;
+  shm->nb_dmas = t->nb_dmas;
+  rte_memcpy(shm->schs, t->schs, sizeof(*t->schs) * t->nb_schs);
+  rte_memcpy(shm->ptp, t->ptp, sizeof(*t->ptp) * t->nb_ports);
+  rte_memcpy(shm->dma, t->dma, sizeof(*t->dma) * t->nb_dmas);
+  rte_memcpy(shm->sessions, t->sessions, sizeof(*t->sessions) * t->nb_sessions);
+  __atomic_store_n(&shm->seq, seq + 2, __ATOMIC_RELEASE);
+
+  dbg("%s, seq %u sessions %u schs %u\n", __func__, seq + 2, t->nb_sessions, t->nb_schs);
+  return 0;
+}
+
+static void telemetry_wakeup_thread(struct mt_telemetry* tele) {
+  mt_pthread_mutex_lock(&tele->wake_mutex);
+  mt_pthread_cond_signal(&tele->wake_cond);
+  mt_pthread_mutex_unlock(&tele->wake_mutex);
+}
+
+static void telemetry_alarm_handler(void* param) {
+  struct mtl_main_impl* impl = param;
+
+  telemetry_wakeup_thread(mt_get_telemetry(impl));
+}
+
+static void* telemetry_thread(void* arg) {
+  struct mtl_main_impl* impl = arg;
+  struct mt_telemetry* tele = mt_get_telemetry(impl);
+
+  info("%s, start\n", __func__);
+  while (rte_atomic32_read(&tele->stop) == 0) {
+    mt_pthread_mutex_lock(&tele->wake_mutex);
+    if (!rte_atomic32_read(&tele->stop))
+      mt_pthread_cond_wait(&tele->wake_cond, &tele->wake_mutex);
+    mt_pthread_mutex_unlock(&tele->wake_mutex);
+
+    if (rte_atomic32_read(&tele->stop)) break;
+    telemetry_update(impl);
+    rte_eal_alarm_set(tele->period_ms * US_PER_MS, telemetry_alarm_handler, impl);
+  }
+  info("%s, stop\n", __func__);
+
+  return NULL;
+}
+
+static int telemetry_shm_detach(struct mt_telemetry* tele) {
+  if (tele->shm) {
+    shmdt(tele->shm);
+    tele->shm = NULL;
+  }
+  if (tele->shm_id >= 0) {
+    if (shmctl(tele->shm_id, IPC_RMID, NULL) < 0)
+      warn("%s, can not remove shared memory, %s\n", __func__, strerror(errno));
+    tele->shm_id = -1;
+  }
+  return 0;
+}
+
+static int telemetry_shm_attach(struct mt_telemetry* tele) {
+  struct mtl_telemetry_shm* shm;
+  pid_t pid = getpid();
+  key_t key = mtl_telemetry_shm_key(pid);
+  int shm_id;
+
+  /* read only for others, a stale segment from a dead process with same pid is reused */
+  shm_id = shmget(key, sizeof(*shm), 0644 | IPC_CREAT);
+  if (shm_id < 0) {
+    err("%s, can not get shared memory for key 0x%x, %s\n", __func__, (unsigned int)key,
+        strerror(errno));
+    return -EIO;
+  }
+  tele->shm_id = shm_id;
+
+  shm = shmat(shm_id, NULL, 0);
+  if (shm == (void*)-1) {
+    err("%s, can not attach shared memory, %s\n", __func__, strerror(errno));
+    telemetry_shm_detach(tele);
+    return -EIO;
+  }
+  tele->shm = shm;
+
+  memset(shm, 0, sizeof(*shm));
+  shm->version = MTL_TELEMETRY_VERSION;
+  shm->size = sizeof(*shm);
+  shm->pid = pid;
+  shm->period_ms = tele->period_ms;
+  /* magic last, the readers check it first */
+  __atomic_store_n(&shm->magic, MTL_TELEMETRY_MAGIC, __ATOMIC_RELEASE);
+
+  info("%s, key 0x%x size %" PRIu64 "\n", __func__, (unsigned int)key, sizeof(*shm));
+  return 0;
+}
+
+int mt_telemetry_init(struct mtl_main_impl* impl) {
+  struct mt_telemetry* tele = mt_get_telemetry(impl);
+  int ret;
+
+  RTE_BUILD_BUG_ON(MTL_TELEMETRY_SCH_MAX < MT_MAX_SCH_NUM);
+  RTE_BUILD_BUG_ON(MTL_TELEMETRY_PORT_MAX < MTL_PORT_MAX);
+  RTE_BUILD_BUG_ON(MTL_TELEMETRY_DMA_MAX < MTL_DMA_DEV_MAX);
+
+  tele->shm_id = -1;
+  if (!mt_has_telemetry_shm(impl)) return 0;
+
+  tele->period_ms = MT_TELEMETRY_PERIOD_MS;
+  tele->staging = mt_rte_zmalloc_socket(sizeof(*tele->staging),
+                                        mt_socket_id(impl, MTL_PORT_P));
+  if (!tele->staging) {
+    err("%s, staging malloc fail\n", __func__);
+    return -ENOMEM;
+  }
+
+  ret = telemetry_shm_attach(tele);
+  if (ret < 0) {
+    mt_telemetry_uinit(impl);
+    return ret;
+  }
+
+  mt_pthread_mutex_init(&tele->wake_mutex, NULL);
+  mt_pthread_cond_init(&tele->wake_cond, NULL);
+  rte_atomic32_set(&tele->stop, 0);
+  ret = pthread_create(&tele->tid, NULL, telemetry_thread, impl);
+  if (ret) {
+    err("%s, thread create fail %d\n", __func__, ret);
+    tele->tid = 0;
+    mt_telemetry_uinit(impl);
+    return -EIO;
+  }
+  rte_eal_alarm_set(tele->period_ms * US_PER_MS, telemetry_alarm_handler, impl);
+
+  return 0;
+}
+
+int mt_telemetry_uinit(struct mtl_main_impl* impl) {
+  struct mt_telemetry* tele = mt_get_telemetry(impl);
+
+  if (!tele->staging) return 0; /* not enabled */
+
+  if (tele->tid) {
+    rte_atomic32_set(&tele->stop, 1);
+    telemetry_wakeup_thread(tele);
+    pthread_join(tele->tid, NULL);
+    tele->tid = 0;
+    rte_eal_alarm_cancel(telemetry_alarm_handler, impl);
+    mt_pthread_mutex_destroy(&tele->wake_mutex);
+    mt_pthread_cond_destroy(&tele->wake_cond);
+  }
+
+  telemetry_shm_detach(tele);
+  mt_rte_free(tele->staging);
+  tele->staging = NULL;
+
+  return 0;
+}
@@ -0,0 +1,17 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _MT_LIB_TELEMETRY_HEAD_H_
+#define _MT_LIB_TELEMETRY_HEAD_H_
+
+#include "mt_main.h"
+#include "mtl_telemetry_api.h"
+
+/* the default update period of the telemetry segment */
+#define MT_TELEMETRY_PERIOD_MS (1000)
+
+int mt_telemetry_init(struct mtl_main_impl* impl);
+int mt_telemetry_uinit(struct mtl_main_impl* impl);
+
+#endif
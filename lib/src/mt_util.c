@@ -4,6 +4,7 @@
 
 #include "mt_util.h"
 
+#include "mt_arena.h"
 #include "mt_log.h"
 #include "mt_main.h"
 
@@ -200,6 +201,17 @@ int mt_build_port_map(struct mtl_main_impl* impl, char** ports, enum mtl_port* m
   return 0;
 }
 
+int mt_port_socket_id(struct mtl_main_impl* impl, const char* port) {
+  struct mtl_init_params* p = mt_get_user_params(impl);
+
+  for (int i = 0; i < p->num_ports; i++) {
+    if (0 == strncmp(p->port[i], port, MTL_PORT_MAX_LEN)) return mt_socket_id(impl, i);
+  }
+
+  dbg("%s, unknown port %s, use the socket of port P\n", __func__, port);
+  return mt_socket_id(impl, MTL_PORT_P);
+}
+
 int mt_pacing_train_result_add(struct mtl_main_impl* impl, enum mtl_port port,
                                uint64_t rl_bps, float pad_interval) {
   struct mt_pacing_train_result* ptr = &mt_if(impl, port)->pt_results[0];
@@ -571,6 +583,29 @@ int st_rx_source_info_check(struct st_rx_source_info* src, int num_ports) {
   return 0;
 }
 
+int st_frame_trans_alloc(struct mtl_main_impl* impl, struct st_frame_trans* frame,
+                         size_t size, int soc_id, struct mt_arena_quota* quota) {
+  struct mt_arena_frame* arena_frame;
+  void* addr;
+
+  if (mt_has_frame_arena(impl)) {
+    arena_frame = mt_arena_get(impl, size, soc_id, quota);
+    if (!arena_frame) return -ENOMEM;
+    frame->arena = arena_frame;
+    frame->addr = arena_frame->addr;
+    frame->iova = arena_frame->iova;
+    frame->flags = ST_FT_FLAG_ARENA;
+    return 0;
+  }
+
+  addr = mt_rte_zmalloc_socket(size, soc_id);
+  if (!addr) return -ENOMEM;
+  frame->addr = addr;
+  frame->iova = rte_malloc_virt2iova(addr);
+  frame->flags = ST_FT_FLAG_RTE_MALLOC;
+  return 0;
+}
+
 int st_frame_trans_uinit(struct st_frame_trans* frame) {
   int idx = frame->idx;
 
@@ -587,6 +622,11 @@ int st_frame_trans_uinit(struct st_frame_trans* frame) {
       dbg("%s(%d), free rte mem\n", __func__, idx);
       mt_rte_free(frame->addr);
     }
+    if (frame->flags & ST_FT_FLAG_ARENA) {
+      dbg("%s(%d), put back to arena\n", __func__, idx);
+      mt_arena_put(frame->arena);
+      frame->arena = NULL;
+    }
     frame->addr = NULL;
   }
   frame->iova = 0;
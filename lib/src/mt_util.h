@@ -62,6 +62,9 @@ int mt_pacing_train_result_search(struct mtl_main_impl* impl, enum mtl_port port
 int mt_build_port_map(struct mtl_main_impl* impl, char** ports, enum mtl_port* maps,
                       int num_ports);
 
+/* numa socket of the port name, fallback to the socket of MTL_PORT_P if not found */
+int mt_port_socket_id(struct mtl_main_impl* impl, const char* port);
+
 /* logical session port to main(physical) port */
 static inline enum mtl_port mt_port_logic2phy(enum mtl_port* maps,
                                               enum mtl_session_port logic) {
@@ -161,6 +164,9 @@ int mt_ip_addr_check(uint8_t* ip);
 
 int st_rx_source_info_check(struct st_rx_source_info* src, int num_ports);
 
+/* alloc the frame from the arena if MTL_FLAG_FRAME_ARENA, else by rte malloc */
+int st_frame_trans_alloc(struct mtl_main_impl* impl, struct st_frame_trans* frame,
+                         size_t size, int soc_id, struct mt_arena_quota* quota);
 int st_frame_trans_uinit(struct st_frame_trans* frame);
 
 int st_vsync_calculate(struct mtl_main_impl* impl, struct st_vsync_info* vsync);
@@ -4,7 +4,9 @@
 
 #include "st20_pipeline_rx.h"
 
+#include "../../mt_arena.h"
 #include "../../mt_log.h"
+#include "../../mt_stat.h"
 
 static const char* st20p_rx_frame_stat_name[ST20P_RX_FRAME_STATUS_MAX] = {
     "free", "ready", "in_converting", "converted", "in_user",
@@ -307,6 +309,16 @@ static int rx_st20p_convert_dump(void* priv) {
   return 0;
 }
 
+static int rx_st20p_stat(void* priv) {
+  struct st20p_rx_ctx* ctx = priv;
+  char hist[128];
+
+  if (mt_hist_summary(&ctx->stat_user_hist, hist, sizeof(hist)))
+    notice("RX_st20p(%s), user hold %s\n", ctx->ops_name, hist);
+
+  return 0;
+}
+
 static int rx_st20p_create_transport(struct mtl_main_impl* impl, struct st20p_rx_ctx* ctx,
                                      struct st20p_rx_ops* ops) {
   int idx = ctx->idx;
@@ -320,6 +332,7 @@ static int rx_st20p_create_transport(struct mtl_main_impl* impl, struct st20p_rx
   ops_rx.num_port = RTE_MIN(ops->port.num_port, MTL_SESSION_PORT_MAX);
   for (int i = 0; i < ops_rx.num_port; i++) {
     memcpy(ops_rx.sip_addr[i], ops->port.sip_addr[i], MTL_IP_ADDR_LEN);
+    memcpy(ops_rx.mcast_sip_addr[i], ops->port.mcast_sip_addr[i], MTL_IP_ADDR_LEN);
     strncpy(ops_rx.port[i], ops->port.port[i], MTL_PORT_MAX_LEN);
     ops_rx.udp_src_port[i] = ops->port.udp_src_port[i];
     ops_rx.udp_port[i] = ops->port.udp_port[i];
@@ -424,7 +437,11 @@ static int rx_st20p_uinit_dst_fbs(struct st20p_rx_ctx* ctx) {
         !(ctx->ops.flags & ST20P_RX_FLAG_EXT_FRAME)) {
       /* do not free derived/ext frames */
       for (uint16_t i = 0; i < ctx->framebuff_cnt; i++) {
-        if (ctx->framebuffs[i].dst.addr[0]) {
+        if (ctx->framebuffs[i].arena) {
+          mt_arena_put(ctx->framebuffs[i].arena);
+          ctx->framebuffs[i].arena = NULL;
+          ctx->framebuffs[i].dst.addr[0] = NULL;
+        } else if (ctx->framebuffs[i].dst.addr[0]) {
           mt_rte_free(ctx->framebuffs[i].dst.addr[0]);
           ctx->framebuffs[i].dst.addr[0] = NULL;
         }
@@ -440,7 +457,7 @@ static int rx_st20p_uinit_dst_fbs(struct st20p_rx_ctx* ctx) {
 static int rx_st20p_init_dst_fbs(struct mtl_main_impl* impl, struct st20p_rx_ctx* ctx,
                                  struct st20p_rx_ops* ops) {
   int idx = ctx->idx;
-  int soc_id = mt_socket_id(impl, MTL_PORT_P);
+  int soc_id = mt_port_socket_id(impl, ops->port.port[MTL_SESSION_PORT_P]);
   struct st20p_rx_frame* frames;
   void* dst = NULL;
   size_t dst_size = ctx->dst_size;
@@ -452,6 +469,7 @@ static int rx_st20p_init_dst_fbs(struct mtl_main_impl* impl, struct st20p_rx_ctx
     return -ENOMEM;
   }
   ctx->framebuffs = frames;
+  mt_arena_quota_init(&ctx->arena_quota, ctx->framebuff_cnt, dst_size);
 
   for (uint16_t i = 0; i < ctx->framebuff_cnt; i++) {
     frames[i].stat = ST20P_RX_FRAME_FREE;
@@ -476,7 +494,12 @@ static int rx_st20p_init_dst_fbs(struct mtl_main_impl* impl, struct st20p_rx_ctx
           frames[i].dst.iova[plane] = 0;
         }
       } else {
-        dst = mt_rte_zmalloc_socket(dst_size, soc_id);
+        if (mt_has_frame_arena(impl)) {
+          frames[i].arena = mt_arena_get(impl, dst_size, soc_id, &ctx->arena_quota);
+          dst = frames[i].arena ? frames[i].arena->addr : NULL;
+        } else {
+          dst = mt_rte_zmalloc_socket(dst_size, soc_id);
+        }
         if (!dst) {
           err("%s(%d), dst frame malloc fail at %u\n", __func__, idx, i);
           rx_st20p_uinit_dst_fbs(ctx);
@@ -593,6 +616,7 @@ struct st_frame* st20p_rx_get_ext_frame(st20p_rx_handle handle,
   ctx->internal_converter->convert_func(&framebuff->src, &framebuff->dst);
 
   framebuff->stat = ST20P_RX_FRAME_IN_USER;
+  framebuff->get_tsc = mt_get_tsc(ctx->impl);
   /* point to next */
   ctx->framebuff_consumer_idx = rx_st20p_next_idx(ctx, framebuff->idx);
 
@@ -636,6 +660,7 @@ struct st_frame* st20p_rx_get_frame(st20p_rx_handle handle) {
   }
 
   framebuff->stat = ST20P_RX_FRAME_IN_USER;
+  framebuff->get_tsc = mt_get_tsc(ctx->impl);
   /* point to next */
   ctx->framebuff_consumer_idx = rx_st20p_next_idx(ctx, framebuff->idx);
 
@@ -661,6 +686,7 @@ int st20p_rx_put_frame(st20p_rx_handle handle, struct st_frame* frame) {
         framebuff->stat);
     return -EIO;
   }
+  mt_hist_add(&ctx->stat_user_hist, mt_get_tsc(ctx->impl) - framebuff->get_tsc);
 
   /* free the frame */
   st20_rx_put_framebuff(ctx->transport, framebuff->src.addr[0]);
@@ -741,6 +767,7 @@ st20p_rx_handle st20p_rx_create(mtl_handle mt, struct st20p_rx_ops* ops) {
 
   /* all ready now */
   ctx->ready = true;
+  mt_stat_register(impl, rx_st20p_stat, ctx);
   info("%s(%d), transport fmt %s, output fmt %s\n", __func__, idx,
        st20_frame_fmt_name(ops->transport_fmt), st_frame_fmt_name(ops->output_fmt));
 
@@ -760,6 +787,11 @@ int st20p_rx_free(st20p_rx_handle handle) {
     return -EIO;
   }
 
+  if (ctx->ready) {
+    mt_stat_unregister(impl, rx_st20p_stat, ctx);
+    ctx->ready = false;
+  }
+
   if (ctx->convert_impl) {
     st20_put_converter(impl, ctx->convert_impl);
     ctx->convert_impl = NULL;
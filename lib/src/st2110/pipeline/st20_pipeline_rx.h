@@ -23,6 +23,8 @@ struct st20p_rx_frame {
   struct st_frame dst; /* converted */
   struct st20_convert_frame_meta convert_frame;
   uint16_t idx;
+  uint64_t get_tsc; /* the time of get_frame */
+  struct mt_arena_frame* arena; /* the dst frame from the arena */
 };
 
 struct st20p_rx_ctx {
@@ -38,6 +40,7 @@ struct st20p_rx_ctx {
   uint16_t framebuff_producer_idx;
   uint16_t framebuff_convert_idx;
   uint16_t framebuff_consumer_idx;
+  struct mt_arena_quota arena_quota;
   struct st20p_rx_frame* framebuffs;
   pthread_mutex_t lock;
 
@@ -50,6 +53,8 @@ struct st20p_rx_ctx {
 
   rte_atomic32_t stat_convert_fail;
   rte_atomic32_t stat_busy;
+  /* the time the user hold a frame, from get_frame to put_frame */
+  struct mt_hist stat_user_hist;
 };
 
 #endif
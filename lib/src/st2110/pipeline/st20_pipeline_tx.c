@@ -4,7 +4,9 @@
 
 #include "st20_pipeline_tx.h"
 
+#include "../../mt_arena.h"
 #include "../../mt_log.h"
+#include "../../mt_stat.h"
 
 static const char* st20p_tx_frame_stat_name[ST20P_TX_FRAME_STATUS_MAX] = {
     "free", "ready", "in_converting", "converted", "in_user", "in_transmitting",
@@ -217,6 +219,16 @@ static int tx_st20p_convert_dump(void* priv) {
   return 0;
 }
 
+static int tx_st20p_stat(void* priv) {
+  struct st20p_tx_ctx* ctx = priv;
+  char hist[128];
+
+  if (mt_hist_summary(&ctx->stat_user_hist, hist, sizeof(hist)))
+    notice("TX_st20p(%s), user hold %s\n", ctx->ops_name, hist);
+
+  return 0;
+}
+
 static int tx_st20p_create_transport(struct mtl_main_impl* impl, struct st20p_tx_ctx* ctx,
                                      struct st20p_tx_ops* ops) {
   int idx = ctx->idx;
@@ -299,7 +311,11 @@ static int tx_st20p_uinit_src_fbs(struct st20p_tx_ctx* ctx) {
     if (!ctx->derive && !(ctx->ops.flags & ST20P_TX_FLAG_EXT_FRAME)) {
       /* do not free derived/ext frames */
       for (uint16_t i = 0; i < ctx->framebuff_cnt; i++) {
-        if (ctx->framebuffs[i].src.addr[0]) {
+        if (ctx->framebuffs[i].arena) {
+          mt_arena_put(ctx->framebuffs[i].arena);
+          ctx->framebuffs[i].arena = NULL;
+          ctx->framebuffs[i].src.addr[0] = NULL;
+        } else if (ctx->framebuffs[i].src.addr[0]) {
           mt_rte_free(ctx->framebuffs[i].src.addr[0]);
           ctx->framebuffs[i].src.addr[0] = NULL;
         }
@@ -315,7 +331,7 @@ static int tx_st20p_uinit_src_fbs(struct st20p_tx_ctx* ctx) {
 static int tx_st20p_init_src_fbs(struct mtl_main_impl* impl, struct st20p_tx_ctx* ctx,
                                  struct st20p_tx_ops* ops) {
   int idx = ctx->idx;
-  int soc_id = mt_socket_id(impl, MTL_PORT_P);
+  int soc_id = mt_port_socket_id(impl, ops->port.port[MTL_SESSION_PORT_P]);
   struct st20p_tx_frame* frames;
   void* src = NULL;
   size_t src_size = ctx->src_size;
@@ -327,6 +343,7 @@ static int tx_st20p_init_src_fbs(struct mtl_main_impl* impl, struct st20p_tx_ctx
     return -ENOMEM;
   }
   ctx->framebuffs = frames;
+  mt_arena_quota_init(&ctx->arena_quota, ctx->framebuff_cnt, src_size);
 
   for (uint16_t i = 0; i < ctx->framebuff_cnt; i++) {
     frames[i].stat = ST20P_TX_FRAME_FREE;
@@ -342,7 +359,12 @@ static int tx_st20p_init_src_fbs(struct mtl_main_impl* impl, struct st20p_tx_ctx
           frames[i].src.iova[plane] = 0;
         }
       } else {
-        src = mt_rte_zmalloc_socket(src_size, soc_id);
+        if (mt_has_frame_arena(impl)) {
+          frames[i].arena = mt_arena_get(impl, src_size, soc_id, &ctx->arena_quota);
+          src = frames[i].arena ? frames[i].arena->addr : NULL;
+        } else {
+          src = mt_rte_zmalloc_socket(src_size, soc_id);
+        }
         if (!src) {
           err("%s(%d), src frame malloc fail at %u\n", __func__, idx, i);
           tx_st20p_uinit_src_fbs(ctx);
@@ -431,6 +453,7 @@ struct st_frame* st20p_tx_get_frame(st20p_tx_handle handle) {
   }
 
   framebuff->stat = ST20P_TX_FRAME_IN_USER;
+  framebuff->get_tsc = mt_get_tsc(ctx->impl);
   /* point to next */
   ctx->framebuff_producer_idx = tx_st20p_next_idx(ctx, framebuff->idx);
   mt_pthread_mutex_unlock(&ctx->lock);
@@ -457,6 +480,7 @@ int st20p_tx_put_frame(st20p_tx_handle handle, struct st_frame* frame) {
         framebuff->stat);
     return -EIO;
   }
+  mt_hist_add(&ctx->stat_user_hist, mt_get_tsc(ctx->impl) - framebuff->get_tsc);
 
   if (ctx->internal_converter) { /* convert internal */
     ctx->internal_converter->convert_func(&framebuff->src, &framebuff->dst);
@@ -495,6 +519,7 @@ int st20p_tx_put_ext_frame(st20p_tx_handle handle, struct st_frame* frame,
         framebuff->stat);
     return -EIO;
   }
+  mt_hist_add(&ctx->stat_user_hist, mt_get_tsc(ctx->impl) - framebuff->get_tsc);
 
   uint8_t planes = st_frame_fmt_planes(framebuff->src.fmt);
   if (ctx->derive) {
@@ -613,6 +638,7 @@ st20p_tx_handle st20p_tx_create(mtl_handle mt, struct st20p_tx_ops* ops) {
 
   /* all ready now */
   ctx->ready = true;
+  mt_stat_register(impl, tx_st20p_stat, ctx);
   info("%s(%d), transport fmt %s, input fmt: %s\n", __func__, idx,
        st20_frame_fmt_name(ops->transport_fmt), st_frame_fmt_name(ops->input_fmt));
 
@@ -632,6 +658,11 @@ int st20p_tx_free(st20p_tx_handle handle) {
     return -EIO;
   }
 
+  if (ctx->ready) {
+    mt_stat_unregister(impl, tx_st20p_stat, ctx);
+    ctx->ready = false;
+  }
+
   if (ctx->convert_impl) {
     st20_put_converter(impl, ctx->convert_impl);
     ctx->convert_impl = NULL;
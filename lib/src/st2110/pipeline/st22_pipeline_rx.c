@@ -195,6 +195,7 @@ static int rx_st22p_create_transport(struct mtl_main_impl* impl, struct st22p_rx
   ops_rx.num_port = RTE_MIN(ops->port.num_port, MTL_SESSION_PORT_MAX);
   for (int i = 0; i < ops_rx.num_port; i++) {
     memcpy(ops_rx.sip_addr[i], ops->port.sip_addr[i], MTL_IP_ADDR_LEN);
+    memcpy(ops_rx.mcast_sip_addr[i], ops->port.mcast_sip_addr[i], MTL_IP_ADDR_LEN);
     strncpy(ops_rx.port[i], ops->port.port[i], MTL_PORT_MAX_LEN);
     ops_rx.udp_src_port[i] = ops->port.udp_src_port[i];
     ops_rx.udp_port[i] = ops->port.udp_port[i];
@@ -258,7 +259,7 @@ static int rx_st22p_uinit_dst_fbs(struct st22p_rx_ctx* ctx) {
 static int rx_st22p_init_dst_fbs(struct mtl_main_impl* impl, struct st22p_rx_ctx* ctx,
                                  struct st22p_rx_ops* ops) {
   int idx = ctx->idx;
-  int soc_id = mt_socket_id(impl, MTL_PORT_P);
+  int soc_id = mt_port_socket_id(impl, ops->port.port[MTL_SESSION_PORT_P]);
   struct st22p_rx_frame* frames;
   void* dst;
   size_t dst_size = ctx->dst_size;
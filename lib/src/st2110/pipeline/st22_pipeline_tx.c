@@ -307,7 +307,7 @@ static int tx_st22p_uinit_src_fbs(struct st22p_tx_ctx* ctx) {
 static int tx_st22p_init_src_fbs(struct mtl_main_impl* impl, struct st22p_tx_ctx* ctx,
                                  struct st22p_tx_ops* ops) {
   int idx = ctx->idx;
-  int soc_id = mt_socket_id(impl, MTL_PORT_P);
+  int soc_id = mt_port_socket_id(impl, ops->port.port[MTL_SESSION_PORT_P]);
   struct st22p_tx_frame* frames;
   void* src;
   size_t src_size = ctx->src_size;
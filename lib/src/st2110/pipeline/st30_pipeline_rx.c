@@ -0,0 +1,413 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include "st30_pipeline_rx.h"
+
+#include "../../mt_log.h"
+#include "../../mt_stat.h"
+
+static const char* st30p_rx_frame_stat_name[ST30P_RX_FRAME_STATUS_MAX] = {
+    "free",
+    "ready",
+    "in_user",
+};
+
+static const char* rx_st30p_stat_name(enum st30p_rx_frame_status stat) {
+  return st30p_rx_frame_stat_name[stat];
+}
+
+static uint16_t rx_st30p_next_idx(struct st30p_rx_ctx* ctx, uint16_t idx) {
+  /* point to next */
+  uint16_t next_idx = idx;
+  next_idx++;
+  if (next_idx >= ctx->framebuff_cnt) next_idx = 0;
+  return next_idx;
+}
+
+static int rx_st30p_frame_ready(void* priv, void* frame,
+                                struct st30_rx_frame_meta* meta) {
+  struct st30p_rx_ctx* ctx = priv;
+  struct st30p_rx_frame* framebuff;
+  uint8_t* src = frame;
+  uint32_t tmstamp = (uint32_t)meta->timestamp;
+  uint32_t remain = ctx->pkt_samples;
+  uint32_t done = 0;
+  int ready_cnt = 0;
+
+  if (!ctx->ready) return -EBUSY; /* not ready */
+
+  mt_pthread_mutex_lock(&ctx->lock);
+  if (ctx->next_tmstamp_valid && (tmstamp != ctx->next_tmstamp)) {
+    rte_atomic32_inc(&ctx->stat_discontinuity);
+  }
+  ctx->next_tmstamp = tmstamp + ctx->pkt_samples;
+  ctx->next_tmstamp_valid = true;
+
+  while (remain) {
+    framebuff = &ctx->framebuffs[ctx->framebuff_producer_idx];
+    if (ST30P_RX_FRAME_FREE != framebuff->stat) {
+      /* app is slow, drop the left samples */
+      rte_atomic32_inc(&ctx->stat_busy);
+      break;
+    }
+
+    uint32_t left = framebuff->frame.samples - ctx->producer_offset;
+    uint32_t n = RTE_MIN(remain, left);
+
+    if (!ctx->producer_offset) { /* first sample of this frame */
+      framebuff->frame.tfmt = ST10_TIMESTAMP_FMT_MEDIA_CLK;
+      framebuff->frame.timestamp = (uint32_t)(tmstamp + done);
+    }
+    st30_pcm_convert(
+        src + done * ctx->transport_group_size, ctx->ops.transport_fmt,
+        (uint8_t*)framebuff->frame.addr + ctx->producer_offset * ctx->output_group_size,
+        ctx->ops.output_fmt, ctx->ops.channel, n, &ctx->am824_frame_idx);
+    ctx->producer_offset += n;
+    done += n;
+    remain -= n;
+
+    if (ctx->producer_offset >= framebuff->frame.samples) {
+      framebuff->frame.data_size = framebuff->frame.buffer_size;
+      framebuff->stat = ST30P_RX_FRAME_READY;
+      ctx->producer_offset = 0;
+      ctx->framebuff_producer_idx = rx_st30p_next_idx(ctx, framebuff->idx);
+      ready_cnt++;
+    }
+  }
+  mt_pthread_mutex_unlock(&ctx->lock);
+
+  /* all samples are copied, return the transport frame */
+  st30_rx_put_framebuff(ctx->transport, frame);
+
+  if (ready_cnt && ctx->ops.notify_frame_available) { /* notify app */
+    ctx->ops.notify_frame_available(ctx->ops.priv);
+  }
+
+  return 0;
+}
+
+static int rx_st30p_stat(void* priv) {
+  struct st30p_rx_ctx* ctx = priv;
+  struct st30p_rx_frame* framebuff = ctx->framebuffs;
+
+  if (!ctx->ready) return -EBUSY; /* not ready */
+
+  uint16_t producer_idx = ctx->framebuff_producer_idx;
+  uint16_t consumer_idx = ctx->framebuff_consumer_idx;
+  notice("RX_st30p(%s), p(%d:%s) c(%d:%s)\n", ctx->ops_name, producer_idx,
+         rx_st30p_stat_name(framebuff[producer_idx].stat), consumer_idx,
+         rx_st30p_stat_name(framebuff[consumer_idx].stat));
+
+  int busy = rte_atomic32_read(&ctx->stat_busy);
+  rte_atomic32_set(&ctx->stat_busy, 0);
+  if (busy) {
+    notice("RX_st30p(%s), busy drop pkt %d\n", ctx->ops_name, busy);
+  }
+
+  int discontinuity = rte_atomic32_read(&ctx->stat_discontinuity);
+  rte_atomic32_set(&ctx->stat_discontinuity, 0);
+  if (discontinuity) {
+    notice("RX_st30p(%s), timestamp discontinuity %d\n", ctx->ops_name, discontinuity);
+  }
+
+  return 0;
+}
+
+static int rx_st30p_create_transport(struct mtl_main_impl* impl, struct st30p_rx_ctx* ctx,
+                                     struct st30p_rx_ops* ops) {
+  int idx = ctx->idx;
+  struct st30_rx_ops ops_rx;
+  st30_rx_handle transport;
+
+  memset(&ops_rx, 0, sizeof(ops_rx));
+  ops_rx.name = ops->name;
+  ops_rx.priv = ctx;
+  ops_rx.num_port = RTE_MIN(ops->port.num_port, MTL_SESSION_PORT_MAX);
+  for (int i = 0; i < ops_rx.num_port; i++) {
+    memcpy(ops_rx.sip_addr[i], ops->port.sip_addr[i], MTL_IP_ADDR_LEN);
+    memcpy(ops_rx.mcast_sip_addr[i], ops->port.mcast_sip_addr[i], MTL_IP_ADDR_LEN);
+    strncpy(ops_rx.port[i], ops->port.port[i], MTL_PORT_MAX_LEN);
+    ops_rx.udp_src_port[i] = ops->port.udp_src_port[i];
+    ops_rx.udp_port[i] = ops->port.udp_port[i];
+  }
+  if (ops->flags & ST30P_RX_FLAG_DATA_PATH_ONLY)
+    ops_rx.flags |= ST30_RX_FLAG_DATA_PATH_ONLY;
+  ops_rx.fmt = ops->transport_fmt;
+  ops_rx.channel = ops->channel;
+  ops_rx.sampling = ops->sampling;
+  ops_rx.ptime = ops->ptime;
+  ops_rx.payload_type = ops->port.payload_type;
+  ops_rx.type = ST30_TYPE_FRAME_LEVEL;
+  ops_rx.sample_size = st30_get_sample_size(ops->transport_fmt);
+  ops_rx.sample_num = ctx->pkt_samples;
+  /* one packet for each transport frame, the samples are streamed to the frames */
+  ops_rx.framebuff_cnt = ops->framebuff_cnt;
+  ops_rx.framebuff_size = ctx->pkt_samples * ctx->transport_group_size;
+  ops_rx.notify_frame_ready = rx_st30p_frame_ready;
+
+  transport = st30_rx_create(impl, &ops_rx);
+  if (!transport) {
+    err("%s(%d), transport create fail\n", __func__, idx);
+    return -EIO;
+  }
+  ctx->transport = transport;
+
+  return 0;
+}
+
+static int rx_st30p_uinit_fbs(struct st30p_rx_ctx* ctx) {
+  if (ctx->framebuffs) {
+    for (uint16_t i = 0; i < ctx->framebuff_cnt; i++) {
+      if (ctx->framebuffs[i].frame.addr) {
+        mt_rte_free(ctx->framebuffs[i].frame.addr);
+        ctx->framebuffs[i].frame.addr = NULL;
+      }
+    }
+    mt_rte_free(ctx->framebuffs);
+    ctx->framebuffs = NULL;
+  }
+
+  return 0;
+}
+
+static int rx_st30p_init_fbs(struct mtl_main_impl* impl, struct st30p_rx_ctx* ctx,
+                             struct st30p_rx_ops* ops) {
+  int idx = ctx->idx;
+  int soc_id = mt_port_socket_id(impl, ops->port.port[MTL_SESSION_PORT_P]);
+  struct st30p_rx_frame* frames;
+  void* addr;
+  size_t frame_size = ctx->frame_size;
+
+  ctx->framebuff_cnt = ops->framebuff_cnt;
+  frames = mt_rte_zmalloc_socket(sizeof(*frames) * ctx->framebuff_cnt, soc_id);
+  if (!frames) {
+    err("%s(%d), frames malloc fail\n", __func__, idx);
+    return -ENOMEM;
+  }
+  ctx->framebuffs = frames;
+
+  for (uint16_t i = 0; i < ctx->framebuff_cnt; i++) {
+    frames[i].stat = ST30P_RX_FRAME_FREE;
+    frames[i].idx = i;
+    addr = mt_rte_zmalloc_socket(frame_size, soc_id);
+    if (!addr) {
+      err("%s(%d), frame malloc fail at %u\n", __func__, idx, i);
+      rx_st30p_uinit_fbs(ctx);
+      return -ENOMEM;
+    }
+    frames[i].frame.addr = addr;
+    frames[i].frame.iova = mtl_hp_virt2iova(ctx->impl, addr);
+    frames[i].frame.fmt = ops->output_fmt;
+    frames[i].frame.channel = ops->channel;
+    frames[i].frame.sampling = ops->sampling;
+    frames[i].frame.samples = ops->samples_per_frame;
+    frames[i].frame.buffer_size = frame_size;
+    frames[i].frame.data_size = frame_size;
+    frames[i].frame.priv = &frames[i];
+  }
+  info("%s(%d), size %" PRIu64 " fmt %d with %u frames\n", __func__, idx, frame_size,
+       ops->output_fmt, ctx->framebuff_cnt);
+  return 0;
+}
+
+static int rx_st30p_ops_check(struct st30p_rx_ops* ops) {
+  if (!ops->notify_frame_available) {
+    err("%s, pls set notify_frame_available\n", __func__);
+    return -EINVAL;
+  }
+  if ((ops->framebuff_cnt < 2) || (ops->framebuff_cnt > ST30P_FB_MAX_COUNT)) {
+    err("%s, invalid framebuff_cnt %u\n", __func__, ops->framebuff_cnt);
+    return -EINVAL;
+  }
+  if (!ops->channel) {
+    err("%s, invalid channel %u\n", __func__, ops->channel);
+    return -EINVAL;
+  }
+  if (!ops->samples_per_frame) {
+    err("%s, invalid samples_per_frame %u\n", __func__, ops->samples_per_frame);
+    return -EINVAL;
+  }
+  if (st30_get_sample_size(ops->output_fmt) < 0) {
+    err("%s, invalid output_fmt %d\n", __func__, ops->output_fmt);
+    return -EINVAL;
+  }
+  if (st30_get_sample_size(ops->transport_fmt) < 0) {
+    err("%s, invalid transport_fmt %d\n", __func__, ops->transport_fmt);
+    return -EINVAL;
+  }
+  if (st30_get_sample_num(ops->ptime, ops->sampling) < 0) {
+    err("%s, invalid ptime %d sampling %d\n", __func__, ops->ptime, ops->sampling);
+    return -EINVAL;
+  }
+
+  return 0;
+}
+
+struct st30_frame* st30p_rx_get_frame(st30p_rx_handle handle) {
+  struct st30p_rx_ctx* ctx = handle;
+  int idx = ctx->idx;
+  struct st30p_rx_frame* framebuff;
+
+  if (ctx->type != MT_ST30_HANDLE_PIPELINE_RX) {
+    err("%s(%d), invalid type %d\n", __func__, idx, ctx->type);
+    return NULL;
+  }
+
+  if (!ctx->ready) return NULL; /* not ready */
+
+  mt_pthread_mutex_lock(&ctx->lock);
+  /* frames are delivered in order to keep the sample continuity */
+  framebuff = &ctx->framebuffs[ctx->framebuff_consumer_idx];
+  if (ST30P_RX_FRAME_READY != framebuff->stat) {
+    mt_pthread_mutex_unlock(&ctx->lock);
+    return NULL;
+  }
+
+  framebuff->stat = ST30P_RX_FRAME_IN_USER;
+  /* point to next */
+  ctx->framebuff_consumer_idx = rx_st30p_next_idx(ctx, framebuff->idx);
+  mt_pthread_mutex_unlock(&ctx->lock);
+
+  dbg("%s(%d), frame %u succ\n", __func__, idx, framebuff->idx);
+  return &framebuff->frame;
+}
+
+int st30p_rx_put_frame(st30p_rx_handle handle, struct st30_frame* frame) {
+  struct st30p_rx_ctx* ctx = handle;
+  int idx = ctx->idx;
+  struct st30p_rx_frame* framebuff = frame->priv;
+  uint16_t consumer_idx = framebuff->idx;
+
+  if (ctx->type != MT_ST30_HANDLE_PIPELINE_RX) {
+    err("%s(%d), invalid type %d\n", __func__, idx, ctx->type);
+    return -EIO;
+  }
+
+  if (ST30P_RX_FRAME_IN_USER != framebuff->stat) {
+    err("%s(%d), frame %u not in user %d\n", __func__, idx, consumer_idx,
+        framebuff->stat);
+    return -EIO;
+  }
+
+  framebuff->stat = ST30P_RX_FRAME_FREE;
+
+  dbg("%s(%d), frame %u succ\n", __func__, idx, consumer_idx);
+  return 0;
+}
+
+st30p_rx_handle st30p_rx_create(mtl_handle mt, struct st30p_rx_ops* ops) {
+  struct mtl_main_impl* impl = mt;
+  struct st30p_rx_ctx* ctx;
+  int ret;
+  int idx = 0; /* todo */
+
+  if (impl->type != MT_HANDLE_MAIN) {
+    err("%s, invalid type %d\n", __func__, impl->type);
+    return NULL;
+  }
+
+  ret = rx_st30p_ops_check(ops);
+  if (ret < 0) {
+    err("%s, st30p_rx_ops check fail %d\n", __func__, ret);
+    return NULL;
+  }
+
+  ctx = mt_rte_zmalloc_socket(sizeof(*ctx), mt_socket_id(impl, MTL_PORT_P));
+  if (!ctx) {
+    err("%s, ctx malloc fail\n", __func__);
+    return NULL;
+  }
+
+  ctx->idx = idx;
+  ctx->ready = false;
+  ctx->impl = impl;
+  ctx->type = MT_ST30_HANDLE_PIPELINE_RX;
+  ctx->pkt_samples = st30_get_sample_num(ops->ptime, ops->sampling);
+  ctx->output_group_size = st30_get_sample_size(ops->output_fmt) * ops->channel;
+  ctx->transport_group_size = st30_get_sample_size(ops->transport_fmt) * ops->channel;
+  ctx->frame_size = ctx->output_group_size * ops->samples_per_frame;
+  rte_atomic32_set(&ctx->stat_busy, 0);
+  rte_atomic32_set(&ctx->stat_discontinuity, 0);
+  mt_pthread_mutex_init(&ctx->lock, NULL);
+
+  /* copy ops */
+  strncpy(ctx->ops_name, ops->name, ST_MAX_NAME_LEN - 1);
+  ctx->ops = *ops;
+
+  /* init fbs */
+  ret = rx_st30p_init_fbs(impl, ctx, ops);
+  if (ret < 0) {
+    err("%s(%d), init fbs fail %d\n", __func__, idx, ret);
+    st30p_rx_free(ctx);
+    return NULL;
+  }
+
+  /* crete transport handle */
+  ret = rx_st30p_create_transport(impl, ctx, ops);
+  if (ret < 0) {
+    err("%s(%d), create transport fail\n", __func__, idx);
+    st30p_rx_free(ctx);
+    return NULL;
+  }
+
+  mt_stat_register(impl, rx_st30p_stat, ctx);
+
+  /* all ready now */
+  ctx->ready = true;
+  info("%s(%d), transport fmt %d, output fmt %d, samples %u per frame %u per pkt\n",
+       __func__, idx, ops->transport_fmt, ops->output_fmt, ops->samples_per_frame,
+       ctx->pkt_samples);
+
+  return ctx;
+}
+
+int st30p_rx_free(st30p_rx_handle handle) {
+  struct st30p_rx_ctx* ctx = handle;
+  struct mtl_main_impl* impl = ctx->impl;
+
+  if (ctx->type != MT_ST30_HANDLE_PIPELINE_RX) {
+    err("%s(%d), invalid type %d\n", __func__, ctx->idx, ctx->type);
+    return -EIO;
+  }
+
+  if (ctx->ready) {
+    mt_stat_unregister(impl, rx_st30p_stat, ctx);
+    ctx->ready = false;
+  }
+
+  if (ctx->transport) {
+    st30_rx_free(ctx->transport);
+    ctx->transport = NULL;
+  }
+  rx_st30p_uinit_fbs(ctx);
+
+  mt_pthread_mutex_destroy(&ctx->lock);
+  mt_rte_free(ctx);
+
+  return 0;
+}
+
+size_t st30p_rx_frame_size(st30p_rx_handle handle) {
+  struct st30p_rx_ctx* ctx = handle;
+  int cidx = ctx->idx;
+
+  if (ctx->type != MT_ST30_HANDLE_PIPELINE_RX) {
+    err("%s(%d), invalid type %d\n", __func__, cidx, ctx->type);
+    return 0;
+  }
+
+  return ctx->frame_size;
+}
+
+int st30p_rx_get_queue_meta(st30p_rx_handle handle, struct st_queue_meta* meta) {
+  struct st30p_rx_ctx* ctx = handle;
+  int cidx = ctx->idx;
+
+  if (ctx->type != MT_ST30_HANDLE_PIPELINE_RX) {
+    err("%s(%d), invalid type %d\n", __func__, cidx, ctx->type);
+    return -EIO;
+  }
+
+  return st30_rx_get_queue_meta(ctx->transport, meta);
+}
@@ -0,0 +1,55 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _ST_LIB_PIPELINE_ST30_RX_HEAD_H_
+#define _ST_LIB_PIPELINE_ST30_RX_HEAD_H_
+
+#include "../st_main.h"
+
+enum st30p_rx_frame_status {
+  ST30P_RX_FRAME_FREE = 0,
+  ST30P_RX_FRAME_READY, /* all samples filled from transport */
+  ST30P_RX_FRAME_IN_USER,
+  ST30P_RX_FRAME_STATUS_MAX,
+};
+
+struct st30p_rx_frame {
+  enum st30p_rx_frame_status stat;
+  struct st30_frame frame;
+  uint16_t idx;
+};
+
+struct st30p_rx_ctx {
+  struct mtl_main_impl* impl;
+  int idx;
+  enum mt_handle_type type; /* for sanity check */
+
+  char ops_name[ST_MAX_NAME_LEN];
+  struct st30p_rx_ops ops;
+
+  st30_rx_handle transport;
+  uint16_t framebuff_cnt;
+  uint16_t framebuff_producer_idx;
+  uint16_t framebuff_consumer_idx;
+  /* samples already filled of the producer frame */
+  uint32_t producer_offset;
+  struct st30p_rx_frame* framebuffs;
+  pthread_mutex_t lock;
+
+  uint16_t pkt_samples; /* samples of single channel in one packet */
+  size_t output_group_size;    /* bytes of one sample for all channels, output fmt */
+  size_t transport_group_size; /* bytes of one sample for all channels, transport fmt */
+  /* expected media clk of next packet, for discontinuity detect */
+  uint32_t next_tmstamp;
+  bool next_tmstamp_valid;
+  uint32_t am824_frame_idx;
+
+  bool ready;
+  size_t frame_size;
+
+  rte_atomic32_t stat_busy;
+  rte_atomic32_t stat_discontinuity;
+};
+
+#endif
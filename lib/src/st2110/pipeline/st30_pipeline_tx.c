@@ -0,0 +1,495 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include "st30_pipeline_tx.h"
+
+#include "../../mt_log.h"
+#include "../../mt_stat.h"
+
+static const char* st30p_tx_frame_stat_name[ST30P_TX_FRAME_STATUS_MAX] = {
+    "free",
+    "in_user",
+    "ready",
+    "in_transmitting",
+};
+
+static const char* tx_st30p_stat_name(enum st30p_tx_frame_status stat) {
+  return st30p_tx_frame_stat_name[stat];
+}
+
+static uint16_t tx_st30p_next_idx(struct st30p_tx_ctx* ctx, uint16_t idx) {
+  /* point to next */
+  uint16_t next_idx = idx;
+  next_idx++;
+  if (next_idx >= ctx->framebuff_cnt) next_idx = 0;
+  return next_idx;
+}
+
+/* samples can be packed from the consumer frame, frames are consumed in order */
+static uint32_t tx_st30p_ready_samples(struct st30p_tx_ctx* ctx, uint32_t max) {
+  uint16_t idx = ctx->framebuff_consumer_idx;
+  uint32_t samples = 0;
+  struct st30p_tx_frame* framebuff;
+
+  for (uint16_t i = 0; i < ctx->framebuff_cnt; i++) {
+    framebuff = &ctx->framebuffs[idx];
+    if (framebuff->stat != ST30P_TX_FRAME_READY) break;
+    samples += framebuff->frame.samples;
+    if (i == 0) samples -= ctx->consumer_offset;
+    if (samples >= max) break;
+    idx = tx_st30p_next_idx(ctx, idx);
+  }
+
+  return samples;
+}
+
+static int tx_st30p_next_frame(void* priv, uint16_t* next_frame_idx,
+                               struct st30_tx_frame_meta* meta) {
+  struct st30p_tx_ctx* ctx = priv;
+  struct st30p_tx_frame* framebuff;
+  uint32_t need = ctx->pkt_samples;
+  uint16_t trans_idx;
+  uint8_t* dst;
+  uint64_t seq;
+
+  if (!ctx->ready) return -EBUSY; /* not ready */
+
+  mt_pthread_mutex_lock(&ctx->lock);
+  /* not enough samples for one packet */
+  if (tx_st30p_ready_samples(ctx, need) < need) {
+    mt_pthread_mutex_unlock(&ctx->lock);
+    return -EBUSY;
+  }
+
+  trans_idx = ctx->trans_idx;
+  dst = st30_tx_get_framebuffer(ctx->transport, trans_idx);
+  seq = ctx->pkt_seq++;
+  ctx->trans_seq[trans_idx] = seq;
+
+  framebuff = &ctx->framebuffs[ctx->framebuff_consumer_idx];
+  if ((ctx->ops.flags & ST30P_TX_FLAG_USER_TIMESTAMP) &&
+      (framebuff->frame.tfmt == ST10_TIMESTAMP_FMT_MEDIA_CLK)) {
+    /* media clk of audio is the sample rate */
+    meta->tfmt = ST10_TIMESTAMP_FMT_MEDIA_CLK;
+    meta->timestamp = (uint32_t)(framebuff->frame.timestamp + ctx->consumer_offset);
+  }
+
+  while (need) {
+    framebuff = &ctx->framebuffs[ctx->framebuff_consumer_idx];
+    uint32_t done = ctx->pkt_samples - need;
+    uint32_t left = framebuff->frame.samples - ctx->consumer_offset;
+    uint32_t n = RTE_MIN(need, left);
+
+    if (!ctx->consumer_offset) { /* first sample of this frame */
+      framebuff->start_seq = seq;
+      framebuff->start_offset = done;
+      framebuff->stamp_pending = true;
+    }
+    st30_pcm_convert(
+        (uint8_t*)framebuff->frame.addr + ctx->consumer_offset * ctx->input_group_size,
+        ctx->ops.input_fmt, dst + done * ctx->transport_group_size,
+        ctx->ops.transport_fmt, ctx->ops.channel, n, &ctx->am824_frame_idx);
+    ctx->consumer_offset += n;
+    need -= n;
+
+    if (ctx->consumer_offset >= framebuff->frame.samples) {
+      framebuff->done_seq = seq;
+      framebuff->stat = ST30P_TX_FRAME_IN_TRANSMITTING;
+      ctx->consumer_offset = 0;
+      ctx->framebuff_consumer_idx = tx_st30p_next_idx(ctx, framebuff->idx);
+    }
+  }
+
+  ctx->trans_idx++;
+  if (ctx->trans_idx >= ST30P_TX_TRANS_FB_CNT) ctx->trans_idx = 0;
+  mt_pthread_mutex_unlock(&ctx->lock);
+
+  *next_frame_idx = trans_idx;
+  dbg("%s(%d), pkt seq %" PRIu64 " succ\n", __func__, ctx->idx, seq);
+  return 0;
+}
+
+static int tx_st30p_frame_done(void* priv, uint16_t frame_idx,
+                               struct st30_tx_frame_meta* meta) {
+  struct st30p_tx_ctx* ctx = priv;
+  struct st30p_tx_frame* framebuff;
+  struct st30p_tx_frame* done_frames[ST30P_FB_MAX_COUNT];
+  uint16_t done_cnt = 0;
+  uint64_t seq;
+  uint16_t idx;
+
+  if (frame_idx >= ST30P_TX_TRANS_FB_CNT) {
+    err("%s(%d), invalid frame_idx %u\n", __func__, ctx->idx, frame_idx);
+    return -EIO;
+  }
+
+  mt_pthread_mutex_lock(&ctx->lock);
+  seq = ctx->trans_seq[frame_idx];
+
+  /* stamp the frames start in this packet with the ptp time of the packet */
+  idx = ctx->framebuff_done_idx;
+  for (uint16_t i = 0; i < ctx->framebuff_cnt; i++) {
+    framebuff = &ctx->framebuffs[idx];
+    if (framebuff->stamp_pending && framebuff->start_seq == seq) {
+      framebuff->stamp_pending = false;
+      if (!(ctx->ops.flags & ST30P_TX_FLAG_USER_TIMESTAMP)) {
+        framebuff->frame.tfmt = ST10_TIMESTAMP_FMT_TAI;
+        framebuff->frame.timestamp =
+            meta->timestamp + framebuff->start_offset * ctx->ns_per_sample;
+      }
+    }
+    idx = tx_st30p_next_idx(ctx, idx);
+  }
+
+  /* release the frames which all samples are sent, in order */
+  for (uint16_t i = 0; i < ctx->framebuff_cnt; i++) {
+    framebuff = &ctx->framebuffs[ctx->framebuff_done_idx];
+    if (framebuff->stat != ST30P_TX_FRAME_IN_TRANSMITTING) break;
+    if (framebuff->done_seq > seq) break;
+    framebuff->stat = ST30P_TX_FRAME_FREE;
+    done_frames[done_cnt++] = framebuff;
+    ctx->framebuff_done_idx = tx_st30p_next_idx(ctx, framebuff->idx);
+  }
+  mt_pthread_mutex_unlock(&ctx->lock);
+
+  if (!done_cnt) return 0;
+
+  if (ctx->ops.notify_frame_done) { /* notify app which frame done */
+    for (uint16_t i = 0; i < done_cnt; i++)
+      ctx->ops.notify_frame_done(ctx->ops.priv, &done_frames[i]->frame);
+  }
+
+  if (ctx->ops.notify_frame_available) { /* notify app can get frame */
+    ctx->ops.notify_frame_available(ctx->ops.priv);
+  }
+
+  return 0;
+}
+
+static int tx_st30p_stat(void* priv) {
+  struct st30p_tx_ctx* ctx = priv;
+  struct st30p_tx_frame* framebuff = ctx->framebuffs;
+
+  if (!ctx->ready) return -EBUSY; /* not ready */
+
+  uint16_t producer_idx = ctx->framebuff_producer_idx;
+  uint16_t consumer_idx = ctx->framebuff_consumer_idx;
+  notice("TX_st30p(%s), p(%d:%s) c(%d:%s)\n", ctx->ops_name, producer_idx,
+         tx_st30p_stat_name(framebuff[producer_idx].stat), consumer_idx,
+         tx_st30p_stat_name(framebuff[consumer_idx].stat));
+
+  int busy = rte_atomic32_read(&ctx->stat_busy);
+  rte_atomic32_set(&ctx->stat_busy, 0);
+  if (busy) {
+    notice("TX_st30p(%s), get frame busy %d\n", ctx->ops_name, busy);
+  }
+
+  return 0;
+}
+
+static int tx_st30p_create_transport(struct mtl_main_impl* impl, struct st30p_tx_ctx* ctx,
+                                     struct st30p_tx_ops* ops) {
+  int idx = ctx->idx;
+  struct st30_tx_ops ops_tx;
+  st30_tx_handle transport;
+
+  memset(&ops_tx, 0, sizeof(ops_tx));
+  ops_tx.name = ops->name;
+  ops_tx.priv = ctx;
+  ops_tx.num_port = RTE_MIN(ops->port.num_port, MTL_SESSION_PORT_MAX);
+  for (int i = 0; i < ops_tx.num_port; i++) {
+    memcpy(ops_tx.dip_addr[i], ops->port.dip_addr[i], MTL_IP_ADDR_LEN);
+    strncpy(ops_tx.port[i], ops->port.port[i], MTL_PORT_MAX_LEN);
+    ops_tx.udp_src_port[i] = ops->port.udp_src_port[i];
+    ops_tx.udp_port[i] = ops->port.udp_port[i];
+  }
+  if (ops->flags & ST30P_TX_FLAG_USER_P_MAC) {
+    memcpy(&ops_tx.tx_dst_mac[MTL_SESSION_PORT_P][0],
+           &ops->tx_dst_mac[MTL_SESSION_PORT_P][0], MTL_MAC_ADDR_LEN);
+    ops_tx.flags |= ST30_TX_FLAG_USER_P_MAC;
+  }
+  if (ops->flags & ST30P_TX_FLAG_USER_R_MAC) {
+    memcpy(&ops_tx.tx_dst_mac[MTL_SESSION_PORT_R][0],
+           &ops->tx_dst_mac[MTL_SESSION_PORT_R][0], MTL_MAC_ADDR_LEN);
+    ops_tx.flags |= ST30_TX_FLAG_USER_R_MAC;
+  }
+  if (ops->flags & ST30P_TX_FLAG_USER_TIMESTAMP)
+    ops_tx.flags |= ST30_TX_FLAG_USER_TIMESTAMP;
+  ops_tx.fmt = ops->transport_fmt;
+  ops_tx.channel = ops->channel;
+  ops_tx.sampling = ops->sampling;
+  ops_tx.ptime = ops->ptime;
+  ops_tx.payload_type = ops->port.payload_type;
+  ops_tx.type = ST30_TYPE_FRAME_LEVEL;
+  ops_tx.sample_size = st30_get_sample_size(ops->transport_fmt);
+  ops_tx.sample_num = ctx->pkt_samples;
+  /* one packet for each transport frame, the samples are streamed from the frames */
+  ops_tx.framebuff_cnt = ST30P_TX_TRANS_FB_CNT;
+  ops_tx.framebuff_size = ctx->pkt_samples * ctx->transport_group_size;
+  ops_tx.get_next_frame = tx_st30p_next_frame;
+  ops_tx.notify_frame_done = tx_st30p_frame_done;
+
+  transport = st30_tx_create(impl, &ops_tx);
+  if (!transport) {
+    err("%s(%d), transport create fail\n", __func__, idx);
+    return -EIO;
+  }
+  ctx->transport = transport;
+
+  return 0;
+}
+
+static int tx_st30p_uinit_fbs(struct st30p_tx_ctx* ctx) {
+  if (ctx->framebuffs) {
+    for (uint16_t i = 0; i < ctx->framebuff_cnt; i++) {
+      if (ctx->framebuffs[i].frame.addr) {
+        mt_rte_free(ctx->framebuffs[i].frame.addr);
+        ctx->framebuffs[i].frame.addr = NULL;
+      }
+    }
+    mt_rte_free(ctx->framebuffs);
+    ctx->framebuffs = NULL;
+  }
+
+  return 0;
+}
+
+static int tx_st30p_init_fbs(struct mtl_main_impl* impl, struct st30p_tx_ctx* ctx,
+                             struct st30p_tx_ops* ops) {
+  int idx = ctx->idx;
+  int soc_id = mt_port_socket_id(impl, ops->port.port[MTL_SESSION_PORT_P]);
+  struct st30p_tx_frame* frames;
+  void* addr;
+  size_t frame_size = ctx->frame_size;
+
+  ctx->framebuff_cnt = ops->framebuff_cnt;
+  frames = mt_rte_zmalloc_socket(sizeof(*frames) * ctx->framebuff_cnt, soc_id);
+  if (!frames) {
+    err("%s(%d), frames malloc fail\n", __func__, idx);
+    return -ENOMEM;
+  }
+  ctx->framebuffs = frames;
+
+  for (uint16_t i = 0; i < ctx->framebuff_cnt; i++) {
+    frames[i].stat = ST30P_TX_FRAME_FREE;
+    frames[i].idx = i;
+    addr = mt_rte_zmalloc_socket(frame_size, soc_id);
+    if (!addr) {
+      err("%s(%d), frame malloc fail at %u\n", __func__, idx, i);
+      tx_st30p_uinit_fbs(ctx);
+      return -ENOMEM;
+    }
+    frames[i].frame.addr = addr;
+    frames[i].frame.iova = mtl_hp_virt2iova(ctx->impl, addr);
+    frames[i].frame.fmt = ops->input_fmt;
+    frames[i].frame.channel = ops->channel;
+    frames[i].frame.sampling = ops->sampling;
+    frames[i].frame.samples = ops->samples_per_frame;
+    frames[i].frame.buffer_size = frame_size;
+    frames[i].frame.data_size = frame_size;
+    frames[i].frame.priv = &frames[i];
+  }
+  info("%s(%d), size %" PRIu64 " fmt %d with %u frames\n", __func__, idx, frame_size,
+       ops->input_fmt, ctx->framebuff_cnt);
+  return 0;
+}
+
+static int tx_st30p_ops_check(struct st30p_tx_ops* ops) {
+  if (!ops->notify_frame_available) {
+    err("%s, pls set notify_frame_available\n", __func__);
+    return -EINVAL;
+  }
+  if ((ops->framebuff_cnt < 2) || (ops->framebuff_cnt > ST30P_FB_MAX_COUNT)) {
+    err("%s, invalid framebuff_cnt %u\n", __func__, ops->framebuff_cnt);
+    return -EINVAL;
+  }
+  if (!ops->channel) {
+    err("%s, invalid channel %u\n", __func__, ops->channel);
+    return -EINVAL;
+  }
+  if (!ops->samples_per_frame) {
+    err("%s, invalid samples_per_frame %u\n", __func__, ops->samples_per_frame);
+    return -EINVAL;
+  }
+  if (st30_get_sample_size(ops->input_fmt) < 0) {
+    err("%s, invalid input_fmt %d\n", __func__, ops->input_fmt);
+    return -EINVAL;
+  }
+  if (st30_get_sample_size(ops->transport_fmt) < 0) {
+    err("%s, invalid transport_fmt %d\n", __func__, ops->transport_fmt);
+    return -EINVAL;
+  }
+  if (st30_get_sample_num(ops->ptime, ops->sampling) < 0) {
+    err("%s, invalid ptime %d sampling %d\n", __func__, ops->ptime, ops->sampling);
+    return -EINVAL;
+  }
+  if (st30_get_sample_rate(ops->sampling) < 0) {
+    err("%s, invalid sampling %d\n", __func__, ops->sampling);
+    return -EINVAL;
+  }
+
+  return 0;
+}
+
+struct st30_frame* st30p_tx_get_frame(st30p_tx_handle handle) {
+  struct st30p_tx_ctx* ctx = handle;
+  int idx = ctx->idx;
+  struct st30p_tx_frame* framebuff;
+
+  if (ctx->type != MT_ST30_HANDLE_PIPELINE_TX) {
+    err("%s(%d), invalid type %d\n", __func__, idx, ctx->type);
+    return NULL;
+  }
+
+  if (!ctx->ready) return NULL; /* not ready */
+
+  mt_pthread_mutex_lock(&ctx->lock);
+  /* frames are filled in order to keep the sample continuity */
+  framebuff = &ctx->framebuffs[ctx->framebuff_producer_idx];
+  if (ST30P_TX_FRAME_FREE != framebuff->stat) {
+    mt_pthread_mutex_unlock(&ctx->lock);
+    rte_atomic32_inc(&ctx->stat_busy);
+    return NULL;
+  }
+
+  framebuff->stat = ST30P_TX_FRAME_IN_USER;
+  framebuff->stamp_pending = false;
+  /* point to next */
+  ctx->framebuff_producer_idx = tx_st30p_next_idx(ctx, framebuff->idx);
+  mt_pthread_mutex_unlock(&ctx->lock);
+
+  dbg("%s(%d), frame %u succ\n", __func__, idx, framebuff->idx);
+  return &framebuff->frame;
+}
+
+int st30p_tx_put_frame(st30p_tx_handle handle, struct st30_frame* frame) {
+  struct st30p_tx_ctx* ctx = handle;
+  int idx = ctx->idx;
+  struct st30p_tx_frame* framebuff = frame->priv;
+  uint16_t producer_idx = framebuff->idx;
+
+  if (ctx->type != MT_ST30_HANDLE_PIPELINE_TX) {
+    err("%s(%d), invalid type %d\n", __func__, idx, ctx->type);
+    return -EIO;
+  }
+
+  if (ST30P_TX_FRAME_IN_USER != framebuff->stat) {
+    err("%s(%d), frame %u not in user %d\n", __func__, idx, producer_idx,
+        framebuff->stat);
+    return -EIO;
+  }
+
+  framebuff->stat = ST30P_TX_FRAME_READY;
+
+  dbg("%s(%d), frame %u succ\n", __func__, idx, producer_idx);
+  return 0;
+}
+
+st30p_tx_handle st30p_tx_create(mtl_handle mt, struct st30p_tx_ops* ops) {
+  struct mtl_main_impl* impl = mt;
+  struct st30p_tx_ctx* ctx;
+  int ret;
+  int idx = 0; /* todo */
+
+  if (impl->type != MT_HANDLE_MAIN) {
+    err("%s, invalid type %d\n", __func__, impl->type);
+    return NULL;
+  }
+
+  ret = tx_st30p_ops_check(ops);
+  if (ret < 0) {
+    err("%s, st30p_tx_ops check fail %d\n", __func__, ret);
+    return NULL;
+  }
+
+  ctx = mt_rte_zmalloc_socket(sizeof(*ctx), mt_socket_id(impl, MTL_PORT_P));
+  if (!ctx) {
+    err("%s, ctx malloc fail\n", __func__);
+    return NULL;
+  }
+
+  ctx->idx = idx;
+  ctx->ready = false;
+  ctx->impl = impl;
+  ctx->type = MT_ST30_HANDLE_PIPELINE_TX;
+  ctx->pkt_samples = st30_get_sample_num(ops->ptime, ops->sampling);
+  ctx->input_group_size = st30_get_sample_size(ops->input_fmt) * ops->channel;
+  ctx->transport_group_size = st30_get_sample_size(ops->transport_fmt) * ops->channel;
+  ctx->ns_per_sample = (double)NS_PER_S / st30_get_sample_rate(ops->sampling);
+  ctx->frame_size = ctx->input_group_size * ops->samples_per_frame;
+  rte_atomic32_set(&ctx->stat_busy, 0);
+  mt_pthread_mutex_init(&ctx->lock, NULL);
+
+  /* copy ops */
+  strncpy(ctx->ops_name, ops->name, ST_MAX_NAME_LEN - 1);
+  ctx->ops = *ops;
+
+  /* init fbs */
+  ret = tx_st30p_init_fbs(impl, ctx, ops);
+  if (ret < 0) {
+    err("%s(%d), init fbs fail %d\n", __func__, idx, ret);
+    st30p_tx_free(ctx);
+    return NULL;
+  }
+
+  /* crete transport handle */
+  ret = tx_st30p_create_transport(impl, ctx, ops);
+  if (ret < 0) {
+    err("%s(%d), create transport fail\n", __func__, idx);
+    st30p_tx_free(ctx);
+    return NULL;
+  }
+
+  mt_stat_register(impl, tx_st30p_stat, ctx);
+
+  /* all ready now */
+  ctx->ready = true;
+  info("%s(%d), transport fmt %d, input fmt %d, samples %u per frame %u per pkt\n",
+       __func__, idx, ops->transport_fmt, ops->input_fmt, ops->samples_per_frame,
+       ctx->pkt_samples);
+
+  if (ctx->ops.notify_frame_available) { /* notify app */
+    ctx->ops.notify_frame_available(ctx->ops.priv);
+  }
+
+  return ctx;
+}
+
+int st30p_tx_free(st30p_tx_handle handle) {
+  struct st30p_tx_ctx* ctx = handle;
+  struct mtl_main_impl* impl = ctx->impl;
+
+  if (ctx->type != MT_ST30_HANDLE_PIPELINE_TX) {
+    err("%s(%d), invalid type %d\n", __func__, ctx->idx, ctx->type);
+    return -EIO;
+  }
+
+  if (ctx->ready) {
+    mt_stat_unregister(impl, tx_st30p_stat, ctx);
+    ctx->ready = false;
+  }
+
+  if (ctx->transport) {
+    st30_tx_free(ctx->transport);
+    ctx->transport = NULL;
+  }
+  tx_st30p_uinit_fbs(ctx);
+
+  mt_pthread_mutex_destroy(&ctx->lock);
+  mt_rte_free(ctx);
+
+  return 0;
+}
+
+size_t st30p_tx_frame_size(st30p_tx_handle handle) {
+  struct st30p_tx_ctx* ctx = handle;
+  int cidx = ctx->idx;
+
+  if (ctx->type != MT_ST30_HANDLE_PIPELINE_TX) {
+    err("%s(%d), invalid type %d\n", __func__, cidx, ctx->type);
+    return 0;
+  }
+
+  return ctx->frame_size;
+}
@@ -0,0 +1,68 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _ST_LIB_PIPELINE_ST30_TX_HEAD_H_
+#define _ST_LIB_PIPELINE_ST30_TX_HEAD_H_
+
+#include "../st_main.h"
+
+/* each transport frame carry one packet, two is enough to ping-pong */
+#define ST30P_TX_TRANS_FB_CNT (2)
+
+enum st30p_tx_frame_status {
+  ST30P_TX_FRAME_FREE = 0,
+  ST30P_TX_FRAME_IN_USER,         /* in user */
+  ST30P_TX_FRAME_READY,           /* put by user, wait the packet builder */
+  ST30P_TX_FRAME_IN_TRANSMITTING, /* all samples copied to packets */
+  ST30P_TX_FRAME_STATUS_MAX,
+};
+
+struct st30p_tx_frame {
+  enum st30p_tx_frame_status stat;
+  struct st30_frame frame;
+  uint16_t idx;
+  /* the packet seq which include the first sample */
+  uint64_t start_seq;
+  /* the sample offset of the first sample in the start packet */
+  uint32_t start_offset;
+  /* the packet seq which include the last sample */
+  uint64_t done_seq;
+  /* wait the tai timestamp of the start packet */
+  bool stamp_pending;
+};
+
+struct st30p_tx_ctx {
+  struct mtl_main_impl* impl;
+  int idx;
+  enum mt_handle_type type; /* for sanity check */
+
+  char ops_name[ST_MAX_NAME_LEN];
+  struct st30p_tx_ops ops;
+
+  st30_tx_handle transport;
+  uint16_t framebuff_cnt;
+  uint16_t framebuff_producer_idx;
+  uint16_t framebuff_consumer_idx;
+  uint16_t framebuff_done_idx;
+  /* samples already packed of the consumer frame */
+  uint32_t consumer_offset;
+  struct st30p_tx_frame* framebuffs;
+  pthread_mutex_t lock;
+
+  uint16_t pkt_samples; /* samples of single channel in one packet */
+  size_t input_group_size;     /* bytes of one sample for all channels, input fmt */
+  size_t transport_group_size; /* bytes of one sample for all channels, transport fmt */
+  double ns_per_sample;
+  uint64_t pkt_seq;
+  uint64_t trans_seq[ST30P_TX_TRANS_FB_CNT];
+  uint16_t trans_idx;
+  uint32_t am824_frame_idx;
+
+  bool ready;
+  size_t frame_size;
+
+  rte_atomic32_t stat_busy;
+};
+
+#endif
@@ -0,0 +1,470 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include "st40_pipeline_rx.h"
+
+#include "../../mt_log.h"
+#include "../../mt_stat.h"
+
+static const char* st40p_rx_frame_stat_name[ST40P_RX_FRAME_STATUS_MAX] = {
+    "free",
+    "receiving",
+    "ready",
+    "in_user",
+};
+
+static const char* rx_st40p_stat_name(enum st40p_rx_frame_status stat) {
+  return st40p_rx_frame_stat_name[stat];
+}
+
+static uint16_t rx_st40p_next_idx(struct st40p_rx_ctx* ctx, uint16_t idx) {
+  /* point to next */
+  uint16_t next_idx = idx;
+  next_idx++;
+  if (next_idx >= ctx->framebuff_cnt) next_idx = 0;
+  return next_idx;
+}
+
+/* parse the ANC packets of one rtp into the frame, return the err ANC count */
+static int rx_st40p_parse_rtp(struct st40p_rx_ctx* ctx, struct st40p_frame* frame,
+                              struct st40_rfc8331_rtp_hdr* hdr, uint16_t len) {
+  uint8_t* payload = (uint8_t*)&hdr[1];
+  uint8_t* end = (uint8_t*)hdr + len;
+  int anc_count = hdr->anc_count;
+  int err_cnt = 0;
+
+  for (int i = 0; i < anc_count; i++) {
+    struct st40_rfc8331_payload_hdr* payload_hdr = (void*)payload;
+    struct st40_rfc8331_payload_hdr anc;
+
+    if ((payload + sizeof(anc)) > end) {
+      dbg("%s(%d), truncated anc hdr at %d\n", __func__, ctx->idx, i);
+      err_cnt++;
+      break;
+    }
+    anc.swaped_first_hdr_chunk = ntohl(payload_hdr->swaped_first_hdr_chunk);
+    anc.swaped_second_hdr_chunk = ntohl(payload_hdr->swaped_second_hdr_chunk);
+    if (!st40_check_parity_bits(anc.second_hdr_chunk.did) ||
+        !st40_check_parity_bits(anc.second_hdr_chunk.sdid) ||
+        !st40_check_parity_bits(anc.second_hdr_chunk.data_count)) {
+      /* the data count is not trusted, no way to locate the next ANC */
+      dbg("%s(%d), hdr parity error at %d\n", __func__, ctx->idx, i);
+      err_cnt += anc_count - i;
+      break;
+    }
+    uint16_t udw_size = anc.second_hdr_chunk.data_count & 0xff;
+    /* 10-bit words: DID, SDID, DATA_COUNT + udw + checksum, align to the 32-bit */
+    uint16_t total_size = ((3 + udw_size + 1) * 10) / 8;
+    total_size = (4 - total_size % 4) + total_size;
+    uint16_t anc_len = sizeof(struct st40_rfc8331_payload_hdr) - 4 + total_size;
+    if ((payload + anc_len) > end) {
+      dbg("%s(%d), truncated anc payload at %d\n", __func__, ctx->idx, i);
+      err_cnt++;
+      break;
+    }
+
+    uint8_t* udw_base = (uint8_t*)&payload_hdr->second_hdr_chunk;
+    payload += anc_len;
+    if ((frame->meta_num >= ST40_MAX_META) ||
+        ((frame->udw_data_size + udw_size) > frame->udw_buffer_size)) {
+      rte_atomic32_inc(&ctx->stat_overflow);
+      continue;
+    }
+
+    struct st40_meta* meta = &frame->meta[frame->meta_num];
+    uint16_t did, sdid;
+    /* parity of all words and the checksum are verified in one pass */
+    int ret = st40_unpack_udw(udw_base, end - udw_base, &did, &sdid,
+                              frame->udw_buf + frame->udw_data_size, udw_size);
+    if (ret < 0) {
+      dbg("%s(%d), udw unpack fail %d at %d\n", __func__, ctx->idx, ret, i);
+      err_cnt++;
+      continue;
+    }
+
+    meta->c = anc.first_hdr_chunk.c;
+    meta->line_number = anc.first_hdr_chunk.line_number;
+    meta->hori_offset = anc.first_hdr_chunk.horizontal_offset;
+    meta->s = anc.first_hdr_chunk.s;
+    meta->stream_num = anc.first_hdr_chunk.stream_num;
+    meta->did = did;
+    meta->sdid = sdid;
+    meta->udw_size = udw_size;
+    meta->udw_offset = frame->udw_data_size;
+    frame->udw_data_size += udw_size;
+    frame->meta_num++;
+  }
+
+  return err_cnt;
+}
+
+static void rx_st40p_frame_complete(struct st40p_rx_ctx* ctx,
+                                    struct st40p_rx_frame* framebuff) {
+  framebuff->stat = ST40P_RX_FRAME_READY;
+  ctx->framebuff_producer_idx = rx_st40p_next_idx(ctx, framebuff->idx);
+  dbg("%s(%d), frame %u with %u anc\n", __func__, ctx->idx, framebuff->idx,
+      framebuff->frame.meta_num);
+}
+
+/* return the number of the frames which become ready */
+static int rx_st40p_handle_rtp(struct st40p_rx_ctx* ctx, void* usrptr, uint16_t len) {
+  struct st40_rfc8331_rtp_hdr* hdr = usrptr;
+  struct st40p_rx_frame* framebuff;
+  uint32_t tmstamp;
+  int ready_cnt = 0;
+  int err_cnt;
+
+  if (len < sizeof(*hdr)) {
+    dbg("%s(%d), invalid len %u\n", __func__, ctx->idx, len);
+    rte_atomic32_inc(&ctx->stat_err_anc);
+    return 0;
+  }
+  tmstamp = ntohl(hdr->base.tmstamp);
+
+  framebuff = &ctx->framebuffs[ctx->framebuff_producer_idx];
+  if ((ST40P_RX_FRAME_RECEIVING == framebuff->stat) && (framebuff->tmstamp != tmstamp)) {
+    /* the marker packet is lost, deliver what we have */
+    rte_atomic32_inc(&ctx->stat_incomplete);
+    rx_st40p_frame_complete(ctx, framebuff);
+    ready_cnt++;
+    framebuff = &ctx->framebuffs[ctx->framebuff_producer_idx];
+  }
+
+  if (ST40P_RX_FRAME_FREE == framebuff->stat) {
+    framebuff->stat = ST40P_RX_FRAME_RECEIVING;
+    framebuff->tmstamp = tmstamp;
+    framebuff->frame.meta_num = 0;
+    framebuff->frame.udw_data_size = 0;
+    framebuff->frame.err_anc_cnt = 0;
+    framebuff->frame.tfmt = ST10_TIMESTAMP_FMT_MEDIA_CLK;
+    framebuff->frame.timestamp = tmstamp;
+  } else if (ST40P_RX_FRAME_RECEIVING != framebuff->stat) {
+    /* app is slow, no free frame */
+    rte_atomic32_inc(&ctx->stat_busy);
+    return ready_cnt;
+  }
+
+  err_cnt = rx_st40p_parse_rtp(ctx, &framebuff->frame, hdr, len);
+  if (err_cnt) {
+    framebuff->frame.err_anc_cnt += err_cnt;
+    rte_atomic32_add(&ctx->stat_err_anc, err_cnt);
+  }
+
+  if (hdr->base.marker) {
+    rx_st40p_frame_complete(ctx, framebuff);
+    ready_cnt++;
+  }
+
+  return ready_cnt;
+}
+
+static int rx_st40p_rtp_ready(void* priv) {
+  struct st40p_rx_ctx* ctx = priv;
+  void* mbuf;
+  void* usrptr;
+  uint16_t len;
+  int ready_cnt = 0;
+
+  if (!ctx->ready) return -EBUSY; /* not ready */
+
+  mt_pthread_mutex_lock(&ctx->lock);
+  while (true) {
+    mbuf = st40_rx_get_mbuf(ctx->transport, &usrptr, &len);
+    if (!mbuf) break;
+    ready_cnt += rx_st40p_handle_rtp(ctx, usrptr, len);
+    st40_rx_put_mbuf(ctx->transport, mbuf);
+  }
+  mt_pthread_mutex_unlock(&ctx->lock);
+
+  if (ready_cnt && ctx->ops.notify_frame_available) { /* notify app */
+    ctx->ops.notify_frame_available(ctx->ops.priv);
+  }
+
+  return 0;
+}
+
+static int rx_st40p_stat(void* priv) {
+  struct st40p_rx_ctx* ctx = priv;
+  struct st40p_rx_frame* framebuff = ctx->framebuffs;
+
+  if (!ctx->ready) return -EBUSY; /* not ready */
+
+  uint16_t producer_idx = ctx->framebuff_producer_idx;
+  uint16_t consumer_idx = ctx->framebuff_consumer_idx;
+  notice("RX_st40p(%s), p(%d:%s) c(%d:%s)\n", ctx->ops_name, producer_idx,
+         rx_st40p_stat_name(framebuff[producer_idx].stat), consumer_idx,
+         rx_st40p_stat_name(framebuff[consumer_idx].stat));
+
+  int busy = rte_atomic32_read(&ctx->stat_busy);
+  rte_atomic32_set(&ctx->stat_busy, 0);
+  if (busy) {
+    notice("RX_st40p(%s), busy drop pkt %d\n", ctx->ops_name, busy);
+  }
+  int incomplete = rte_atomic32_read(&ctx->stat_incomplete);
+  rte_atomic32_set(&ctx->stat_incomplete, 0);
+  if (incomplete) {
+    notice("RX_st40p(%s), frame without marker %d\n", ctx->ops_name, incomplete);
+  }
+  int err_anc = rte_atomic32_read(&ctx->stat_err_anc);
+  rte_atomic32_set(&ctx->stat_err_anc, 0);
+  if (err_anc) {
+    notice("RX_st40p(%s), parity or checksum error anc %d\n", ctx->ops_name, err_anc);
+  }
+  int overflow = rte_atomic32_read(&ctx->stat_overflow);
+  rte_atomic32_set(&ctx->stat_overflow, 0);
+  if (overflow) {
+    notice("RX_st40p(%s), frame overflow drop anc %d\n", ctx->ops_name, overflow);
+  }
+
+  return 0;
+}
+
+static int rx_st40p_create_transport(struct mtl_main_impl* impl, struct st40p_rx_ctx* ctx,
+                                     struct st40p_rx_ops* ops) {
+  int idx = ctx->idx;
+  struct st40_rx_ops ops_rx;
+  st40_rx_handle transport;
+
+  memset(&ops_rx, 0, sizeof(ops_rx));
+  ops_rx.name = ops->name;
+  ops_rx.priv = ctx;
+  ops_rx.num_port = RTE_MIN(ops->port.num_port, MTL_SESSION_PORT_MAX);
+  for (int i = 0; i < ops_rx.num_port; i++) {
+    memcpy(ops_rx.sip_addr[i], ops->port.sip_addr[i], MTL_IP_ADDR_LEN);
+    memcpy(ops_rx.mcast_sip_addr[i], ops->port.mcast_sip_addr[i], MTL_IP_ADDR_LEN);
+    strncpy(ops_rx.port[i], ops->port.port[i], MTL_PORT_MAX_LEN);
+    ops_rx.udp_src_port[i] = ops->port.udp_src_port[i];
+    ops_rx.udp_port[i] = ops->port.udp_port[i];
+  }
+  if (ops->flags & ST40P_RX_FLAG_DATA_PATH_ONLY)
+    ops_rx.flags |= ST40_RX_FLAG_DATA_PATH_ONLY;
+  ops_rx.payload_type = ops->port.payload_type;
+  /* the rtp packets are parsed to frames in the rtp ready callback */
+  ops_rx.rtp_ring_size = ST40P_RX_RTP_RING_SIZE;
+  ops_rx.notify_rtp_ready = rx_st40p_rtp_ready;
+
+  transport = st40_rx_create(impl, &ops_rx);
+  if (!transport) {
+    err("%s(%d), transport create fail\n", __func__, idx);
+    return -EIO;
+  }
+  ctx->transport = transport;
+
+  return 0;
+}
+
+static int rx_st40p_uinit_fbs(struct st40p_rx_ctx* ctx) {
+  if (ctx->framebuffs) {
+    for (uint16_t i = 0; i < ctx->framebuff_cnt; i++) {
+      if (ctx->framebuffs[i].frame.udw_buf) {
+        mt_rte_free(ctx->framebuffs[i].frame.udw_buf);
+        ctx->framebuffs[i].frame.udw_buf = NULL;
+      }
+    }
+    mt_rte_free(ctx->framebuffs);
+    ctx->framebuffs = NULL;
+  }
+
+  return 0;
+}
+
+static int rx_st40p_init_fbs(struct mtl_main_impl* impl, struct st40p_rx_ctx* ctx,
+                             struct st40p_rx_ops* ops) {
+  int idx = ctx->idx;
+  int soc_id = mt_port_socket_id(impl, ops->port.port[MTL_SESSION_PORT_P]);
+  struct st40p_rx_frame* frames;
+  uint8_t* udw_buf;
+
+  ctx->framebuff_cnt = ops->framebuff_cnt;
+  frames = mt_rte_zmalloc_socket(sizeof(*frames) * ctx->framebuff_cnt, soc_id);
+  if (!frames) {
+    err("%s(%d), frames malloc fail\n", __func__, idx);
+    return -ENOMEM;
+  }
+  ctx->framebuffs = frames;
+
+  for (uint16_t i = 0; i < ctx->framebuff_cnt; i++) {
+    frames[i].stat = ST40P_RX_FRAME_FREE;
+    frames[i].idx = i;
+    udw_buf = mt_rte_zmalloc_socket(ctx->udw_buff_size, soc_id);
+    if (!udw_buf) {
+      err("%s(%d), udw buf malloc fail at %u\n", __func__, idx, i);
+      rx_st40p_uinit_fbs(ctx);
+      return -ENOMEM;
+    }
+    frames[i].frame.udw_buf = udw_buf;
+    frames[i].frame.udw_buffer_size = ctx->udw_buff_size;
+    frames[i].frame.priv = &frames[i];
+  }
+  info("%s(%d), udw buf size %u with %u frames\n", __func__, idx, ctx->udw_buff_size,
+       ctx->framebuff_cnt);
+  return 0;
+}
+
+static int rx_st40p_ops_check(struct st40p_rx_ops* ops) {
+  if (!ops->notify_frame_available) {
+    err("%s, pls set notify_frame_available\n", __func__);
+    return -EINVAL;
+  }
+  if ((ops->framebuff_cnt < 2) || (ops->framebuff_cnt > ST40P_FB_MAX_COUNT)) {
+    err("%s, invalid framebuff_cnt %u\n", __func__, ops->framebuff_cnt);
+    return -EINVAL;
+  }
+
+  return 0;
+}
+
+struct st40p_frame* st40p_rx_get_frame(st40p_rx_handle handle) {
+  struct st40p_rx_ctx* ctx = handle;
+  int idx = ctx->idx;
+  struct st40p_rx_frame* framebuff;
+
+  if (ctx->type != MT_ST40_HANDLE_PIPELINE_RX) {
+    err("%s(%d), invalid type %d\n", __func__, idx, ctx->type);
+    return NULL;
+  }
+
+  if (!ctx->ready) return NULL; /* not ready */
+
+  mt_pthread_mutex_lock(&ctx->lock);
+  /* frames are delivered in the receiving order */
+  framebuff = &ctx->framebuffs[ctx->framebuff_consumer_idx];
+  if (ST40P_RX_FRAME_READY != framebuff->stat) {
+    mt_pthread_mutex_unlock(&ctx->lock);
+    return NULL;
+  }
+
+  framebuff->stat = ST40P_RX_FRAME_IN_USER;
+  /* point to next */
+  ctx->framebuff_consumer_idx = rx_st40p_next_idx(ctx, framebuff->idx);
+  mt_pthread_mutex_unlock(&ctx->lock);
+
+  dbg("%s(%d), frame %u succ\n", __func__, idx, framebuff->idx);
+  return &framebuff->frame;
+}
+
+int st40p_rx_put_frame(st40p_rx_handle handle, struct st40p_frame* frame) {
+  struct st40p_rx_ctx* ctx = handle;
+  int idx = ctx->idx;
+  struct st40p_rx_frame* framebuff = frame->priv;
+  uint16_t consumer_idx = framebuff->idx;
+
+  if (ctx->type != MT_ST40_HANDLE_PIPELINE_RX) {
+    err("%s(%d), invalid type %d\n", __func__, idx, ctx->type);
+    return -EIO;
+  }
+
+  if (ST40P_RX_FRAME_IN_USER != framebuff->stat) {
+    err("%s(%d), frame %u not in user %d\n", __func__, idx, consumer_idx,
+        framebuff->stat);
+    return -EIO;
+  }
+
+  framebuff->stat = ST40P_RX_FRAME_FREE;
+
+  dbg("%s(%d), frame %u succ\n", __func__, idx, consumer_idx);
+  return 0;
+}
+
+st40p_rx_handle st40p_rx_create(mtl_handle mt, struct st40p_rx_ops* ops) {
+  struct mtl_main_impl* impl = mt;
+  struct st40p_rx_ctx* ctx;
+  int ret;
+  int idx = 0; /* todo */
+
+  if (impl->type != MT_HANDLE_MAIN) {
+    err("%s, invalid type %d\n", __func__, impl->type);
+    return NULL;
+  }
+
+  ret = rx_st40p_ops_check(ops);
+  if (ret < 0) {
+    err("%s, st40p_rx_ops check fail %d\n", __func__, ret);
+    return NULL;
+  }
+
+  ctx = mt_rte_zmalloc_socket(sizeof(*ctx), mt_socket_id(impl, MTL_PORT_P));
+  if (!ctx) {
+    err("%s, ctx malloc fail\n", __func__);
+    return NULL;
+  }
+
+  ctx->idx = idx;
+  ctx->ready = false;
+  ctx->impl = impl;
+  ctx->type = MT_ST40_HANDLE_PIPELINE_RX;
+  ctx->udw_buff_size =
+      ops->udw_buff_size ? ops->udw_buff_size : ST40P_DEFAULT_UDW_BUFF_SIZE;
+  rte_atomic32_set(&ctx->stat_busy, 0);
+  rte_atomic32_set(&ctx->stat_incomplete, 0);
+  rte_atomic32_set(&ctx->stat_err_anc, 0);
+  rte_atomic32_set(&ctx->stat_overflow, 0);
+  mt_pthread_mutex_init(&ctx->lock, NULL);
+
+  /* copy ops */
+  strncpy(ctx->ops_name, ops->name, ST_MAX_NAME_LEN - 1);
+  ctx->ops = *ops;
+
+  /* init fbs */
+  ret = rx_st40p_init_fbs(impl, ctx, ops);
+  if (ret < 0) {
+    err("%s(%d), init fbs fail %d\n", __func__, idx, ret);
+    st40p_rx_free(ctx);
+    return NULL;
+  }
+
+  /* crete transport handle */
+  ret = rx_st40p_create_transport(impl, ctx, ops);
+  if (ret < 0) {
+    err("%s(%d), create transport fail\n", __func__, idx);
+    st40p_rx_free(ctx);
+    return NULL;
+  }
+
+  mt_stat_register(impl, rx_st40p_stat, ctx);
+
+  /* all ready now */
+  ctx->ready = true;
+  info("%s(%d), %u frames\n", __func__, idx, ctx->framebuff_cnt);
+
+  return ctx;
+}
+
+int st40p_rx_free(st40p_rx_handle handle) {
+  struct st40p_rx_ctx* ctx = handle;
+  struct mtl_main_impl* impl = ctx->impl;
+
+  if (ctx->type != MT_ST40_HANDLE_PIPELINE_RX) {
+    err("%s(%d), invalid type %d\n", __func__, ctx->idx, ctx->type);
+    return -EIO;
+  }
+
+  if (ctx->ready) {
+    mt_stat_unregister(impl, rx_st40p_stat, ctx);
+    ctx->ready = false;
+  }
+
+  if (ctx->transport) {
+    st40_rx_free(ctx->transport);
+    ctx->transport = NULL;
+  }
+  rx_st40p_uinit_fbs(ctx);
+
+  mt_pthread_mutex_destroy(&ctx->lock);
+  mt_rte_free(ctx);
+
+  return 0;
+}
+
+int st40p_rx_get_queue_meta(st40p_rx_handle handle, struct st_queue_meta* meta) {
+  struct st40p_rx_ctx* ctx = handle;
+  int cidx = ctx->idx;
+
+  if (ctx->type != MT_ST40_HANDLE_PIPELINE_RX) {
+    err("%s(%d), invalid type %d\n", __func__, cidx, ctx->type);
+    return -EIO;
+  }
+
+  return st40_rx_get_queue_meta(ctx->transport, meta);
+}
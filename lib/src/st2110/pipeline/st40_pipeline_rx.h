@@ -0,0 +1,51 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _ST_LIB_PIPELINE_ST40_RX_HEAD_H_
+#define _ST_LIB_PIPELINE_ST40_RX_HEAD_H_
+
+#include "../st_main.h"
+
+#define ST40P_RX_RTP_RING_SIZE (1024)
+
+enum st40p_rx_frame_status {
+  ST40P_RX_FRAME_FREE = 0,
+  ST40P_RX_FRAME_RECEIVING, /* filling by the ANC packets from transport */
+  ST40P_RX_FRAME_READY,     /* marker bit or new rtp timestamp arrived */
+  ST40P_RX_FRAME_IN_USER,
+  ST40P_RX_FRAME_STATUS_MAX,
+};
+
+struct st40p_rx_frame {
+  enum st40p_rx_frame_status stat;
+  struct st40p_frame frame;
+  uint16_t idx;
+  uint32_t tmstamp; /* rtp timestamp of the receiving frame */
+};
+
+struct st40p_rx_ctx {
+  struct mtl_main_impl* impl;
+  int idx;
+  enum mt_handle_type type; /* for sanity check */
+
+  char ops_name[ST_MAX_NAME_LEN];
+  struct st40p_rx_ops ops;
+
+  st40_rx_handle transport;
+  uint16_t framebuff_cnt;
+  uint16_t framebuff_producer_idx;
+  uint16_t framebuff_consumer_idx;
+  struct st40p_rx_frame* framebuffs;
+  pthread_mutex_t lock;
+
+  bool ready;
+  uint32_t udw_buff_size;
+
+  rte_atomic32_t stat_busy;
+  rte_atomic32_t stat_incomplete;
+  rte_atomic32_t stat_err_anc;
+  rte_atomic32_t stat_overflow;
+};
+
+#endif
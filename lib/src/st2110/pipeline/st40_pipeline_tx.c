@@ -0,0 +1,424 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include "st40_pipeline_tx.h"
+
+#include "../../mt_log.h"
+#include "../../mt_stat.h"
+
+static const char* st40p_tx_frame_stat_name[ST40P_TX_FRAME_STATUS_MAX] = {
+    "free",
+    "in_user",
+    "ready",
+    "in_transmitting",
+};
+
+static const char* tx_st40p_stat_name(enum st40p_tx_frame_status stat) {
+  return st40p_tx_frame_stat_name[stat];
+}
+
+static uint16_t tx_st40p_next_idx(struct st40p_tx_ctx* ctx, uint16_t idx) {
+  /* point to next */
+  uint16_t next_idx = idx;
+  next_idx++;
+  if (next_idx >= ctx->framebuff_cnt) next_idx = 0;
+  return next_idx;
+}
+
+static int tx_st40p_next_frame(void* priv, uint16_t* next_frame_idx,
+                               struct st40_tx_frame_meta* meta) {
+  struct st40p_tx_ctx* ctx = priv;
+  struct st40p_tx_frame* framebuff;
+  struct st40p_frame* frame;
+  struct st40_frame* dst;
+
+  if (!ctx->ready) return -EBUSY; /* not ready */
+
+  mt_pthread_mutex_lock(&ctx->lock);
+  framebuff = &ctx->framebuffs[ctx->framebuff_consumer_idx];
+  if (ST40P_TX_FRAME_READY != framebuff->stat) {
+    mt_pthread_mutex_unlock(&ctx->lock);
+    return -EBUSY;
+  }
+  framebuff->stat = ST40P_TX_FRAME_IN_TRANSMITTING;
+  ctx->framebuff_consumer_idx = tx_st40p_next_idx(ctx, framebuff->idx);
+  mt_pthread_mutex_unlock(&ctx->lock);
+
+  /* the transport frame share the udw buffer, only the meta is copied */
+  frame = &framebuff->frame;
+  dst = st40_tx_get_framebuffer(ctx->transport, framebuff->idx);
+  memcpy(dst->meta, frame->meta, sizeof(*dst->meta) * frame->meta_num);
+  dst->meta_num = frame->meta_num;
+  dst->data = frame->udw_buf;
+  dst->data_size = frame->udw_data_size;
+
+  if ((ctx->ops.flags & ST40P_TX_FLAG_USER_TIMESTAMP) &&
+      (frame->tfmt == ST10_TIMESTAMP_FMT_MEDIA_CLK)) {
+    meta->tfmt = ST10_TIMESTAMP_FMT_MEDIA_CLK;
+    meta->timestamp = frame->timestamp;
+  }
+
+  *next_frame_idx = framebuff->idx;
+  dbg("%s(%d), frame %u succ\n", __func__, ctx->idx, framebuff->idx);
+  return 0;
+}
+
+static int tx_st40p_frame_done(void* priv, uint16_t frame_idx,
+                               struct st40_tx_frame_meta* meta) {
+  struct st40p_tx_ctx* ctx = priv;
+  struct st40p_tx_frame* framebuff;
+  int ret;
+
+  if (frame_idx >= ctx->framebuff_cnt) {
+    err("%s(%d), invalid frame_idx %u\n", __func__, ctx->idx, frame_idx);
+    return -EIO;
+  }
+
+  mt_pthread_mutex_lock(&ctx->lock);
+  framebuff = &ctx->framebuffs[frame_idx];
+  if (ST40P_TX_FRAME_IN_TRANSMITTING == framebuff->stat) {
+    ret = 0;
+    framebuff->frame.tfmt = meta->tfmt;
+    framebuff->frame.timestamp = meta->timestamp;
+    framebuff->stat = ST40P_TX_FRAME_FREE;
+    dbg("%s(%d), done_idx %u\n", __func__, ctx->idx, frame_idx);
+  } else {
+    ret = -EIO;
+    err("%s(%d), err status %d for frame %u\n", __func__, ctx->idx, framebuff->stat,
+        frame_idx);
+  }
+  mt_pthread_mutex_unlock(&ctx->lock);
+
+  if (ret < 0) return ret;
+
+  if (ctx->ops.notify_frame_done) { /* notify app which frame done */
+    ctx->ops.notify_frame_done(ctx->ops.priv, &framebuff->frame);
+  }
+
+  if (ctx->ops.notify_frame_available) { /* notify app can get frame */
+    ctx->ops.notify_frame_available(ctx->ops.priv);
+  }
+
+  return 0;
+}
+
+static int tx_st40p_stat(void* priv) {
+  struct st40p_tx_ctx* ctx = priv;
+  struct st40p_tx_frame* framebuff = ctx->framebuffs;
+
+  if (!ctx->ready) return -EBUSY; /* not ready */
+
+  uint16_t producer_idx = ctx->framebuff_producer_idx;
+  uint16_t consumer_idx = ctx->framebuff_consumer_idx;
+  notice("TX_st40p(%s), p(%d:%s) c(%d:%s)\n", ctx->ops_name, producer_idx,
+         tx_st40p_stat_name(framebuff[producer_idx].stat), consumer_idx,
+         tx_st40p_stat_name(framebuff[consumer_idx].stat));
+
+  int busy = rte_atomic32_read(&ctx->stat_busy);
+  rte_atomic32_set(&ctx->stat_busy, 0);
+  if (busy) {
+    notice("TX_st40p(%s), get frame busy %d\n", ctx->ops_name, busy);
+  }
+
+  return 0;
+}
+
+static int tx_st40p_create_transport(struct mtl_main_impl* impl, struct st40p_tx_ctx* ctx,
+                                     struct st40p_tx_ops* ops) {
+  int idx = ctx->idx;
+  struct st40_tx_ops ops_tx;
+  st40_tx_handle transport;
+
+  memset(&ops_tx, 0, sizeof(ops_tx));
+  ops_tx.name = ops->name;
+  ops_tx.priv = ctx;
+  ops_tx.num_port = RTE_MIN(ops->port.num_port, MTL_SESSION_PORT_MAX);
+  for (int i = 0; i < ops_tx.num_port; i++) {
+    memcpy(ops_tx.dip_addr[i], ops->port.dip_addr[i], MTL_IP_ADDR_LEN);
+    strncpy(ops_tx.port[i], ops->port.port[i], MTL_PORT_MAX_LEN);
+    ops_tx.udp_src_port[i] = ops->port.udp_src_port[i];
+    ops_tx.udp_port[i] = ops->port.udp_port[i];
+  }
+  if (ops->flags & ST40P_TX_FLAG_USER_P_MAC) {
+    memcpy(&ops_tx.tx_dst_mac[MTL_SESSION_PORT_P][0],
+           &ops->tx_dst_mac[MTL_SESSION_PORT_P][0], MTL_MAC_ADDR_LEN);
+    ops_tx.flags |= ST40_TX_FLAG_USER_P_MAC;
+  }
+  if (ops->flags & ST40P_TX_FLAG_USER_R_MAC) {
+    memcpy(&ops_tx.tx_dst_mac[MTL_SESSION_PORT_R][0],
+           &ops->tx_dst_mac[MTL_SESSION_PORT_R][0], MTL_MAC_ADDR_LEN);
+    ops_tx.flags |= ST40_TX_FLAG_USER_R_MAC;
+  }
+  if (ops->flags & ST40P_TX_FLAG_USER_TIMESTAMP)
+    ops_tx.flags |= ST40_TX_FLAG_USER_TIMESTAMP;
+  ops_tx.fps = ops->fps;
+  ops_tx.payload_type = ops->port.payload_type;
+  ops_tx.type = ST40_TYPE_FRAME_LEVEL;
+  /* one to one map between the pipeline frames and the transport frames */
+  ops_tx.framebuff_cnt = ctx->framebuff_cnt;
+  ops_tx.get_next_frame = tx_st40p_next_frame;
+  ops_tx.notify_frame_done = tx_st40p_frame_done;
+
+  transport = st40_tx_create(impl, &ops_tx);
+  if (!transport) {
+    err("%s(%d), transport create fail\n", __func__, idx);
+    return -EIO;
+  }
+  ctx->transport = transport;
+
+  return 0;
+}
+
+static int tx_st40p_uinit_fbs(struct st40p_tx_ctx* ctx) {
+  if (ctx->framebuffs) {
+    for (uint16_t i = 0; i < ctx->framebuff_cnt; i++) {
+      if (ctx->framebuffs[i].frame.udw_buf) {
+        mt_rte_free(ctx->framebuffs[i].frame.udw_buf);
+        ctx->framebuffs[i].frame.udw_buf = NULL;
+      }
+    }
+    mt_rte_free(ctx->framebuffs);
+    ctx->framebuffs = NULL;
+  }
+
+  return 0;
+}
+
+static int tx_st40p_init_fbs(struct mtl_main_impl* impl, struct st40p_tx_ctx* ctx,
+                             struct st40p_tx_ops* ops) {
+  int idx = ctx->idx;
+  int soc_id = mt_port_socket_id(impl, ops->port.port[MTL_SESSION_PORT_P]);
+  struct st40p_tx_frame* frames;
+  uint8_t* udw_buf;
+
+  ctx->framebuff_cnt = ops->framebuff_cnt;
+  frames = mt_rte_zmalloc_socket(sizeof(*frames) * ctx->framebuff_cnt, soc_id);
+  if (!frames) {
+    err("%s(%d), frames malloc fail\n", __func__, idx);
+    return -ENOMEM;
+  }
+  ctx->framebuffs = frames;
+
+  for (uint16_t i = 0; i < ctx->framebuff_cnt; i++) {
+    frames[i].stat = ST40P_TX_FRAME_FREE;
+    frames[i].idx = i;
+    udw_buf = mt_rte_zmalloc_socket(ctx->udw_buff_size, soc_id);
+    if (!udw_buf) {
+      err("%s(%d), udw buf malloc fail at %u\n", __func__, idx, i);
+      tx_st40p_uinit_fbs(ctx);
+      return -ENOMEM;
+    }
+    frames[i].frame.udw_buf = udw_buf;
+    frames[i].frame.udw_buffer_size = ctx->udw_buff_size;
+    frames[i].frame.priv = &frames[i];
+  }
+  info("%s(%d), udw buf size %u with %u frames\n", __func__, idx, ctx->udw_buff_size,
+       ctx->framebuff_cnt);
+  return 0;
+}
+
+static int tx_st40p_ops_check(struct st40p_tx_ops* ops) {
+  if (!ops->notify_frame_available) {
+    err("%s, pls set notify_frame_available\n", __func__);
+    return -EINVAL;
+  }
+  if ((ops->framebuff_cnt < 2) || (ops->framebuff_cnt > ST40P_FB_MAX_COUNT)) {
+    err("%s, invalid framebuff_cnt %u\n", __func__, ops->framebuff_cnt);
+    return -EINVAL;
+  }
+  if (ops->fps >= ST_FPS_MAX) {
+    err("%s, invalid fps %d\n", __func__, ops->fps);
+    return -EINVAL;
+  }
+
+  return 0;
+}
+
+int st40p_frame_add_anc(struct st40p_frame* frame, struct st40_meta* meta,
+                        const uint8_t* udw) {
+  struct st40_meta* dst;
+
+  if (frame->meta_num >= ST40_MAX_META) {
+    dbg("%s, meta full %u\n", __func__, frame->meta_num);
+    return -ENOSPC;
+  }
+  if (meta->udw_size > ST40P_MAX_UDW) {
+    err("%s, invalid udw_size %u\n", __func__, meta->udw_size);
+    return -EINVAL;
+  }
+  if ((frame->udw_data_size + meta->udw_size) > frame->udw_buffer_size) {
+    dbg("%s, udw buf full %u:%u\n", __func__, frame->udw_data_size, meta->udw_size);
+    return -ENOSPC;
+  }
+
+  dst = &frame->meta[frame->meta_num];
+  *dst = *meta;
+  dst->udw_offset = frame->udw_data_size;
+  rte_memcpy(frame->udw_buf + dst->udw_offset, udw, meta->udw_size);
+  frame->udw_data_size += meta->udw_size;
+  frame->meta_num++;
+
+  return 0;
+}
+
+struct st40p_frame* st40p_tx_get_frame(st40p_tx_handle handle) {
+  struct st40p_tx_ctx* ctx = handle;
+  int idx = ctx->idx;
+  struct st40p_tx_frame* framebuff;
+
+  if (ctx->type != MT_ST40_HANDLE_PIPELINE_TX) {
+    err("%s(%d), invalid type %d\n", __func__, idx, ctx->type);
+    return NULL;
+  }
+
+  if (!ctx->ready) return NULL; /* not ready */
+
+  mt_pthread_mutex_lock(&ctx->lock);
+  /* frames are sent in order, one frame each frame time */
+  framebuff = &ctx->framebuffs[ctx->framebuff_producer_idx];
+  if (ST40P_TX_FRAME_FREE != framebuff->stat) {
+    mt_pthread_mutex_unlock(&ctx->lock);
+    rte_atomic32_inc(&ctx->stat_busy);
+    return NULL;
+  }
+
+  framebuff->stat = ST40P_TX_FRAME_IN_USER;
+  /* point to next */
+  ctx->framebuff_producer_idx = tx_st40p_next_idx(ctx, framebuff->idx);
+  mt_pthread_mutex_unlock(&ctx->lock);
+
+  framebuff->frame.meta_num = 0;
+  framebuff->frame.udw_data_size = 0;
+  dbg("%s(%d), frame %u succ\n", __func__, idx, framebuff->idx);
+  return &framebuff->frame;
+}
+
+int st40p_tx_put_frame(st40p_tx_handle handle, struct st40p_frame* frame) {
+  struct st40p_tx_ctx* ctx = handle;
+  int idx = ctx->idx;
+  struct st40p_tx_frame* framebuff = frame->priv;
+  uint16_t producer_idx = framebuff->idx;
+
+  if (ctx->type != MT_ST40_HANDLE_PIPELINE_TX) {
+    err("%s(%d), invalid type %d\n", __func__, idx, ctx->type);
+    return -EIO;
+  }
+
+  if (ST40P_TX_FRAME_IN_USER != framebuff->stat) {
+    err("%s(%d), frame %u not in user %d\n", __func__, idx, producer_idx,
+        framebuff->stat);
+    return -EIO;
+  }
+
+  if (frame->meta_num > ST40_MAX_META) {
+    err("%s(%d), frame %u invalid meta_num %u\n", __func__, idx, producer_idx,
+        frame->meta_num);
+    return -EINVAL;
+  }
+  for (uint32_t i = 0; i < frame->meta_num; i++) {
+    struct st40_meta* meta = &frame->meta[i];
+    if ((meta->udw_size > ST40P_MAX_UDW) ||
+        ((meta->udw_offset + meta->udw_size) > frame->udw_buffer_size)) {
+      err("%s(%d), frame %u invalid udw %u:%u on meta %u\n", __func__, idx,
+          producer_idx, meta->udw_offset, meta->udw_size, i);
+      return -EINVAL;
+    }
+  }
+
+  framebuff->stat = ST40P_TX_FRAME_READY;
+
+  dbg("%s(%d), frame %u succ\n", __func__, idx, producer_idx);
+  return 0;
+}
+
+st40p_tx_handle st40p_tx_create(mtl_handle mt, struct st40p_tx_ops* ops) {
+  struct mtl_main_impl* impl = mt;
+  struct st40p_tx_ctx* ctx;
+  int ret;
+  int idx = 0; /* todo */
+
+  if (impl->type != MT_HANDLE_MAIN) {
+    err("%s, invalid type %d\n", __func__, impl->type);
+    return NULL;
+  }
+
+  ret = tx_st40p_ops_check(ops);
+  if (ret < 0) {
+    err("%s, st40p_tx_ops check fail %d\n", __func__, ret);
+    return NULL;
+  }
+
+  ctx = mt_rte_zmalloc_socket(sizeof(*ctx), mt_socket_id(impl, MTL_PORT_P));
+  if (!ctx) {
+    err("%s, ctx malloc fail\n", __func__);
+    return NULL;
+  }
+
+  ctx->idx = idx;
+  ctx->ready = false;
+  ctx->impl = impl;
+  ctx->type = MT_ST40_HANDLE_PIPELINE_TX;
+  ctx->udw_buff_size =
+      ops->udw_buff_size ? ops->udw_buff_size : ST40P_DEFAULT_UDW_BUFF_SIZE;
+  rte_atomic32_set(&ctx->stat_busy, 0);
+  mt_pthread_mutex_init(&ctx->lock, NULL);
+
+  /* copy ops */
+  strncpy(ctx->ops_name, ops->name, ST_MAX_NAME_LEN - 1);
+  ctx->ops = *ops;
+
+  /* init fbs */
+  ret = tx_st40p_init_fbs(impl, ctx, ops);
+  if (ret < 0) {
+    err("%s(%d), init fbs fail %d\n", __func__, idx, ret);
+    st40p_tx_free(ctx);
+    return NULL;
+  }
+
+  /* crete transport handle */
+  ret = tx_st40p_create_transport(impl, ctx, ops);
+  if (ret < 0) {
+    err("%s(%d), create transport fail\n", __func__, idx);
+    st40p_tx_free(ctx);
+    return NULL;
+  }
+
+  mt_stat_register(impl, tx_st40p_stat, ctx);
+
+  /* all ready now */
+  ctx->ready = true;
+  info("%s(%d), fps %d, %u frames\n", __func__, idx, ops->fps, ctx->framebuff_cnt);
+
+  if (ctx->ops.notify_frame_available) { /* notify app */
+    ctx->ops.notify_frame_available(ctx->ops.priv);
+  }
+
+  return ctx;
+}
+
+int st40p_tx_free(st40p_tx_handle handle) {
+  struct st40p_tx_ctx* ctx = handle;
+  struct mtl_main_impl* impl = ctx->impl;
+
+  if (ctx->type != MT_ST40_HANDLE_PIPELINE_TX) {
+    err("%s(%d), invalid type %d\n", __func__, ctx->idx, ctx->type);
+    return -EIO;
+  }
+
+  if (ctx->ready) {
+    mt_stat_unregister(impl, tx_st40p_stat, ctx);
+    ctx->ready = false;
+  }
+
+  if (ctx->transport) {
+    st40_tx_free(ctx->transport);
+    ctx->transport = NULL;
+  }
+  tx_st40p_uinit_fbs(ctx);
+
+  mt_pthread_mutex_destroy(&ctx->lock);
+  mt_rte_free(ctx);
+
+  return 0;
+}
@@ -0,0 +1,45 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _ST_LIB_PIPELINE_ST40_TX_HEAD_H_
+#define _ST_LIB_PIPELINE_ST40_TX_HEAD_H_
+
+#include "../st_main.h"
+
+enum st40p_tx_frame_status {
+  ST40P_TX_FRAME_FREE = 0,
+  ST40P_TX_FRAME_IN_USER,         /* in user */
+  ST40P_TX_FRAME_READY,           /* put by user, wait the transport */
+  ST40P_TX_FRAME_IN_TRANSMITTING, /* in transport */
+  ST40P_TX_FRAME_STATUS_MAX,
+};
+
+struct st40p_tx_frame {
+  enum st40p_tx_frame_status stat;
+  struct st40p_frame frame;
+  uint16_t idx;
+};
+
+struct st40p_tx_ctx {
+  struct mtl_main_impl* impl;
+  int idx;
+  enum mt_handle_type type; /* for sanity check */
+
+  char ops_name[ST_MAX_NAME_LEN];
+  struct st40p_tx_ops ops;
+
+  st40_tx_handle transport;
+  uint16_t framebuff_cnt;
+  uint16_t framebuff_producer_idx;
+  uint16_t framebuff_consumer_idx;
+  struct st40p_tx_frame* framebuffs;
+  pthread_mutex_t lock;
+
+  bool ready;
+  uint32_t udw_buff_size;
+
+  rte_atomic32_t stat_busy;
+};
+
+#endif
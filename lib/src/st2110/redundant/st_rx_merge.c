@@ -0,0 +1,201 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include "st_rx_merge.h"
+
+#include "../../mt_log.h"
+
+#define ST_RX_MERGE_SLOT_MASK (ST_RX_MERGE_SLOTS - 1)
+#define ST_RX_MERGE_HIST_VALID (0x10000)
+
+static inline uint16_t rx_merge_slot(uint16_t seq) { return seq & ST_RX_MERGE_SLOT_MASK; }
+
+static void rx_merge_deliver_slot(struct st_rx_merge* m, uint16_t slot) {
+  struct rte_mbuf* mbuf = m->slot_mbuf[slot];
+
+  m->deliver(m->priv, mbuf, m->slot_port[slot]);
+  m->port[m->slot_port[slot]].first++;
+  rte_pktmbuf_free(mbuf); /* the ref taken when hold */
+  m->slot_mbuf[slot] = NULL;
+  m->held--;
+  m->stat_reordered++;
+}
+
+/* deliver all the in order pkts from the slots after the gap is filled or skipped */
+static void rx_merge_drain(struct st_rx_merge* m, uint64_t now_ns) {
+  uint16_t slot;
+
+  while (m->held) {
+    slot = rx_merge_slot(m->next_seq);
+    if (!m->slot_mbuf[slot]) break;
+    rx_merge_deliver_slot(m, slot);
+    m->next_seq = (uint16_t)(m->next_seq + 1);
+  }
+
+  /* the wait for the next missing seq start from now */
+  m->gap_start_ns = m->held ? now_ns : 0;
+}
+
+/* deliver the held pkts and restart from seq, for stream restart or path switch */
+static void rx_merge_resync(struct st_rx_merge* m, uint16_t seq) {
+  uint16_t slot;
+
+  dbg("%s(%d), next %d seq %u held %u\n", __func__, m->idx, m->next_seq, seq, m->held);
+  for (uint16_t i = 0; (i < ST_RX_MERGE_SLOTS) && m->held; i++) {
+    slot = rx_merge_slot(m->next_seq + i);
+    if (m->slot_mbuf[slot]) rx_merge_deliver_slot(m, slot);
+  }
+  m->gap_start_ns = 0;
+  m->next_seq = seq;
+}
+
+static void rx_merge_port_seq(struct st_rx_merge_port_stat* stat, uint16_t seq) {
+  if (stat->last_seq >= 0) {
+    int16_t delta = (int16_t)(seq - (uint16_t)stat->last_seq);
+    if (delta <= 0) return; /* out of order on this path */
+    if (delta < ST_RX_MERGE_SLOTS) stat->lost += delta - 1;
+  }
+  stat->last_seq = seq;
+}
+
+int st_rx_merge_push(struct st_rx_merge* m, struct rte_mbuf* mbuf, uint16_t seq,
+                     enum mtl_session_port s_port, uint64_t now_ns) {
+  struct st_rx_merge_port_stat* stat = &m->port[s_port];
+  uint16_t slot = rx_merge_slot(seq);
+  int16_t dist;
+
+  stat->pkts++;
+  rx_merge_port_seq(stat, seq);
+
+  /* the first arrival of this seq is known, it's the redundant one */
+  if (m->hist_seq[slot] == (seq | ST_RX_MERGE_HIST_VALID)) {
+    stat->redundant++;
+    if (m->hist_port[slot] != s_port) {
+      uint64_t late_ns = now_ns - m->hist_ns[slot];
+      stat->late_cnt++;
+      stat->late_sum_ns += late_ns;
+      if (late_ns > stat->late_max_ns) stat->late_max_ns = late_ns;
+      m->hist_port[slot] = s_port; /* only measure once */
+    }
+    return -EEXIST;
+  }
+
+  if (unlikely(m->next_seq < 0)) m->next_seq = seq;
+  dist = (int16_t)(seq - (uint16_t)m->next_seq);
+  if (unlikely((dist >= ST_RX_MERGE_SLOTS) || (dist <= -ST_RX_MERGE_SLOTS))) {
+    rx_merge_resync(m, seq);
+    dist = 0;
+  } else if (dist < 0) {
+    /* the seq is skipped already as the wait timeout */
+    m->stat_late++;
+    return -EIO;
+  }
+
+  m->hist_seq[slot] = seq | ST_RX_MERGE_HIST_VALID;
+  m->hist_ns[slot] = now_ns;
+  m->hist_port[slot] = s_port;
+
+  if (dist == 0) {
+    /* the fast path, in order pkt */
+    m->deliver(m->priv, mbuf, s_port);
+    stat->first++;
+    m->next_seq = (uint16_t)(seq + 1);
+    if (m->held) rx_merge_drain(m, now_ns);
+    return 0;
+  }
+
+  /* hold it until the missing seq arrive from any path or the window timeout */
+  rte_mbuf_refcnt_update(mbuf, 1);
+  m->slot_mbuf[slot] = mbuf;
+  m->slot_port[slot] = s_port;
+  m->held++;
+  if (!m->gap_start_ns) m->gap_start_ns = now_ns;
+  st_rx_merge_timeout(m, now_ns);
+  return 0;
+}
+
+int st_rx_merge_timeout(struct st_rx_merge* m, uint64_t now_ns) {
+  uint16_t slot;
+
+  while (m->held && ((now_ns - m->gap_start_ns) > m->window_ns)) {
+    /* skip all the missing seq until the next held pkt */
+    slot = rx_merge_slot(m->next_seq);
+    while (!m->slot_mbuf[slot]) {
+      dbg("%s(%d), seq %d lost on all path\n", __func__, m->idx, m->next_seq);
+      m->stat_lost++;
+      m->next_seq = (uint16_t)(m->next_seq + 1);
+      slot = rx_merge_slot(m->next_seq);
+    }
+    rx_merge_drain(m, now_ns);
+  }
+
+  return m->held;
+}
+
+void st_rx_merge_reset(struct st_rx_merge* m) {
+  for (int i = 0; i < ST_RX_MERGE_SLOTS; i++) {
+    if (m->slot_mbuf[i]) {
+      rte_pktmbuf_free(m->slot_mbuf[i]);
+      m->slot_mbuf[i] = NULL;
+    }
+    m->hist_seq[i] = 0;
+  }
+  m->held = 0;
+  m->gap_start_ns = 0;
+  m->next_seq = -1;
+  for (int i = 0; i < MTL_SESSION_PORT_MAX; i++) m->port[i].last_seq = -1;
+}
+
+void st_rx_merge_stat(struct st_rx_merge* m, const char* tag, int num_port) {
+  struct st_rx_merge_port_stat* stat;
+
+  for (int i = 0; i < num_port; i++) {
+    stat = &m->port[i];
+    notice("%s(%d), port %d pkts %u first %u redundant %u lost %u\n", tag, m->idx, i,
+           stat->pkts, stat->first, stat->redundant, stat->lost);
+    if (stat->late_cnt) {
+      notice("%s(%d), port %d path delay avg %fus max %fus\n", tag, m->idx, i,
+             (double)stat->late_sum_ns / stat->late_cnt / NS_PER_US,
+             (double)stat->late_max_ns / NS_PER_US);
+    }
+    stat->pkts = 0;
+    stat->first = 0;
+    stat->redundant = 0;
+    stat->lost = 0;
+    stat->late_cnt = 0;
+    stat->late_sum_ns = 0;
+    stat->late_max_ns = 0;
+  }
+  if (m->stat_reordered || m->stat_lost || m->stat_late) {
+    notice("%s(%d), merge reordered %u lost %u late %u, held %u\n", tag, m->idx,
+           m->stat_reordered, m->stat_lost, m->stat_late, m->held);
+    m->stat_reordered = 0;
+    m->stat_lost = 0;
+    m->stat_late = 0;
+  }
+}
+
+struct st_rx_merge* st_rx_merge_create(int idx, uint32_t window_us, int soc_id,
+                                       st_rx_merge_deliver deliver, void* priv) {
+  struct st_rx_merge* m = mt_rte_zmalloc_socket(sizeof(*m), soc_id);
+  if (!m) {
+    err("%s(%d), malloc fail\n", __func__, idx);
+    return NULL;
+  }
+
+  m->idx = idx;
+  m->window_ns = (uint64_t)(window_us ? window_us : ST_RX_MERGE_DEFAULT_WINDOW_US) *
+                 NS_PER_US;
+  m->deliver = deliver;
+  m->priv = priv;
+  st_rx_merge_reset(m);
+
+  info("%s(%d), window %" PRIu64 "us\n", __func__, idx, m->window_ns / NS_PER_US);
+  return m;
+}
+
+void st_rx_merge_free(struct st_rx_merge* m) {
+  st_rx_merge_reset(m);
+  mt_rte_free(m);
+}
@@ -0,0 +1,66 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _ST_LIB_REDUNDANT_RX_MERGE_HEAD_H_
+#define _ST_LIB_REDUNDANT_RX_MERGE_HEAD_H_
+
+#include "../st_main.h"
+
+/* max seq distance between the two paths which can be hold, power of 2 */
+#define ST_RX_MERGE_SLOTS (256)
+/* default max time to wait the missing pkt from the late path */
+#define ST_RX_MERGE_DEFAULT_WINDOW_US (10 * 1000)
+
+/* deliver one in order pkt to the session, the mbuf is still owned by the caller */
+typedef int (*st_rx_merge_deliver)(void* priv, struct rte_mbuf* mbuf,
+                                   enum mtl_session_port s_port);
+
+struct st_rx_merge_port_stat {
+  uint32_t pkts;      /* pkts received on this path */
+  uint32_t first;     /* pkts delivered from this path */
+  uint32_t redundant; /* pkts already received from the other path */
+  uint32_t lost;      /* seq gap on this path */
+  uint32_t late_cnt;  /* the redundant pkts with path delay measured */
+  uint64_t late_sum_ns;
+  uint64_t late_max_ns;
+  int32_t last_seq; /* -1 for no pkt yet */
+};
+
+struct st_rx_merge {
+  int idx;
+  uint64_t window_ns; /* max time to wait the missing pkt */
+  st_rx_merge_deliver deliver;
+  void* priv;
+
+  int32_t next_seq; /* next seq to deliver, -1 for the first pkt */
+  uint16_t held;    /* pkts held in slots */
+  uint64_t gap_start_ns;
+  /* out of order pkts waiting for the missing seq, index by seq */
+  struct rte_mbuf* slot_mbuf[ST_RX_MERGE_SLOTS];
+  uint8_t slot_port[ST_RX_MERGE_SLOTS];
+  /* first arrival of each seq, for duplicate check and path delay */
+  uint32_t hist_seq[ST_RX_MERGE_SLOTS]; /* seq with the valid flag */
+  uint64_t hist_ns[ST_RX_MERGE_SLOTS];
+  uint8_t hist_port[ST_RX_MERGE_SLOTS];
+
+  struct st_rx_merge_port_stat port[MTL_SESSION_PORT_MAX];
+  uint32_t stat_reordered; /* pkts delivered from the slots */
+  uint32_t stat_lost;      /* seq lost on all paths */
+  uint32_t stat_late;      /* pkts arrived after the seq is delivered or skipped */
+};
+
+struct st_rx_merge* st_rx_merge_create(int idx, uint32_t window_us, int soc_id,
+                                       st_rx_merge_deliver deliver, void* priv);
+void st_rx_merge_free(struct st_rx_merge* m);
+void st_rx_merge_reset(struct st_rx_merge* m);
+
+/* return 0 if the pkt is delivered or held, <0 if dropped */
+int st_rx_merge_push(struct st_rx_merge* m, struct rte_mbuf* mbuf, uint16_t seq,
+                     enum mtl_session_port s_port, uint64_t now_ns);
+/* skip the missing seq which wait longer than the window, call it from the tasklet */
+int st_rx_merge_timeout(struct st_rx_merge* m, uint64_t now_ns);
+
+void st_rx_merge_stat(struct st_rx_merge* m, const char* tag, int num_port);
+
+#endif
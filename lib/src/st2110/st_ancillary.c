@@ -2,7 +2,18 @@
  * Copyright(c) 2022 Intel Corporation
  */
 
+#include "st_ancillary.h"
+
 #include "../mt_log.h"
+#include "st_main.h"
+
+#ifdef MTL_HAS_AVX2
+#include "st_avx2.h"
+#endif
+
+#ifdef MTL_HAS_AVX512
+#include "st_avx512.h"
+#endif
 
 typedef union anc_udw_10_6e {
   struct {
@@ -185,4 +196,130 @@ uint16_t st40_add_parity_bits(uint16_t val) {
 
 int st40_check_parity_bits(uint16_t val) {
   return val == st40_add_parity_bits(val & 0xFF);
-}
\ No newline at end of file
+}
+
+static int st40_pack_udw_scalar(uint16_t did, uint16_t sdid, const uint8_t* udw,
+                                uint16_t udw_size, uint8_t* data) {
+  uint16_t words[ST40_UDW_WORDS_MAX];
+  uint32_t num = 3 + udw_size + 1;
+  uint16_t sum;
+
+  words[0] = get_parity_bits(did) | (did & 0xff);
+  words[1] = get_parity_bits(sdid) | (sdid & 0xff);
+  words[2] = get_parity_bits(udw_size) | (udw_size & 0xff);
+  sum = words[0] + words[1] + words[2];
+  for (uint16_t i = 0; i < udw_size; i++) {
+    words[3 + i] = get_parity_bits(udw[i]) | udw[i];
+    sum += words[3 + i];
+  }
+  words[num - 1] = st40_words_checksum(sum);
+
+  st40_words_pack_scalar(words, 0, num, data);
+  return st40_words_size(num);
+}
+
+static int st40_unpack_udw_scalar(const uint8_t* data, uint16_t udw_size, uint8_t* udw) {
+  uint16_t words[ST40_UDW_WORDS_MAX];
+  uint32_t num = 3 + udw_size + 1;
+  uint16_t sum = 0;
+  uint16_t word;
+
+  st40_words_unpack_scalar(data, 0, num, words);
+  for (uint32_t i = 0; i < 3; i++) sum += words[i];
+  for (uint16_t i = 0; i < udw_size; i++) {
+    word = words[3 + i];
+    if (word != (get_parity_bits(word) | (word & 0xff))) return -EIO;
+    udw[i] = word & 0xff;
+    sum += word;
+  }
+  if (words[num - 1] != st40_words_checksum(sum)) return -EIO;
+
+  return 0;
+}
+
+int st40_pack_udw_simd(uint16_t did, uint16_t sdid, const uint8_t* udw,
+                       uint16_t udw_size, uint8_t* data, enum mtl_simd_level level) {
+  enum mtl_simd_level cpu_level = mtl_get_simd_level();
+  int ret;
+
+  MT_MAY_UNUSED(cpu_level);
+  MT_MAY_UNUSED(ret);
+
+  if (udw_size > 255) {
+    err("%s, invalid udw_size %u\n", __func__, udw_size);
+    return -EINVAL;
+  }
+
+#ifdef MTL_HAS_AVX512
+  if ((level >= MTL_SIMD_LEVEL_AVX512) && (cpu_level >= MTL_SIMD_LEVEL_AVX512)) {
+    dbg("%s, avx512 ways\n", __func__);
+    ret = st40_pack_udw_avx512(did, sdid, udw, udw_size, data);
+    if (ret > 0) return ret;
+    dbg("%s, avx512 ways failed\n", __func__);
+  }
+#endif
+
+#ifdef MTL_HAS_AVX2
+  if ((level >= MTL_SIMD_LEVEL_AVX2) && (cpu_level >= MTL_SIMD_LEVEL_AVX2)) {
+    dbg("%s, avx2 ways\n", __func__);
+    ret = st40_pack_udw_avx2(did, sdid, udw, udw_size, data);
+    if (ret > 0) return ret;
+    dbg("%s, avx2 ways failed\n", __func__);
+  }
+#endif
+
+  /* the last option */
+  return st40_pack_udw_scalar(did, sdid, udw, udw_size, data);
+}
+
+int st40_unpack_udw_simd(const uint8_t* data, uint32_t data_size, uint16_t* did,
+                         uint16_t* sdid, uint8_t* udw, uint16_t udw_max,
+                         enum mtl_simd_level level) {
+  enum mtl_simd_level cpu_level = mtl_get_simd_level();
+  uint16_t words[3];
+  uint16_t udw_size;
+  int ret;
+
+  MT_MAY_UNUSED(cpu_level);
+
+  if (data_size < st40_words_size(3 + 1)) return -EINVAL;
+  /* the DID, SDID and DATA_COUNT */
+  st40_words_unpack_scalar(data, 0, 3, words);
+  for (int i = 0; i < 3; i++) {
+    if (!st40_check_parity_bits(words[i])) return -EIO;
+  }
+  udw_size = words[2] & 0xff;
+  if (udw_size > udw_max) {
+    dbg("%s, udw_size %u exceed the buf %u\n", __func__, udw_size, udw_max);
+    return -ENOSPC;
+  }
+  if (data_size < st40_words_size(3 + udw_size + 1)) {
+    dbg("%s, udw_size %u exceed the data %u\n", __func__, udw_size, data_size);
+    return -EINVAL;
+  }
+  *did = words[0] & 0xff;
+  *sdid = words[1] & 0xff;
+
+  ret = -ENOTSUP;
+#ifdef MTL_HAS_AVX512
+  if ((ret == -ENOTSUP) && (level >= MTL_SIMD_LEVEL_AVX512) &&
+      (cpu_level >= MTL_SIMD_LEVEL_AVX512)) {
+    dbg("%s, avx512 ways\n", __func__);
+    ret = st40_unpack_udw_avx512(data, udw_size, udw);
+  }
+#endif
+
+#ifdef MTL_HAS_AVX2
+  if ((ret == -ENOTSUP) && (level >= MTL_SIMD_LEVEL_AVX2) &&
+      (cpu_level >= MTL_SIMD_LEVEL_AVX2)) {
+    dbg("%s, avx2 ways\n", __func__);
+    ret = st40_unpack_udw_avx2(data, udw_size, udw);
+  }
+#endif
+
+  /* the last option */
+  if (ret == -ENOTSUP) ret = st40_unpack_udw_scalar(data, udw_size, udw);
+  if (ret < 0) return ret;
+
+  return udw_size;
+}
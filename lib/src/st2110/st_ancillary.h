@@ -0,0 +1,87 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _ST_LIB_ANCILLARY_HEAD_H_
+#define _ST_LIB_ANCILLARY_HEAD_H_
+
+#include <st40_api.h>
+
+/* DID, SDID, DATA_COUNT, max 255 udw and the checksum */
+#define ST40_UDW_WORDS_MAX (3 + 255 + 1)
+
+/* 10 bits words stream size in bytes */
+static inline uint32_t st40_words_size(uint32_t num) { return (num * 10 + 7) / 8; }
+
+/* bit9 is the inverse of bit8 for the checksum word */
+static inline uint16_t st40_words_checksum(uint16_t sum) {
+  sum &= 0x1ff;
+  return sum | ((~(sum << 1)) & 0x200);
+}
+
+/* pack words[start, num) to the 10 bits big endian stream, start should align to 4 */
+static inline void st40_words_pack_scalar(const uint16_t* words, uint32_t start,
+                                          uint32_t num, uint8_t* data) {
+  uint8_t* dst = data + start / 4 * 5;
+  uint32_t i = start;
+  uint64_t acc;
+  int bits;
+
+  /* four words to five bytes */
+  for (; (i + 4) <= num; i += 4) {
+    acc = ((uint64_t)(words[i] & 0x3ff) << 30) |
+          ((uint64_t)(words[i + 1] & 0x3ff) << 20) | ((words[i + 2] & 0x3ff) << 10) |
+          (words[i + 3] & 0x3ff);
+    dst[0] = acc >> 32;
+    dst[1] = acc >> 24;
+    dst[2] = acc >> 16;
+    dst[3] = acc >> 8;
+    dst[4] = acc;
+    dst += 5;
+  }
+
+  acc = 0;
+  bits = 0;
+  for (; i < num; i++) {
+    acc = (acc << 10) | (words[i] & 0x3ff);
+    bits += 10;
+    while (bits >= 8) {
+      bits -= 8;
+      *dst++ = acc >> bits;
+    }
+  }
+  if (bits) *dst = acc << (8 - bits); /* pad zero */
+}
+
+/* unpack words[start, num) from the 10 bits big endian stream, start should align to 4 */
+static inline void st40_words_unpack_scalar(const uint8_t* data, uint32_t start,
+                                            uint32_t num, uint16_t* words) {
+  const uint8_t* src = data + start / 4 * 5;
+  uint32_t i = start;
+  uint64_t acc;
+  int bits;
+
+  /* five bytes to four words */
+  for (; (i + 4) <= num; i += 4) {
+    acc = ((uint64_t)src[0] << 32) | ((uint32_t)src[1] << 24) | (src[2] << 16) |
+          (src[3] << 8) | src[4];
+    words[i] = (acc >> 30) & 0x3ff;
+    words[i + 1] = (acc >> 20) & 0x3ff;
+    words[i + 2] = (acc >> 10) & 0x3ff;
+    words[i + 3] = acc & 0x3ff;
+    src += 5;
+  }
+
+  acc = 0;
+  bits = 0;
+  for (; i < num; i++) {
+    while (bits < 10) {
+      acc = (acc << 8) | *src++;
+      bits += 8;
+    }
+    bits -= 10;
+    words[i] = (acc >> bits) & 0x3ff;
+  }
+}
+
+#endif
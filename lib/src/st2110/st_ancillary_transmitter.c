@@ -122,6 +122,7 @@ int st_ancillary_transmitter_init(struct mtl_main_impl* impl, struct mt_sch_impl
   ops.start = st_ancillary_trs_tasklet_start;
   ops.stop = st_ancillary_trs_tasklet_stop;
   ops.handler = st_ancillary_trs_tasklet_handler;
+  ops.migratable = true;
 
   trs->tasklet = mt_sch_register_tasklet(sch, &ops);
   if (!trs->tasklet) {
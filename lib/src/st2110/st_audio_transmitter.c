@@ -121,6 +121,7 @@ int st_audio_transmitter_init(struct mtl_main_impl* impl, struct mt_sch_impl* sc
   ops.start = st_audio_trs_tasklet_start;
   ops.stop = st_audio_trs_tasklet_stop;
   ops.handler = st_audio_trs_tasklet_handler;
+  ops.migratable = true;
 
   trs->tasklet = mt_sch_register_tasklet(sch, &ops);
   if (!trs->tasklet) {
@@ -5,6 +5,7 @@
 #include "st_avx2.h"
 
 #include "../mt_log.h"
+#include "st_ancillary.h"
 #include "st_main.h"
 
 #ifdef MTL_HAS_AVX2
@@ -215,5 +216,153 @@ int st20_rfc4175_422le10_to_422be10_avx2(struct st20_rfc4175_422_10_pg2_le* pg_l
   return 0;
 }
 /* end st20_rfc4175_422le10_to_422be10_avx2 */
+
+/* begin st40_pack_udw_avx2 */
+static uint8_t st40_popcnt_nibble_tbl[32] = {
+    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, /* lane 0 */
+    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, /* lane 1 */
+};
+
+/* 40 bits of four words in each 64 bits to 5 big endian bytes */
+static uint8_t st40_words_pack_shuffle_tbl[32] = {
+    4,    3,    2,    1,    0,    12,   11,   10, 9, 8, /* lane 0 */
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80,                 /* zeros */
+    4,    3,    2,    1,    0,    12,   11,   10, 9, 8, /* lane 1 */
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80,                 /* zeros */
+};
+
+/* 5 big endian bytes to the 40 bits of four words in each 64 bits */
+static uint8_t st40_words_unpack_shuffle_tbl[32] = {
+    4, 3, 2, 1, 0, 0x80, 0x80, 0x80, 9, 8, 7, 6, 5, 0x80, 0x80, 0x80, /* lane 0 */
+    4, 3, 2, 1, 0, 0x80, 0x80, 0x80, 9, 8, 7, 6, 5, 0x80, 0x80, 0x80, /* lane 1 */
+};
+
+/* 8 bits value in each 16 bits to the 10 bits word with the parity bits */
+static inline __m256i st40_add_parity_avx2(__m256i val, __m256i popcnt_tbl) {
+  __m256i nibble_mask = _mm256_set1_epi16(0x0f);
+  __m256i lo = _mm256_shuffle_epi8(popcnt_tbl, _mm256_and_si256(val, nibble_mask));
+  __m256i hi = _mm256_shuffle_epi8(
+      popcnt_tbl, _mm256_and_si256(_mm256_srli_epi16(val, 4), nibble_mask));
+  __m256i parity = _mm256_and_si256(_mm256_add_epi8(lo, hi), _mm256_set1_epi16(1));
+  /* b8 is the even parity, b9 is the inverse of b8 */
+  __m256i b89 = _mm256_sub_epi16(_mm256_set1_epi16(0x200), _mm256_slli_epi16(parity, 8));
+  return _mm256_or_si256(val, b89);
+}
+
+static inline uint16_t st40_sum_epi16_avx2(__m256i sum) {
+  uint16_t tmp[16];
+  uint16_t s = 0;
+
+  _mm256_storeu_si256((__m256i*)tmp, sum);
+  for (int i = 0; i < 16; i++) s += tmp[i];
+  return s;
+}
+
+int st40_pack_udw_avx2(uint16_t did, uint16_t sdid, const uint8_t* udw,
+                       uint16_t udw_size, uint8_t* data) {
+  __m256i popcnt_tbl = _mm256_loadu_si256((__m256i*)st40_popcnt_nibble_tbl);
+  __m256i shuffle = _mm256_loadu_si256((__m256i*)st40_words_pack_shuffle_tbl);
+  __m256i madd = _mm256_set1_epi32(0x00010400); /* w0 << 10 + w1 */
+  __m256i sum_v = _mm256_setzero_si256();
+  uint16_t words[ST40_UDW_WORDS_MAX];
+  uint32_t num = 3 + udw_size + 1;
+  uint16_t sum;
+  uint32_t i = 0;
+
+  words[0] = st40_add_parity_bits(did);
+  words[1] = st40_add_parity_bits(sdid);
+  words[2] = st40_add_parity_bits(udw_size);
+  sum = words[0] + words[1] + words[2];
+
+  /* parity and checksum, 16 udw each loop */
+  for (; (i + 16) <= udw_size; i += 16) {
+    __m256i val = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i*)(udw + i)));
+    __m256i word = st40_add_parity_avx2(val, popcnt_tbl);
+    sum_v = _mm256_add_epi16(sum_v, word);
+    _mm256_storeu_si256((__m256i*)&words[3 + i], word);
+  }
+  for (; i < udw_size; i++) {
+    words[3 + i] = st40_add_parity_bits(udw[i]);
+    sum += words[3 + i];
+  }
+  sum += st40_sum_epi16_avx2(sum_v);
+  words[num - 1] = st40_words_checksum(sum);
+
+  /* pack 16 words to 20 bytes each loop, keep 8 words for the 16 bytes store */
+  uint32_t k = 0;
+  uint8_t* dst = data;
+  for (; (k + 16 + 8) <= num; k += 16) {
+    __m256i word = _mm256_loadu_si256((__m256i*)&words[k]);
+    __m256i w20 = _mm256_madd_epi16(word, madd);
+    __m256i w40 = _mm256_or_si256(_mm256_slli_epi64(w20, 20), _mm256_srli_epi64(w20, 32));
+    __m256i result = _mm256_shuffle_epi8(w40, shuffle);
+
+    _mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(result));
+    _mm_storeu_si128((__m128i*)(dst + 10), _mm256_extracti128_si256(result, 1));
+    dst += 20;
+  }
+  st40_words_pack_scalar(words, k, num, data);
+
+  return st40_words_size(num);
+}
+/* end st40_pack_udw_avx2 */
+
+/* begin st40_unpack_udw_avx2 */
+int st40_unpack_udw_avx2(const uint8_t* data, uint16_t udw_size, uint8_t* udw) {
+  __m256i popcnt_tbl = _mm256_loadu_si256((__m256i*)st40_popcnt_nibble_tbl);
+  __m256i shuffle = _mm256_loadu_si256((__m256i*)st40_words_unpack_shuffle_tbl);
+  __m256i mask_20 = _mm256_set1_epi64x(0xfffff);
+  __m256i mask_10 = _mm256_set1_epi32(0x3ff);
+  __m256i mask_8 = _mm256_set1_epi16(0xff);
+  __m256i sum_v = _mm256_setzero_si256();
+  uint16_t words[ST40_UDW_WORDS_MAX];
+  uint32_t num = 3 + udw_size + 1;
+  uint16_t sum = 0;
+  uint32_t k = 0;
+  const uint8_t* src = data;
+
+  /* unpack 20 bytes to 16 words each loop, keep 8 words for the 16 bytes load */
+  for (; (k + 16 + 8) <= num; k += 16) {
+    __m256i input = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128((__m128i*)src)),
+        _mm_loadu_si128((__m128i*)(src + 10)), 1);
+    __m256i w40 = _mm256_shuffle_epi8(input, shuffle);
+    __m256i w20 =
+        _mm256_or_si256(_mm256_srli_epi64(w40, 20),
+                        _mm256_slli_epi64(_mm256_and_si256(w40, mask_20), 32));
+    __m256i word = _mm256_or_si256(_mm256_srli_epi32(w20, 10),
+                                   _mm256_slli_epi32(_mm256_and_si256(w20, mask_10), 16));
+
+    _mm256_storeu_si256((__m256i*)&words[k], word);
+    src += 20;
+  }
+  st40_words_unpack_scalar(data, k, num, words);
+
+  for (uint32_t i = 0; i < 3; i++) sum += words[i];
+  /* parity check and checksum, 16 udw each loop */
+  uint32_t i = 0;
+  for (; (i + 16) <= udw_size; i += 16) {
+    __m256i word = _mm256_loadu_si256((__m256i*)&words[3 + i]);
+    __m256i val = _mm256_and_si256(word, mask_8);
+    __m256i expect = st40_add_parity_avx2(val, popcnt_tbl);
+    if (_mm256_movemask_epi8(_mm256_cmpeq_epi16(word, expect)) != -1) return -EIO;
+    sum_v = _mm256_add_epi16(sum_v, word);
+    /* the packus work on each 128 lane, permute to get the 16 bytes in order */
+    __m256i result = _mm256_permute4x64_epi64(
+        _mm256_packus_epi16(val, _mm256_setzero_si256()), 0xd8 /* 0, 2, 1, 3 */);
+    _mm_storeu_si128((__m128i*)(udw + i), _mm256_castsi256_si128(result));
+  }
+  for (; i < udw_size; i++) {
+    uint16_t word = words[3 + i];
+    if (word != st40_add_parity_bits(word & 0xff)) return -EIO;
+    udw[i] = word & 0xff;
+    sum += word;
+  }
+  sum += st40_sum_epi16_avx2(sum_v);
+  if (words[num - 1] != st40_words_checksum(sum)) return -EIO;
+
+  return 0;
+}
+/* end st40_unpack_udw_avx2 */
 MT_TARGET_CODE_STOP
 #endif
@@ -15,4 +15,9 @@ int st20_rfc4175_422le10_to_422be10_avx2(struct st20_rfc4175_422_10_pg2_le* pg_l
                                          struct st20_rfc4175_422_10_pg2_be* pg_be,
                                          uint32_t w, uint32_t h);
 
+int st40_pack_udw_avx2(uint16_t did, uint16_t sdid, const uint8_t* udw,
+                       uint16_t udw_size, uint8_t* data);
+
+int st40_unpack_udw_avx2(const uint8_t* data, uint16_t udw_size, uint8_t* udw);
+
 #endif
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "st_avx512.h"
 
 #include "../mt_log.h"
+#include "st_ancillary.h"
 #include "st_main.h"
 
 #ifdef MTL_HAS_AVX512
@@ -2629,5 +2630,147 @@ int st20_rfc4175_422be12_to_yuv422p12le_avx512_dma(
   return 0;
 }
 /* end st20_rfc4175_422be12_to_yuv422p12le_avx512 */
+
+/* begin st40_pack_udw_avx512 */
+static uint8_t st40_popcnt_nibble_tbl_128[16] = {
+    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+};
+
+/* 40 bits of four words in each 64 bits to 5 big endian bytes */
+static uint8_t st40_words_pack_shuffle_tbl_128[16] = {
+    4, 3, 2, 1, 0, 12, 11, 10, 9, 8, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+};
+
+/* 5 big endian bytes to the 40 bits of four words in each 64 bits */
+static uint8_t st40_words_unpack_shuffle_tbl_128[16] = {
+    4, 3, 2, 1, 0, 0x80, 0x80, 0x80, 9, 8, 7, 6, 5, 0x80, 0x80, 0x80,
+};
+
+/* 8 bits value in each 16 bits to the 10 bits word with the parity bits */
+static inline __m512i st40_add_parity_avx512(__m512i val, __m512i popcnt_tbl) {
+  __m512i nibble_mask = _mm512_set1_epi16(0x0f);
+  __m512i lo = _mm512_shuffle_epi8(popcnt_tbl, _mm512_and_si512(val, nibble_mask));
+  __m512i hi = _mm512_shuffle_epi8(
+      popcnt_tbl, _mm512_and_si512(_mm512_srli_epi16(val, 4), nibble_mask));
+  __m512i parity = _mm512_and_si512(_mm512_add_epi8(lo, hi), _mm512_set1_epi16(1));
+  /* b8 is the even parity, b9 is the inverse of b8 */
+  __m512i b89 = _mm512_sub_epi16(_mm512_set1_epi16(0x200), _mm512_slli_epi16(parity, 8));
+  return _mm512_or_si512(val, b89);
+}
+
+static inline uint16_t st40_sum_epi16_avx512(__m512i sum) {
+  /* widen to 32 bits then reduce, only the low 9 bits are used for checksum */
+  __m512i sum32 = _mm512_madd_epi16(sum, _mm512_set1_epi16(1));
+  return _mm512_reduce_add_epi32(sum32);
+}
+
+int st40_pack_udw_avx512(uint16_t did, uint16_t sdid, const uint8_t* udw,
+                         uint16_t udw_size, uint8_t* data) {
+  __m512i popcnt_tbl =
+      _mm512_broadcast_i32x4(_mm_loadu_si128((__m128i*)st40_popcnt_nibble_tbl_128));
+  __m512i shuffle =
+      _mm512_broadcast_i32x4(_mm_loadu_si128((__m128i*)st40_words_pack_shuffle_tbl_128));
+  __m512i madd = _mm512_set1_epi32(0x00010400); /* w0 << 10 + w1 */
+  __m512i sum_v = _mm512_setzero_si512();
+  uint16_t words[ST40_UDW_WORDS_MAX];
+  uint32_t num = 3 + udw_size + 1;
+  uint16_t sum;
+  uint32_t i = 0;
+
+  words[0] = st40_add_parity_bits(did);
+  words[1] = st40_add_parity_bits(sdid);
+  words[2] = st40_add_parity_bits(udw_size);
+  sum = words[0] + words[1] + words[2];
+
+  /* parity and checksum, 32 udw each loop */
+  for (; (i + 32) <= udw_size; i += 32) {
+    __m512i val = _mm512_cvtepu8_epi16(_mm256_loadu_si256((__m256i*)(udw + i)));
+    __m512i word = st40_add_parity_avx512(val, popcnt_tbl);
+    sum_v = _mm512_add_epi16(sum_v, word);
+    _mm512_storeu_si512((__m512i*)&words[3 + i], word);
+  }
+  /* the left with mask */
+  if (i < udw_size) {
+    __mmask32 k = (1u << (udw_size - i)) - 1;
+    __m512i val = _mm512_maskz_cvtepu8_epi16(k, _mm256_maskz_loadu_epi8(k, udw + i));
+    __m512i word = _mm512_maskz_mov_epi16(k, st40_add_parity_avx512(val, popcnt_tbl));
+    sum_v = _mm512_add_epi16(sum_v, word);
+    _mm512_mask_storeu_epi16(&words[3 + i], k, word);
+  }
+  sum += st40_sum_epi16_avx512(sum_v);
+  words[num - 1] = st40_words_checksum(sum);
+
+  /* pack 32 words to 40 bytes each loop, keep 8 words for the 16 bytes store */
+  uint32_t k = 0;
+  uint8_t* dst = data;
+  for (; (k + 32 + 8) <= num; k += 32) {
+    __m512i word = _mm512_loadu_si512((__m512i*)&words[k]);
+    __m512i w20 = _mm512_madd_epi16(word, madd);
+    __m512i w40 = _mm512_or_si512(_mm512_slli_epi64(w20, 20), _mm512_srli_epi64(w20, 32));
+    __m512i result = _mm512_shuffle_epi8(w40, shuffle);
+
+    _mm_storeu_si128((__m128i*)dst, _mm512_castsi512_si128(result));
+    _mm_storeu_si128((__m128i*)(dst + 10), _mm512_extracti32x4_epi32(result, 1));
+    _mm_storeu_si128((__m128i*)(dst + 20), _mm512_extracti32x4_epi32(result, 2));
+    _mm_storeu_si128((__m128i*)(dst + 30), _mm512_extracti32x4_epi32(result, 3));
+    dst += 40;
+  }
+  st40_words_pack_scalar(words, k, num, data);
+
+  return st40_words_size(num);
+}
+/* end st40_pack_udw_avx512 */
+
+/* begin st40_unpack_udw_avx512 */
+int st40_unpack_udw_avx512(const uint8_t* data, uint16_t udw_size, uint8_t* udw) {
+  __m512i popcnt_tbl =
+      _mm512_broadcast_i32x4(_mm_loadu_si128((__m128i*)st40_popcnt_nibble_tbl_128));
+  __m512i shuffle = _mm512_broadcast_i32x4(
+      _mm_loadu_si128((__m128i*)st40_words_unpack_shuffle_tbl_128));
+  __m512i mask_20 = _mm512_set1_epi64(0xfffff);
+  __m512i mask_10 = _mm512_set1_epi32(0x3ff);
+  __m512i mask_8 = _mm512_set1_epi16(0xff);
+  __m512i sum_v = _mm512_setzero_si512();
+  uint16_t words[ST40_UDW_WORDS_MAX];
+  uint32_t num = 3 + udw_size + 1;
+  uint16_t sum = 0;
+  uint32_t k = 0;
+  const uint8_t* src = data;
+
+  /* unpack 40 bytes to 32 words each loop, keep 8 words for the 16 bytes load */
+  for (; (k + 32 + 8) <= num; k += 32) {
+    __m512i input = _mm512_castsi128_si512(_mm_loadu_si128((__m128i*)src));
+    input = _mm512_inserti32x4(input, _mm_loadu_si128((__m128i*)(src + 10)), 1);
+    input = _mm512_inserti32x4(input, _mm_loadu_si128((__m128i*)(src + 20)), 2);
+    input = _mm512_inserti32x4(input, _mm_loadu_si128((__m128i*)(src + 30)), 3);
+    __m512i w40 = _mm512_shuffle_epi8(input, shuffle);
+    __m512i w20 =
+        _mm512_or_si512(_mm512_srli_epi64(w40, 20),
+                        _mm512_slli_epi64(_mm512_and_si512(w40, mask_20), 32));
+    __m512i word = _mm512_or_si512(_mm512_srli_epi32(w20, 10),
+                                   _mm512_slli_epi32(_mm512_and_si512(w20, mask_10), 16));
+
+    _mm512_storeu_si512((__m512i*)&words[k], word);
+    src += 40;
+  }
+  st40_words_unpack_scalar(data, k, num, words);
+
+  for (uint32_t i = 0; i < 3; i++) sum += words[i];
+  /* parity check and checksum, 32 udw each loop */
+  for (uint32_t i = 0; i < udw_size; i += 32) {
+    __mmask32 m = (udw_size - i) >= 32 ? 0xffffffff : ((1u << (udw_size - i)) - 1);
+    __m512i word = _mm512_maskz_loadu_epi16(m, &words[3 + i]);
+    __m512i val = _mm512_and_si512(word, mask_8);
+    __m512i expect = _mm512_maskz_mov_epi16(m, st40_add_parity_avx512(val, popcnt_tbl));
+    if (_mm512_cmpneq_epi16_mask(word, expect)) return -EIO;
+    sum_v = _mm512_add_epi16(sum_v, word);
+    _mm256_mask_storeu_epi8(udw + i, m, _mm512_cvtepi16_epi8(val));
+  }
+  sum += st40_sum_epi16_avx512(sum_v);
+  if (words[num - 1] != st40_words_checksum(sum)) return -EIO;
+
+  return 0;
+}
+/* end st40_unpack_udw_avx512 */
 MT_TARGET_CODE_STOP
 #endif
@@ -111,4 +111,9 @@ int st20_rfc4175_422be12_to_yuv422p12le_avx512_dma(
     struct mtl_dma_lender_dev* dma, struct st20_rfc4175_422_12_pg2_be* pg_be,
     mtl_iova_t pg_be_iova, uint16_t* y, uint16_t* b, uint16_t* r, uint32_t w, uint32_t h);
 
+int st40_pack_udw_avx512(uint16_t did, uint16_t sdid, const uint8_t* udw,
+                         uint16_t udw_size, uint8_t* data);
+
+int st40_unpack_udw_avx512(const uint8_t* data, uint16_t udw_size, uint8_t* udw);
+
 #endif
\ No newline at end of file
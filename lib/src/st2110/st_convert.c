@@ -2480,3 +2480,106 @@ int st31_aes3_to_am824(struct st31_aes3* sf_aes3, struct st31_am824* sf_am824,
 
   return 0;
 }
+
+/* read one sample to a signed 24 bits value */
+static inline int32_t st30_sample_read(const uint8_t* p, enum st30_fmt fmt) {
+  int32_t v;
+
+  switch (fmt) {
+    case ST30_FMT_PCM8:
+      v = (int32_t)((uint32_t)p[0] << 24) >> 8;
+      break;
+    case ST30_FMT_PCM16:
+      v = (int32_t)(((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16)) >> 8;
+      break;
+    case ST30_FMT_PCM24:
+      v = (int32_t)(((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+                    ((uint32_t)p[2] << 8)) >>
+          8;
+      break;
+    default: /* ST31_FMT_AM824, same data layout as st31_am824_to_aes3 */
+      v = (int32_t)(((uint32_t)p[3] << 24) | ((uint32_t)p[2] << 16) |
+                    ((uint32_t)p[1] << 8)) >>
+          8;
+      break;
+  }
+
+  return v;
+}
+
+static inline void st30_sample_write(uint8_t* p, enum st30_fmt fmt, int32_t v) {
+  uint32_t u = (uint32_t)v;
+
+  switch (fmt) {
+    case ST30_FMT_PCM8:
+      p[0] = u >> 16;
+      break;
+    case ST30_FMT_PCM16:
+      p[0] = u >> 16;
+      p[1] = u >> 8;
+      break;
+    case ST30_FMT_PCM24:
+      p[0] = u >> 16;
+      p[1] = u >> 8;
+      p[2] = u;
+      break;
+    default: /* ST31_FMT_AM824, label byte is filled by the caller */
+      p[1] = u;
+      p[2] = u >> 8;
+      p[3] = u >> 16;
+      break;
+  }
+}
+
+int st30_pcm_convert(const void* src, enum st30_fmt src_fmt, void* dst,
+                     enum st30_fmt dst_fmt, uint16_t channel, uint32_t samples,
+                     uint32_t* am824_frame_idx) {
+  int src_size = st30_get_sample_size(src_fmt);
+  int dst_size = st30_get_sample_size(dst_fmt);
+  const uint8_t* s = src;
+  uint8_t* d = dst;
+  uint32_t frame_idx = am824_frame_idx ? *am824_frame_idx : 0;
+
+  if (src_size < 0 || dst_size < 0) {
+    err("%s, invalid fmt src %d dst %d\n", __func__, src_fmt, dst_fmt);
+    return -EINVAL;
+  }
+  if (!channel) {
+    err("%s, invalid channel %u\n", __func__, channel);
+    return -EINVAL;
+  }
+
+  if (src_fmt == dst_fmt) {
+    rte_memcpy(dst, src, (size_t)src_size * channel * samples);
+    return 0;
+  }
+
+  for (uint32_t i = 0; i < samples; i++) {
+    for (uint16_t c = 0; c < channel; c++) {
+      int32_t v = st30_sample_read(s, src_fmt);
+
+      st30_sample_write(d, dst_fmt, v);
+      if (dst_fmt == ST31_FMT_AM824) {
+        struct st31_am824* am = (struct st31_am824*)d;
+        /* channel pairs map to AES3 subframe 1(X/Z) and subframe 2(Y) */
+        bool first = !(c & 0x1);
+
+        am->unused = 0;
+        am->v = 0;
+        am->u = 0;
+        am->c = 0;
+        am->f = first ? 1 : 0;
+        am->b = (first && !frame_idx) ? 1 : 0;
+        /* even parity over the 24 bits audio data */
+        am->p = __builtin_parity((uint32_t)v & 0xFFFFFF);
+      }
+      s += src_size;
+      d += dst_size;
+    }
+    frame_idx++;
+    if (frame_idx >= 192) frame_idx = 0; /* AES3 block has 192 frames */
+  }
+
+  if (am824_frame_idx) *am824_frame_idx = frame_idx;
+  return 0;
+}
@@ -726,6 +726,11 @@ uint64_t st10_media_clk_to_ns(uint32_t media_ts, uint32_t sampling_rate) {
 }
 
 enum mtl_pmd_type mtl_pmd_by_port_name(const char* port) {
+  if (!strncmp(port, MTL_LOOPBACK_PORT_PREFIX, strlen(MTL_LOOPBACK_PORT_PREFIX)))
+    return MTL_PMD_DPDK_LOOPBACK;
+  if (!strncmp(port, MTL_PCAP_PORT_PREFIX, strlen(MTL_PCAP_PORT_PREFIX)))
+    return MTL_PMD_DPDK_PCAP;
+
   char* bdf = strstr(port, ":");
   return bdf ? MTL_PMD_DPDK_USER : MTL_PMD_DPDK_AF_XDP;
 }
@@ -6,8 +6,11 @@
 #define _MT_LIB_ST_HEAD_H_
 
 #include "../mt_header.h"
+#include "mtl_ebu_api.h"
 #include "st20_api.h"
 #include "st30_api.h"
+#include "st30_pipeline_api.h"
+#include "st40_pipeline_api.h"
 #include "st40_api.h"
 #include "st_convert.h"
 #include "st_fmt.h"
@@ -106,6 +109,8 @@ struct st_rx_muf_priv_data {
 #define ST_FT_FLAG_RTE_MALLOC (MTL_BIT32(0))
 /* ext frame by application */
 #define ST_FT_FLAG_EXT (MTL_BIT32(1))
+/* the frame is from the frame arena */
+#define ST_FT_FLAG_ARENA (MTL_BIT32(2))
 
 /* IOVA mapping info of each page in frame, used for IOVA:PA mode */
 struct st_page_info {
@@ -127,6 +132,7 @@ struct st_frame_trans {
 
   uint32_t flags;                          /* ST_FT_FLAG_* */
   struct rte_mbuf_ext_shared_info sh_info; /* for st20 tx ext shared */
+  struct mt_arena_frame* arena;            /* for ST_FT_FLAG_ARENA */
 
   /* metadata */
   union {
@@ -242,6 +248,15 @@ struct st_vsync_info {
   bool init;
 };
 
+/* the metrics of a tx video session, see tv_metric_descs */
+enum st_tx_video_metric {
+  ST_TX_VIDEO_METRIC_FRAMES = 0,
+  ST_TX_VIDEO_METRIC_PKTS_BUILD,
+  ST_TX_VIDEO_METRIC_PKTS_BURST,
+  ST_TX_VIDEO_METRIC_EPOCH_DROP,
+  ST_TX_VIDEO_METRIC_MAX,
+};
+
 struct st_tx_video_session_impl {
   enum mtl_port port_maps[MTL_SESSION_PORT_MAX];
   struct rte_mempool* mbuf_mempool_hdr[MTL_SESSION_PORT_MAX];
@@ -307,6 +322,7 @@ struct st_tx_video_session_impl {
   size_t st20_linesize;     /* line size including padding bytes */
   uint16_t st20_frames_cnt; /* numbers of frames requested */
   struct st_frame_trans* st20_frames;
+  struct mt_arena_quota arena_quota;
 
   uint16_t st20_frame_idx; /* current frame index */
   enum st21_tx_frame_status st20_frame_stat;
@@ -345,12 +361,15 @@ struct st_tx_video_session_impl {
   rte_atomic32_t stat_frame_cnt;
   int stat_pkts_build;
   int stat_pkts_dummy;
-  int stat_pkts_burst;
+  int stat_pkts_burst[MTL_SESSION_PORT_MAX];
   int stat_pkts_burst_dummy;
   int stat_pkts_chain_realloc_fail;
   int stat_trs_ret_code[MTL_SESSION_PORT_MAX];
   int stat_build_ret_code;
   uint64_t stat_last_time;
+  struct mt_metric_group* metrics; /* monotonic, see enum st_tx_video_metric */
+  /* how late the pkts are sent to the nic against the pacing target */
+  struct mt_hist stat_pacing_err_hist;
   uint32_t stat_epoch_drop;
   uint32_t stat_epoch_onward;
   uint32_t stat_error_user_timestamp;
@@ -413,33 +432,24 @@ struct st_rx_video_slot_impl {
   /* payload len for codestream packetization mode */
   uint16_t st22_payload_length;
   uint16_t st22_box_hdr_length;
+  /* the time all pkts received while dma copy is still pending, 0 if not */
+  uint64_t complete_tsc;
 };
 
 struct st_rx_video_ebu_info {
-  double trs;        /* in ns for of 2 consecutive packets, T-Frame / N-Packets */
-  double tr_offset;  /* in ns, tr offset time of each frame */
-  double frame_time; /* time of the frame in nanoseconds */
-  double frame_time_sampling; /* time of the frame in sampling(90k) */
-  int dropped_results;        /* number of results to drop at the beginning */
-
-  // pass criteria
-  uint32_t c_max_narrow_pass;
-  uint32_t c_max_wide_pass;
-  uint32_t vrx_full_narrow_pass;
-  uint32_t vrx_full_wide_pass;
-  uint32_t rtp_offset_max_pass;
+  struct mtl_ebu_video_info model; /* timing model and pass criteria */
+  int dropped_results;             /* number of results to drop at the beginning */
 
   bool init;
 };
 
 struct st_rx_video_ebu_stat {
-  uint64_t cur_epochs; /* epoch of current frame */
+  struct mtl_ebu_video_frame frame; /* state and values of current frame */
   int frame_idx;
   bool compliant;
   bool compliant_narrow;
 
   /* Cinst, packet level check */
-  uint64_t cinmtl_initial_time;
   int32_t cinst_max;
   int32_t cinst_min;
   uint32_t cinst_cnt;
@@ -447,8 +457,6 @@ struct st_rx_video_ebu_stat {
   float cinst_avg;
 
   /* vrx, packet level check */
-  int32_t vrx_drained_prev;
-  int32_t vrx_prev;
   int32_t vrx_max;
   int32_t vrx_min;
   uint32_t vrx_cnt;
@@ -477,7 +485,6 @@ struct st_rx_video_ebu_stat {
   float rtp_offset_avg;
 
   /* Inter-frame RTP TS Delta, frame level check */
-  uint32_t prev_rtp_ts;
   int32_t rtp_ts_delta_max;
   int32_t rtp_ts_delta_min;
   uint32_t rtp_ts_delta_cnt;
@@ -485,7 +492,6 @@ struct st_rx_video_ebu_stat {
   float rtp_ts_delta_avg;
 
   /* Inter-packet time(ns), packet level check */
-  uint64_t prev_rtp_ipt_ts;
   int32_t rtp_ipt_max;
   int32_t rtp_ipt_min;
   uint32_t rtp_ipt_cnt;
@@ -564,6 +570,16 @@ struct st_rx_session_priv {
   enum mtl_session_port s_port;
 };
 
+/* the metrics of a rx video session, see rv_metric_descs */
+enum st_rx_video_metric {
+  ST_RX_VIDEO_METRIC_FRAMES_RECEIVED = 0,
+  ST_RX_VIDEO_METRIC_FRAMES_DROPPED,
+  ST_RX_VIDEO_METRIC_PKTS_RECEIVED,
+  ST_RX_VIDEO_METRIC_PKTS_REDUNDANT,
+  ST_RX_VIDEO_METRIC_PKTS_OUT_OF_ORDER,
+  ST_RX_VIDEO_METRIC_MAX,
+};
+
 struct st_rx_video_session_impl {
   int idx; /* index for current session */
   struct st_rx_video_sessions_mgr* parent;
@@ -602,6 +618,7 @@ struct st_rx_video_session_impl {
   size_t st20_frame_bitmap_size; /* bitmap size per frame */
   int st20_frames_cnt;           /* numbers of frames requested */
   struct st_frame_trans* st20_frames;
+  struct mt_arena_quota arena_quota;
   struct st20_pgroup st20_pg;
 
   size_t st20_uframe_size; /* size per user frame */
@@ -676,6 +693,9 @@ struct st_rx_video_session_impl {
   int stat_pkts_slice_fail;
   int stat_pkts_slice_merged;
   uint64_t stat_last_time;
+  struct mt_metric_group* metrics; /* monotonic, see enum st_rx_video_metric */
+  /* from all pkts of a frame received to the return of notify_frame_ready */
+  struct mt_hist stat_notify_hist;
   uint32_t stat_vsync_mismatch;
   uint32_t stat_slot_get_frame_fail;
   uint32_t stat_slot_query_ext_fail;
@@ -812,15 +832,8 @@ struct st_audio_transmitter_impl {
 };
 
 struct st_rx_audio_ebu_info {
-  double frame_time;          /* time of the frame in nanoseconds */
-  double frame_time_sampling; /* time of the frame in sampling */
-  int dropped_results;        /* number of results to drop at the beginning */
-
-  /* Pass Criteria */
-  int32_t dpvr_max_pass_narrow;
-  int32_t dpvr_max_pass_wide;
-  float dpvr_avg_pass_wide;
-  int32_t tsdf_max_pass;
+  struct mtl_ebu_audio_info model; /* timing model and pass criteria */
+  int dropped_results;             /* number of results to drop at the beginning */
 };
 
 struct st_rx_audio_ebu_stat {
@@ -876,6 +889,8 @@ struct st_rx_audio_session_impl {
   int st30_pkt_idx;       /* pkt index in current frame */
   int st30_seq_id;        /* seq id for each pkt */
 
+  struct st_rx_merge* merge; /* st2022-7 merge, only for num_port > 1 */
+
   uint32_t tmstamp;
   size_t frame_recv_size;
 
@@ -1017,7 +1032,8 @@ struct st_rx_ancillary_session_impl {
   uint16_t st40_src_port[MTL_SESSION_PORT_MAX]; /* udp port */
   uint16_t st40_dst_port[MTL_SESSION_PORT_MAX]; /* udp port */
 
-  int st40_seq_id; /* seq id for each pkt */
+  int st40_seq_id;           /* seq id for each pkt */
+  struct st_rx_merge* merge; /* st2022-7 merge, only for num_port > 1 */
 
   uint32_t tmstamp;
   /* status */
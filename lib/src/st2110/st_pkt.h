@@ -13,13 +13,6 @@
 #define ST_RARTP_PAYLOAD_TYPE_PCM_AUDIO (111)
 #define ST_RANCRTP_PAYLOAD_TYPE_ANCILLARY (113)
 
-#define ST_EBU_CINST_DRAIN_FACTOR (1.1f) /* Drain factor */
-
-#define ST_EBU_LATENCY_MAX_US (1000)                         /* Latency in us */
-#define ST_EBU_LATENCY_MAX_NS (1000 * ST_EBU_LATENCY_MAX_US) /* Latency in ns */
-
-#define ST_EBU_RTP_OFFSET_MIN (-1) /* MIN RTP Offset */
-
 #define ST_EBU_RTP_WRAP_AROUND (0x100000000)
 
 #define ST_EBU_PASS_NARROW "PASSED NARROW"
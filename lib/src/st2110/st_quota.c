@@ -0,0 +1,221 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include "st_quota.h"
+
+#include "../mt_log.h"
+
+/* one 1080p 422 10bit frame */
+#define ST_QUOTA_CAL_PKTS_PER_FRAME (4320)
+#define ST_QUOTA_CAL_FRAME_SIZE (ST_QUOTA_CAL_PKTS_PER_FRAME * ST_VIDEO_BPM_SIZE)
+/* pkts for each measure */
+#define ST_QUOTA_CAL_PKTS (ST_QUOTA_CAL_PKTS_PER_FRAME * 8)
+#define ST_QUOTA_CAL_BURST (32)
+/*
+ * the PMD burst cost of each pkt, it's not measurable before the port started as no pkt
+ * can be sent, from the tx/rx burst profile on E810.
+ */
+#define ST_QUOTA_CAL_DRV_PKT_CYCLES (120)
+
+struct st_quota_cal {
+  struct mtl_main_impl* impl;
+  struct rte_mempool* pool;
+  uint8_t* frame;
+  struct rte_mbuf_ext_shared_info sh_info;
+  struct st_rfc4175_video_hdr hdr;
+  uint8_t bitmap[ST_QUOTA_CAL_PKTS_PER_FRAME / 8];
+};
+
+static void quota_cal_ext_free_cb(void* addr, void* opaque) {
+  /* the frame is owned by the cal, nothing to do */
+  dbg("%s, addr %p opaque %p\n", __func__, addr, opaque);
+}
+
+/* the same steps as tv_build_st20/tv_build_st20_chain */
+static inline void quota_cal_tx_build(struct st_quota_cal* cal, struct rte_mbuf* pkt,
+                                      struct rte_mbuf* pkt_chain, uint32_t pkt_idx) {
+  struct st_rfc4175_video_hdr* hdr = rte_pktmbuf_mtod(pkt, struct st_rfc4175_video_hdr*);
+  uint32_t offset = (pkt_idx % ST_QUOTA_CAL_PKTS_PER_FRAME) * ST_VIDEO_BPM_SIZE;
+  struct st20_rfc4175_rtp_hdr* rtp = &hdr->rtp;
+
+  rte_memcpy(hdr, &cal->hdr, sizeof(*hdr));
+  hdr->ipv4.packet_id = htons(pkt_idx);
+  rtp->base.seq_number = htons((uint16_t)pkt_idx);
+  rtp->seq_number_ext = htons((uint16_t)(pkt_idx >> 16));
+  rtp->row_number = htons(offset / 4800);
+  rtp->row_offset = htons((offset % 4800) * 2 / 5);
+  rtp->row_length = htons(ST_VIDEO_BPM_SIZE);
+  mt_mbuf_init_ipv4(pkt);
+  pkt->data_len = sizeof(*hdr);
+
+  if (pkt_chain) {
+    rte_pktmbuf_attach_extbuf(pkt_chain, cal->frame + offset, 0, ST_VIDEO_BPM_SIZE,
+                              &cal->sh_info);
+    rte_mbuf_ext_refcnt_update(&cal->sh_info, 1);
+    pkt_chain->data_len = ST_VIDEO_BPM_SIZE;
+    pkt_chain->pkt_len = ST_VIDEO_BPM_SIZE;
+    pkt->pkt_len = pkt->data_len;
+    rte_pktmbuf_chain(pkt, pkt_chain);
+  } else {
+    mtl_memcpy(&rtp[1], cal->frame + offset, ST_VIDEO_BPM_SIZE);
+    pkt->data_len += ST_VIDEO_BPM_SIZE;
+    pkt->pkt_len = pkt->data_len;
+  }
+
+  hdr->udp.dgram_len = htons(pkt->pkt_len - pkt->l2_len - pkt->l3_len);
+  hdr->ipv4.total_length = htons(pkt->pkt_len - pkt->l2_len);
+}
+
+static int quota_cal_tx(struct st_quota_cal* cal, bool chain, uint32_t* cycles) {
+  struct rte_mbuf* pkts[ST_QUOTA_CAL_BURST];
+  struct rte_mbuf* pkts_chain[ST_QUOTA_CAL_BURST];
+  uint64_t start = rte_get_tsc_cycles();
+  int ret;
+
+  for (uint32_t i = 0; i < ST_QUOTA_CAL_PKTS; i += ST_QUOTA_CAL_BURST) {
+    ret = rte_pktmbuf_alloc_bulk(cal->pool, pkts, ST_QUOTA_CAL_BURST);
+    if (ret < 0) return ret;
+    if (chain) {
+      ret = rte_pktmbuf_alloc_bulk(cal->pool, pkts_chain, ST_QUOTA_CAL_BURST);
+      if (ret < 0) {
+        rte_pktmbuf_free_bulk(pkts, ST_QUOTA_CAL_BURST);
+        return ret;
+      }
+    }
+    for (int j = 0; j < ST_QUOTA_CAL_BURST; j++)
+      quota_cal_tx_build(cal, pkts[j], chain ? pkts_chain[j] : NULL, i + j);
+    /* the free after the nic tx done */
+    rte_pktmbuf_free_bulk(pkts, ST_QUOTA_CAL_BURST);
+  }
+
+  *cycles = (rte_get_tsc_cycles() - start) / ST_QUOTA_CAL_PKTS;
+  return 0;
+}
+
+/* the same steps as rv_handle_frame_pkt, copy the payload if not dma */
+static inline int quota_cal_rx_handle(struct st_quota_cal* cal, struct rte_mbuf* pkt,
+                                      uint8_t* dst, bool copy) {
+  struct st_rfc4175_video_hdr* hdr = rte_pktmbuf_mtod(pkt, struct st_rfc4175_video_hdr*);
+  struct st20_rfc4175_rtp_hdr* rtp = &hdr->rtp;
+  uint32_t seq_id_u32 = (uint32_t)ntohs(rtp->seq_number_ext) << 16 |
+                        ntohs(rtp->base.seq_number);
+  uint16_t line1_number = ntohs(rtp->row_number);
+  uint16_t line1_offset = ntohs(rtp->row_offset);
+  uint16_t line1_length = ntohs(rtp->row_length);
+  uint32_t offset = line1_number * 4800 + line1_offset * 5 / 2;
+  int pkt_idx = seq_id_u32 % ST_QUOTA_CAL_PKTS_PER_FRAME;
+
+  if (hdr->rtp.base.payload_type != cal->hdr.rtp.base.payload_type) return -EINVAL;
+  if ((offset + line1_length) > ST_QUOTA_CAL_FRAME_SIZE) return -EIO;
+  if (mt_bitmap_test_and_set(cal->bitmap, pkt_idx)) return -EIO;
+  if (copy) mtl_memcpy(dst + offset, &rtp[1], line1_length);
+  return 0;
+}
+
+static int quota_cal_rx(struct st_quota_cal* cal, uint8_t* dst, bool copy,
+                        uint32_t* cycles) {
+  struct rte_mbuf* pkts[ST_QUOTA_CAL_BURST];
+  uint64_t start;
+  int ret;
+
+  /* the pkts in the rx ring */
+  ret = rte_pktmbuf_alloc_bulk(cal->pool, pkts, ST_QUOTA_CAL_BURST);
+  if (ret < 0) return ret;
+  for (int j = 0; j < ST_QUOTA_CAL_BURST; j++) quota_cal_tx_build(cal, pkts[j], NULL, j);
+
+  start = rte_get_tsc_cycles();
+  for (uint32_t i = 0; i < ST_QUOTA_CAL_PKTS; i += ST_QUOTA_CAL_BURST) {
+    if (!(i % ST_QUOTA_CAL_PKTS_PER_FRAME)) memset(cal->bitmap, 0, sizeof(cal->bitmap));
+    for (int j = 0; j < ST_QUOTA_CAL_BURST; j++) {
+      struct st_rfc4175_video_hdr* hdr =
+          rte_pktmbuf_mtod(pkts[j], struct st_rfc4175_video_hdr*);
+      hdr->rtp.base.seq_number = htons((uint16_t)(i + j));
+      quota_cal_rx_handle(cal, pkts[j], dst, copy);
+    }
+  }
+  *cycles = (rte_get_tsc_cycles() - start) / ST_QUOTA_CAL_PKTS;
+
+  rte_pktmbuf_free_bulk(pkts, ST_QUOTA_CAL_BURST);
+  return 0;
+}
+
+int st_quota_calibrate(struct mtl_main_impl* impl, int* data_quota_mbs_per_sch) {
+  struct mt_sch_mgr* mgr = mt_sch_get_mgr(impl);
+  int soc_id = mt_socket_id(impl, MTL_PORT_P);
+  struct st_quota_cal* cal;
+  uint8_t* rx_frame = NULL;
+  uint32_t tx_cycles, rx_cycles, rx_copy_cycles;
+  int ret = -ENOMEM;
+
+  cal = mt_rte_zmalloc_socket(sizeof(*cal), soc_id);
+  if (!cal) {
+    err("%s, cal malloc fail\n", __func__);
+    return -ENOMEM;
+  }
+  cal->impl = impl;
+  cal->sh_info.free_cb = quota_cal_ext_free_cb;
+  rte_mbuf_ext_refcnt_set(&cal->sh_info, 0);
+  cal->hdr.eth.ether_type = htons(RTE_ETHER_TYPE_IPV4);
+  cal->hdr.ipv4.version_ihl = (4 << 4) | (sizeof(struct rte_ipv4_hdr) / 4);
+  cal->hdr.ipv4.time_to_live = 64;
+  cal->hdr.ipv4.next_proto_id = IPPROTO_UDP;
+  cal->hdr.rtp.base.version = 2;
+  cal->hdr.rtp.base.payload_type = ST_RVRTP_PAYLOAD_TYPE_RAW_VIDEO;
+
+  cal->pool = mt_mempool_create_common(impl, MTL_PORT_P, "ST_QUOTA_CAL", 1024);
+  cal->frame = mt_rte_zmalloc_socket(ST_QUOTA_CAL_FRAME_SIZE, soc_id);
+  rx_frame = mt_rte_zmalloc_socket(ST_QUOTA_CAL_FRAME_SIZE, soc_id);
+  if (!cal->pool || !cal->frame || !rx_frame) {
+    err("%s, pool or frame malloc fail\n", __func__);
+    goto exit;
+  }
+
+  /* warm up the cache and the pool */
+  quota_cal_tx(cal, true, &tx_cycles);
+
+  ret = quota_cal_tx(cal, !mt_has_tx_no_chain(impl), &tx_cycles);
+  if (ret < 0) {
+    err("%s, tx measure fail %d\n", __func__, ret);
+    goto exit;
+  }
+  ret = quota_cal_rx(cal, rx_frame, false, &rx_cycles);
+  if (ret < 0) {
+    err("%s, rx measure fail %d\n", __func__, ret);
+    goto exit;
+  }
+  ret = quota_cal_rx(cal, rx_frame, true, &rx_copy_cycles);
+  if (ret < 0) {
+    err("%s, rx copy measure fail %d\n", __func__, ret);
+    goto exit;
+  }
+
+  mgr->tx_pkt_cycles = tx_cycles + ST_QUOTA_CAL_DRV_PKT_CYCLES;
+  mgr->rx_pkt_cycles = rx_cycles + ST_QUOTA_CAL_DRV_PKT_CYCLES;
+  mgr->rx_copy_cycles = (rx_copy_cycles > rx_cycles) ? (rx_copy_cycles - rx_cycles) : 0;
+
+  /* cpu ratio of 1 mb/s tx video */
+  double pkts_per_mbs = (double)MT_DEV_STAT_M_UNIT / 8 /
+                        (ST_VIDEO_BPM_SIZE + sizeof(struct st_rfc4175_video_hdr));
+  mgr->load_per_mbs = pkts_per_mbs * mgr->tx_pkt_cycles / rte_get_tsc_hz();
+
+  int quota_mbs = MT_SCH_LOAD_TARGET / mgr->load_per_mbs;
+  int quota_1080p = st20_1080p59_yuv422_10bit_bandwidth_mps();
+  /* at least one 1080p session, at most the max sessions of one sch */
+  quota_mbs = RTE_MAX(quota_mbs, quota_1080p);
+  quota_mbs = RTE_MIN(quota_mbs, quota_1080p * ST_SCH_MAX_TX_VIDEO_SESSIONS);
+  *data_quota_mbs_per_sch = quota_mbs;
+  mgr->quota_calibrated = true;
+
+  info("%s, tx %u cycles rx %u(copy %u) cycles per pkt, %f 1080p tx sessions per sch\n",
+       __func__, mgr->tx_pkt_cycles, mgr->rx_pkt_cycles, mgr->rx_copy_cycles,
+       (float)quota_mbs / quota_1080p);
+  ret = 0;
+
+exit:
+  if (rx_frame) mt_rte_free(rx_frame);
+  if (cal->frame) mt_rte_free(cal->frame);
+  if (cal->pool) mt_mempool_free(cal->pool);
+  mt_rte_free(cal);
+  return ret;
+}
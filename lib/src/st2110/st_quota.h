@@ -0,0 +1,30 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _ST_LIB_QUOTA_HEAD_H_
+#define _ST_LIB_QUOTA_HEAD_H_
+
+#include "st_main.h"
+
+/*
+ * benchmark the per pkt cost of st20 tx build and rx handle on current cpu, fill the
+ * result to the sch mgr and return the data quota(mb/s) for one sch.
+ */
+int st_quota_calibrate(struct mtl_main_impl* impl, int* data_quota_mbs_per_sch);
+
+/* convert the rx quota to the tx based sch quota unit with the calibrated cost */
+static inline int st_quota_rx_scale(struct mtl_main_impl* impl, int quota_mbs,
+                                    bool dma) {
+  struct mt_sch_mgr* mgr = mt_sch_get_mgr(impl);
+  float ratio;
+
+  if (dma)
+    ratio = (float)mgr->rx_pkt_cycles / mgr->tx_pkt_cycles;
+  else
+    ratio = (float)(mgr->rx_pkt_cycles + mgr->rx_copy_cycles) / mgr->tx_pkt_cycles;
+
+  return quota_mbs * ratio;
+}
+
+#endif
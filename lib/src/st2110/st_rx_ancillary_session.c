@@ -7,6 +7,7 @@
 #include "../mt_log.h"
 #include "../mt_shared_rss.h"
 #include "../mt_stat.h"
+#include "redundant/st_rx_merge.h"
 #include "st_ancillary_transmitter.h"
 
 /* call rx_ancillary_session_put always if get successfully */
@@ -78,6 +79,36 @@ static int rx_ancillary_sessions_tasklet_stop(void* priv) {
   return 0;
 }
 
+/* the in order pkt, from the seq check or the st2022-7 merge */
+static int rx_ancillary_session_consume_pkt(void* priv, struct rte_mbuf* mbuf,
+                                            enum mtl_session_port s_port) {
+  struct st_rx_ancillary_session_impl* s = priv;
+  struct st40_rx_ops* ops = &s->ops;
+  size_t hdr_offset = sizeof(struct st_rfc3550_hdr) - sizeof(struct st_rfc3550_rtp_hdr);
+  struct st_rfc3550_rtp_hdr* rtp =
+      rte_pktmbuf_mtod_offset(mbuf, struct st_rfc3550_rtp_hdr*, hdr_offset);
+
+  /* enqueue to packet ring to let app to handle */
+  int ret = rte_ring_sp_enqueue(s->packet_ring, (void*)mbuf);
+  if (ret < 0) {
+    err("%s(%d), can not enqueue to the rte ring, packet drop, pkt seq %d\n", __func__,
+        s->idx, ntohs(rtp->seq_number));
+    s->st40_stat_pkts_dropped++;
+    return 0;
+  }
+  rte_mbuf_refcnt_update(mbuf, 1); /* free when app put */
+
+  if (rtp->tmstamp != s->tmstamp) {
+    rte_atomic32_inc(&s->st40_stat_frames_received);
+    s->tmstamp = rtp->tmstamp;
+  }
+  s->st40_stat_pkts_received++;
+  /* get a valid packet */
+  if (ops->priv) ops->notify_rtp_ready(ops->priv);
+
+  return 0;
+}
+
 static int rx_ancillary_session_handle_pkt(struct mtl_main_impl* impl,
                                            struct st_rx_ancillary_session_impl* s,
                                            struct rte_mbuf* mbuf,
@@ -95,6 +126,12 @@ static int rx_ancillary_session_handle_pkt(struct mtl_main_impl* impl,
     return -EINVAL;
   }
 
+  /* st2022-7, the merge deliver the pkts in seq order */
+  if (s->merge) {
+    st_rx_merge_push(s->merge, mbuf, seq_id, s_port, mt_get_tsc(impl));
+    return 0;
+  }
+
   /* set first seq_id - 1 */
   if (unlikely(s->st40_seq_id == -1)) s->st40_seq_id = seq_id - 1;
   /* drop old packet */
@@ -106,25 +143,7 @@ static int rx_ancillary_session_handle_pkt(struct mtl_main_impl* impl,
   /* update seq id */
   s->st40_seq_id = seq_id;
 
-  /* enqueue to packet ring to let app to handle */
-  int ret = rte_ring_sp_enqueue(s->packet_ring, (void*)mbuf);
-  if (ret < 0) {
-    err("%s(%d), can not enqueue to the rte ring, packet drop, pkt seq %d\n", __func__,
-        s->idx, seq_id);
-    s->st40_stat_pkts_dropped++;
-    return 0;
-  }
-  rte_mbuf_refcnt_update(mbuf, 1); /* free when app put */
-
-  if (rtp->tmstamp != s->tmstamp) {
-    rte_atomic32_inc(&s->st40_stat_frames_received);
-    s->tmstamp = rtp->tmstamp;
-  }
-  s->st40_stat_pkts_received++;
-  /* get a valid packet */
-  if (ops->priv) ops->notify_rtp_ready(ops->priv);
-
-  return 0;
+  return rx_ancillary_session_consume_pkt(s, mbuf, s_port);
 }
 
 static int rx_ancillary_session_handle_mbuf(void* priv, struct rte_mbuf** mbuf,
@@ -167,6 +186,8 @@ static int rx_ancillary_session_tasklet(struct mtl_main_impl* impl,
 
     if (rv) done = false;
   }
+  /* skip the pkts lost on all paths */
+  if (s->merge && s->merge->held) st_rx_merge_timeout(s->merge, mt_get_tsc(impl));
 
   return done ? MT_TASKLET_ALL_DONE : MT_TASKLET_HAS_PENDING;
 }
@@ -254,6 +275,7 @@ static int rx_ancillary_session_uinit_mcast(struct mtl_main_impl* impl,
   for (int i = 0; i < ops->num_port; i++) {
     if (mt_is_multicast_ip(ops->sip_addr[i]))
       mt_mcast_leave(impl, mt_ip_to_u32(ops->sip_addr[i]),
+                     mt_ip_to_u32(ops->mcast_sip_addr[i]),
                      mt_port_logic2phy(s->port_maps, i));
   }
 
@@ -274,7 +296,7 @@ static int rx_ancillary_session_init_mcast(struct mtl_main_impl* impl,
       return 0;
     }
     ret = mt_mcast_join(impl, mt_ip_to_u32(ops->sip_addr[i]),
-                        mt_port_logic2phy(s->port_maps, i));
+                        mt_ip_to_u32(ops->mcast_sip_addr[i]), port);
     if (ret < 0) return ret;
   }
 
@@ -304,11 +326,26 @@ static int rx_ancillary_session_init_sw(struct mtl_main_impl* impl,
   }
   s->packet_ring = ring;
   info("%s(%d,%d), rtp_ring_size %d\n", __func__, mgr_idx, idx, count);
+
+  if (s->ops.num_port > 1) {
+    s->merge = st_rx_merge_create(idx, s->ops.merge_window_us, mt_socket_id(impl, port),
+                                  rx_ancillary_session_consume_pkt, s);
+    if (!s->merge) {
+      err("%s(%d,%d), merge create fail\n", __func__, mgr_idx, idx);
+      rte_ring_free(s->packet_ring);
+      s->packet_ring = NULL;
+      return -ENOMEM;
+    }
+  }
   return 0;
 }
 
 static int rx_ancillary_session_uinit_sw(struct mtl_main_impl* impl,
                                          struct st_rx_ancillary_session_impl* s) {
+  if (s->merge) {
+    st_rx_merge_free(s->merge);
+    s->merge = NULL;
+  }
   if (s->packet_ring) {
     mt_ring_dequeue_clean(s->packet_ring);
     rte_ring_free(s->packet_ring);
@@ -406,6 +443,7 @@ static void rx_ancillary_session_stat(struct st_rx_ancillary_session_impl* s) {
            s->st40_stat_pkts_wrong_hdr_dropped);
     s->st40_stat_pkts_wrong_hdr_dropped = 0;
   }
+  if (s->merge) st_rx_merge_stat(s->merge, "RX_ANC_SESSION", s->ops.num_port);
 }
 
 static int rx_ancillary_session_detach(struct mtl_main_impl* impl,
@@ -436,6 +474,7 @@ static int rx_ancillary_session_update_src(struct mtl_main_impl* impl,
   /* update ip and port */
   for (int i = 0; i < num_port; i++) {
     memcpy(ops->sip_addr[i], src->sip_addr[i], MTL_IP_ADDR_LEN);
+    memcpy(ops->mcast_sip_addr[i], src->mcast_sip_addr[i], MTL_IP_ADDR_LEN);
     ops->udp_port[i] = src->udp_port[i];
     s->st40_dst_port[i] = (ops->udp_port[i]) ? (ops->udp_port[i]) : (30000 + idx);
     s->st40_src_port[i] =
@@ -443,6 +482,7 @@ static int rx_ancillary_session_update_src(struct mtl_main_impl* impl,
   }
   /* reset seq id */
   s->st40_seq_id = -1;
+  if (s->merge) st_rx_merge_reset(s->merge);
 
   ret = rx_ancillary_session_init_hw(impl, s);
   if (ret < 0) {
@@ -514,6 +554,7 @@ static int rx_ancillary_sessions_mgr_init(struct mtl_main_impl* impl,
     ops.start = rx_ancillary_sessions_tasklet_start;
     ops.stop = rx_ancillary_sessions_tasklet_stop;
     ops.handler = rx_ancillary_sessions_tasklet_handler;
+    ops.migratable = true;
 
     mgr->tasklet = mt_sch_register_tasklet(sch, &ops);
     if (!mgr->tasklet) {
@@ -533,12 +574,13 @@ static struct st_rx_ancillary_session_impl* rx_ancillary_sessions_mgr_attach(
   struct mtl_main_impl* impl = mgr->parent;
   int ret;
   struct st_rx_ancillary_session_impl* s;
+  int socket = mt_port_socket_id(impl, ops->port[MTL_SESSION_PORT_P]);
 
   /* find one empty slot in the mgr */
   for (int i = 0; i < ST_MAX_RX_ANC_SESSIONS; i++) {
     if (!rx_ancillary_session_get_empty(mgr, i)) continue;
 
-    s = mt_rte_zmalloc_socket(sizeof(*s), mt_socket_id(impl, MTL_PORT_P));
+    s = mt_rte_zmalloc_socket(sizeof(*s), socket);
     if (!s) {
       err("%s(%d), session malloc fail on %d\n", __func__, midx, i);
       rx_ancillary_session_put(mgr, i);
@@ -708,7 +750,8 @@ st40_rx_handle st40_rx_create(mtl_handle mt, struct st40_rx_ops* ops) {
     return NULL;
   }
 
-  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), mt_socket_id(impl, MTL_PORT_P));
+  int socket = mt_port_socket_id(impl, ops->port[MTL_SESSION_PORT_P]);
+  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), socket);
   if (!s_impl) {
     err("%s, s_impl malloc fail\n", __func__);
     return NULL;
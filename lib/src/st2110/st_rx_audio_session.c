@@ -9,6 +9,7 @@
 #include "../mt_log.h"
 #include "../mt_shared_rss.h"
 #include "../mt_stat.h"
+#include "redundant/st_rx_merge.h"
 
 static inline double ra_ebu_pass_rate(struct st_rx_audio_ebu_result* ebu_result,
                                       int pass) {
@@ -71,20 +72,18 @@ static char* ra_ebu_dpvr_result(struct st_rx_audio_session_impl* s) {
   struct st_rx_audio_ebu_info* ebu_info = &s->ebu_info;
   struct st_rx_audio_ebu_result* ebu_result = &s->ebu_result;
 
-  if (ebu->dpvr_max >= 0 && ebu->dpvr_max < ebu_info->dpvr_max_pass_narrow) {
-    ebu_result->dpvr_pass_narrow++;
-    return ST_EBU_PASS_NARROW;
-  }
-
-  if (ebu->dpvr_max >= 0 && ebu->dpvr_max < ebu_info->dpvr_max_pass_wide &&
-      ebu->dpvr_avg >= 0 && ebu->dpvr_avg < ebu_info->dpvr_avg_pass_wide) {
-    ebu_result->dpvr_pass_wide++;
-    return ST_EBU_PASS_WIDE;
+  switch (mtl_ebu_audio_dpvr_check(&ebu_info->model, ebu->dpvr_max, ebu->dpvr_avg)) {
+    case MTL_EBU_PASS_NARROW:
+      ebu_result->dpvr_pass_narrow++;
+      return ST_EBU_PASS_NARROW;
+    case MTL_EBU_PASS_WIDE:
+      ebu_result->dpvr_pass_wide++;
+      return ST_EBU_PASS_WIDE;
+    default:
+      ebu_result->dpvr_fail++;
+      ebu->compliant = false;
+      return ST_EBU_FAIL;
   }
-
-  ebu_result->dpvr_fail++;
-  ebu->compliant = false;
-  return ST_EBU_FAIL;
 }
 
 static char* ra_ebu_tsdf_result(struct st_rx_audio_session_impl* s) {
@@ -92,7 +91,7 @@ static char* ra_ebu_tsdf_result(struct st_rx_audio_session_impl* s) {
   struct st_rx_audio_ebu_info* ebu_info = &s->ebu_info;
   struct st_rx_audio_ebu_result* ebu_result = &s->ebu_result;
 
-  if (ebu->tsdf_max < ebu_info->tsdf_max_pass) {
+  if (mtl_ebu_audio_tsdf_check(&ebu_info->model, ebu->tsdf_max) == MTL_EBU_PASS) {
     ebu_result->tsdf_pass++;
     return ST_EBU_PASS;
   }
@@ -133,17 +132,7 @@ static void ra_ebu_on_packet(struct st_rx_audio_session_impl* s, uint32_t rtp_tm
   struct st_rx_audio_ebu_stat* ebu = &s->ebu;
   struct st_rx_audio_ebu_info* ebu_info = &s->ebu_info;
   struct st_rx_audio_ebu_result* ebu_result = &s->ebu_result;
-
-  uint64_t epochs = (double)pkt_tmstamp / ebu_info->frame_time;
-  uint64_t epoch_tmstamp = (double)epochs * ebu_info->frame_time;
-  double fpt_delta = (double)pkt_tmstamp - epoch_tmstamp;
-  uint64_t tmstamp64 = epochs * ebu_info->frame_time_sampling;
-  uint32_t tmstamp32 = tmstamp64;
-  double diff_rtp_ts = (double)rtp_tmstamp - tmstamp32;
-  double diff_rtp_ts_ns =
-      diff_rtp_ts * ebu_info->frame_time / ebu_info->frame_time_sampling;
-  double latency = fpt_delta - diff_rtp_ts_ns;
-  double dpvr = latency / 1000;
+  double dpvr = mtl_ebu_audio_dpvr(&ebu_info->model, rtp_tmstamp, pkt_tmstamp);
 
   ebu->pkt_num++;
 
@@ -166,27 +155,23 @@ static void ra_ebu_on_packet(struct st_rx_audio_session_impl* s, uint32_t rtp_tm
 static int ra_ebu_init(struct mtl_main_impl* impl, struct st_rx_audio_session_impl* s) {
   int idx = s->idx;
   struct st_rx_audio_ebu_info* ebu_info = &s->ebu_info;
+  struct mtl_ebu_audio_info* model = &ebu_info->model;
   struct st30_rx_ops* ops = &s->ops;
 
   ra_ebu_clear_result(&s->ebu);
 
   int sampling = (ops->sampling == ST30_SAMPLING_48K) ? 48 : 96;
-  ebu_info->frame_time = (double)1000000000.0 * 1 / 1000; /* 1ms, in ns */
-  ebu_info->frame_time_sampling = (double)(sampling * 1000) * 1 / 1000;
-
-  ebu_info->dpvr_max_pass_narrow = 3 * ebu_info->frame_time / 1000; /* in us */
-  ebu_info->dpvr_max_pass_wide = 20 * ebu_info->frame_time / 1000;  /* in us */
-  ebu_info->dpvr_avg_pass_wide = 2.5 * ebu_info->frame_time / 1000; /* in us */
-  ebu_info->tsdf_max_pass = 17 * ebu_info->frame_time / 1000;       /* in us */
+  /* 1ms, in ns */
+  mtl_ebu_audio_info_init(model, (double)NS_PER_S / 1000, sampling * 1000);
 
   ebu_info->dropped_results = 10; /* we drop first 10 results */
 
   info("%s[%02d], Delta Packet vs RTP Pass Criteria(narrow) min %d (us) max %d (us)\n",
-       __func__, idx, 0, ebu_info->dpvr_max_pass_narrow);
+       __func__, idx, 0, model->dpvr_max_pass_narrow);
   info("%s[%02d], Delta Packet vs RTP Pass Criteria(wide) max %d (us) avg %.2f (us)\n",
-       __func__, idx, ebu_info->dpvr_max_pass_wide, ebu_info->dpvr_avg_pass_wide);
+       __func__, idx, model->dpvr_max_pass_wide, model->dpvr_avg_pass_wide);
   info("%s[%02d], Maximum Timestamped Delay Factor Pass Criteria %d (us)\n", __func__,
-       idx, ebu_info->tsdf_max_pass);
+       idx, model->tsdf_max_pass);
 
   return 0;
 }
@@ -386,31 +371,14 @@ static int rx_audio_session_handle_frame_pkt(struct mtl_main_impl* impl,
       rte_pktmbuf_mtod_offset(mbuf, struct st_rfc3550_rtp_hdr*, hdr_offset);
   void* payload = &rtp[1];
 
-  uint16_t seq_id = ntohs(rtp->seq_number);
   uint32_t tmstamp = ntohl(rtp->tmstamp);
-  uint8_t payload_type = rtp->payload_type;
-
-  if (payload_type != ops->payload_type) {
-    s->st30_stat_pkts_wrong_hdr_dropped++;
-    return -EINVAL;
-  }
-
-  /* set first seq_id - 1 */
-  if (unlikely(s->st30_seq_id == -1)) s->st30_seq_id = seq_id - 1;
-  /* drop old packet */
-  if (st_rx_seq_drop(seq_id, s->st30_seq_id, 5)) {
-    dbg("%s(%d,%d), drop as pkt seq %d is old\n", __func__, s->idx, s_port, seq_id);
-    s->st30_stat_pkts_dropped++;
-    return -EIO;
-  }
-  /* update seq id */
-  s->st30_seq_id = seq_id;
 
   // copy frame
   if (!s->st30_cur_frame) {
     s->st30_cur_frame = rx_audio_session_get_frame(s);
     if (!s->st30_cur_frame) {
-      dbg("%s(%d,%d), seq %d drop as frame run out\n", __func__, s->idx, s_port, seq_id);
+      dbg("%s(%d,%d), seq %d drop as frame run out\n", __func__, s->idx, s_port,
+          ntohs(rtp->seq_number));
       s->st30_stat_pkts_dropped++;
       return -EIO;
     }
@@ -469,30 +437,13 @@ static int rx_audio_session_handle_rtp_pkt(struct mtl_main_impl* impl,
   struct st_rfc3550_rtp_hdr* rtp =
       rte_pktmbuf_mtod_offset(mbuf, struct st_rfc3550_rtp_hdr*, hdr_offset);
 
-  uint16_t seq_id = ntohs(rtp->seq_number);
   uint32_t tmstamp = ntohl(rtp->tmstamp);
-  uint8_t payload_type = rtp->payload_type;
-
-  if (payload_type != ops->payload_type) {
-    s->st30_stat_pkts_wrong_hdr_dropped++;
-    return -EINVAL;
-  }
-
-  /* set first seq_id - 1 */
-  if (unlikely(s->st30_seq_id == -1)) s->st30_seq_id = seq_id - 1;
-  /* drop old packet */
-  if (st_rx_seq_drop(seq_id, s->st30_seq_id, 5)) {
-    dbg("%s(%d,%d), drop as pkt seq %d is old\n", __func__, s->idx, s_port, seq_id);
-    s->st30_stat_pkts_dropped++;
-    return -EIO;
-  }
-  /* update seq id */
-  s->st30_seq_id = seq_id;
 
   /* enqueue the packet ring to app */
   int ret = rte_ring_sp_enqueue(s->st30_rtps_ring, (void*)mbuf);
   if (ret < 0) {
-    dbg("%s(%d,%d), drop as rtps ring full, seq id %d\n", __func__, seq_id, s_port);
+    dbg("%s(%d,%d), drop as rtps ring full, seq id %d\n", __func__, s->idx, s_port,
+        ntohs(rtp->seq_number));
     s->st30_stat_pkts_rtp_ring_full++;
     return -EIO;
   }
@@ -508,26 +459,63 @@ static int rx_audio_session_handle_rtp_pkt(struct mtl_main_impl* impl,
   return 0;
 }
 
+/* the in order pkt, from the seq check or the st2022-7 merge */
+static int rx_audio_session_consume_pkt(void* priv, struct rte_mbuf* mbuf,
+                                        enum mtl_session_port s_port) {
+  struct st_rx_audio_session_impl* s = priv;
+  struct mtl_main_impl* impl = s->priv[s_port].impl;
+
+  if (ST30_TYPE_FRAME_LEVEL == s->ops.type)
+    return rx_audio_session_handle_frame_pkt(impl, s, mbuf, s_port);
+  else
+    return rx_audio_session_handle_rtp_pkt(impl, s, mbuf, s_port);
+}
+
+static int rx_audio_session_handle_pkt(struct mtl_main_impl* impl,
+                                       struct st_rx_audio_session_impl* s,
+                                       struct rte_mbuf* mbuf,
+                                       enum mtl_session_port s_port) {
+  size_t hdr_offset =
+      sizeof(struct st_rfc3550_audio_hdr) - sizeof(struct st_rfc3550_rtp_hdr);
+  struct st_rfc3550_rtp_hdr* rtp =
+      rte_pktmbuf_mtod_offset(mbuf, struct st_rfc3550_rtp_hdr*, hdr_offset);
+  uint16_t seq_id = ntohs(rtp->seq_number);
+  uint8_t payload_type = rtp->payload_type;
+
+  if (payload_type != s->ops.payload_type) {
+    s->st30_stat_pkts_wrong_hdr_dropped++;
+    return -EINVAL;
+  }
+
+  /* st2022-7, the merge deliver the pkts in seq order */
+  if (s->merge) return st_rx_merge_push(s->merge, mbuf, seq_id, s_port, mt_get_tsc(impl));
+
+  /* set first seq_id - 1 */
+  if (unlikely(s->st30_seq_id == -1)) s->st30_seq_id = seq_id - 1;
+  /* drop old packet */
+  if (st_rx_seq_drop(seq_id, s->st30_seq_id, 5)) {
+    dbg("%s(%d,%d), drop as pkt seq %d is old\n", __func__, s->idx, s_port, seq_id);
+    s->st30_stat_pkts_dropped++;
+    return -EIO;
+  }
+  /* update seq id */
+  s->st30_seq_id = seq_id;
+
+  return rx_audio_session_consume_pkt(s, mbuf, s_port);
+}
+
 static int rx_audio_session_handle_mbuf(void* priv, struct rte_mbuf** mbuf, uint16_t nb) {
   struct st_rx_session_priv* s_priv = priv;
   struct st_rx_audio_session_impl* s = s_priv->session;
   struct mtl_main_impl* impl = s_priv->impl;
   enum mtl_session_port s_port = s_priv->s_port;
-  enum st30_type st30_type = s->ops.type;
 
   if (!s->st30_handle) {
     dbg("%s(%d,%d), session not ready\n", __func__, s->idx, s_port);
     return -EIO;
   }
 
-  if (ST30_TYPE_FRAME_LEVEL == st30_type) {
-    for (uint16_t i = 0; i < nb; i++)
-      rx_audio_session_handle_frame_pkt(impl, s, mbuf[i], s_port);
-  } else {
-    for (uint16_t i = 0; i < nb; i++) {
-      rx_audio_session_handle_rtp_pkt(impl, s, mbuf[i], s_port);
-    }
-  }
+  for (uint16_t i = 0; i < nb; i++) rx_audio_session_handle_pkt(impl, s, mbuf[i], s_port);
 
   return 0;
 }
@@ -555,6 +543,8 @@ static int rx_audio_session_tasklet(struct mtl_main_impl* impl,
 
     if (rv) done = false;
   }
+  /* skip the pkts lost on all paths */
+  if (s->merge && s->merge->held) st_rx_merge_timeout(s->merge, mt_get_tsc(impl));
 
   return done ? MT_TASKLET_ALL_DONE : MT_TASKLET_HAS_PENDING;
 }
@@ -642,6 +632,7 @@ static int rx_audio_session_uinit_mcast(struct mtl_main_impl* impl,
   for (int i = 0; i < ops->num_port; i++) {
     if (mt_is_multicast_ip(ops->sip_addr[i]))
       mt_mcast_leave(impl, mt_ip_to_u32(ops->sip_addr[i]),
+                     mt_ip_to_u32(ops->mcast_sip_addr[i]),
                      mt_port_logic2phy(s->port_maps, i));
   }
 
@@ -662,7 +653,7 @@ static int rx_audio_session_init_mcast(struct mtl_main_impl* impl,
       return 0;
     }
     ret = mt_mcast_join(impl, mt_ip_to_u32(ops->sip_addr[i]),
-                        mt_port_logic2phy(s->port_maps, i));
+                        mt_ip_to_u32(ops->mcast_sip_addr[i]), port);
     if (ret < 0) return ret;
   }
 
@@ -671,6 +662,10 @@ static int rx_audio_session_init_mcast(struct mtl_main_impl* impl,
 
 static int rx_audio_session_uinit_sw(struct mtl_main_impl* impl,
                                      struct st_rx_audio_session_impl* s) {
+  if (s->merge) {
+    st_rx_merge_free(s->merge);
+    s->merge = NULL;
+  }
   rx_audio_session_free_frames(s);
   rx_audio_session_free_rtps(s);
   return 0;
@@ -696,6 +691,18 @@ static int rx_audio_session_init_sw(struct mtl_main_impl* impl,
   }
   if (ret < 0) return ret;
 
+  if (s->ops.num_port > 1) {
+    enum mtl_port port = mt_port_logic2phy(s->port_maps, MTL_SESSION_PORT_P);
+    s->merge = st_rx_merge_create(idx, s->ops.merge_window_us, mt_socket_id(impl, port),
+                                  rx_audio_session_consume_pkt, s);
+    if (!s->merge) {
+      err("%s(%d), merge create fail\n", __func__, idx);
+      rx_audio_session_free_frames(s);
+      rx_audio_session_free_rtps(s);
+      return -ENOMEM;
+    }
+  }
+
   return 0;
 }
 
@@ -817,6 +824,7 @@ static void rx_audio_session_stat(struct st_rx_audio_session_impl* s) {
            s->st30_stat_pkts_wrong_hdr_dropped);
     s->st30_stat_pkts_wrong_hdr_dropped = 0;
   }
+  if (s->merge) st_rx_merge_stat(s->merge, "RX_AUDIO_SESSION", s->ops.num_port);
 }
 
 static int rx_audio_session_detach(struct mtl_main_impl* impl,
@@ -848,6 +856,7 @@ static int rx_audio_session_update_src(struct mtl_main_impl* impl,
   /* update ip and port */
   for (int i = 0; i < num_port; i++) {
     memcpy(ops->sip_addr[i], src->sip_addr[i], MTL_IP_ADDR_LEN);
+    memcpy(ops->mcast_sip_addr[i], src->mcast_sip_addr[i], MTL_IP_ADDR_LEN);
     ops->udp_port[i] = src->udp_port[i];
     s->st30_dst_port[i] = (ops->udp_port[i]) ? (ops->udp_port[i]) : (20000 + idx);
     s->st30_src_port[i] =
@@ -855,6 +864,7 @@ static int rx_audio_session_update_src(struct mtl_main_impl* impl,
   }
   /* reset seq id */
   s->st30_seq_id = -1;
+  if (s->merge) st_rx_merge_reset(s->merge);
 
   ret = rx_audio_session_init_hw(impl, s);
   if (ret < 0) {
@@ -925,6 +935,7 @@ static int rx_audio_sessions_mgr_init(struct mtl_main_impl* impl, struct mt_sch_
     ops.start = rx_audio_sessions_tasklet_start;
     ops.stop = rx_audio_sessions_tasklet_stop;
     ops.handler = rx_audio_sessions_tasklet_handler;
+    ops.migratable = true;
 
     mgr->tasklet = mt_sch_register_tasklet(sch, &ops);
     if (!mgr->tasklet) {
@@ -951,12 +962,13 @@ static struct st_rx_audio_session_impl* rx_audio_sessions_mgr_attach(
   struct mtl_main_impl* impl = mgr->parent;
   int ret;
   struct st_rx_audio_session_impl* s;
+  int socket = mt_port_socket_id(impl, ops->port[MTL_SESSION_PORT_P]);
 
   /* find one empty slot in the mgr */
   for (int i = 0; i < ST_MAX_RX_AUDIO_SESSIONS; i++) {
     if (!rx_audio_session_get_empty(mgr, i)) continue;
 
-    s = mt_rte_zmalloc_socket(sizeof(*s), mt_socket_id(impl, MTL_PORT_P));
+    s = mt_rte_zmalloc_socket(sizeof(*s), socket);
     if (!s) {
       err("%s(%d), session malloc fail on %d\n", __func__, midx, i);
       rx_audio_session_put(mgr, i);
@@ -1141,7 +1153,8 @@ st30_rx_handle st30_rx_create(mtl_handle mt, struct st30_rx_ops* ops) {
     return NULL;
   }
 
-  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), mt_socket_id(impl, MTL_PORT_P));
+  int socket = mt_port_socket_id(impl, ops->port[MTL_SESSION_PORT_P]);
+  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), socket);
   if (!s_impl) {
     err("%s, s_impl malloc fail\n", __func__);
     return NULL;
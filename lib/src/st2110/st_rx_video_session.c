@@ -6,10 +6,20 @@
 
 #include <math.h>
 
+#include "../mt_arena.h"
 #include "../mt_log.h"
 #include "../mt_shared_rss.h"
 #include "../mt_stat.h"
 #include "st_fmt.h"
+#include "st_quota.h"
+
+static const struct mt_metric_desc rv_metric_descs[ST_RX_VIDEO_METRIC_MAX] = {
+    [ST_RX_VIDEO_METRIC_FRAMES_RECEIVED] = {"frames_received", MTL_METRIC_COUNTER},
+    [ST_RX_VIDEO_METRIC_FRAMES_DROPPED] = {"frames_dropped", MTL_METRIC_COUNTER},
+    [ST_RX_VIDEO_METRIC_PKTS_RECEIVED] = {"pkts_received", MTL_METRIC_COUNTER},
+    [ST_RX_VIDEO_METRIC_PKTS_REDUNDANT] = {"pkts_redundant", MTL_METRIC_COUNTER},
+    [ST_RX_VIDEO_METRIC_PKTS_OUT_OF_ORDER] = {"pkts_out_of_order", MTL_METRIC_COUNTER},
+};
 
 static int rv_init_pkt_handler(struct st_rx_video_session_impl* s);
 static int rvs_mgr_update(struct st_rx_video_sessions_mgr* mgr);
@@ -98,50 +108,46 @@ static inline float rv_ebu_calculate_avg(uint32_t cnt, int64_t sum) {
 static char* rv_ebu_cinst_result(struct st_rx_video_ebu_stat* ebu,
                                  struct st_rx_video_ebu_info* ebu_info,
                                  struct st_rx_video_ebu_result* ebu_result) {
-  if (ebu->cinst_max <= ebu_info->c_max_narrow_pass) {
-    ebu_result->cinst_pass_narrow++;
-    return ST_EBU_PASS_NARROW;
-  }
-
-  if (ebu->cinst_max <= ebu_info->c_max_wide_pass) {
-    ebu_result->cinst_pass_wide++;
-    ebu->compliant_narrow = false;
-    return ST_EBU_PASS_WIDE;
+  switch (mtl_ebu_video_cinst_check(&ebu_info->model, ebu->cinst_max)) {
+    case MTL_EBU_PASS_NARROW:
+      ebu_result->cinst_pass_narrow++;
+      return ST_EBU_PASS_NARROW;
+    case MTL_EBU_PASS_WIDE:
+      ebu_result->cinst_pass_wide++;
+      ebu->compliant_narrow = false;
+      return ST_EBU_PASS_WIDE;
+    case MTL_EBU_PASS_WIDE_WA:
+      ebu_result->cinst_pass_wide++;
+      ebu->compliant_narrow = false;
+      return ST_EBU_PASS_WIDE_WA; /* WA, the RX time inaccurate */
+    default:
+      ebu_result->cinst_fail++;
+      ebu->compliant = false;
+      return ST_EBU_FAIL;
   }
-
-  if (ebu->cinst_max <= (ebu_info->c_max_wide_pass * 16)) {
-    ebu_result->cinst_pass_wide++;
-    ebu->compliant_narrow = false;
-    return ST_EBU_PASS_WIDE_WA; /* WA, the RX time inaccurate */
-  }
-
-  ebu_result->cinst_fail++;
-  ebu->compliant = false;
-  return ST_EBU_FAIL;
 }
 
 static char* rv_ebu_vrx_result(struct st_rx_video_ebu_stat* ebu,
                                struct st_rx_video_ebu_info* ebu_info,
                                struct st_rx_video_ebu_result* ebu_result) {
-  if ((ebu->vrx_min > 0) && (ebu->vrx_max <= ebu_info->vrx_full_narrow_pass)) {
-    ebu_result->vrx_pass_narrow++;
-    return ST_EBU_PASS_NARROW;
+  switch (mtl_ebu_video_vrx_check(&ebu_info->model, ebu->vrx_min, ebu->vrx_max)) {
+    case MTL_EBU_PASS_NARROW:
+      ebu_result->vrx_pass_narrow++;
+      return ST_EBU_PASS_NARROW;
+    case MTL_EBU_PASS_WIDE:
+      ebu_result->vrx_pass_wide++;
+      ebu->compliant_narrow = false;
+      return ST_EBU_PASS_WIDE;
+    default:
+      ebu_result->vrx_fail++;
+      ebu->compliant = false;
+      return ST_EBU_FAIL;
   }
-
-  if ((ebu->vrx_min > 0) && (ebu->vrx_max <= ebu_info->vrx_full_wide_pass)) {
-    ebu_result->vrx_pass_wide++;
-    ebu->compliant_narrow = false;
-    return ST_EBU_PASS_WIDE;
-  }
-
-  ebu_result->vrx_fail++;
-  ebu->compliant = false;
-  return ST_EBU_FAIL;
 }
 
 static char* rv_ebu_latency_result(struct st_rx_video_ebu_stat* ebu,
                                    struct st_rx_video_ebu_result* ebu_result) {
-  if ((ebu->latency_min < 0) || (ebu->latency_max > ST_EBU_LATENCY_MAX_NS)) {
+  if (mtl_ebu_video_latency_check(ebu->latency_min, ebu->latency_max) == MTL_EBU_FAIL) {
     ebu_result->latency_fail++;
     ebu->compliant = false;
     return ST_EBU_FAIL;
@@ -154,8 +160,8 @@ static char* rv_ebu_latency_result(struct st_rx_video_ebu_stat* ebu,
 static char* rv_ebu_rtp_offset_result(struct st_rx_video_ebu_stat* ebu,
                                       struct st_rx_video_ebu_info* ebu_info,
                                       struct st_rx_video_ebu_result* ebu_result) {
-  if ((ebu->rtp_offset_min < ST_EBU_RTP_OFFSET_MIN) ||
-      (ebu->rtp_offset_max > ebu_info->rtp_offset_max_pass)) {
+  if (mtl_ebu_video_rtp_offset_check(&ebu_info->model, ebu->rtp_offset_min,
+                                     ebu->rtp_offset_max) == MTL_EBU_FAIL) {
     ebu_result->rtp_offset_fail++;
     ebu->compliant = false;
     return ST_EBU_FAIL;
@@ -168,9 +174,8 @@ static char* rv_ebu_rtp_offset_result(struct st_rx_video_ebu_stat* ebu,
 static char* rv_ebu_rtp_ts_delta_result(struct st_rx_video_ebu_stat* ebu,
                                         struct st_rx_video_ebu_info* ebu_info,
                                         struct st_rx_video_ebu_result* ebu_result) {
-  int32_t rtd = ebu_info->frame_time_sampling;
-
-  if ((ebu->rtp_ts_delta_min < rtd) || (ebu->rtp_ts_delta_max > (rtd + 1))) {
+  if (mtl_ebu_video_rtp_ts_delta_check(&ebu_info->model, ebu->rtp_ts_delta_min,
+                                       ebu->rtp_ts_delta_max) == MTL_EBU_FAIL) {
     ebu_result->rtp_ts_delta_fail++;
     ebu->compliant = false;
     return ST_EBU_FAIL;
@@ -180,21 +185,21 @@ static char* rv_ebu_rtp_ts_delta_result(struct st_rx_video_ebu_stat* ebu,
   return ST_EBU_PASS;
 }
 
-static char* rv_ebu_fpt_result(struct st_rx_video_ebu_stat* ebu, uint32_t tr_offset,
+static char* rv_ebu_fpt_result(struct st_rx_video_ebu_stat* ebu,
+                               struct st_rx_video_ebu_info* ebu_info,
                                struct st_rx_video_ebu_result* ebu_result) {
-  if (ebu->fpt_max <= tr_offset) {
-    ebu_result->fpt_pass++;
-    return ST_EBU_PASS;
+  switch (mtl_ebu_video_fpt_check(&ebu_info->model, ebu->fpt_max)) {
+    case MTL_EBU_PASS:
+      ebu_result->fpt_pass++;
+      return ST_EBU_PASS;
+    case MTL_EBU_PASS_WIDE_WA: /* WA as no HW RX time */
+      ebu_result->fpt_pass++;
+      return ST_EBU_PASS_WIDE_WA;
+    default:
+      ebu_result->fpt_fail++;
+      ebu->compliant = false;
+      return ST_EBU_FAIL;
   }
-
-  if (ebu->fpt_max <= (tr_offset * 2)) { /* WA as no HW RX time */
-    ebu_result->fpt_pass++;
-    return ST_EBU_PASS_WIDE_WA;
-  }
-
-  ebu_result->fpt_fail++;
-  ebu->compliant = false;
-  return ST_EBU_FAIL;
 }
 
 static void rv_ebu_result(struct st_rx_video_session_impl* s) {
@@ -217,8 +222,8 @@ static void rv_ebu_result(struct st_rx_video_session_impl* s) {
   info("%s(%d), VRX AVG %.2f MIN %d MAX %d test %s!\n", __func__, idx, ebu->vrx_avg,
        ebu->vrx_min, ebu->vrx_max, rv_ebu_vrx_result(ebu, ebu_info, ebu_result));
   info("%s(%d), TRO %.2f TPRS %.2f FPT AVG %.2f MIN %d MAX %d test %s!\n", __func__, idx,
-       ebu_info->tr_offset, ebu_info->trs, ebu->fpt_avg, ebu->fpt_min, ebu->fpt_max,
-       rv_ebu_fpt_result(ebu, ebu_info->tr_offset, ebu_result));
+       ebu_info->model.tr_offset, ebu_info->model.trs, ebu->fpt_avg, ebu->fpt_min,
+       ebu->fpt_max, rv_ebu_fpt_result(ebu, ebu_info, ebu_result));
   info("%s(%d), LATENCY AVG %.2f MIN %d MAX %d test %s!\n", __func__, idx,
        ebu->latency_avg, ebu->latency_min, ebu->latency_max,
        rv_ebu_latency_result(ebu, ebu_result));
@@ -242,9 +247,7 @@ static void rv_ebu_on_frame(struct st_rx_video_session_impl* s, uint32_t rtp_tms
   struct st_rx_video_ebu_stat* ebu = &s->ebu;
   struct st_rx_video_ebu_info* ebu_info = &s->ebu_info;
   struct st_rx_video_ebu_result* ebu_result = &s->ebu_result;
-  uint64_t epochs = (double)pkt_tmstamp / ebu_info->frame_time;
-  uint64_t epoch_tmstamp = (double)epochs * ebu_info->frame_time;
-  double fpt_delta = (double)pkt_tmstamp - epoch_tmstamp;
+  struct mtl_ebu_video_frame* frame = &ebu->frame;
 
   ebu->frame_idx++;
   if (ebu->frame_idx % (60 * 5) == 0) { /* every 5(60fps)/10(30fps) seconds */
@@ -265,103 +268,74 @@ static void rv_ebu_on_frame(struct st_rx_video_session_impl* s, uint32_t rtp_tms
     rv_ebu_clear_result(ebu);
   }
 
-  ebu->cur_epochs = epochs;
-  ebu->vrx_drained_prev = 0;
-  ebu->vrx_prev = 0;
-  ebu->cinmtl_initial_time = pkt_tmstamp;
-  ebu->prev_rtp_ipt_ts = 0;
+  mtl_ebu_video_on_frame(&ebu_info->model, frame, rtp_tmstamp, pkt_tmstamp);
 
   /* calculate fpt */
-  ebu->fpt_sum += fpt_delta;
-  ebu->fpt_min = RTE_MIN(fpt_delta, ebu->fpt_min);
-  ebu->fpt_max = RTE_MAX(fpt_delta, ebu->fpt_max);
+  ebu->fpt_sum += frame->fpt;
+  ebu->fpt_min = RTE_MIN(frame->fpt, ebu->fpt_min);
+  ebu->fpt_max = RTE_MAX(frame->fpt, ebu->fpt_max);
   ebu->fpt_cnt++;
 
-  uint64_t tmstamp64 = epochs * ebu_info->frame_time_sampling;
-  uint32_t tmstamp32 = tmstamp64;
-  double diff_rtp_ts = (double)rtp_tmstamp - tmstamp32;
-  double diff_rtp_ts_ns =
-      diff_rtp_ts * ebu_info->frame_time / ebu_info->frame_time_sampling;
-  double latency = fpt_delta - diff_rtp_ts_ns;
-
   /* calculate latency */
-  ebu->latency_sum += latency;
-  ebu->latency_min = RTE_MIN(latency, ebu->latency_min);
-  ebu->latency_max = RTE_MAX(latency, ebu->latency_max);
+  ebu->latency_sum += frame->latency;
+  ebu->latency_min = RTE_MIN(frame->latency, ebu->latency_min);
+  ebu->latency_max = RTE_MAX(frame->latency, ebu->latency_max);
   ebu->latency_cnt++;
 
   /* calculate rtp offset */
-  ebu->rtp_offset_sum += diff_rtp_ts;
-  ebu->rtp_offset_min = RTE_MIN(diff_rtp_ts, ebu->rtp_offset_min);
-  ebu->rtp_offset_max = RTE_MAX(diff_rtp_ts, ebu->rtp_offset_max);
+  ebu->rtp_offset_sum += frame->rtp_offset;
+  ebu->rtp_offset_min = RTE_MIN(frame->rtp_offset, ebu->rtp_offset_min);
+  ebu->rtp_offset_max = RTE_MAX(frame->rtp_offset, ebu->rtp_offset_max);
   ebu->rtp_offset_cnt++;
 
   /* calculate rtp ts dleta */
-  if (ebu->prev_rtp_ts) {
-    int rtp_ts_delta = rtp_tmstamp - ebu->prev_rtp_ts;
-
-    ebu->rtp_ts_delta_sum += rtp_ts_delta;
-    ebu->rtp_ts_delta_min = RTE_MIN(rtp_ts_delta, ebu->rtp_ts_delta_min);
-    ebu->rtp_ts_delta_max = RTE_MAX(rtp_ts_delta, ebu->rtp_ts_delta_max);
+  if (frame->has_rtp_ts_delta) {
+    ebu->rtp_ts_delta_sum += frame->rtp_ts_delta;
+    ebu->rtp_ts_delta_min = RTE_MIN(frame->rtp_ts_delta, ebu->rtp_ts_delta_min);
+    ebu->rtp_ts_delta_max = RTE_MAX(frame->rtp_ts_delta, ebu->rtp_ts_delta_max);
     ebu->rtp_ts_delta_cnt++;
   }
-  ebu->prev_rtp_ts = rtp_tmstamp;
 }
 
 static void rv_ebu_on_packet(struct st_rx_video_session_impl* s, uint32_t rtp_tmstamp,
                              uint64_t pkt_tmstamp, int pkt_idx) {
   struct st_rx_video_ebu_stat* ebu = &s->ebu;
   struct st_rx_video_ebu_info* ebu_info = &s->ebu_info;
-  uint64_t epoch_tmstamp;
-  double tvd, packet_delta_ns, trs = ebu_info->trs;
+  struct mtl_ebu_video_frame* frame = &ebu->frame;
 
   if (!ebu_info->init) return;
 
   if (!pkt_idx) /* start of new frame */
     rv_ebu_on_frame(s, rtp_tmstamp, pkt_tmstamp);
 
-  epoch_tmstamp = (uint64_t)(ebu->cur_epochs * ebu_info->frame_time);
-  tvd = epoch_tmstamp + ebu_info->tr_offset;
-
-  /* Calculate vrx */
-  packet_delta_ns = (double)pkt_tmstamp - tvd;
-  int32_t drained = (packet_delta_ns + trs) / trs;
-  int32_t vrx_cur = ebu->vrx_prev + 1 - (drained - ebu->vrx_drained_prev);
+  mtl_ebu_video_on_packet(&ebu_info->model, frame, pkt_tmstamp, pkt_idx);
 
-  ebu->vrx_sum += vrx_cur;
-  ebu->vrx_min = RTE_MIN(vrx_cur, ebu->vrx_min);
-  ebu->vrx_max = RTE_MAX(vrx_cur, ebu->vrx_max);
+  /* vrx */
+  ebu->vrx_sum += frame->vrx;
+  ebu->vrx_min = RTE_MIN(frame->vrx, ebu->vrx_min);
+  ebu->vrx_max = RTE_MAX(frame->vrx, ebu->vrx_max);
   ebu->vrx_cnt++;
-  ebu->vrx_prev = vrx_cur;
-  ebu->vrx_drained_prev = drained;
 
-  /* Calculate C-inst */
-  int exp_cin_pkts =
-      ((pkt_tmstamp - ebu->cinmtl_initial_time) / trs) * ST_EBU_CINST_DRAIN_FACTOR;
-  int cinst = RTE_MAX(0, pkt_idx - exp_cin_pkts);
-
-  ebu->cinst_sum += cinst;
-  ebu->cinst_min = RTE_MIN(cinst, ebu->cinst_min);
-  ebu->cinst_max = RTE_MAX(cinst, ebu->cinst_max);
+  /* C-inst */
+  ebu->cinst_sum += frame->cinst;
+  ebu->cinst_min = RTE_MIN(frame->cinst, ebu->cinst_min);
+  ebu->cinst_max = RTE_MAX(frame->cinst, ebu->cinst_max);
   ebu->cinst_cnt++;
 
-  /* calculate Inter-packet time */
-  if (ebu->prev_rtp_ipt_ts) {
-    double ipt = (double)pkt_tmstamp - ebu->prev_rtp_ipt_ts;
-
-    ebu->rtp_ipt_sum += ipt;
-    ebu->rtp_ipt_min = RTE_MIN(ipt, ebu->rtp_ipt_min);
-    ebu->rtp_ipt_max = RTE_MAX(ipt, ebu->rtp_ipt_max);
+  /* Inter-packet time */
+  if (frame->has_ipt) {
+    ebu->rtp_ipt_sum += frame->ipt;
+    ebu->rtp_ipt_min = RTE_MIN(frame->ipt, ebu->rtp_ipt_min);
+    ebu->rtp_ipt_max = RTE_MAX(frame->ipt, ebu->rtp_ipt_max);
     ebu->rtp_ipt_cnt++;
   }
-  ebu->prev_rtp_ipt_ts = pkt_tmstamp;
 }
 
 static int rv_ebu_init(struct mtl_main_impl* impl, struct st_rx_video_session_impl* s) {
   int idx = s->idx, ret;
   struct st_rx_video_ebu_info* ebu_info = &s->ebu_info;
+  struct mtl_ebu_video_info* model = &ebu_info->model;
   struct st20_rx_ops* ops = &s->ops;
-  double frame_time, frame_time_s;
   struct st_fps_timing fps_tm;
 
   rv_ebu_clear_result(&s->ebu);
@@ -372,9 +346,6 @@ static int rv_ebu_init(struct mtl_main_impl* impl, struct st_rx_video_session_im
     return ret;
   }
 
-  frame_time_s = (double)fps_tm.den / fps_tm.mul;
-  frame_time = (double)1000000000.0 * fps_tm.den / fps_tm.mul;
-
   int st20_total_pkts = s->detector.pkt_per_frame;
   info("%s(%d), st20_total_pkts %d\n", __func__, idx, st20_total_pkts);
   if (!st20_total_pkts) {
@@ -382,49 +353,24 @@ static int rv_ebu_init(struct mtl_main_impl* impl, struct st_rx_video_session_im
     return -EINVAL;
   }
 
-  double reactive = 1080.0 / 1125.0;
-  if (ops->interlaced && ops->height <= 576) {
-    reactive = (ops->height == 480) ? 487.0 / 525.0 : 576.0 / 625.0;
-  }
-
-  ebu_info->frame_time = frame_time;
-  ebu_info->frame_time_sampling =
-      (double)(fps_tm.sampling_clock_rate) * fps_tm.den / fps_tm.mul;
-  ebu_info->trs = frame_time * reactive / st20_total_pkts;
-  if (!ops->interlaced) {
-    ebu_info->tr_offset =
-        ops->height >= 1080 ? frame_time * (43.0 / 1125.0) : frame_time * (28.0 / 750.0);
-  } else {
-    if (ops->height == 480) {
-      ebu_info->tr_offset = frame_time * (20.0 / 525.0) * 2;
-    } else if (ops->height == 576) {
-      ebu_info->tr_offset = frame_time * (26.0 / 625.0) * 2;
-    } else {
-      ebu_info->tr_offset = frame_time * (22.0 / 1125.0) * 2;
-    }
+  ret = mtl_ebu_video_info_init(model, (double)NS_PER_S * fps_tm.den / fps_tm.mul,
+                                fps_tm.sampling_clock_rate, ops->height,
+                                ops->interlaced, st20_total_pkts, false);
+  if (ret < 0) {
+    err("%s(%d), ebu info init fail\n", __func__, idx);
+    return -EINVAL;
   }
 
-  ebu_info->c_max_narrow_pass =
-      RTE_MAX(4, (double)st20_total_pkts / (43200 * reactive * frame_time_s));
-  ebu_info->c_max_wide_pass =
-      RTE_MAX(16, (double)st20_total_pkts / (21600 * frame_time_s));
-
-  ebu_info->vrx_full_narrow_pass = RTE_MAX(8, st20_total_pkts / (27000 * frame_time_s));
-  ebu_info->vrx_full_wide_pass = RTE_MAX(720, st20_total_pkts / (300 * frame_time_s));
-
-  ebu_info->rtp_offset_max_pass =
-      ceil((ebu_info->tr_offset / NS_PER_S) * fps_tm.sampling_clock_rate) + 1;
-
   ebu_info->dropped_results = 4; /* we drop the first 4 results */
 
-  info("%s[%02d], trs %f tr offset %f sampling %f\n", __func__, idx, ebu_info->trs,
-       ebu_info->tr_offset, ebu_info->frame_time_sampling);
+  info("%s[%02d], trs %f tr offset %f sampling %f\n", __func__, idx, model->trs,
+       model->tr_offset, model->frame_time_sampling);
   info(
       "%s[%02d], cmax_narrow %d cmax_wide %d vrx_full_narrow %d vrx_full_wide %d "
       "rtp_offset_max %d\n",
-      __func__, idx, ebu_info->c_max_narrow_pass, ebu_info->c_max_wide_pass,
-      ebu_info->vrx_full_narrow_pass, ebu_info->vrx_full_wide_pass,
-      ebu_info->rtp_offset_max_pass);
+      __func__, idx, model->c_max_narrow_pass, model->c_max_wide_pass,
+      model->vrx_full_narrow_pass, model->vrx_full_wide_pass,
+      model->rtp_offset_max_pass);
   ebu_info->init = true;
   return 0;
 }
@@ -781,6 +727,7 @@ static int rv_alloc_frames(struct mtl_main_impl* impl,
   size_t size = s->st20_uframe_size ? s->st20_uframe_size : s->st20_fb_size;
   struct st_frame_trans* st20_frame;
   void* frame;
+  int ret;
 
   s->st20_frames =
       mt_rte_zmalloc_socket(sizeof(*s->st20_frames) * s->st20_frames_cnt, soc_id);
@@ -788,6 +735,7 @@ static int rv_alloc_frames(struct mtl_main_impl* impl,
     err("%s(%d), st20_frames alloc fail\n", __func__, idx);
     return -ENOMEM;
   }
+  mt_arena_quota_init(&s->arena_quota, s->st20_frames_cnt, size);
 
   for (int i = 0; i < s->st20_frames_cnt; i++) {
     st20_frame = &s->st20_frames[i];
@@ -796,7 +744,7 @@ static int rv_alloc_frames(struct mtl_main_impl* impl,
   }
 
   if (rv_is_hdr_split(s)) {
-    int ret = rv_init_hdr_split_frame(impl, s);
+    ret = rv_init_hdr_split_frame(impl, s);
     if (ret < 0) {
       rv_free_frames(s);
       return ret;
@@ -833,15 +781,12 @@ static int rv_alloc_frames(struct mtl_main_impl* impl,
       st20_frame->addr = NULL;
       st20_frame->flags = 0;
     } else {
-      frame = mt_rte_zmalloc_socket(size, soc_id);
-      if (!frame) {
+      ret = st_frame_trans_alloc(impl, st20_frame, size, soc_id, &s->arena_quota);
+      if (ret < 0) {
         err("%s(%d), frame malloc %" PRIu64 " fail for %d\n", __func__, idx, size, i);
         rv_free_frames(s);
-        return -ENOMEM;
+        return ret;
       }
-      st20_frame->flags = ST_FT_FLAG_RTE_MALLOC;
-      st20_frame->addr = frame;
-      st20_frame->iova = rte_malloc_virt2iova(frame);
       if (impl->iova_mode == RTE_IOVA_PA && s->dma_dev)
         rv_frame_create_page_table(s, st20_frame);
     }
@@ -1071,6 +1016,7 @@ static void rv_frame_notify(struct st_rx_video_session_impl* s,
         meta->status = ST_FRAME_STATUS_RECONSTRUCTED;
     }
     rte_atomic32_inc(&s->stat_frames_received);
+    mt_metric_add(s->metrics, ST_RX_VIDEO_METRIC_FRAMES_RECEIVED, 1);
 
     /* notify frame */
     int ret = -EIO;
@@ -1087,6 +1033,7 @@ static void rv_frame_notify(struct st_rx_video_session_impl* s,
         __func__, s->idx, meta->frame_recv_size, meta->frame_total_size, slot->tmstamp);
     meta->status = ST_FRAME_STATUS_CORRUPTED;
     s->stat_frames_dropped++;
+    mt_metric_add(s->metrics, ST_RX_VIDEO_METRIC_FRAMES_DROPPED, 1);
     rte_atomic32_inc(&s->cbs_incomplete_frame_cnt);
     /* notify the incomplete frame if user required */
     if (ops->flags & ST20_RX_FLAG_RECEIVE_INCOMPLETE_FRAME) {
@@ -1115,6 +1062,7 @@ static void rv_st22_frame_notify(struct st_rx_video_session_impl* s,
 
   if (st_is_frame_complete(status)) {
     rte_atomic32_inc(&s->stat_frames_received);
+    mt_metric_add(s->metrics, ST_RX_VIDEO_METRIC_FRAMES_RECEIVED, 1);
     if (st22_info->notify_frame_ready)
       ret = st22_info->notify_frame_ready(ops->priv, slot->frame->addr, meta);
     if (ret < 0) {
@@ -1124,6 +1072,7 @@ static void rv_st22_frame_notify(struct st_rx_video_session_impl* s,
     }
   } else {
     s->stat_frames_dropped++;
+    mt_metric_add(s->metrics, ST_RX_VIDEO_METRIC_FRAMES_DROPPED, 1);
     rte_atomic32_inc(&s->cbs_incomplete_frame_cnt);
     /* notify the incomplete frame if user required */
     if (ops->flags & ST20_RX_FLAG_RECEIVE_INCOMPLETE_FRAME) {
@@ -1250,6 +1199,7 @@ static struct st_rx_video_slot_impl* rv_slot_by_tmstamp(
   slot->seq_id_got = false;
   slot->pkts_received = 0;
   slot->pkts_redundant_received = 0;
+  slot->complete_tsc = 0;
   s->slot_idx = slot_idx;
 
   struct st_frame_trans* frame_info = rv_get_frame(s);
@@ -1330,18 +1280,27 @@ static struct st_rx_video_slot_impl* rv_rtp_slot_by_tmstamp(
 
 static void rv_slot_full_frame(struct st_rx_video_session_impl* s,
                                struct st_rx_video_slot_impl* slot) {
+  struct mtl_main_impl* impl = rv_get_impl(s);
+  uint64_t complete_tsc = slot->complete_tsc ? slot->complete_tsc : mt_get_tsc(impl);
+
   /* end of frame */
   rv_frame_notify(s, slot);
+  mt_hist_add(&s->stat_notify_hist, mt_get_tsc(impl) - complete_tsc);
   rv_slot_init_frame_size(s, slot);
   slot->pkts_received = 0;
   slot->pkts_redundant_received = 0;
+  slot->complete_tsc = 0;
   slot->frame = NULL; /* frame pass to app */
 }
 
 static void rv_st22_slot_full_frame(struct st_rx_video_session_impl* s,
                                     struct st_rx_video_slot_impl* slot) {
+  struct mtl_main_impl* impl = rv_get_impl(s);
+  uint64_t complete_tsc = mt_get_tsc(impl);
+
   /* end of frame */
   rv_st22_frame_notify(s, slot, ST_FRAME_STATUS_COMPLETE);
+  mt_hist_add(&s->stat_notify_hist, mt_get_tsc(impl) - complete_tsc);
   rv_slot_init_frame_size(s, slot);
   slot->pkts_received = 0;
   slot->pkts_redundant_received = 0;
@@ -1353,6 +1312,7 @@ static void rv_st22_slot_drop_frame(struct st_rx_video_session_impl* s,
   rv_put_frame(s, slot->frame);
   slot->frame = NULL;
   s->stat_frames_dropped++;
+  mt_metric_add(s->metrics, ST_RX_VIDEO_METRIC_FRAMES_DROPPED, 1);
   rte_atomic32_inc(&s->cbs_incomplete_frame_cnt);
   rv_slot_init_frame_size(s, slot);
   slot->pkts_received = 0;
@@ -1658,6 +1618,7 @@ static int rv_handle_frame_pkt(struct st_rx_video_session_impl* s, struct rte_mb
       dbg("%s(%d,%d), drop as invalid pkt_idx %d base %u\n", __func__, s->idx, s_port,
           pkt_idx, slot->seq_id_base_u32);
       s->stat_pkts_idx_oo_bitmap++;
+      mt_metric_add(s->metrics, ST_RX_VIDEO_METRIC_PKTS_OUT_OF_ORDER, 1);
       return -EIO;
     }
     bool is_set = mt_bitmap_test_and_set(bitmap, pkt_idx);
@@ -1665,6 +1626,7 @@ static int rv_handle_frame_pkt(struct st_rx_video_session_impl* s, struct rte_mb
       dbg("%s(%d,%d), drop as pkt %d already received\n", __func__, s->idx, s_port,
           pkt_idx);
       s->stat_pkts_redundant_dropped++;
+      mt_metric_add(s->metrics, ST_RX_VIDEO_METRIC_PKTS_REDUNDANT, 1);
       slot->pkts_redundant_received++;
       return -EIO;
     }
@@ -1772,6 +1734,7 @@ static int rv_handle_frame_pkt(struct st_rx_video_session_impl* s, struct rte_mb
     rv_slot_add_frame_size(s, slot, payload_length);
   }
   s->stat_pkts_received++;
+  mt_metric_add(s->metrics, ST_RX_VIDEO_METRIC_PKTS_RECEIVED, 1);
   slot->pkts_received++;
 
   /* slice */
@@ -1783,7 +1746,12 @@ static int rv_handle_frame_pkt(struct st_rx_video_session_impl* s, struct rte_mb
   size_t frame_recv_size = rv_slot_get_frame_size(s, slot);
   bool end_frame = false;
   if (dma_dev) {
-    if (frame_recv_size >= s->st20_frame_size && mt_dma_empty(dma_dev)) end_frame = true;
+    if (frame_recv_size >= s->st20_frame_size) {
+      if (mt_dma_empty(dma_dev))
+        end_frame = true;
+      else if (!slot->complete_tsc) /* notify after the dma done */
+        slot->complete_tsc = mt_get_tsc(impl);
+    }
   } else {
     if (frame_recv_size >= s->st20_frame_size) end_frame = true;
   }
@@ -1845,12 +1813,14 @@ static int rv_handle_rtp_pkt(struct st_rx_video_session_impl* s, struct rte_mbuf
       dbg("%s(%d,%d), drop as invalid pkt_idx %d base %u\n", __func__, s->idx, s_port,
           pkt_idx, slot->seq_id_base);
       s->stat_pkts_idx_oo_bitmap++;
+      mt_metric_add(s->metrics, ST_RX_VIDEO_METRIC_PKTS_OUT_OF_ORDER, 1);
       return -EIO;
     }
     bool is_set = mt_bitmap_test_and_set(bitmap, pkt_idx);
     if (is_set) {
       dbg("%s(%d,%d), drop as pkt %d already received\n", __func__, idx, s_port, pkt_idx);
       s->stat_pkts_redundant_dropped++;
+      mt_metric_add(s->metrics, ST_RX_VIDEO_METRIC_PKTS_REDUNDANT, 1);
       return -EIO;
     }
   } else {
@@ -1859,6 +1829,7 @@ static int rv_handle_rtp_pkt(struct st_rx_video_session_impl* s, struct rte_mbuf
       slot->seq_id_base_u32 = seq_id_u32;
       slot->seq_id_got = true;
       rte_atomic32_inc(&s->stat_frames_received);
+      mt_metric_add(s->metrics, ST_RX_VIDEO_METRIC_FRAMES_RECEIVED, 1);
       mt_bitmap_test_and_set(bitmap, 0);
       pkt_idx = 0;
       dbg("%s(%d,%d), seq_id_base %d tmstamp %u\n", __func__, idx, s_port, seq_id,
@@ -1883,6 +1854,7 @@ static int rv_handle_rtp_pkt(struct st_rx_video_session_impl* s, struct rte_mbuf
 
   ops->notify_rtp_ready(ops->priv);
   s->stat_pkts_received++;
+  mt_metric_add(s->metrics, ST_RX_VIDEO_METRIC_PKTS_RECEIVED, 1);
 
   return 0;
 }
@@ -1986,6 +1958,7 @@ static int rv_handle_st22_pkt(struct st_rx_video_session_impl* s, struct rte_mbu
       dbg("%s(%d,%d), drop as invalid pkt_idx %d base %u\n", __func__, s->idx, s_port,
           pkt_idx, slot->seq_id_base);
       s->stat_pkts_idx_oo_bitmap++;
+      mt_metric_add(s->metrics, ST_RX_VIDEO_METRIC_PKTS_OUT_OF_ORDER, 1);
       return -EIO;
     }
     bool is_set = mt_bitmap_test_and_set(bitmap, pkt_idx);
@@ -1993,6 +1966,7 @@ static int rv_handle_st22_pkt(struct st_rx_video_session_impl* s, struct rte_mbu
       dbg("%s(%d,%d), drop as pkt %d already received\n", __func__, s->idx, s_port,
           pkt_idx);
       s->stat_pkts_redundant_dropped++;
+      mt_metric_add(s->metrics, ST_RX_VIDEO_METRIC_PKTS_REDUNDANT, 1);
       slot->pkts_redundant_received++;
       return -EIO;
     }
@@ -2050,6 +2024,7 @@ static int rv_handle_st22_pkt(struct st_rx_video_session_impl* s, struct rte_mbu
   rte_memcpy(slot->frame->addr + offset, payload, payload_length);
   rv_slot_add_frame_size(s, slot, payload_length);
   s->stat_pkts_received++;
+  mt_metric_add(s->metrics, ST_RX_VIDEO_METRIC_PKTS_RECEIVED, 1);
   slot->pkts_received++;
 
   /* check if frame is full */
@@ -2128,6 +2103,7 @@ static int rv_handle_hdr_split_pkt(struct st_rx_video_session_impl* s,
       dbg("%s(%d,%d), drop as invalid pkt_idx %d base %u\n", __func__, s->idx, s_port,
           pkt_idx, slot->seq_id_base_u32);
       s->stat_pkts_idx_oo_bitmap++;
+      mt_metric_add(s->metrics, ST_RX_VIDEO_METRIC_PKTS_OUT_OF_ORDER, 1);
       return -EIO;
     }
     bool is_set = mt_bitmap_test_and_set(bitmap, pkt_idx);
@@ -2135,6 +2111,7 @@ static int rv_handle_hdr_split_pkt(struct st_rx_video_session_impl* s,
       dbg("%s(%d,%d), drop as pkt %d already received\n", __func__, s->idx, s_port,
           pkt_idx);
       s->stat_pkts_redundant_dropped++;
+      mt_metric_add(s->metrics, ST_RX_VIDEO_METRIC_PKTS_REDUNDANT, 1);
       slot->pkts_redundant_received++;
       return -EIO;
     }
@@ -2211,6 +2188,7 @@ static int rv_handle_hdr_split_pkt(struct st_rx_video_session_impl* s,
 
   rv_slot_add_frame_size(s, slot, payload_length);
   s->stat_pkts_received++;
+  mt_metric_add(s->metrics, ST_RX_VIDEO_METRIC_PKTS_RECEIVED, 1);
   slot->pkts_received++;
 
   /* slice */
@@ -2296,7 +2274,7 @@ static int rv_init_pkt_lcore(struct mtl_main_impl* impl,
   }
   s->pkt_lcore_ring = ring;
 
-  ret = mt_dev_get_lcore(impl, &lcore);
+  ret = mt_dev_get_lcore(impl, mt_socket_id(impl, port), &lcore);
   if (ret < 0) {
     err("%s(%d,%d), get lcore fail %d\n", __func__, mgr_idx, idx, ret);
     rv_uinit_pkt_lcore(impl, s);
@@ -2613,6 +2591,7 @@ static int rv_handle_detect_pkt(struct st_rx_video_session_impl* s, struct rte_m
   }
 
   s->stat_pkts_received++;
+  mt_metric_add(s->metrics, ST_RX_VIDEO_METRIC_PKTS_RECEIVED, 1);
   return 0;
 }
 
@@ -2786,6 +2765,7 @@ static int rv_uinit_mcast(struct mtl_main_impl* impl,
   for (int i = 0; i < ops->num_port; i++) {
     if (mt_is_multicast_ip(ops->sip_addr[i]))
       mt_mcast_leave(impl, mt_ip_to_u32(ops->sip_addr[i]),
+                     mt_ip_to_u32(ops->mcast_sip_addr[i]),
                      mt_port_logic2phy(s->port_maps, i));
   }
 
@@ -2804,7 +2784,8 @@ static int rv_init_mcast(struct mtl_main_impl* impl, struct st_rx_video_session_
       info("%s(%d), skip mcast join for port %d\n", __func__, s->idx, i);
       return 0;
     }
-    ret = mt_mcast_join(impl, mt_ip_to_u32(ops->sip_addr[i]), port);
+    ret = mt_mcast_join(impl, mt_ip_to_u32(ops->sip_addr[i]),
+                        mt_ip_to_u32(ops->mcast_sip_addr[i]), port);
     if (ret < 0) return ret;
   }
 
@@ -2972,6 +2953,15 @@ static int rv_attach(struct mtl_main_impl* impl, struct st_rx_video_sessions_mgr
     return -EIO;
   }
 
+  char metric_name[MTL_METRIC_NAME_MAX];
+  snprintf(metric_name, sizeof(metric_name), "%s.%d.%d", st22_ops ? "st22_rx" : "st20_rx",
+           mgr->idx, idx);
+  s->metrics = mt_metric_register(impl, metric_name, rv_metric_descs,
+                                  ST_RX_VIDEO_METRIC_MAX,
+                                  mt_socket_id(impl, s->port_maps[MTL_SESSION_PORT_P]));
+  /* not fatal, the metric helpers skip a NULL group */
+  if (!s->metrics) warn("%s(%d), metric register fail\n", __func__, idx);
+
   info("%s(%d), %d frames with size %" PRIu64 "(%" PRIu64 ",%" PRIu64 "), type %d\n",
        __func__, idx, s->st20_frames_cnt, s->st20_frame_size, s->st20_frame_bitmap_size,
        s->st20_uframe_size, ops->type);
@@ -3075,6 +3065,7 @@ static void rv_stat(struct st_rx_video_sessions_mgr* mgr,
   double time_sec = (double)(cur_time_ns - s->stat_last_time) / NS_PER_S;
   int frames_received = rte_atomic32_read(&s->stat_frames_received);
   double framerate = frames_received / time_sec;
+  char hist[128];
 
   rte_atomic32_set(&s->stat_frames_received, 0);
 
@@ -3142,6 +3133,8 @@ static void rv_stat(struct st_rx_video_sessions_mgr* mgr,
            s->stat_pkts_slice_merged);
     s->stat_pkts_slice_merged = 0;
   }
+  if (mt_hist_summary(&s->stat_notify_hist, hist, sizeof(hist)))
+    notice("RX_VIDEO_SESSION(%d,%d): frame notify latency %s\n", m_idx, idx, hist);
   if (s->stat_pkts_multi_segments_received) {
     notice("RX_VIDEO_SESSION(%d,%d): multi segments pkts %d\n", m_idx, idx,
            s->stat_pkts_multi_segments_received);
@@ -3214,6 +3207,10 @@ static int rv_detach(struct mtl_main_impl* impl, struct st_rx_video_sessions_mgr
                      struct st_rx_video_session_impl* s) {
   if (mt_has_ebu(mgr->parent)) rv_ebu_final_result(s);
   rv_stat(mgr, s);
+  if (s->metrics) {
+    mt_metric_unregister(impl, s->metrics);
+    s->metrics = NULL;
+  }
   for (int i = 0; i < s->ops.num_port; i++) {
     if (s->srss[i]) {
       mt_srss_put(s->srss[i]);
@@ -3238,6 +3235,7 @@ static int rv_update_src(struct mtl_main_impl* impl, struct st_rx_video_session_
   /* update ip and port */
   for (int i = 0; i < num_port; i++) {
     memcpy(ops->sip_addr[i], src->sip_addr[i], MTL_IP_ADDR_LEN);
+    memcpy(ops->mcast_sip_addr[i], src->mcast_sip_addr[i], MTL_IP_ADDR_LEN);
     ops->udp_port[i] = src->udp_port[i];
     s->st20_dst_port[i] = (ops->udp_port[i]) ? (ops->udp_port[i]) : (10000 + idx);
     s->st20_src_port[i] =
@@ -3348,12 +3346,13 @@ static struct st_rx_video_session_impl* rv_mgr_attach(
   struct mtl_main_impl* impl = mgr->parent;
   int ret;
   struct st_rx_video_session_impl* s;
+  int socket = mt_port_socket_id(impl, ops->port[MTL_SESSION_PORT_P]);
 
   /* find one empty slot in the mgr */
   for (int i = 0; i < ST_SCH_MAX_RX_VIDEO_SESSIONS; i++) {
     if (!rx_video_session_get_empty(mgr, i)) continue;
 
-    s = mt_rte_zmalloc_socket(sizeof(*s), mt_socket_id(impl, MTL_PORT_P));
+    s = mt_rte_zmalloc_socket(sizeof(*s), socket);
     if (!s) {
       err("%s(%d), session malloc fail on %d\n", __func__, midx, i);
       rx_video_session_put(mgr, i);
@@ -3661,7 +3660,11 @@ st20_rx_handle st20_rx_create_with_mask(struct mtl_main_impl* impl,
   }
   quota_mbs = bps / (1000 * 1000);
   quota_mbs *= ops->num_port;
-  if (!mt_has_user_quota(impl)) {
+  if (!mt_has_user_quota(impl) && mt_sch_get_mgr(impl)->quota_calibrated) {
+    /* the rtp level has no payload copy in lib */
+    quota_mbs_wo_dma = st_quota_rx_scale(impl, quota_mbs, false);
+    quota_mbs = st_quota_rx_scale(impl, quota_mbs, true);
+  } else if (!mt_has_user_quota(impl)) {
     if (ST20_TYPE_RTP_LEVEL == ops->type) {
       quota_mbs = quota_mbs * ST_QUOTA_TX1080P_PER_SCH / ST_QUOTA_RX1080P_RTP_PER_SCH;
     } else {
@@ -3671,7 +3674,8 @@ st20_rx_handle st20_rx_create_with_mask(struct mtl_main_impl* impl,
     }
   }
 
-  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), mt_socket_id(impl, MTL_PORT_P));
+  int socket = mt_port_socket_id(impl, ops->port[MTL_SESSION_PORT_P]);
+  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), socket);
   if (!s_impl) {
     err("%s, s_impl malloc fail\n", __func__);
     return NULL;
@@ -3682,7 +3686,7 @@ st20_rx_handle st20_rx_create_with_mask(struct mtl_main_impl* impl,
   if (mt_has_srss(impl, MTL_PORT_P))
     sch = impl->srss[MTL_PORT_P]->sch;
   else
-    sch = mt_sch_get(impl, quota_mbs, type, sch_mask);
+    sch = mt_sch_get(impl, quota_mbs, type, sch_mask, socket);
   if (!sch) {
     mt_rte_free(s_impl);
     err("%s, get sch fail\n", __func__);
@@ -4007,7 +4011,8 @@ st22_rx_handle st22_rx_create(mtl_handle mt, struct st22_rx_ops* ops) {
     quota_mbs *= ops->num_port;
   }
 
-  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), mt_socket_id(impl, MTL_PORT_P));
+  int socket = mt_port_socket_id(impl, ops->port[MTL_SESSION_PORT_P]);
+  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), socket);
   if (!s_impl) {
     err("%s, s_impl malloc fail\n", __func__);
     return NULL;
@@ -4015,7 +4020,7 @@ st22_rx_handle st22_rx_create(mtl_handle mt, struct st22_rx_ops* ops) {
 
   enum mt_sch_type type =
       mt_has_rxv_separate_sch(impl) ? MT_SCH_TYPE_RX_VIDEO_ONLY : MT_SCH_TYPE_DEFAULT;
-  sch = mt_sch_get(impl, quota_mbs, type, MT_SCH_MASK_ALL);
+  sch = mt_sch_get(impl, quota_mbs, type, MT_SCH_MASK_ALL, socket);
   if (!sch) {
     mt_rte_free(s_impl);
     err("%s, get sch fail\n", __func__);
@@ -4039,6 +4044,7 @@ st22_rx_handle st22_rx_create(mtl_handle mt, struct st22_rx_ops* ops) {
   st20_ops.num_port = ops->num_port;
   for (int i = 0; i < ops->num_port; i++) {
     memcpy(st20_ops.sip_addr[i], ops->sip_addr[i], MTL_IP_ADDR_LEN);
+    memcpy(st20_ops.mcast_sip_addr[i], ops->mcast_sip_addr[i], MTL_IP_ADDR_LEN);
     strncpy(st20_ops.port[i], ops->port[i], MTL_PORT_MAX_LEN);
     st20_ops.udp_src_port[i] = ops->udp_src_port[i];
     st20_ops.udp_port[i] = ops->udp_port[i];
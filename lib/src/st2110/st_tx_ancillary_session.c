@@ -418,21 +418,11 @@ static int tx_ancillary_session_build_packet(struct st_tx_ancillary_session_impl
     pktBuff->first_hdr_chunk.horizontal_offset = src->meta[idx].hori_offset;
     pktBuff->first_hdr_chunk.s = src->meta[idx].s;
     pktBuff->first_hdr_chunk.stream_num = src->meta[idx].stream_num;
-    pktBuff->second_hdr_chunk.did = st40_add_parity_bits(src->meta[idx].did);
-    pktBuff->second_hdr_chunk.sdid = st40_add_parity_bits(src->meta[idx].sdid);
-    pktBuff->second_hdr_chunk.data_count = st40_add_parity_bits(udw_size);
-
     pktBuff->swaped_first_hdr_chunk = htonl(pktBuff->swaped_first_hdr_chunk);
-    pktBuff->swaped_second_hdr_chunk = htonl(pktBuff->swaped_second_hdr_chunk);
-    int i = 0;
-    int offset = src->meta[idx].udw_offset;
-    for (; i < udw_size; i++) {
-      st40_set_udw(i + 3, st40_add_parity_bits(src->data[offset++]),
-                   (uint8_t*)&pktBuff->second_hdr_chunk);
-    }
-    uint16_t checksum = 0;
-    checksum = st40_calc_checksum(3 + udw_size, (uint8_t*)&pktBuff->second_hdr_chunk);
-    st40_set_udw(i + 3, checksum, (uint8_t*)&pktBuff->second_hdr_chunk);
+    /* DID, SDID, DATA_COUNT, udw and checksum in one pass */
+    st40_pack_udw(src->meta[idx].did, src->meta[idx].sdid,
+                  &src->data[src->meta[idx].udw_offset], udw_size,
+                  (uint8_t*)&pktBuff->second_hdr_chunk);
 
     uint16_t total_size =
         ((3 + udw_size + 1) * 10) / 8;  // Calculate size of the
@@ -497,21 +487,11 @@ static int tx_ancillary_session_build_rtp_packet(struct st_tx_ancillary_session_
     pktBuff->first_hdr_chunk.horizontal_offset = src->meta[idx].hori_offset;
     pktBuff->first_hdr_chunk.s = src->meta[idx].s;
     pktBuff->first_hdr_chunk.stream_num = src->meta[idx].stream_num;
-    pktBuff->second_hdr_chunk.did = st40_add_parity_bits(src->meta[idx].did);
-    pktBuff->second_hdr_chunk.sdid = st40_add_parity_bits(src->meta[idx].sdid);
-    pktBuff->second_hdr_chunk.data_count = st40_add_parity_bits(udw_size);
-
     pktBuff->swaped_first_hdr_chunk = htonl(pktBuff->swaped_first_hdr_chunk);
-    pktBuff->swaped_second_hdr_chunk = htonl(pktBuff->swaped_second_hdr_chunk);
-    int i = 0;
-    int offset = src->meta[idx].udw_offset;
-    for (; i < udw_size; i++) {
-      st40_set_udw(i + 3, st40_add_parity_bits(src->data[offset++]),
-                   (uint8_t*)&pktBuff->second_hdr_chunk);
-    }
-    uint16_t checksum = 0;
-    checksum = st40_calc_checksum(3 + udw_size, (uint8_t*)&pktBuff->second_hdr_chunk);
-    st40_set_udw(i + 3, checksum, (uint8_t*)&pktBuff->second_hdr_chunk);
+    /* DID, SDID, DATA_COUNT, udw and checksum in one pass */
+    st40_pack_udw(src->meta[idx].did, src->meta[idx].sdid,
+                  &src->data[src->meta[idx].udw_offset], udw_size,
+                  (uint8_t*)&pktBuff->second_hdr_chunk);
 
     uint16_t total_size =
         ((3 + udw_size + 1) * 10) / 8;  // Calculate size of the
@@ -692,8 +672,9 @@ static int tx_ancillary_session_tasklet_frame(struct mtl_main_impl* impl,
     dbg("%s(%d), st40_total_pkts %d total_udw %d meta_num %u src %p\n", __func__, idx,
         s->st40_total_pkts, total_udw, src->meta_num, src);
     if (s->st40_total_pkts < 1) {
-      err("%s(%d), frame %u invalid st40_total_pkts %d\n", __func__, idx, next_frame_idx,
-          s->st40_total_pkts);
+      /* no ANC in this frame, send one rtp with anc_count 0 to keep the cadence */
+      dbg("%s(%d), frame %u empty\n", __func__, idx, next_frame_idx);
+      s->st40_total_pkts = 1;
     }
   }
 
@@ -1409,6 +1390,7 @@ static int tx_ancillary_sessions_mgr_init(struct mtl_main_impl* impl,
   ops.start = tx_ancillary_sessions_tasklet_start;
   ops.stop = tx_ancillary_sessions_tasklet_stop;
   ops.handler = tx_ancillary_sessions_tasklet_handler;
+  ops.migratable = true;
 
   mgr->tasklet = mt_sch_register_tasklet(sch, &ops);
   if (!mgr->tasklet) {
@@ -1428,12 +1410,13 @@ static struct st_tx_ancillary_session_impl* tx_ancillary_sessions_mgr_attach(
   struct mtl_main_impl* impl = mgr->parent;
   int ret;
   struct st_tx_ancillary_session_impl* s;
+  int socket = mt_port_socket_id(impl, ops->port[MTL_SESSION_PORT_P]);
 
   /* find one empty slot in the mgr */
   for (int i = 0; i < ST_MAX_TX_ANC_SESSIONS; i++) {
     if (!tx_ancillary_session_get_empty(mgr, i)) continue;
 
-    s = mt_rte_zmalloc_socket(sizeof(*s), mt_socket_id(impl, MTL_PORT_P));
+    s = mt_rte_zmalloc_socket(sizeof(*s), socket);
     if (!s) {
       err("%s(%d), session malloc fail on %d\n", __func__, midx, i);
       tx_ancillary_session_put(mgr, i);
@@ -1623,7 +1606,8 @@ st40_tx_handle st40_tx_create(mtl_handle mt, struct st40_tx_ops* ops) {
     return NULL;
   }
 
-  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), mt_socket_id(impl, MTL_PORT_P));
+  int socket = mt_port_socket_id(impl, ops->port[MTL_SESSION_PORT_P]);
+  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), socket);
   if (!s_impl) {
     err("%s, s_impl malloc fail\n", __func__);
     return NULL;
@@ -1477,6 +1477,7 @@ static int tx_audio_sessions_mgr_init(struct mtl_main_impl* impl, struct mt_sch_
   ops.start = tx_audio_sessions_tasklet_start;
   ops.stop = tx_audio_sessions_tasklet_stop;
   ops.handler = tx_audio_sessions_tasklet_handler;
+  ops.migratable = true;
 
   mgr->tasklet = mt_sch_register_tasklet(sch, &ops);
   if (!mgr->tasklet) {
@@ -1496,12 +1497,13 @@ static struct st_tx_audio_session_impl* tx_audio_sessions_mgr_attach(
   struct mtl_main_impl* impl = mgr->parent;
   int ret;
   struct st_tx_audio_session_impl* s;
+  int socket = mt_port_socket_id(impl, ops->port[MTL_SESSION_PORT_P]);
 
   /* find one empty slot in the mgr */
   for (int i = 0; i < ST_MAX_TX_AUDIO_SESSIONS; i++) {
     if (!tx_audio_session_get_empty(mgr, i)) continue;
 
-    s = mt_rte_zmalloc_socket(sizeof(*s), mt_socket_id(impl, MTL_PORT_P));
+    s = mt_rte_zmalloc_socket(sizeof(*s), socket);
     if (!s) {
       err("%s(%d), session malloc fail on %d\n", __func__, midx, i);
       tx_audio_session_put(mgr, i);
@@ -1694,7 +1696,8 @@ st30_tx_handle st30_tx_create(mtl_handle mt, struct st30_tx_ops* ops) {
     return NULL;
   }
 
-  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), mt_socket_id(impl, MTL_PORT_P));
+  int socket = mt_port_socket_id(impl, ops->port[MTL_SESSION_PORT_P]);
+  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), socket);
   if (!s_impl) {
     err("%s, s_impl malloc fail\n", __func__);
     return NULL;
@@ -6,11 +6,19 @@
 
 #include <math.h>
 
+#include "../mt_arena.h"
 #include "../mt_log.h"
 #include "../mt_stat.h"
 #include "st_err.h"
 #include "st_video_transmitter.h"
 
+static const struct mt_metric_desc tv_metric_descs[ST_TX_VIDEO_METRIC_MAX] = {
+    [ST_TX_VIDEO_METRIC_FRAMES] = {"frames", MTL_METRIC_COUNTER},
+    [ST_TX_VIDEO_METRIC_PKTS_BUILD] = {"pkts_build", MTL_METRIC_COUNTER},
+    [ST_TX_VIDEO_METRIC_PKTS_BURST] = {"pkts_burst", MTL_METRIC_COUNTER},
+    [ST_TX_VIDEO_METRIC_EPOCH_DROP] = {"epoch_drop", MTL_METRIC_COUNTER},
+};
+
 static inline double pacing_time(struct st_tx_video_pacing* pacing, uint64_t epochs) {
   return epochs * pacing->frame_time;
 }
@@ -158,6 +166,7 @@ static int tv_alloc_frames(struct mtl_main_impl* impl,
   int idx = s->idx;
   struct st_frame_trans* frame_info;
   struct st22_tx_video_info* st22_info = s->st22_info;
+  int ret;
 
   s->st20_frames =
       mt_rte_zmalloc_socket(sizeof(*s->st20_frames) * s->st20_frames_cnt, soc_id);
@@ -165,6 +174,7 @@ static int tv_alloc_frames(struct mtl_main_impl* impl,
     err("%s(%d), st20_frames malloc fail\n", __func__, idx);
     return -ENOMEM;
   }
+  mt_arena_quota_init(&s->arena_quota, s->st20_frames_cnt, s->st20_fb_size);
 
   for (int i = 0; i < s->st20_frames_cnt; i++) {
     frame_info = &s->st20_frames[i];
@@ -185,18 +195,16 @@ static int tv_alloc_frames(struct mtl_main_impl* impl,
       frame_info->flags = ST_FT_FLAG_EXT;
       info("%s(%d), use external framebuffer, skip allocation\n", __func__, idx);
     } else {
-      void* frame = mt_rte_zmalloc_socket(s->st20_fb_size, soc_id);
-      if (!frame) {
+      ret = st_frame_trans_alloc(impl, frame_info, s->st20_fb_size, soc_id,
+                                 &s->arena_quota);
+      if (ret < 0) {
         err("%s(%d), rte_malloc %" PRIu64 " fail at %d\n", __func__, idx, s->st20_fb_size,
             i);
-        return -ENOMEM;
+        return ret;
       }
       if (st22_info) { /* copy boxes */
-        mtl_memcpy(frame, &st22_info->st22_boxes, s->st22_box_hdr_length);
+        mtl_memcpy(frame_info->addr, &st22_info->st22_boxes, s->st22_box_hdr_length);
       }
-      frame_info->iova = rte_mem_virt2iova(frame);
-      frame_info->addr = frame;
-      frame_info->flags = ST_FT_FLAG_RTE_MALLOC;
       if (impl->iova_mode == RTE_IOVA_PA && !s->tx_no_chain)
         tv_frame_create_page_table(s, frame_info);
     }
@@ -515,7 +523,10 @@ static int tv_sync_pacing(struct mtl_main_impl* impl, struct st_tx_video_session
     to_epoch_tr_offset = 0;
   }
 
-  if (epochs > next_epochs) s->stat_epoch_drop += (epochs - next_epochs);
+  if (epochs > next_epochs) {
+    s->stat_epoch_drop += (epochs - next_epochs);
+    mt_metric_add(s->metrics, ST_TX_VIDEO_METRIC_EPOCH_DROP, epochs - next_epochs);
+  }
   if (epochs < next_epochs) s->stat_epoch_onward += (next_epochs - epochs);
   pacing->cur_epochs = epochs;
   pacing->cur_epoch_time = pacing_time(pacing, epochs);
@@ -1048,6 +1059,7 @@ static int tv_build_rtp_chain(struct mtl_main_impl* impl,
     /* start of a new frame */
     s->st20_pkt_idx = 0;
     rte_atomic32_inc(&s->stat_frame_cnt);
+    mt_metric_add(s->metrics, ST_TX_VIDEO_METRIC_FRAMES, 1);
     s->st20_rtp_time = rtp->tmstamp;
     tv_sync_pacing(impl, s, false, 0);
     if (s->ops.flags & ST20_TX_FLAG_USER_TIMESTAMP) {
@@ -1573,6 +1585,7 @@ static int tv_tasklet_frame(struct mtl_main_impl* impl,
     pacing_forward_cursor(pacing); /* pkt forward */
     s->st20_pkt_idx++;
     s->stat_pkts_build++;
+    mt_metric_add(s->metrics, ST_TX_VIDEO_METRIC_PKTS_BUILD, 1);
   }
 
   bool done = false;
@@ -1601,6 +1614,7 @@ static int tv_tasklet_frame(struct mtl_main_impl* impl,
     s->st20_frame_stat = ST21_TX_STAT_WAIT_FRAME;
     s->st20_pkt_idx = 0;
     rte_atomic32_inc(&s->stat_frame_cnt);
+    mt_metric_add(s->metrics, ST_TX_VIDEO_METRIC_FRAMES, 1);
     if (s->tx_no_chain) {
       /* trigger extbuf free cb since mbuf attach not used */
       struct st_frame_trans* frame_info = &s->st20_frames[s->st20_frame_idx];
@@ -1725,6 +1739,7 @@ static int tv_tasklet_rtp(struct mtl_main_impl* impl,
     pacing_forward_cursor(pacing); /* pkt forward */
     s->st20_pkt_idx++;
     s->stat_pkts_build++;
+    mt_metric_add(s->metrics, ST_TX_VIDEO_METRIC_PKTS_BUILD, 1);
   }
 
   /* build dummy bulk pkts to satisfy video transmitter which is bulk based */
@@ -1902,6 +1917,7 @@ static int tv_tasklet_st22(struct mtl_main_impl* impl,
       pacing_forward_cursor(pacing); /* pkt forward */
       s->st20_pkt_idx++;
       s->stat_pkts_build++;
+      mt_metric_add(s->metrics, ST_TX_VIDEO_METRIC_PKTS_BUILD, 1);
       s->stat_pkts_dummy++;
     }
   } else {
@@ -1974,6 +1990,7 @@ static int tv_tasklet_st22(struct mtl_main_impl* impl,
       pacing_forward_cursor(pacing); /* pkt forward */
       s->st20_pkt_idx++;
       s->stat_pkts_build++;
+      mt_metric_add(s->metrics, ST_TX_VIDEO_METRIC_PKTS_BUILD, 1);
     }
   }
 
@@ -2003,6 +2020,7 @@ static int tv_tasklet_st22(struct mtl_main_impl* impl,
     s->st20_frame_stat = ST21_TX_STAT_WAIT_FRAME;
     s->st20_pkt_idx = 0;
     rte_atomic32_inc(&s->stat_frame_cnt);
+    mt_metric_add(s->metrics, ST_TX_VIDEO_METRIC_FRAMES, 1);
     st22_info->frame_idx++;
 
     uint64_t frame_end_time = mt_get_tsc(impl);
@@ -2669,6 +2687,15 @@ static int tv_attach(struct mtl_main_impl* impl, struct st_tx_video_sessions_mgr
     info("%s(%d), advice sleep us %" PRIu64 "\n", __func__, idx, s->advice_sleep_us);
   }
 
+  char metric_name[MTL_METRIC_NAME_MAX];
+  snprintf(metric_name, sizeof(metric_name), "%s.%d.%d",
+           (s_type == MT_ST22_HANDLE_TX_VIDEO) ? "st22_tx" : "st20_tx", mgr->idx, idx);
+  s->metrics = mt_metric_register(impl, metric_name, tv_metric_descs,
+                                  ST_TX_VIDEO_METRIC_MAX,
+                                  mt_socket_id(impl, s->port_maps[MTL_SESSION_PORT_P]));
+  /* not fatal, the metric helpers skip a NULL group */
+  if (!s->metrics) warn("%s(%d), metric register fail\n", __func__, idx);
+
   s->stat_lines_not_ready = 0;
   s->stat_user_busy = 0;
   s->stat_user_busy_first = true;
@@ -2690,6 +2717,13 @@ static int tv_attach(struct mtl_main_impl* impl, struct st_tx_video_sessions_mgr
     s->trs_inflight_num2[i] = 0;
     s->trs_pad_inflight_num[i] = 0;
     s->trs_target_tsc[i] = 0;
+    s->stat_pkts_burst[i] = 0;
+  }
+  if (num_port > 1) {
+    /* redundant pkts reuse the primary payload, chain it or copy if no chain support */
+    info("%s(%d), redundant with %s payload, pacing way: %s\n", __func__, idx,
+         s->tx_no_chain ? "copied" : "chained",
+         st_tx_pacing_way_name(s->pacing_way[MTL_SESSION_PORT_R]));
   }
 
   info("%s(%d), len %d(%d) total %d each line %d type %d flags 0x%x\n", __func__, idx,
@@ -2723,11 +2757,12 @@ void tx_video_session_cal_cpu_busy(struct st_tx_video_session_impl* s) {
 
 static void tv_stat(struct st_tx_video_sessions_mgr* mgr,
                     struct st_tx_video_session_impl* s) {
-  int m_idx = mgr->idx, idx = s->idx;
+  int m_idx = mgr->idx, idx = s->idx, num_port = s->ops.num_port;
   uint64_t cur_time_ns = mt_get_monotonic_time();
   double time_sec = (double)(cur_time_ns - s->stat_last_time) / NS_PER_S;
   int frame_cnt = rte_atomic32_read(&s->stat_frame_cnt);
   double framerate = frame_cnt / time_sec;
+  char hist[128];
 
   rte_atomic32_set(&s->stat_frame_cnt, 0);
 
@@ -2735,12 +2770,23 @@ static void tv_stat(struct st_tx_video_sessions_mgr* mgr,
       "TX_VIDEO_SESSION(%d,%d:%s): fps %f, frame %d pkts %d:%d inflight %d:%d, cpu busy "
       "%f\n",
       m_idx, idx, s->ops_name, framerate, frame_cnt, s->stat_pkts_build,
-      s->stat_pkts_burst, s->trs_inflight_cnt[0], s->inflight_cnt[0], s->cpu_busy_score);
+      s->stat_pkts_burst[MTL_SESSION_PORT_P], s->trs_inflight_cnt[MTL_SESSION_PORT_P],
+      s->inflight_cnt[MTL_SESSION_PORT_P], s->cpu_busy_score);
   s->stat_last_time = cur_time_ns;
   s->stat_pkts_build = 0;
-  s->stat_pkts_burst = 0;
-  s->trs_inflight_cnt[0] = 0;
-  s->inflight_cnt[0] = 0;
+  for (int i = 0; i < num_port; i++) {
+    if (i != MTL_SESSION_PORT_P) {
+      /* redundant port shares the build with the primary, report the burst only */
+      notice("TX_VIDEO_SESSION(%d,%d): port %d pkts burst %d inflight %d:%d\n", m_idx,
+             idx, i, s->stat_pkts_burst[i], s->trs_inflight_cnt[i], s->inflight_cnt[i]);
+    }
+    s->stat_pkts_burst[i] = 0;
+    s->trs_inflight_cnt[i] = 0;
+    s->inflight_cnt[i] = 0;
+  }
+
+  if (mt_hist_summary(&s->stat_pacing_err_hist, hist, sizeof(hist)))
+    notice("TX_VIDEO_SESSION(%d,%d): pacing error %s\n", m_idx, idx, hist);
 
   if (s->stat_pkts_dummy) {
     notice("TX_VIDEO_SESSION(%d,%d): dummy pkts %u, burst %u\n", m_idx, idx,
@@ -2829,6 +2875,10 @@ static void tv_stat(struct st_tx_video_sessions_mgr* mgr,
 static int tv_detach(struct mtl_main_impl* impl, struct st_tx_video_sessions_mgr* mgr,
                      struct st_tx_video_session_impl* s) {
   tv_stat(mgr, s);
+  if (s->metrics) {
+    mt_metric_unregister(impl, s->metrics);
+    s->metrics = NULL;
+  }
   /* must uinit hw firstly as frame use shared external buffer */
   tv_uinit_hw(impl, s);
   tv_uinit_sw(s);
@@ -2848,12 +2898,13 @@ static struct st_tx_video_session_impl* tv_mgr_attach(
   struct mtl_main_impl* impl = mgr->parent;
   int ret;
   struct st_tx_video_session_impl* s;
+  int socket = mt_port_socket_id(impl, ops->port[MTL_SESSION_PORT_P]);
 
   /* find one empty slot in the mgr */
   for (int i = 0; i < ST_SCH_MAX_TX_VIDEO_SESSIONS; i++) {
     if (!tx_video_session_get_empty(mgr, i)) continue;
 
-    s = mt_rte_zmalloc_socket(sizeof(*s), mt_socket_id(impl, MTL_PORT_P));
+    s = mt_rte_zmalloc_socket(sizeof(*s), socket);
     if (!s) {
       err("%s(%d), session malloc fail on %d\n", __func__, midx, i);
       tx_video_session_put(mgr, i);
@@ -3207,13 +3258,14 @@ st20_tx_handle st20_tx_create(mtl_handle mt, struct st20_tx_ops* ops) {
     }
   }
 
-  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), mt_socket_id(impl, MTL_PORT_P));
+  int socket = mt_port_socket_id(impl, ops->port[MTL_SESSION_PORT_P]);
+  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), socket);
   if (!s_impl) {
     err("%s, s_impl malloc fail\n", __func__);
     return NULL;
   }
 
-  sch = mt_sch_get(impl, quota_mbs, MT_SCH_TYPE_DEFAULT, MT_SCH_MASK_ALL);
+  sch = mt_sch_get(impl, quota_mbs, MT_SCH_TYPE_DEFAULT, MT_SCH_MASK_ALL, socket);
   if (!sch) {
     mt_rte_free(s_impl);
     err("%s, get sch fail\n", __func__);
@@ -3546,13 +3598,14 @@ st22_tx_handle st22_tx_create(mtl_handle mt, struct st22_tx_ops* ops) {
     quota_mbs *= ops->num_port;
   }
 
-  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), mt_socket_id(impl, MTL_PORT_P));
+  int socket = mt_port_socket_id(impl, ops->port[MTL_SESSION_PORT_P]);
+  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), socket);
   if (!s_impl) {
     err("%s, s_impl malloc fail\n", __func__);
     return NULL;
   }
 
-  sch = mt_sch_get(impl, quota_mbs, MT_SCH_TYPE_DEFAULT, MT_SCH_MASK_ALL);
+  sch = mt_sch_get(impl, quota_mbs, MT_SCH_TYPE_DEFAULT, MT_SCH_MASK_ALL, socket);
   if (!sch) {
     mt_rte_free(s_impl);
     err("%s, get sch fail\n", __func__);
@@ -7,6 +7,7 @@
 #include <math.h>
 
 #include "../mt_log.h"
+#include "../mt_stat.h"
 #include "st_err.h"
 #include "st_tx_video_session.h"
 
@@ -78,7 +79,8 @@ static int video_burst_packet(struct st_tx_video_session_impl* s,
   int tx = mt_dev_tx_burst(s->queue[s_port], &pkts[0], bulk);
   int pkt_idx = st_tx_mbuf_get_idx(pkts[0]);
 
-  s->stat_pkts_burst += tx;
+  s->stat_pkts_burst[s_port] += tx;
+  mt_metric_add(s->metrics, ST_TX_VIDEO_METRIC_PKTS_BURST, tx);
   s->pri_nic_burst_cnt++;
   if (s->pri_nic_burst_cnt > ST_VIDEO_STAT_UPDATE_INTERVAL) {
     rte_atomic32_add(&s->nic_burst_cnt, s->pri_nic_burst_cnt);
@@ -131,7 +133,8 @@ static int _video_trs_rl_tasklet(struct mtl_main_impl* impl,
                          s->trs_inflight_num2[s_port]);
     s->trs_inflight_num2[s_port] -= tx;
     s->trs_inflight_idx2[s_port] += tx;
-    s->stat_pkts_burst += tx;
+    s->stat_pkts_burst[s_port] += tx;
+    mt_metric_add(s->metrics, ST_TX_VIDEO_METRIC_PKTS_BURST, tx);
     if (tx > 0) {
       return MT_TASKLET_HAS_PENDING;
     } else {
@@ -154,6 +157,8 @@ static int _video_trs_rl_tasklet(struct mtl_main_impl* impl,
         err("%s(%d), invalid trs tsc cur %" PRIu64 " target %" PRIu64 "\n", __func__, idx,
             cur_tsc, target_tsc);
       }
+    } else {
+      mt_hist_add(&s->stat_pacing_err_hist, cur_tsc - target_tsc);
     }
     video_trs_rl_warm_up(impl, s, s_port);
     s->trs_target_tsc[s_port] = 0;
@@ -180,7 +185,8 @@ static int _video_trs_rl_tasklet(struct mtl_main_impl* impl,
                          s->trs_inflight_num[s_port]);
     s->trs_inflight_num[s_port] -= tx;
     s->trs_inflight_idx[s_port] += tx;
-    s->stat_pkts_burst += tx;
+    s->stat_pkts_burst[s_port] += tx;
+    mt_metric_add(s->metrics, ST_TX_VIDEO_METRIC_PKTS_BURST, tx);
     if (tx > 0) {
       return MT_TASKLET_HAS_PENDING;
     } else {
@@ -247,6 +253,7 @@ static int _video_trs_rl_tasklet(struct mtl_main_impl* impl,
             __func__, idx, cur_tsc, target_tsc);
       }
     } else {
+      mt_hist_add(&s->stat_pacing_err_hist, cur_tsc - target_tsc);
       video_trs_rl_warm_up(impl, s, s_port);
     }
   }
@@ -302,6 +309,8 @@ static int video_trs_tsc_tasklet(struct mtl_main_impl* impl,
         err("%s(%d), invalid trs tsc cur %" PRIu64 " target %" PRIu64 "\n", __func__, idx,
             cur_tsc, target_tsc);
       }
+    } else {
+      mt_hist_add(&s->stat_pacing_err_hist, cur_tsc - target_tsc);
     }
     s->trs_target_tsc[s_port] = 0;
   }
@@ -313,7 +322,8 @@ static int video_trs_tsc_tasklet(struct mtl_main_impl* impl,
                          s->trs_inflight_num[s_port]);
     s->trs_inflight_num[s_port] -= tx;
     s->trs_inflight_idx[s_port] += tx;
-    s->stat_pkts_burst += tx;
+    s->stat_pkts_burst[s_port] += tx;
+    mt_metric_add(s->metrics, ST_TX_VIDEO_METRIC_PKTS_BURST, tx);
     if (tx > 0) {
       return MT_TASKLET_HAS_PENDING;
     } else {
@@ -379,11 +389,14 @@ static int video_trs_tsc_tasklet(struct mtl_main_impl* impl,
         err("%s(%d), invalid tsc cur %" PRIu64 " target %" PRIu64 "\n", __func__, idx,
             cur_tsc, target_tsc);
       }
+    } else {
+      mt_hist_add(&s->stat_pacing_err_hist, cur_tsc - target_tsc);
     }
   }
 
   tx = mt_dev_tx_burst(s->queue[s_port], &pkts[0], valid_bulk);
-  s->stat_pkts_burst += tx;
+  s->stat_pkts_burst[s_port] += tx;
+  mt_metric_add(s->metrics, ST_TX_VIDEO_METRIC_PKTS_BURST, tx);
 
   if (tx < valid_bulk) {
     unsigned int i;
@@ -421,6 +434,8 @@ static int video_trs_ptp_tasklet(struct mtl_main_impl* impl,
         err("%s(%d), invalid trs tsc cur %" PRIu64 " target %" PRIu64 "\n", __func__, idx,
             cur_ptp, target_ptp);
       }
+    } else {
+      mt_hist_add(&s->stat_pacing_err_hist, cur_ptp - target_ptp);
     }
     s->trs_target_tsc[s_port] = 0;
   }
@@ -432,7 +447,8 @@ static int video_trs_ptp_tasklet(struct mtl_main_impl* impl,
                          s->trs_inflight_num[s_port]);
     s->trs_inflight_num[s_port] -= tx;
     s->trs_inflight_idx[s_port] += tx;
-    s->stat_pkts_burst += tx;
+    s->stat_pkts_burst[s_port] += tx;
+    mt_metric_add(s->metrics, ST_TX_VIDEO_METRIC_PKTS_BURST, tx);
     if (tx > 0) {
       return MT_TASKLET_HAS_PENDING;
     } else {
@@ -497,10 +513,13 @@ static int video_trs_ptp_tasklet(struct mtl_main_impl* impl,
       err("%s(%d), invalid tsc cur %" PRIu64 " target %" PRIu64 "\n", __func__, idx,
           cur_ptp, target_ptp);
     }
+  } else {
+    mt_hist_add(&s->stat_pacing_err_hist, cur_ptp - target_ptp);
   }
 
   tx = mt_dev_tx_burst(s->queue[s_port], &pkts[0], valid_bulk);
-  s->stat_pkts_burst += tx;
+  s->stat_pkts_burst[s_port] += tx;
+  mt_metric_add(s->metrics, ST_TX_VIDEO_METRIC_PKTS_BURST, tx);
 
   if (tx < valid_bulk) {
     unsigned int i;
@@ -133,6 +133,7 @@ static int udp_build_tx_pkt(struct mtl_main_impl* impl, struct mudp_impl* s,
   struct rte_udp_hdr* udp = &hdr->udp;
   enum mtl_port port = s->port;
   int idx = s->idx;
+  bool arp_pending = false;
   int ret;
 
   if (len > MUDP_MAX_BYTES) {
@@ -151,11 +152,14 @@ static int udp_build_tx_pkt(struct mtl_main_impl* impl, struct mudp_impl* s,
   } else {
     ret = mt_dev_dst_ip_mac(impl, dip, d_addr, port, arp_timeout_ms);
     if (ret < 0) {
-      if (arp_timeout_ms) /* log only if not zero timeout */
+      if (arp_timeout_ms) { /* log only if not zero timeout */
         err("%s(%d), mt_dev_dst_ip_mac fail %d for %u.%u.%u.%u\n", __func__, idx, ret,
             dip[0], dip[1], dip[2], dip[3]);
-      s->stat_pkt_arp_fail++;
-      MUDP_ERR_RET(EIO);
+        s->stat_pkt_arp_fail++;
+        MUDP_ERR_RET(EIO);
+      }
+      /* build without the mac, the caller queue it until arp resolved */
+      arp_pending = true;
     }
   }
 
@@ -185,7 +189,7 @@ static int udp_build_tx_pkt(struct mtl_main_impl* impl, struct mudp_impl* s,
   }
 
   s->stat_pkt_build++;
-  return 0;
+  return arp_pending ? 1 : 0;
 }
 
 static ssize_t udp_msg_len(const struct msghdr* msg) {
@@ -341,12 +345,13 @@ static unsigned int udp_tx_pkts(struct mtl_main_impl* impl, struct mudp_impl* s,
   uint64_t start_ts = mt_get_tsc(impl);
 
   while (1) {
-    unsigned int remaining = count - sent;
+    unsigned int remaining = count - sent, tx;
     if (s->tsq)
-      sent += mt_tsq_burst(s->tsq, pkts, remaining);
+      tx = mt_tsq_burst(s->tsq, &pkts[sent], remaining);
     else
-      sent = mt_dev_tx_burst(s->txq, pkts, remaining);
-    s->stat_pkt_tx += sent;
+      tx = mt_dev_tx_burst(s->txq, &pkts[sent], remaining);
+    sent += tx;
+    s->stat_pkt_tx += tx;
     if (sent >= count) { /* all tx succ */
       return sent;
     }
@@ -544,6 +549,11 @@ static int udp_stat_dump(void* priv) {
     notice("%s(%d,%d), tx gso count %u\n", __func__, port, idx, s->stat_tx_gso_count);
     s->stat_tx_gso_count = 0;
   }
+  if (s->stat_pkt_arp_queue) {
+    notice("%s(%d,%d), pkt %u queued for arp\n", __func__, port, idx,
+           s->stat_pkt_arp_queue);
+    s->stat_pkt_arp_queue = 0;
+  }
   if (s->stat_pkt_arp_fail) {
     warn("%s(%d,%d), pkt %u arp fail\n", __func__, port, idx, s->stat_pkt_arp_fail);
     s->stat_pkt_arp_fail = 0;
@@ -552,6 +562,11 @@ static int udp_stat_dump(void* priv) {
     warn("%s(%d,%d), pkt tx retry %u\n", __func__, port, idx, s->stat_tx_retry);
     s->stat_tx_retry = 0;
   }
+  if (s->tsq && s->tsq->stat_backpressure) {
+    warn("%s(%d,%d), tsq backpressure %" PRIu64 "\n", __func__, port, idx,
+         s->tsq->stat_backpressure);
+    s->tsq->stat_backpressure = 0;
+  }
   if (s->user_dump) {
     s->user_dump(s->user_dump_priv);
   }
@@ -804,7 +819,7 @@ static int udp_add_membership(struct mudp_impl* s, const void* optval, socklen_t
   mreq = (const struct ip_mreq*)optval;
   ip = (uint8_t*)&mreq->imr_multiaddr.s_addr;
   uint32_t group_addr = mt_ip_to_u32(ip);
-  ret = mt_mcast_join(s->parent, group_addr, port);
+  ret = mt_mcast_join(s->parent, group_addr, 0, port);
   if (ret < 0) {
     err("%s(%d), join mcast fail\n", __func__, idx);
     return ret;
@@ -824,7 +839,7 @@ static int udp_add_membership(struct mudp_impl* s, const void* optval, socklen_t
   mt_pthread_mutex_unlock(&s->mcast_addrs_mutex);
   if (!added) {
     err("%s(%d), record mcast fail\n", __func__, idx);
-    mt_mcast_leave(s->parent, group_addr, port);
+    mt_mcast_leave(s->parent, group_addr, 0, port);
     MUDP_ERR_RET(EIO);
   }
 
@@ -869,7 +884,7 @@ static int udp_drop_membership(struct mudp_impl* s, const void* optval,
     MUDP_ERR_RET(EIO);
   }
 
-  mt_mcast_leave(s->parent, group_addr, port);
+  mt_mcast_leave(s->parent, group_addr, 0, port);
   return 0;
 }
 
@@ -1264,21 +1279,32 @@ ssize_t mudp_sendto(mudp_handle ut, const void* buf, size_t len, int flags,
   }
 
   size_t offset = 0;
+  bool arp_pending = false;
   for (unsigned int i = 0; i < pkts_nb; i++) {
     size_t cur_len = RTE_MIN(sz_per_pkt, len - offset);
     ret = udp_build_tx_pkt(impl, s, pkts[i], buf + offset, cur_len, addr_in,
                            arp_timeout_ms);
     if (ret < 0) {
       rte_pktmbuf_free_bulk(pkts, pkts_nb);
-      if (arp_timeout_ms) {
-        err("%s(%d), build pkt fail %d\n", __func__, idx, ret);
-        return ret;
-      } else {
-        mt_sleep_us(1);
-        /* align to kernel behavior which sendto succ even if arp not resolved */
-        return len;
-      }
+      err("%s(%d), build pkt fail %d\n", __func__, idx, ret);
+      return ret;
+    }
+    if (ret > 0) arp_pending = true;
+  }
+
+  if (arp_pending) {
+    /* hold the pkts until arp resolved, they are sent by the arp on the sys queue */
+    ret = mt_dev_dst_ip_queue(impl, (uint8_t*)&addr_in->sin_addr, s->port, pkts,
+                              pkts_nb);
+    if (ret < 0) ret = 0;
+    s->stat_pkt_arp_queue += ret;
+    if ((unsigned int)ret < pkts_nb) {
+      rte_pktmbuf_free_bulk(pkts + ret, pkts_nb - ret);
+      s->stat_pkt_arp_fail += pkts_nb - ret;
+      mt_sleep_us(1);
     }
+    /* align to kernel behavior which sendto succ even if arp not resolved */
+    return len;
   }
 
   unsigned int sent = udp_tx_pkts(impl, s, pkts, pkts_nb);
@@ -94,6 +94,7 @@ struct mudp_impl {
   /* do we need atomic here? atomic may impact the performance */
   uint32_t stat_pkt_build;
   uint32_t stat_pkt_arp_fail;
+  uint32_t stat_pkt_arp_queue;
   uint32_t stat_pkt_tx;
   uint32_t stat_tx_gso_count;
   uint32_t stat_tx_retry;
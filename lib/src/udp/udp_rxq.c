@@ -103,6 +103,7 @@ static int udp_init_tasklet(struct mtl_main_impl* impl, struct mudp_rxq* q) {
   ops.priv = q;
   ops.name = q->name;
   ops.handler = udp_tasklet_handler;
+  ops.migratable = true;
 
   q->lcore_tasklet = mt_sch_register_tasklet(impl->main_sch, &ops);
   if (!q->lcore_tasklet) {
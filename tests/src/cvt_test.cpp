@@ -3857,6 +3857,45 @@ TEST(Cvt, st31_aes3_to_am824) {
   test_aes3_to_am824(100);
 }
 
+static void test_st30_pcm_convert(enum st30_fmt fmt, enum st30_fmt inter_fmt,
+                                  uint16_t channel, uint32_t samples) {
+  int ret;
+  size_t src_size = st30_get_sample_size(fmt) * channel * samples;
+  size_t inter_size = st30_get_sample_size(inter_fmt) * channel * samples;
+  uint8_t* src = (uint8_t*)st_test_zmalloc(src_size);
+  uint8_t* inter = (uint8_t*)st_test_zmalloc(inter_size);
+  uint8_t* dst = (uint8_t*)st_test_zmalloc(src_size);
+  if (!src || !inter || !dst) {
+    EXPECT_EQ(0, 1);
+    if (src) st_test_free(src);
+    if (inter) st_test_free(inter);
+    if (dst) st_test_free(dst);
+    return;
+  }
+
+  st_test_rand_data(src, src_size, 0);
+
+  /* the wider format keeps all bits */
+  ret = st30_pcm_convert(src, fmt, inter, inter_fmt, channel, samples, NULL);
+  EXPECT_EQ(0, ret);
+  ret = st30_pcm_convert(inter, inter_fmt, dst, fmt, channel, samples, NULL);
+  EXPECT_EQ(0, ret);
+
+  EXPECT_EQ(0, memcmp(src, dst, src_size));
+
+  st_test_free(src);
+  st_test_free(inter);
+  st_test_free(dst);
+}
+
+TEST(Cvt, st30_pcm_convert) {
+  test_st30_pcm_convert(ST30_FMT_PCM16, ST30_FMT_PCM24, 2, 48);
+  test_st30_pcm_convert(ST30_FMT_PCM16, ST31_FMT_AM824, 8, 480);
+  test_st30_pcm_convert(ST30_FMT_PCM24, ST31_FMT_AM824, 2, 1024);
+  test_st30_pcm_convert(ST30_FMT_PCM8, ST30_FMT_PCM16, 1, 192);
+  test_st30_pcm_convert(ST30_FMT_PCM8, ST31_FMT_AM824, 16, 6);
+}
+
 static void frame_malloc(struct st_frame* frame, uint8_t rand, bool align) {
   int planes = st_frame_fmt_planes(frame->fmt);
   size_t fb_size = 0;
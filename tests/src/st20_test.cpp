@@ -1128,6 +1128,21 @@ TEST(St20_rx, frame_1080p_fps50_s1) {
   int height[1] = {1080};
   st20_rx_fps_test(type, fps, width, height, ST20_FMT_YUV_420_10BIT, ST_TEST_LEVEL_ALL);
 }
+TEST(St20_rx, loopback_frame_1080p_fps59_94_s1) {
+  auto ctx = (struct st_tests_context*)st_test_ctx();
+  /* the frames go from the tx of P to the rx of R by the crossed loopback rings */
+  if ((ctx->para.pmd[MTL_PORT_P] != MTL_PMD_DPDK_LOOPBACK) ||
+      (ctx->para.pmd[MTL_PORT_R] != MTL_PMD_DPDK_LOOPBACK)) {
+    info("%s, skip as the ports are not loopback\n", __func__);
+    return;
+  }
+  enum st20_type type[1] = {ST20_TYPE_FRAME_LEVEL};
+  enum st_fps fps[1] = {ST_FPS_P59_94};
+  int width[1] = {1920};
+  int height[1] = {1080};
+  st20_rx_fps_test(type, fps, width, height, ST20_FMT_YUV_422_10BIT,
+                   ST_TEST_LEVEL_MANDATORY);
+}
 TEST(St20_rx, mix_1080p_fps50_s3) {
   enum st20_type type[3] = {ST20_TYPE_RTP_LEVEL, ST20_TYPE_FRAME_LEVEL,
                             ST20_TYPE_FRAME_LEVEL};
@@ -320,6 +320,7 @@ TEST(St20p, tx_create_free_mix) { pipeline_create_free_test(st20p_tx, 2, 3, 4);
 TEST(St20p, rx_create_free_single) { pipeline_create_free_test(st20p_rx, 0, 1, 1); }
 TEST(St20p, rx_create_free_multi) { pipeline_create_free_test(st20p_rx, 0, 1, 6); }
 TEST(St20p, rx_create_free_mix) { pipeline_create_free_test(st20p_rx, 2, 3, 4); }
+TEST(St20p, tx_create_free_redundant) { pipeline_create_free_redundant_test(st20p_tx); }
 TEST(St20p, tx_create_free_max) { pipeline_create_free_max(st20p_tx, 100); }
 TEST(St20p, rx_create_free_max) { pipeline_create_free_max(st20p_rx, 100); }
 TEST(St20p, tx_create_expect_fail) { pipeline_expect_fail_test(st20p_tx); }
@@ -522,6 +522,7 @@ TEST(St22p, tx_create_free_mix) { pipeline_create_free_test(st22p_tx, 2, 3, 4);
 TEST(St22p, rx_create_free_single) { pipeline_create_free_test(st22p_rx, 0, 1, 1); }
 TEST(St22p, rx_create_free_multi) { pipeline_create_free_test(st22p_rx, 0, 1, 6); }
 TEST(St22p, rx_create_free_mix) { pipeline_create_free_test(st22p_rx, 2, 3, 4); }
+TEST(St22p, tx_create_free_redundant) { pipeline_create_free_redundant_test(st22p_tx); }
 TEST(St22p, tx_create_free_max) { pipeline_create_free_max(st22p_tx, 100); }
 TEST(St22p, rx_create_free_max) { pipeline_create_free_max(st22p_rx, 100); }
 TEST(St22p, tx_create_expect_fail) { pipeline_expect_fail_test(st22p_tx); }
@@ -0,0 +1,287 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <thread>
+
+#include "log.h"
+#include "tests.h"
+
+#define ST30P_TEST_PAYLOAD_TYPE (111)
+#define ST30P_TEST_UDP_PORT (17000)
+
+static int test_st30p_tx_frame_available(void* priv) {
+  tests_context* s = (tests_context*)priv;
+
+  s->cv.notify_all();
+
+  return 0;
+}
+
+static int test_st30p_tx_frame_done(void* priv, struct st30_frame* frame) {
+  tests_context* s = (tests_context*)priv;
+
+  if (!s->handle) return -EIO; /* not ready */
+
+  s->fb_send_done++;
+
+  return 0;
+}
+
+static int test_st30p_rx_frame_available(void* priv) {
+  tests_context* s = (tests_context*)priv;
+
+  s->cv.notify_all();
+
+  return 0;
+}
+
+static void st30p_tx_ops_init(tests_context* st30, struct st30p_tx_ops* ops_tx) {
+  auto ctx = st30->ctx;
+
+  memset(ops_tx, 0, sizeof(*ops_tx));
+  ops_tx->name = "st30p_test";
+  ops_tx->priv = st30;
+  ops_tx->port.num_port = 1;
+  memcpy(ops_tx->port.dip_addr[MTL_SESSION_PORT_P], ctx->mcast_ip_addr[MTL_PORT_P],
+         MTL_IP_ADDR_LEN);
+  strncpy(ops_tx->port.port[MTL_SESSION_PORT_P], ctx->para.port[MTL_PORT_P],
+          MTL_PORT_MAX_LEN);
+  ops_tx->port.udp_port[MTL_SESSION_PORT_P] = ST30P_TEST_UDP_PORT + st30->idx;
+  ops_tx->port.payload_type = ST30P_TEST_PAYLOAD_TYPE;
+  ops_tx->input_fmt = ST30_FMT_PCM16;
+  ops_tx->transport_fmt = ST30_FMT_PCM24;
+  ops_tx->channel = 2;
+  ops_tx->sampling = ST30_SAMPLING_48K;
+  ops_tx->ptime = ST30_PTIME_1MS;
+  ops_tx->samples_per_frame = 1024;
+  ops_tx->framebuff_cnt = st30->fb_cnt;
+  ops_tx->notify_frame_available = test_st30p_tx_frame_available;
+  ops_tx->notify_frame_done = test_st30p_tx_frame_done;
+  st30->frame_size = st30_get_sample_size(ops_tx->input_fmt) * ops_tx->channel *
+                     ops_tx->samples_per_frame;
+}
+
+static void st30p_rx_ops_init(tests_context* st30, struct st30p_rx_ops* ops_rx) {
+  auto ctx = st30->ctx;
+
+  memset(ops_rx, 0, sizeof(*ops_rx));
+  ops_rx->name = "st30p_test";
+  ops_rx->priv = st30;
+  ops_rx->port.num_port = 1;
+  memcpy(ops_rx->port.sip_addr[MTL_SESSION_PORT_P], ctx->mcast_ip_addr[MTL_PORT_P],
+         MTL_IP_ADDR_LEN);
+  strncpy(ops_rx->port.port[MTL_SESSION_PORT_P], ctx->para.port[MTL_PORT_R],
+          MTL_PORT_MAX_LEN);
+  ops_rx->port.udp_port[MTL_SESSION_PORT_P] = ST30P_TEST_UDP_PORT + st30->idx;
+  ops_rx->port.payload_type = ST30P_TEST_PAYLOAD_TYPE;
+  ops_rx->output_fmt = ST30_FMT_PCM16;
+  ops_rx->transport_fmt = ST30_FMT_PCM24;
+  ops_rx->channel = 2;
+  ops_rx->sampling = ST30_SAMPLING_48K;
+  ops_rx->ptime = ST30_PTIME_1MS;
+  ops_rx->samples_per_frame = 1024;
+  ops_rx->framebuff_cnt = st30->fb_cnt;
+  ops_rx->notify_frame_available = test_st30p_rx_frame_available;
+  st30->frame_size = st30_get_sample_size(ops_rx->output_fmt) * ops_rx->channel *
+                     ops_rx->samples_per_frame;
+}
+
+static void st30p_tx_assert_cnt(int expect_st30_tx_cnt) {
+  auto ctx = st_test_ctx();
+  auto handle = ctx->handle;
+  struct mtl_stats stats;
+  int ret;
+
+  ret = mtl_get_stats(handle, &stats);
+  EXPECT_GE(ret, 0);
+  EXPECT_EQ(stats.st30_tx_sessions_cnt, expect_st30_tx_cnt);
+}
+
+static void st30p_rx_assert_cnt(int expect_st30_rx_cnt) {
+  auto ctx = st_test_ctx();
+  auto handle = ctx->handle;
+  struct mtl_stats stats;
+  int ret;
+
+  ret = mtl_get_stats(handle, &stats);
+  EXPECT_GE(ret, 0);
+  EXPECT_EQ(stats.st30_rx_sessions_cnt, expect_st30_rx_cnt);
+}
+
+TEST(St30p, tx_create_free_single) { pipeline_create_free_test(st30p_tx, 0, 1, 1); }
+TEST(St30p, tx_create_free_multi) { pipeline_create_free_test(st30p_tx, 0, 1, 6); }
+TEST(St30p, tx_create_free_mix) { pipeline_create_free_test(st30p_tx, 2, 3, 4); }
+TEST(St30p, rx_create_free_single) { pipeline_create_free_test(st30p_rx, 0, 1, 1); }
+TEST(St30p, rx_create_free_multi) { pipeline_create_free_test(st30p_rx, 0, 1, 6); }
+TEST(St30p, rx_create_free_mix) { pipeline_create_free_test(st30p_rx, 2, 3, 4); }
+TEST(St30p, tx_create_expect_fail) { pipeline_expect_fail_test(st30p_tx); }
+TEST(St30p, rx_create_expect_fail) { pipeline_expect_fail_test(st30p_rx); }
+TEST(St30p, tx_create_expect_fail_fb_cnt) {
+  uint16_t fbcnt = 1;
+  pipeline_expect_fail_test_fb_cnt(st30p_tx, fbcnt);
+  fbcnt = ST30P_FB_MAX_COUNT + 1;
+  pipeline_expect_fail_test_fb_cnt(st30p_tx, fbcnt);
+}
+TEST(St30p, rx_create_expect_fail_fb_cnt) {
+  uint16_t fbcnt = 1;
+  pipeline_expect_fail_test_fb_cnt(st30p_rx, fbcnt);
+  fbcnt = ST30P_FB_MAX_COUNT + 1;
+  pipeline_expect_fail_test_fb_cnt(st30p_rx, fbcnt);
+}
+
+static void test_st30p_tx_frame_thread(void* args) {
+  tests_context* s = (tests_context*)args;
+  auto handle = s->handle;
+  struct st30_frame* frame;
+  std::unique_lock<std::mutex> lck(s->mtx, std::defer_lock);
+
+  dbg("%s(%d), start\n", __func__, s->idx);
+  while (!s->stop) {
+    frame = st30p_tx_get_frame((st30p_tx_handle)handle);
+    if (!frame) { /* no frame */
+      lck.lock();
+      if (!s->stop) s->cv.wait(lck);
+      lck.unlock();
+      continue;
+    }
+    if (frame->buffer_size != s->frame_size) s->incomplete_frame_cnt++;
+    st30p_tx_put_frame((st30p_tx_handle)handle, frame);
+    s->fb_send++;
+    if (!s->start_time) s->start_time = st_test_get_monotonic_time();
+  }
+  dbg("%s(%d), stop\n", __func__, s->idx);
+}
+
+static void test_st30p_rx_frame_thread(void* args) {
+  tests_context* s = (tests_context*)args;
+  auto handle = s->handle;
+  struct st30_frame* frame;
+  std::unique_lock<std::mutex> lck(s->mtx, std::defer_lock);
+  uint64_t timestamp = 0;
+
+  dbg("%s(%d), start\n", __func__, s->idx);
+  while (!s->stop) {
+    frame = st30p_rx_get_frame((st30p_rx_handle)handle);
+    if (!frame) { /* no frame */
+      lck.lock();
+      if (!s->stop) s->cv.wait(lck);
+      lck.unlock();
+      continue;
+    }
+
+    if (frame->data_size != s->frame_size) s->incomplete_frame_cnt++;
+    if (frame->tfmt != ST10_TIMESTAMP_FMT_MEDIA_CLK) s->incomplete_frame_cnt++;
+    /* media clk step by the samples per frame */
+    if (timestamp && ((uint32_t)(frame->timestamp - timestamp) != frame->samples))
+      s->fail_cnt++;
+    timestamp = frame->timestamp;
+    st30p_rx_put_frame((st30p_rx_handle)handle, frame);
+    s->fb_rec++;
+    if (!s->start_time) s->start_time = st_test_get_monotonic_time();
+  }
+  dbg("%s(%d), stop\n", __func__, s->idx);
+}
+
+static void st30p_rx_digest_test(uint32_t samples_per_frame, enum st30_ptime ptime,
+                                 enum st_test_level level) {
+  auto ctx = (struct st_tests_context*)st_test_ctx();
+  auto m_handle = ctx->handle;
+  int ret;
+  struct st30p_tx_ops ops_tx;
+  struct st30p_rx_ops ops_rx;
+
+  if (ctx->para.num_ports != 2) {
+    info("%s, dual port should be enabled for tx test, one for tx and one for rx\n",
+         __func__);
+    return;
+  }
+
+  /* return if level small than global */
+  if (level < ctx->level) return;
+
+  auto test_ctx_tx = new tests_context();
+  ASSERT_TRUE(test_ctx_tx != NULL);
+  test_ctx_tx->idx = 0;
+  test_ctx_tx->ctx = ctx;
+  test_ctx_tx->fb_cnt = 4;
+  st30p_tx_ops_init(test_ctx_tx, &ops_tx);
+  memcpy(ops_tx.port.dip_addr[MTL_SESSION_PORT_P], ctx->para.sip_addr[MTL_PORT_R],
+         MTL_IP_ADDR_LEN);
+  ops_tx.ptime = ptime;
+  ops_tx.samples_per_frame = samples_per_frame;
+  test_ctx_tx->frame_size = st30_get_sample_size(ops_tx.input_fmt) * ops_tx.channel *
+                            ops_tx.samples_per_frame;
+  auto tx_handle = st30p_tx_create(m_handle, &ops_tx);
+  ASSERT_TRUE(tx_handle != NULL);
+  test_ctx_tx->handle = tx_handle;
+
+  auto test_ctx_rx = new tests_context();
+  ASSERT_TRUE(test_ctx_rx != NULL);
+  test_ctx_rx->idx = 0;
+  test_ctx_rx->ctx = ctx;
+  test_ctx_rx->fb_cnt = 4;
+  st30p_rx_ops_init(test_ctx_rx, &ops_rx);
+  memcpy(ops_rx.port.sip_addr[MTL_SESSION_PORT_P], ctx->para.sip_addr[MTL_PORT_P],
+         MTL_IP_ADDR_LEN);
+  ops_rx.ptime = ptime;
+  ops_rx.samples_per_frame = samples_per_frame;
+  test_ctx_rx->frame_size = st30_get_sample_size(ops_rx.output_fmt) * ops_rx.channel *
+                            ops_rx.samples_per_frame;
+  auto rx_handle = st30p_rx_create(m_handle, &ops_rx);
+  ASSERT_TRUE(rx_handle != NULL);
+  test_ctx_rx->handle = rx_handle;
+
+  struct st_queue_meta q_meta;
+  ret = st30p_rx_get_queue_meta(rx_handle, &q_meta);
+  EXPECT_GE(ret, 0);
+
+  test_ctx_tx->stop = false;
+  test_ctx_rx->stop = false;
+  std::thread tx_thread(test_st30p_tx_frame_thread, test_ctx_tx);
+  std::thread rx_thread(test_st30p_rx_frame_thread, test_ctx_rx);
+
+  ret = mtl_start(m_handle);
+  EXPECT_GE(ret, 0);
+  sleep(10);
+
+  uint64_t cur_time_ns = st_test_get_monotonic_time();
+  double time_sec = (double)(cur_time_ns - test_ctx_rx->start_time) / NS_PER_S;
+  double framerate = test_ctx_rx->fb_rec / time_sec;
+  double expect_framerate = 48000.0 / samples_per_frame;
+
+  test_ctx_tx->stop = true;
+  test_ctx_tx->cv.notify_all();
+  tx_thread.join();
+  test_ctx_rx->stop = true;
+  test_ctx_rx->cv.notify_all();
+  rx_thread.join();
+
+  ret = mtl_stop(m_handle);
+  EXPECT_GE(ret, 0);
+
+  EXPECT_GT(test_ctx_rx->fb_rec, 0);
+  EXPECT_GT(test_ctx_tx->fb_send_done, 0);
+  EXPECT_EQ(test_ctx_tx->incomplete_frame_cnt, 0);
+  EXPECT_EQ(test_ctx_rx->incomplete_frame_cnt, 0);
+  EXPECT_LE(test_ctx_rx->fail_cnt, 2);
+  EXPECT_NEAR(framerate, expect_framerate, expect_framerate * 0.1);
+  info("%s, fb_rec %d, framerate %f\n", __func__, test_ctx_rx->fb_rec, framerate);
+
+  ret = st30p_tx_free(tx_handle);
+  EXPECT_GE(ret, 0);
+  ret = st30p_rx_free(rx_handle);
+  EXPECT_GE(ret, 0);
+  delete test_ctx_tx;
+  delete test_ctx_rx;
+}
+
+TEST(St30p, digest_1024_samples_1ms) {
+  st30p_rx_digest_test(1024, ST30_PTIME_1MS, ST_TEST_LEVEL_ALL);
+}
+TEST(St30p, digest_480_samples_125us) {
+  st30p_rx_digest_test(480, ST30_PTIME_125US, ST_TEST_LEVEL_MANDATORY);
+}
+TEST(St30p, digest_32_samples_1ms) {
+  st30p_rx_digest_test(32, ST30_PTIME_1MS, ST_TEST_LEVEL_ALL);
+}
@@ -278,6 +278,94 @@ static void st40_rx_assert_cnt(int expect_s40_rx_cnt) {
   EXPECT_EQ(stats.st40_rx_sessions_cnt, expect_s40_rx_cnt);
 }
 
+static void test_st40_udw_pack_unpack(uint16_t udw_size, enum mtl_simd_level pack_level,
+                                      enum mtl_simd_level unpack_level) {
+  uint8_t udw[255];
+  uint8_t udw_back[255];
+  uint8_t data[512];
+  uint8_t ref[4 + 512]; /* with the first hdr chunk */
+  uint8_t* data_ref = ref + 4;
+  uint16_t did = 0x43, sdid = 0x02;
+  uint16_t did_back, sdid_back;
+  int ret;
+
+  for (uint16_t i = 0; i < udw_size; i++) udw[i] = rand();
+
+  /* the reference with the per word api */
+  memset(ref, 0, sizeof(ref));
+  struct st40_rfc8331_payload_hdr* hdr = (struct st40_rfc8331_payload_hdr*)ref;
+  hdr->second_hdr_chunk.did = st40_add_parity_bits(did);
+  hdr->second_hdr_chunk.sdid = st40_add_parity_bits(sdid);
+  hdr->second_hdr_chunk.data_count = st40_add_parity_bits(udw_size);
+  hdr->swaped_second_hdr_chunk = htonl(hdr->swaped_second_hdr_chunk);
+  for (uint16_t i = 0; i < udw_size; i++)
+    st40_set_udw(i + 3, st40_add_parity_bits(udw[i]), data_ref);
+  st40_set_udw(udw_size + 3, st40_calc_checksum(3 + udw_size, data_ref), data_ref);
+
+  memset(data, 0, sizeof(data));
+  ret = st40_pack_udw_simd(did, sdid, udw, udw_size, data, pack_level);
+  EXPECT_EQ(ret, ((3 + udw_size + 1) * 10 + 7) / 8);
+  EXPECT_EQ(0, memcmp(data, data_ref, sizeof(data)));
+
+  ret = st40_unpack_udw_simd(data, sizeof(data), &did_back, &sdid_back, udw_back,
+                             sizeof(udw_back), unpack_level);
+  EXPECT_EQ(ret, udw_size);
+  EXPECT_EQ(did_back, did);
+  EXPECT_EQ(sdid_back, sdid);
+  EXPECT_EQ(0, memcmp(udw, udw_back, udw_size));
+
+  /* flip one bit of the udw words, expect the parity or checksum error */
+  if (udw_size) {
+    int bit = 30 + (rand() % (udw_size * 10));
+    data[bit / 8] ^= 1 << (7 - bit % 8);
+    ret = st40_unpack_udw_simd(data, sizeof(data), &did_back, &sdid_back, udw_back,
+                               sizeof(udw_back), unpack_level);
+    EXPECT_EQ(ret, -EIO);
+  }
+}
+
+static void test_st40_udw_all_size(enum mtl_simd_level pack_level,
+                                   enum mtl_simd_level unpack_level) {
+  for (uint16_t udw_size = 0; udw_size <= 255; udw_size++)
+    test_st40_udw_pack_unpack(udw_size, pack_level, unpack_level);
+}
+
+TEST(St40, udw_pack_unpack) {
+  test_st40_udw_all_size(MTL_SIMD_LEVEL_MAX, MTL_SIMD_LEVEL_MAX);
+}
+TEST(St40, udw_pack_unpack_scalar) {
+  test_st40_udw_all_size(MTL_SIMD_LEVEL_NONE, MTL_SIMD_LEVEL_NONE);
+}
+TEST(St40, udw_pack_unpack_avx2) {
+  test_st40_udw_all_size(MTL_SIMD_LEVEL_AVX2, MTL_SIMD_LEVEL_AVX2);
+  test_st40_udw_all_size(MTL_SIMD_LEVEL_AVX2, MTL_SIMD_LEVEL_NONE);
+  test_st40_udw_all_size(MTL_SIMD_LEVEL_NONE, MTL_SIMD_LEVEL_AVX2);
+}
+TEST(St40, udw_pack_unpack_avx512) {
+  test_st40_udw_all_size(MTL_SIMD_LEVEL_AVX512, MTL_SIMD_LEVEL_AVX512);
+  test_st40_udw_all_size(MTL_SIMD_LEVEL_AVX512, MTL_SIMD_LEVEL_NONE);
+  test_st40_udw_all_size(MTL_SIMD_LEVEL_NONE, MTL_SIMD_LEVEL_AVX512);
+}
+TEST(St40, udw_pack_unpack_expect_fail) {
+  uint8_t data[16];
+  uint8_t udw[4];
+  uint16_t did, sdid;
+  int ret;
+
+  memset(data, 0, sizeof(data));
+  /* all zero words have the wrong parity */
+  ret = st40_unpack_udw(data, sizeof(data), &did, &sdid, udw, sizeof(udw));
+  EXPECT_EQ(ret, -EIO);
+  /* too short for the DID, SDID, DATA_COUNT and checksum */
+  ret = st40_unpack_udw(data, 4, &did, &sdid, udw, sizeof(udw));
+  EXPECT_LT(ret, 0);
+  /* udw buffer too small */
+  uint8_t src[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  st40_pack_udw(0x43, 0x02, src, sizeof(src), data);
+  ret = st40_unpack_udw(data, sizeof(data), &did, &sdid, udw, sizeof(udw));
+  EXPECT_EQ(ret, -ENOSPC);
+}
+
 TEST(St40_tx, create_free_single) { create_free_test(st40_tx, 0, 1, 1); }
 TEST(St40_tx, create_free_multi) { create_free_test(st40_tx, 0, 1, 6); }
 TEST(St40_tx, create_free_mix) { create_free_test(st40_tx, 2, 3, 4); }
@@ -0,0 +1,285 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <thread>
+
+#include "log.h"
+#include "tests.h"
+
+#define ST40P_TEST_PAYLOAD_TYPE (113)
+#define ST40P_TEST_UDP_PORT (18000)
+#define ST40P_TEST_ANC_PER_FRAME (2)
+#define ST40P_TEST_UDW_SIZE (64)
+
+static int test_st40p_tx_frame_available(void* priv) {
+  tests_context* s = (tests_context*)priv;
+
+  s->cv.notify_all();
+
+  return 0;
+}
+
+static int test_st40p_tx_frame_done(void* priv, struct st40p_frame* frame) {
+  tests_context* s = (tests_context*)priv;
+
+  if (!s->handle) return -EIO; /* not ready */
+
+  if (frame->tfmt != ST10_TIMESTAMP_FMT_TAI) s->fail_cnt++;
+  s->fb_send_done++;
+
+  return 0;
+}
+
+static int test_st40p_rx_frame_available(void* priv) {
+  tests_context* s = (tests_context*)priv;
+
+  s->cv.notify_all();
+
+  return 0;
+}
+
+static void st40p_tx_ops_init(tests_context* st40, struct st40p_tx_ops* ops_tx) {
+  auto ctx = st40->ctx;
+
+  memset(ops_tx, 0, sizeof(*ops_tx));
+  ops_tx->name = "st40p_test";
+  ops_tx->priv = st40;
+  ops_tx->port.num_port = 1;
+  memcpy(ops_tx->port.dip_addr[MTL_SESSION_PORT_P], ctx->mcast_ip_addr[MTL_PORT_P],
+         MTL_IP_ADDR_LEN);
+  strncpy(ops_tx->port.port[MTL_SESSION_PORT_P], ctx->para.port[MTL_PORT_P],
+          MTL_PORT_MAX_LEN);
+  ops_tx->port.udp_port[MTL_SESSION_PORT_P] = ST40P_TEST_UDP_PORT + st40->idx;
+  ops_tx->port.payload_type = ST40P_TEST_PAYLOAD_TYPE;
+  ops_tx->fps = ST_FPS_P59_94;
+  ops_tx->framebuff_cnt = st40->fb_cnt;
+  ops_tx->notify_frame_available = test_st40p_tx_frame_available;
+  ops_tx->notify_frame_done = test_st40p_tx_frame_done;
+}
+
+static void st40p_rx_ops_init(tests_context* st40, struct st40p_rx_ops* ops_rx) {
+  auto ctx = st40->ctx;
+
+  memset(ops_rx, 0, sizeof(*ops_rx));
+  ops_rx->name = "st40p_test";
+  ops_rx->priv = st40;
+  ops_rx->port.num_port = 1;
+  memcpy(ops_rx->port.sip_addr[MTL_SESSION_PORT_P], ctx->mcast_ip_addr[MTL_PORT_P],
+         MTL_IP_ADDR_LEN);
+  strncpy(ops_rx->port.port[MTL_SESSION_PORT_P], ctx->para.port[MTL_PORT_R],
+          MTL_PORT_MAX_LEN);
+  ops_rx->port.udp_port[MTL_SESSION_PORT_P] = ST40P_TEST_UDP_PORT + st40->idx;
+  ops_rx->port.payload_type = ST40P_TEST_PAYLOAD_TYPE;
+  ops_rx->framebuff_cnt = st40->fb_cnt;
+  ops_rx->notify_frame_available = test_st40p_rx_frame_available;
+}
+
+static void st40p_tx_assert_cnt(int expect_st40_tx_cnt) {
+  auto ctx = st_test_ctx();
+  auto handle = ctx->handle;
+  struct mtl_stats stats;
+  int ret;
+
+  ret = mtl_get_stats(handle, &stats);
+  EXPECT_GE(ret, 0);
+  EXPECT_EQ(stats.st40_tx_sessions_cnt, expect_st40_tx_cnt);
+}
+
+static void st40p_rx_assert_cnt(int expect_st40_rx_cnt) {
+  auto ctx = st_test_ctx();
+  auto handle = ctx->handle;
+  struct mtl_stats stats;
+  int ret;
+
+  ret = mtl_get_stats(handle, &stats);
+  EXPECT_GE(ret, 0);
+  EXPECT_EQ(stats.st40_rx_sessions_cnt, expect_st40_rx_cnt);
+}
+
+TEST(St40p, tx_create_free_single) { pipeline_create_free_test(st40p_tx, 0, 1, 1); }
+TEST(St40p, tx_create_free_multi) { pipeline_create_free_test(st40p_tx, 0, 1, 6); }
+TEST(St40p, tx_create_free_mix) { pipeline_create_free_test(st40p_tx, 2, 3, 4); }
+TEST(St40p, rx_create_free_single) { pipeline_create_free_test(st40p_rx, 0, 1, 1); }
+TEST(St40p, rx_create_free_multi) { pipeline_create_free_test(st40p_rx, 0, 1, 6); }
+TEST(St40p, rx_create_free_mix) { pipeline_create_free_test(st40p_rx, 2, 3, 4); }
+TEST(St40p, tx_create_expect_fail) { pipeline_expect_fail_test(st40p_tx); }
+TEST(St40p, rx_create_expect_fail) { pipeline_expect_fail_test(st40p_rx); }
+TEST(St40p, tx_create_expect_fail_fb_cnt) {
+  uint16_t fbcnt = 1;
+  pipeline_expect_fail_test_fb_cnt(st40p_tx, fbcnt);
+  fbcnt = ST40P_FB_MAX_COUNT + 1;
+  pipeline_expect_fail_test_fb_cnt(st40p_tx, fbcnt);
+}
+TEST(St40p, rx_create_expect_fail_fb_cnt) {
+  uint16_t fbcnt = 1;
+  pipeline_expect_fail_test_fb_cnt(st40p_rx, fbcnt);
+  fbcnt = ST40P_FB_MAX_COUNT + 1;
+  pipeline_expect_fail_test_fb_cnt(st40p_rx, fbcnt);
+}
+
+static void test_st40p_tx_frame_thread(void* args) {
+  tests_context* s = (tests_context*)args;
+  auto handle = s->handle;
+  struct st40p_frame* frame;
+  struct st40_meta meta;
+  uint8_t udw[ST40P_TEST_UDW_SIZE];
+  std::unique_lock<std::mutex> lck(s->mtx, std::defer_lock);
+
+  dbg("%s(%d), start\n", __func__, s->idx);
+  while (!s->stop) {
+    frame = st40p_tx_get_frame((st40p_tx_handle)handle);
+    if (!frame) { /* no frame */
+      lck.lock();
+      if (!s->stop) s->cv.wait(lck);
+      lck.unlock();
+      continue;
+    }
+
+    for (int i = 0; i < ST40P_TEST_ANC_PER_FRAME; i++) {
+      memset(&meta, 0, sizeof(meta));
+      meta.line_number = 9 + i;
+      meta.hori_offset = i;
+      meta.did = 0x61; /* CEA-708 captions */
+      meta.sdid = 0x01 + i;
+      meta.udw_size = ST40P_TEST_UDW_SIZE;
+      /* udw step from a seed, rx check the continuity */
+      for (int j = 0; j < ST40P_TEST_UDW_SIZE; j++) udw[j] = s->fb_send + i + j;
+      if (st40p_frame_add_anc(frame, &meta, udw) < 0) s->incomplete_frame_cnt++;
+    }
+    st40p_tx_put_frame((st40p_tx_handle)handle, frame);
+    s->fb_send++;
+    if (!s->start_time) s->start_time = st_test_get_monotonic_time();
+  }
+  dbg("%s(%d), stop\n", __func__, s->idx);
+}
+
+static void test_st40p_rx_frame_thread(void* args) {
+  tests_context* s = (tests_context*)args;
+  auto handle = s->handle;
+  struct st40p_frame* frame;
+  std::unique_lock<std::mutex> lck(s->mtx, std::defer_lock);
+
+  dbg("%s(%d), start\n", __func__, s->idx);
+  while (!s->stop) {
+    frame = st40p_rx_get_frame((st40p_rx_handle)handle);
+    if (!frame) { /* no frame */
+      lck.lock();
+      if (!s->stop) s->cv.wait(lck);
+      lck.unlock();
+      continue;
+    }
+
+    if (frame->meta_num != ST40P_TEST_ANC_PER_FRAME) s->incomplete_frame_cnt++;
+    if (frame->err_anc_cnt) s->fail_cnt++;
+    for (uint32_t i = 0; i < frame->meta_num; i++) {
+      struct st40_meta* meta = &frame->meta[i];
+      uint8_t* udw = frame->udw_buf + meta->udw_offset;
+
+      if ((meta->did != 0x61) || (meta->sdid != 0x01 + i) ||
+          (meta->line_number != 9 + i) || (meta->udw_size != ST40P_TEST_UDW_SIZE)) {
+        s->fail_cnt++;
+        continue;
+      }
+      for (int j = 1; j < meta->udw_size; j++) {
+        if (udw[j] != (uint8_t)(udw[0] + j)) {
+          s->fail_cnt++;
+          break;
+        }
+      }
+    }
+    st40p_rx_put_frame((st40p_rx_handle)handle, frame);
+    s->fb_rec++;
+    if (!s->start_time) s->start_time = st_test_get_monotonic_time();
+  }
+  dbg("%s(%d), stop\n", __func__, s->idx);
+}
+
+static void st40p_rx_digest_test(enum st_fps fps, enum st_test_level level) {
+  auto ctx = (struct st_tests_context*)st_test_ctx();
+  auto m_handle = ctx->handle;
+  int ret;
+  struct st40p_tx_ops ops_tx;
+  struct st40p_rx_ops ops_rx;
+
+  if (ctx->para.num_ports != 2) {
+    info("%s, dual port should be enabled for tx test, one for tx and one for rx\n",
+         __func__);
+    return;
+  }
+
+  /* return if level small than global */
+  if (level < ctx->level) return;
+
+  auto test_ctx_tx = new tests_context();
+  ASSERT_TRUE(test_ctx_tx != NULL);
+  test_ctx_tx->idx = 0;
+  test_ctx_tx->ctx = ctx;
+  test_ctx_tx->fb_cnt = 3;
+  st40p_tx_ops_init(test_ctx_tx, &ops_tx);
+  memcpy(ops_tx.port.dip_addr[MTL_SESSION_PORT_P], ctx->para.sip_addr[MTL_PORT_R],
+         MTL_IP_ADDR_LEN);
+  ops_tx.fps = fps;
+  auto tx_handle = st40p_tx_create(m_handle, &ops_tx);
+  ASSERT_TRUE(tx_handle != NULL);
+  test_ctx_tx->handle = tx_handle;
+
+  auto test_ctx_rx = new tests_context();
+  ASSERT_TRUE(test_ctx_rx != NULL);
+  test_ctx_rx->idx = 0;
+  test_ctx_rx->ctx = ctx;
+  test_ctx_rx->fb_cnt = 3;
+  st40p_rx_ops_init(test_ctx_rx, &ops_rx);
+  memcpy(ops_rx.port.sip_addr[MTL_SESSION_PORT_P], ctx->para.sip_addr[MTL_PORT_P],
+         MTL_IP_ADDR_LEN);
+  auto rx_handle = st40p_rx_create(m_handle, &ops_rx);
+  ASSERT_TRUE(rx_handle != NULL);
+  test_ctx_rx->handle = rx_handle;
+
+  struct st_queue_meta q_meta;
+  ret = st40p_rx_get_queue_meta(rx_handle, &q_meta);
+  EXPECT_GE(ret, 0);
+
+  test_ctx_tx->stop = false;
+  test_ctx_rx->stop = false;
+  std::thread tx_thread(test_st40p_tx_frame_thread, test_ctx_tx);
+  std::thread rx_thread(test_st40p_rx_frame_thread, test_ctx_rx);
+
+  ret = mtl_start(m_handle);
+  EXPECT_GE(ret, 0);
+  sleep(10);
+
+  uint64_t cur_time_ns = st_test_get_monotonic_time();
+  double time_sec = (double)(cur_time_ns - test_ctx_rx->start_time) / NS_PER_S;
+  double framerate = test_ctx_rx->fb_rec / time_sec;
+  double expect_framerate = st_frame_rate(fps);
+
+  test_ctx_tx->stop = true;
+  test_ctx_tx->cv.notify_all();
+  tx_thread.join();
+  test_ctx_rx->stop = true;
+  test_ctx_rx->cv.notify_all();
+  rx_thread.join();
+
+  ret = mtl_stop(m_handle);
+  EXPECT_GE(ret, 0);
+
+  EXPECT_GT(test_ctx_rx->fb_rec, 0);
+  EXPECT_GT(test_ctx_tx->fb_send_done, 0);
+  EXPECT_EQ(test_ctx_tx->incomplete_frame_cnt, 0);
+  EXPECT_EQ(test_ctx_tx->fail_cnt, 0);
+  EXPECT_LE(test_ctx_rx->incomplete_frame_cnt, 2);
+  EXPECT_EQ(test_ctx_rx->fail_cnt, 0);
+  EXPECT_NEAR(framerate, expect_framerate, expect_framerate * 0.1);
+  info("%s, fb_rec %d, framerate %f\n", __func__, test_ctx_rx->fb_rec, framerate);
+
+  ret = st40p_tx_free(tx_handle);
+  EXPECT_GE(ret, 0);
+  ret = st40p_rx_free(rx_handle);
+  EXPECT_GE(ret, 0);
+  delete test_ctx_tx;
+  delete test_ctx_rx;
+}
+
+TEST(St40p, digest_p59) { st40p_rx_digest_test(ST_FPS_P59_94, ST_TEST_LEVEL_MANDATORY); }
+TEST(St40p, digest_p50) { st40p_rx_digest_test(ST_FPS_P50, ST_TEST_LEVEL_ALL); }
@@ -560,7 +560,7 @@ GTEST_API_ int main(int argc, char** argv) {
   /* parse af xdp pmd info */
   for (int i = 0; i < ctx->para.num_ports; i++) {
     ctx->para.pmd[i] = mtl_pmd_by_port_name(ctx->para.port[i]);
-    if (ctx->para.pmd[i] != MTL_PMD_DPDK_USER) {
+    if (ctx->para.pmd[i] == MTL_PMD_DPDK_AF_XDP) {
       mtl_get_if_ip(ctx->para.port[i], ctx->para.sip_addr[i], ctx->para.netmask[i]);
       ctx->para.flags |= MTL_FLAG_RX_SEPARATE_VIDEO_LCORE;
       ctx->para.tx_sessions_cnt_max = 8;
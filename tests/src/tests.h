@@ -8,7 +8,9 @@
 #include <inttypes.h>
 #include <math.h>
 #include <mtl/st30_api.h>
+#include <mtl/st30_pipeline_api.h>
 #include <mtl/st40_api.h>
+#include <mtl/st40_pipeline_api.h>
 #include <mtl/st_convert_api.h>
 #include <mtl/st_pipeline_api.h>
 
@@ -590,6 +592,42 @@ int tx_next_frame(void* priv, uint16_t* next_frame_idx);
     delete test_ctx;                                     \
   } while (0)
 
+#define pipeline_create_free_redundant_test(A)                                      \
+  do {                                                                              \
+    auto ctx = st_test_ctx();                                                       \
+    auto m_handle = ctx->handle;                                                    \
+    int ret;                                                                        \
+    struct A##_ops ops;                                                             \
+                                                                                    \
+    if (ctx->para.num_ports != 2) {                                                 \
+      info("%s, dual port should be enabled for redundant\n", __func__);            \
+      break;                                                                        \
+    }                                                                               \
+    auto test_ctx = new tests_context();                                            \
+    ASSERT_TRUE(test_ctx != NULL);                                                  \
+                                                                                    \
+    test_ctx->idx = 0;                                                              \
+    test_ctx->ctx = ctx;                                                            \
+    test_ctx->fb_cnt = 2;                                                           \
+    test_ctx->fb_idx = 0;                                                           \
+    A##_ops_init(test_ctx, &ops);                                                   \
+    ops.port.num_port = 2;                                                          \
+    memcpy(ops.port.dip_addr[MTL_SESSION_PORT_R], ctx->mcast_ip_addr[MTL_PORT_R],   \
+           MTL_IP_ADDR_LEN);                                                        \
+    strncpy(ops.port.port[MTL_SESSION_PORT_R], ctx->para.port[MTL_PORT_R],          \
+            MTL_PORT_MAX_LEN);                                                      \
+    ops.port.udp_port[MTL_SESSION_PORT_R] = ops.port.udp_port[MTL_SESSION_PORT_P]; \
+                                                                                    \
+    A##_handle handle = A##_create(m_handle, &ops);                                 \
+    ASSERT_TRUE(handle != NULL);                                                    \
+    A##_assert_cnt(1);                                                              \
+    ret = A##_free(handle);                                                         \
+    EXPECT_GE(ret, 0);                                                              \
+    A##_assert_cnt(0);                                                              \
+                                                                                    \
+    delete test_ctx;                                                                \
+  } while (0)
+
 #define pipeline_create_free_max(A, max)                    \
   do {                                                      \
     auto ctx = st_test_ctx();                               \
@@ -0,0 +1,828 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <net/ethernet.h>
+#include <netinet/ip.h>
+#include <netinet/udp.h>
+#include <pcap.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mtl_ebu_api.h"
+
+#define NS_PER_S (1000000000)
+#define EA_FLOW_MAX (16)
+#define EA_RTP_HDR_LEN (12)
+/* frames to detect the video format before the analysis */
+#define EA_VIDEO_DETECT_FRAMES (4)
+/* number of bins of each histogram, the last bin also count the overflow */
+#define EA_HIST_BINS (64)
+/* audio pkts of one dpvr/tsdf check period, 1s for 1ms packet time */
+#define EA_AUDIO_PERIOD_PKTS (1000)
+
+enum ea_args_cmd {
+  EA_ARG_UNKNOWN = 0,
+  EA_ARG_PCAP = 0x100, /* start from end of ascii */
+  EA_ARG_IFACE,
+  EA_ARG_VIDEO,
+  EA_ARG_AUDIO,
+  EA_ARG_ANC,
+  EA_ARG_UTC_OFFSET,
+  EA_ARG_REPORT_S,
+};
+
+enum ea_flow_type {
+  EA_FLOW_VIDEO = 0,
+  EA_FLOW_AUDIO,
+  EA_FLOW_ANC,
+};
+
+struct ea_hist {
+  const char* name;
+  const char* unit;
+  double bin_width;
+  uint32_t bins[EA_HIST_BINS];
+  uint64_t cnt;
+};
+
+/* the per frame results of one timing model, gapped or linear */
+struct ea_video_model {
+  struct mtl_ebu_video_info info;
+  struct mtl_ebu_video_frame frame;
+  int32_t cinst_max;
+  int32_t vrx_min;
+  int32_t vrx_max;
+  uint32_t narrow;
+  uint32_t wide;
+  uint32_t fail;
+};
+
+struct ea_video {
+  /* detect */
+  bool detected;
+  int detect_frames;
+  uint32_t detect_pkts;
+  uint32_t detect_first_ts;
+  uint32_t max_row;
+  bool interlaced;
+  uint32_t pkts_per_frame;
+  double fps;
+
+  /* analysis */
+  struct ea_video_model gapped;
+  struct ea_video_model linear;
+  int pkt_idx;
+  uint64_t frames;
+  uint64_t frames_incomplete;
+  uint32_t fpt_fail;
+  uint32_t latency_fail;
+  uint32_t rtp_offset_fail;
+  uint32_t rtp_ts_delta_fail;
+  struct ea_hist cinst_hist;
+  struct ea_hist vrx_hist;
+  struct ea_hist tpr0_hist;
+};
+
+struct ea_audio {
+  struct mtl_ebu_audio_info info;
+  bool detected;
+  uint32_t detect_pkts;
+  uint64_t detect_first_time;
+  uint32_t detect_first_ts;
+  uint32_t sampling_rate;
+  double pkt_time;
+  bool pkt_time_std;
+
+  uint32_t period_pkts;
+  double dpvr_min;
+  double dpvr_max;
+  double dpvr_sum;
+  uint32_t periods;
+  uint32_t dpvr_narrow;
+  uint32_t dpvr_wide;
+  uint32_t dpvr_fail;
+  uint32_t tsdf_pass;
+  uint32_t tsdf_fail;
+  double tsdf_max;
+  uint64_t pkt_time_ts_err;
+};
+
+struct ea_anc {
+  uint64_t frames;
+  uint32_t frame_ts;
+  bool marker_seen;
+  uint32_t prev_frame_ts;
+  uint32_t rtp_ts_delta;
+  uint64_t rtp_ts_delta_err;
+  uint64_t marker_missing;
+  uint64_t malformed;
+  uint64_t field_invalid;
+  uint64_t anc_packets;
+};
+
+struct ea_flow {
+  enum ea_flow_type type;
+  uint16_t dst_port;
+  uint32_t dst_ip; /* the first dst ip seen on the port, network order */
+  bool active;
+
+  uint64_t pkts;
+  uint64_t seq_gaps;
+  uint16_t prev_seq;
+  uint32_t prev_ts;
+  bool prev_marker;
+
+  union {
+    struct ea_video video;
+    struct ea_audio audio;
+    struct ea_anc anc;
+  };
+};
+
+struct ea_context {
+  char pcap_file[256];
+  char iface[64];
+  int utc_offset;
+  int report_s;
+
+  struct ea_flow flows[EA_FLOW_MAX];
+  int nb_flows;
+
+  uint64_t first_pkt_time;
+  uint64_t last_report_time;
+  uint64_t pkts;
+  uint64_t pkts_ignored;
+};
+
+static pcap_t* g_pcap;
+
+static struct option ea_args_options[] = {
+    {"pcap", required_argument, 0, EA_ARG_PCAP},
+    {"iface", required_argument, 0, EA_ARG_IFACE},
+    {"video", required_argument, 0, EA_ARG_VIDEO},
+    {"audio", required_argument, 0, EA_ARG_AUDIO},
+    {"anc", required_argument, 0, EA_ARG_ANC},
+    {"utc_offset", required_argument, 0, EA_ARG_UTC_OFFSET},
+    {"report_s", required_argument, 0, EA_ARG_REPORT_S},
+
+    {0, 0, 0, 0}};
+
+static const char* ea_flow_type_names[] = {"video", "audio", "anc"};
+
+/* the standard ST2110-30 packet time in ns */
+static const double ea_audio_pkt_times[] = {1000000, 125000, 250000,
+                                            333333,  4000000, 80000};
+
+static const double ea_video_fps[] = {
+    24000.0 / 1001, 24, 25, 30000.0 / 1001, 30,  50,
+    60000.0 / 1001, 60, 100, 120000.0 / 1001, 120};
+
+static void ea_sig_handler(int signo) {
+  if (signo == SIGINT && g_pcap) pcap_breakloop(g_pcap);
+}
+
+static void ea_hist_init(struct ea_hist* hist, const char* name, const char* unit,
+                         double bin_width) {
+  memset(hist, 0, sizeof(*hist));
+  hist->name = name;
+  hist->unit = unit;
+  hist->bin_width = bin_width > 0 ? bin_width : 1;
+}
+
+static void ea_hist_add(struct ea_hist* hist, double value) {
+  int bin = value < 0 ? 0 : (int)(value / hist->bin_width);
+
+  if (bin >= EA_HIST_BINS) bin = EA_HIST_BINS - 1;
+  hist->bins[bin]++;
+  hist->cnt++;
+}
+
+static void ea_hist_dump(struct ea_hist* hist) {
+  if (!hist->cnt) return;
+
+  printf("  %s histogram(%s), %" PRIu64 " frames\n", hist->name, hist->unit, hist->cnt);
+  for (int i = 0; i < EA_HIST_BINS; i++) {
+    if (!hist->bins[i]) continue;
+    printf("    [%8.1f, %8.1f%s: %8u %6.2f%%\n", i * hist->bin_width,
+           (i + 1) * hist->bin_width, (i == EA_HIST_BINS - 1) ? "+)" : ") ",
+           hist->bins[i], (double)hist->bins[i] * 100 / hist->cnt);
+  }
+}
+
+static int ea_add_flow(struct ea_context* ctx, enum ea_flow_type type, const char* port) {
+  struct ea_flow* flow;
+
+  if (ctx->nb_flows >= EA_FLOW_MAX) {
+    printf("%s, max %d flows\n", __func__, EA_FLOW_MAX);
+    return -EINVAL;
+  }
+  flow = &ctx->flows[ctx->nb_flows];
+  memset(flow, 0, sizeof(*flow));
+  flow->type = type;
+  flow->dst_port = atoi(port);
+  if (!flow->dst_port) {
+    printf("%s, invalid udp port %s\n", __func__, port);
+    return -EINVAL;
+  }
+  ctx->nb_flows++;
+  return 0;
+}
+
+static int ea_parse_args(struct ea_context* ctx, int argc, char** argv) {
+  int cmd = -1, opt_idx = 0, ret;
+
+  while (1) {
+    cmd = getopt_long_only(argc, argv, "hv", ea_args_options, &opt_idx);
+    if (cmd == -1) break;
+
+    switch (cmd) {
+      case EA_ARG_PCAP:
+        snprintf(ctx->pcap_file, sizeof(ctx->pcap_file), "%s", optarg);
+        break;
+      case EA_ARG_IFACE:
+        snprintf(ctx->iface, sizeof(ctx->iface), "%s", optarg);
+        break;
+      case EA_ARG_VIDEO:
+        ret = ea_add_flow(ctx, EA_FLOW_VIDEO, optarg);
+        if (ret < 0) return ret;
+        break;
+      case EA_ARG_AUDIO:
+        ret = ea_add_flow(ctx, EA_FLOW_AUDIO, optarg);
+        if (ret < 0) return ret;
+        break;
+      case EA_ARG_ANC:
+        ret = ea_add_flow(ctx, EA_FLOW_ANC, optarg);
+        if (ret < 0) return ret;
+        break;
+      case EA_ARG_UTC_OFFSET:
+        ctx->utc_offset = atoi(optarg);
+        break;
+      case EA_ARG_REPORT_S:
+        ctx->report_s = atoi(optarg);
+        break;
+      default:
+        break;
+    }
+  };
+
+  return 0;
+}
+
+static struct ea_flow* ea_find_flow(struct ea_context* ctx, uint16_t dst_port) {
+  for (int i = 0; i < ctx->nb_flows; i++) {
+    if (ctx->flows[i].dst_port == dst_port) return &ctx->flows[i];
+  }
+  return NULL;
+}
+
+static const char* ea_result_name(enum mtl_ebu_result result) {
+  switch (result) {
+    case MTL_EBU_PASS_NARROW:
+      return "narrow";
+    case MTL_EBU_PASS_WIDE:
+      return "wide";
+    case MTL_EBU_PASS:
+      return "pass";
+    default:
+      return "fail";
+  }
+}
+
+static void ea_video_model_clear(struct ea_video_model* model) {
+  model->cinst_max = 0;
+  model->vrx_min = INT32_MAX;
+  model->vrx_max = INT32_MIN;
+}
+
+/* the capture time is accurate, no workaround for the sw rx time */
+static enum mtl_ebu_result ea_video_model_frame(struct ea_video_model* model) {
+  enum mtl_ebu_result cinst = mtl_ebu_video_cinst_check(&model->info, model->cinst_max);
+  /* same thresholds as the lib rx check, a report differs only by the timestamps */
+  enum mtl_ebu_result vrx =
+      mtl_ebu_video_vrx_check(&model->info, model->vrx_min, model->vrx_max);
+
+  if ((cinst == MTL_EBU_PASS_NARROW) && (vrx == MTL_EBU_PASS_NARROW)) {
+    model->narrow++;
+    return MTL_EBU_PASS_NARROW;
+  }
+  if (((cinst == MTL_EBU_PASS_NARROW) || (cinst == MTL_EBU_PASS_WIDE)) &&
+      ((vrx == MTL_EBU_PASS_NARROW) || (vrx == MTL_EBU_PASS_WIDE))) {
+    model->wide++;
+    return MTL_EBU_PASS_WIDE;
+  }
+  model->fail++;
+  return MTL_EBU_FAIL;
+}
+
+static void ea_video_model_pkt(struct ea_video_model* model, uint32_t rtp_ts,
+                               uint64_t pkt_time, int pkt_idx) {
+  if (!pkt_idx) mtl_ebu_video_on_frame(&model->info, &model->frame, rtp_ts, pkt_time);
+  mtl_ebu_video_on_packet(&model->info, &model->frame, pkt_time, pkt_idx);
+  if (model->frame.cinst > model->cinst_max) model->cinst_max = model->frame.cinst;
+  if (model->frame.vrx < model->vrx_min) model->vrx_min = model->frame.vrx;
+  if (model->frame.vrx > model->vrx_max) model->vrx_max = model->frame.vrx;
+}
+
+static void ea_video_frame_done(struct ea_flow* flow) {
+  struct ea_video* v = &flow->video;
+  struct mtl_ebu_video_frame* frame = &v->gapped.frame;
+  struct mtl_ebu_video_info* info = &v->gapped.info;
+
+  if (v->pkt_idx != (int)v->pkts_per_frame) v->frames_incomplete++;
+  v->frames++;
+
+  ea_video_model_frame(&v->gapped);
+  ea_video_model_frame(&v->linear);
+
+  ea_hist_add(&v->cinst_hist, v->gapped.cinst_max);
+  ea_hist_add(&v->vrx_hist, v->gapped.vrx_max);
+  ea_hist_add(&v->tpr0_hist, frame->fpt / 1000);
+
+  if (mtl_ebu_video_fpt_check(info, frame->fpt) != MTL_EBU_PASS) v->fpt_fail++;
+  if (mtl_ebu_video_latency_check(frame->latency, frame->latency) == MTL_EBU_FAIL)
+    v->latency_fail++;
+  if (mtl_ebu_video_rtp_offset_check(info, frame->rtp_offset, frame->rtp_offset) ==
+      MTL_EBU_FAIL)
+    v->rtp_offset_fail++;
+  if (frame->has_rtp_ts_delta &&
+      (mtl_ebu_video_rtp_ts_delta_check(info, frame->rtp_ts_delta,
+                                        frame->rtp_ts_delta) == MTL_EBU_FAIL))
+    v->rtp_ts_delta_fail++;
+}
+
+static int ea_video_init_analysis(struct ea_flow* flow) {
+  struct ea_video* v = &flow->video;
+  uint32_t height = v->interlaced ? (v->max_row + 1) * 2 : v->max_row + 1;
+  double frame_time = (double)NS_PER_S / v->fps;
+  int ret;
+
+  ret = mtl_ebu_video_info_init(&v->gapped.info, frame_time, 90000, height, v->interlaced,
+                                v->pkts_per_frame, false);
+  if (ret < 0) return ret;
+  ret = mtl_ebu_video_info_init(&v->linear.info, frame_time, 90000, height, v->interlaced,
+                                v->pkts_per_frame, true);
+  if (ret < 0) return ret;
+
+  ea_hist_init(&v->cinst_hist, "Cinst max", "pkts", 1);
+  ea_hist_init(&v->vrx_hist, "VRX max", "pkts",
+               (double)v->gapped.info.vrx_full_wide_pass / (EA_HIST_BINS - 1));
+  ea_hist_init(&v->tpr0_hist, "TPR0", "us",
+               v->gapped.info.tr_offset * 2 / 1000 / (EA_HIST_BINS - 1));
+
+  printf("video(%u): detected %u lines%s %.2f fps, %u pkts per frame\n", flow->dst_port,
+         height, v->interlaced ? "i" : "p", v->fps, v->pkts_per_frame);
+  printf("video(%u): trs %.2fns(gapped) %.2fns(linear), tr offset %.2fns\n",
+         flow->dst_port, v->gapped.info.trs, v->linear.info.trs,
+         v->gapped.info.tr_offset);
+  printf("video(%u): cmax narrow %u wide %u, vrx full narrow %u wide %u\n",
+         flow->dst_port, v->gapped.info.c_max_narrow_pass, v->gapped.info.c_max_wide_pass,
+         v->gapped.info.vrx_full_narrow_pass, v->gapped.info.vrx_full_wide_pass);
+  v->detected = true;
+  return 0;
+}
+
+/* detect the fps, the dimension and the pkts per frame by the first frames */
+static void ea_video_detect(struct ea_flow* flow, const uint8_t* payload, uint32_t len,
+                            uint32_t rtp_ts, bool marker) {
+  struct ea_video* v = &flow->video;
+  double frame_time_sampling, best = 0;
+
+  /* the rfc4175 hdr: extended seq(2), then the first srd: length(2), f|row(2) */
+  if (len >= 6) {
+    uint16_t row = ntohs(*(uint16_t*)(payload + 4));
+    if (row & 0x8000) v->interlaced = true;
+    row &= 0x7fff;
+    if (row > v->max_row) v->max_row = row;
+  }
+
+  /* wait the first marker to start from a frame boundary */
+  if (v->detect_frames < 0) {
+    if (marker) v->detect_frames = 0;
+    return;
+  }
+  if (!v->detect_frames && !v->detect_pkts) v->detect_first_ts = rtp_ts;
+  v->detect_pkts++;
+  if (!marker) return;
+
+  v->detect_frames++;
+  if (v->detect_frames == 1) v->pkts_per_frame = v->detect_pkts;
+  if (v->detect_pkts != v->pkts_per_frame * v->detect_frames) {
+    /* pkts lost, restart the detect */
+    v->detect_frames = 0;
+    v->detect_pkts = 0;
+    return;
+  }
+  if (v->detect_frames < EA_VIDEO_DETECT_FRAMES) return;
+
+  /* the rtp ts of the first frame to the last frame */
+  frame_time_sampling = (double)(rtp_ts - v->detect_first_ts) / (v->detect_frames - 1);
+  for (size_t i = 0; i < sizeof(ea_video_fps) / sizeof(ea_video_fps[0]); i++) {
+    double diff = frame_time_sampling - 90000 / ea_video_fps[i];
+    if (diff < 0) diff = -diff;
+    if (!v->fps || diff < best) {
+      v->fps = ea_video_fps[i];
+      best = diff;
+    }
+  }
+  if (ea_video_init_analysis(flow) < 0) {
+    printf("video(%u): detect fail\n", flow->dst_port);
+    v->detect_frames = 0;
+    v->detect_pkts = 0;
+    v->fps = 0;
+  }
+}
+
+static void ea_video_pkt(struct ea_flow* flow, const uint8_t* payload, uint32_t len,
+                         uint32_t rtp_ts, bool marker, uint64_t pkt_time) {
+  struct ea_video* v = &flow->video;
+
+  if (!v->detected) {
+    ea_video_detect(flow, payload, len, rtp_ts, marker);
+    return;
+  }
+
+  /* a new frame on a new rtp ts, also if the marker pkt of the prev frame lost */
+  if (v->pkt_idx && (rtp_ts != flow->prev_ts)) {
+    ea_video_frame_done(flow);
+    v->pkt_idx = 0;
+  }
+  if (!v->pkt_idx) {
+    ea_video_model_clear(&v->gapped);
+    ea_video_model_clear(&v->linear);
+  }
+  ea_video_model_pkt(&v->gapped, rtp_ts, pkt_time, v->pkt_idx);
+  ea_video_model_pkt(&v->linear, rtp_ts, pkt_time, v->pkt_idx);
+  v->pkt_idx++;
+
+  if (marker) {
+    ea_video_frame_done(flow);
+    v->pkt_idx = 0;
+  }
+}
+
+static void ea_audio_period_done(struct ea_audio* a) {
+  double dpvr_avg = a->dpvr_sum / a->period_pkts;
+  double tsdf = a->dpvr_max - a->dpvr_min;
+
+  switch (mtl_ebu_audio_dpvr_check(&a->info, a->dpvr_max, dpvr_avg)) {
+    case MTL_EBU_PASS_NARROW:
+      a->dpvr_narrow++;
+      break;
+    case MTL_EBU_PASS_WIDE:
+      a->dpvr_wide++;
+      break;
+    default:
+      a->dpvr_fail++;
+      break;
+  }
+  if (mtl_ebu_audio_tsdf_check(&a->info, tsdf) == MTL_EBU_PASS)
+    a->tsdf_pass++;
+  else
+    a->tsdf_fail++;
+  if (tsdf > a->tsdf_max) a->tsdf_max = tsdf;
+  a->periods++;
+
+  a->period_pkts = 0;
+  a->dpvr_sum = 0;
+}
+
+static void ea_audio_detect(struct ea_flow* flow, uint32_t rtp_ts, uint64_t pkt_time) {
+  struct ea_audio* a = &flow->audio;
+  uint32_t samples;
+  double pkt_time_avg;
+
+  if (!a->detect_pkts) {
+    a->detect_first_time = pkt_time;
+    a->detect_first_ts = rtp_ts;
+  }
+  a->detect_pkts++;
+  if (a->detect_pkts <= 100) return;
+
+  /* the samples per pkt by the rtp ts and the sampling rate by the rx time */
+  samples = (rtp_ts - a->detect_first_ts) / (a->detect_pkts - 1);
+  pkt_time_avg = (double)(pkt_time - a->detect_first_time) / (a->detect_pkts - 1);
+  if (!samples || pkt_time_avg <= 0) {
+    a->detect_pkts = 0;
+    return;
+  }
+  double rate = samples * (double)NS_PER_S / pkt_time_avg;
+  if (rate < (44100 + 48000) / 2)
+    a->sampling_rate = 44100;
+  else if (rate < (48000 + 96000) / 2)
+    a->sampling_rate = 48000;
+  else
+    a->sampling_rate = 96000;
+  a->pkt_time = (double)samples * NS_PER_S / a->sampling_rate;
+
+  for (size_t i = 0; i < sizeof(ea_audio_pkt_times) / sizeof(ea_audio_pkt_times[0]);
+       i++) {
+    double diff = a->pkt_time - ea_audio_pkt_times[i];
+    if (diff < 0) diff = -diff;
+    if (diff < ea_audio_pkt_times[i] / 100) a->pkt_time_std = true;
+  }
+
+  mtl_ebu_audio_info_init(&a->info, a->pkt_time, a->sampling_rate);
+  a->dpvr_min = INT32_MAX;
+  a->dpvr_max = INT32_MIN;
+  printf("audio(%u): detected %u hz, %u samples per pkt, packet time %.2fus%s\n",
+         flow->dst_port, a->sampling_rate, samples, a->pkt_time / 1000,
+         a->pkt_time_std ? "" : " not a ST2110-30 packet time");
+  a->detected = true;
+}
+
+static void ea_audio_pkt(struct ea_flow* flow, uint32_t rtp_ts, uint64_t pkt_time) {
+  struct ea_audio* a = &flow->audio;
+  double dpvr;
+
+  if (!a->detected) {
+    ea_audio_detect(flow, rtp_ts, pkt_time);
+    return;
+  }
+
+  /* the samples of each pkt should be same */
+  if ((uint32_t)(rtp_ts - flow->prev_ts) != (uint32_t)(a->info.pkt_time_sampling + 0.5))
+    a->pkt_time_ts_err++;
+
+  dpvr = mtl_ebu_audio_dpvr(&a->info, rtp_ts, pkt_time);
+  if (!a->period_pkts) {
+    a->dpvr_min = dpvr;
+    a->dpvr_max = dpvr;
+  }
+  if (dpvr < a->dpvr_min) a->dpvr_min = dpvr;
+  if (dpvr > a->dpvr_max) a->dpvr_max = dpvr;
+  a->dpvr_sum += dpvr;
+  a->period_pkts++;
+  if (a->period_pkts >= EA_AUDIO_PERIOD_PKTS) ea_audio_period_done(a);
+}
+
+/* rfc8331 hdr: extended seq(2), length(2), anc_count(1), f(2 bits) + reserved */
+static void ea_anc_pkt(struct ea_flow* flow, const uint8_t* payload, uint32_t len,
+                       uint32_t rtp_ts, bool marker) {
+  struct ea_anc* anc = &flow->anc;
+
+  if (len < 8) {
+    anc->malformed++;
+  } else {
+    uint16_t length = ntohs(*(uint16_t*)(payload + 2));
+    uint8_t f = payload[5] >> 6;
+
+    if (length > len - 8) anc->malformed++;
+    if (f == 0x1) anc->field_invalid++;
+    anc->anc_packets += payload[4];
+  }
+
+  if (anc->frames && rtp_ts != anc->frame_ts) {
+    /* new frame, the last pkt of the prev frame should have the marker */
+    if (!anc->marker_seen) anc->marker_missing++;
+    uint32_t delta = rtp_ts - anc->frame_ts;
+    if (!anc->rtp_ts_delta)
+      anc->rtp_ts_delta = delta;
+    else if ((delta != anc->rtp_ts_delta) && (delta != anc->rtp_ts_delta + 1) &&
+             (delta + 1 != anc->rtp_ts_delta))
+      anc->rtp_ts_delta_err++;
+  }
+  if (!anc->frames || rtp_ts != anc->frame_ts) {
+    anc->frames++;
+    anc->frame_ts = rtp_ts;
+    anc->marker_seen = false;
+  }
+  if (marker) anc->marker_seen = true;
+}
+
+static double ea_rate(uint32_t cnt, uint64_t total) {
+  return total ? (double)cnt * 100 / total : 0;
+}
+
+static void ea_video_report(struct ea_flow* flow) {
+  struct ea_video* v = &flow->video;
+  struct ea_video_model* g = &v->gapped;
+  struct ea_video_model* l = &v->linear;
+  const char* sender;
+
+  if (!v->frames) {
+    printf("video(%u): no frame analyzed, pkts %" PRIu64 "\n", flow->dst_port,
+           flow->pkts);
+    return;
+  }
+
+  if (!g->wide && !g->fail)
+    sender = "narrow(N)";
+  else if (!l->wide && !l->fail)
+    sender = "narrow linear(NL)";
+  else if (!g->fail || !l->fail)
+    sender = "wide(W)";
+  else
+    sender = "non-compliant";
+
+  printf("video(%u): sender %s, frames %" PRIu64 " incomplete %" PRIu64
+         " seq gaps %" PRIu64 "\n",
+         flow->dst_port, sender, v->frames, v->frames_incomplete, flow->seq_gaps);
+  printf("  gapped: narrow %.2f%% wide %.2f%% fail %.2f%%\n",
+         ea_rate(g->narrow, v->frames), ea_rate(g->wide, v->frames),
+         ea_rate(g->fail, v->frames));
+  printf("  linear: narrow %.2f%% wide %.2f%% fail %.2f%%\n",
+         ea_rate(l->narrow, v->frames), ea_rate(l->wide, v->frames),
+         ea_rate(l->fail, v->frames));
+  printf("  fail rate: TPR0 %.2f%% latency %.2f%% rtp offset %.2f%% ts delta %.2f%%\n",
+         ea_rate(v->fpt_fail, v->frames), ea_rate(v->latency_fail, v->frames),
+         ea_rate(v->rtp_offset_fail, v->frames),
+         ea_rate(v->rtp_ts_delta_fail, v->frames));
+  ea_hist_dump(&v->cinst_hist);
+  ea_hist_dump(&v->vrx_hist);
+  ea_hist_dump(&v->tpr0_hist);
+}
+
+static void ea_audio_report(struct ea_flow* flow) {
+  struct ea_audio* a = &flow->audio;
+
+  if (!a->periods) {
+    printf("audio(%u): no period analyzed, pkts %" PRIu64 "\n", flow->dst_port,
+           flow->pkts);
+    return;
+  }
+
+  printf("audio(%u): packet time %.2fus %s, ts errors %" PRIu64 " seq gaps %" PRIu64 "\n",
+         flow->dst_port, a->pkt_time / 1000, a->pkt_time_std ? "pass" : "fail",
+         a->pkt_time_ts_err, flow->seq_gaps);
+  printf("  dpvr: narrow %.2f%% wide %.2f%% fail %.2f%%, tsdf max %.2fus %s\n",
+         ea_rate(a->dpvr_narrow, a->periods), ea_rate(a->dpvr_wide, a->periods),
+         ea_rate(a->dpvr_fail, a->periods), a->tsdf_max,
+         a->tsdf_fail ? ea_result_name(MTL_EBU_FAIL) : ea_result_name(MTL_EBU_PASS));
+}
+
+static void ea_anc_report(struct ea_flow* flow) {
+  struct ea_anc* anc = &flow->anc;
+
+  printf("anc(%u): frames %" PRIu64 " anc packets %" PRIu64 ", rtp ts delta %u\n",
+         flow->dst_port, anc->frames, anc->anc_packets, anc->rtp_ts_delta);
+  printf("  marker missing %" PRIu64 " rtp ts delta errors %" PRIu64
+         " malformed %" PRIu64 " invalid field %" PRIu64 " seq gaps %" PRIu64 "\n",
+         anc->marker_missing, anc->rtp_ts_delta_err, anc->malformed, anc->field_invalid,
+         flow->seq_gaps);
+}
+
+static void ea_report(struct ea_context* ctx) {
+  printf("\n--- pkts %" PRIu64 " ignored %" PRIu64 " ---\n", ctx->pkts,
+         ctx->pkts_ignored);
+  for (int i = 0; i < ctx->nb_flows; i++) {
+    struct ea_flow* flow = &ctx->flows[i];
+
+    if (!flow->active) {
+      printf("%s(%u): no pkt\n", ea_flow_type_names[flow->type], flow->dst_port);
+      continue;
+    }
+    if (flow->type == EA_FLOW_VIDEO)
+      ea_video_report(flow);
+    else if (flow->type == EA_FLOW_AUDIO)
+      ea_audio_report(flow);
+    else
+      ea_anc_report(flow);
+  }
+}
+
+static void ea_pkt_handler(u_char* priv, const struct pcap_pkthdr* pkthdr,
+                           const u_char* pkt) {
+  struct ea_context* ctx = (struct ea_context*)priv;
+  /* ns precision, tv_usec is ns */
+  uint64_t pkt_time = (uint64_t)pkthdr->ts.tv_sec * NS_PER_S + pkthdr->ts.tv_usec;
+  uint32_t len = pkthdr->caplen, offset = sizeof(struct ether_header);
+  const struct ether_header* eth = (const struct ether_header*)pkt;
+  uint16_t ether_type;
+  const struct ip* ip;
+  const struct udphdr* udp;
+  const uint8_t* rtp;
+  struct ea_flow* flow;
+
+  ctx->pkts++;
+  /* to the ptp(tai) time */
+  pkt_time += (uint64_t)ctx->utc_offset * NS_PER_S;
+
+  if (len < offset) goto ignore;
+  ether_type = ntohs(eth->ether_type);
+  if (ether_type == ETHERTYPE_VLAN) {
+    if (len < offset + 4) goto ignore;
+    ether_type = ntohs(*(uint16_t*)(pkt + offset + 2));
+    offset += 4;
+  }
+  if (ether_type != ETHERTYPE_IP) goto ignore;
+  if (len < offset + sizeof(*ip)) goto ignore;
+  ip = (const struct ip*)(pkt + offset);
+  if (ip->ip_p != IPPROTO_UDP) goto ignore;
+  offset += ip->ip_hl * 4;
+  if (len < offset + sizeof(*udp) + EA_RTP_HDR_LEN) goto ignore;
+  udp = (const struct udphdr*)(pkt + offset);
+  flow = ea_find_flow(ctx, ntohs(udp->uh_dport));
+  if (!flow) goto ignore;
+  offset += sizeof(*udp);
+  rtp = pkt + offset;
+
+  if (!flow->active) {
+    flow->active = true;
+    flow->dst_ip = ip->ip_dst.s_addr;
+    flow->prev_marker = true;
+    if (flow->type == EA_FLOW_VIDEO) flow->video.detect_frames = -1;
+  } else if (flow->dst_ip != ip->ip_dst.s_addr) {
+    goto ignore; /* same port but other stream */
+  }
+  if (!ctx->first_pkt_time) {
+    ctx->first_pkt_time = pkt_time;
+    ctx->last_report_time = pkt_time;
+  }
+
+  uint16_t seq = ntohs(*(uint16_t*)(rtp + 2));
+  uint32_t rtp_ts = ntohl(*(uint32_t*)(rtp + 4));
+  bool marker = (rtp[1] & 0x80) ? true : false;
+  const uint8_t* payload = rtp + EA_RTP_HDR_LEN;
+  uint32_t payload_len = len - offset - EA_RTP_HDR_LEN;
+
+  if (flow->pkts && (uint16_t)(flow->prev_seq + 1) != seq) flow->seq_gaps++;
+  flow->pkts++;
+
+  if (flow->type == EA_FLOW_VIDEO)
+    ea_video_pkt(flow, payload, payload_len, rtp_ts, marker, pkt_time);
+  else if (flow->type == EA_FLOW_AUDIO)
+    ea_audio_pkt(flow, rtp_ts, pkt_time);
+  else
+    ea_anc_pkt(flow, payload, payload_len, rtp_ts, marker);
+
+  flow->prev_seq = seq;
+  flow->prev_ts = rtp_ts;
+  flow->prev_marker = marker;
+
+  if (ctx->report_s &&
+      (pkt_time - ctx->last_report_time >= (uint64_t)ctx->report_s * NS_PER_S)) {
+    ea_report(ctx);
+    ctx->last_report_time = pkt_time;
+  }
+  return;
+
+ignore:
+  ctx->pkts_ignored++;
+}
+
+static pcap_t* ea_open_live(const char* iface, char* errbuf) {
+  pcap_t* p = pcap_create(iface, errbuf);
+  if (!p) return NULL;
+
+  pcap_set_snaplen(p, 2048);
+  pcap_set_promisc(p, 1);
+  pcap_set_immediate_mode(p, 1);
+  pcap_set_tstamp_precision(p, PCAP_TSTAMP_PRECISION_NANO);
+  /* the nic rx time if supported, the sw time is not accurate for the Cinst and VRX */
+  if (pcap_set_tstamp_type(p, PCAP_TSTAMP_ADAPTER) != 0)
+    printf("no adapter timestamp on %s, use host time\n", iface);
+  if (pcap_activate(p) < 0) {
+    snprintf(errbuf, PCAP_ERRBUF_SIZE, "%s", pcap_geterr(p));
+    pcap_close(p);
+    return NULL;
+  }
+  return p;
+}
+
+int main(int argc, char** argv) {
+  struct ea_context ctx;
+  char errbuf[PCAP_ERRBUF_SIZE];
+  int ret;
+
+  memset(&ctx, 0, sizeof(ctx));
+  ctx.utc_offset = 37; /* the tai to utc offset of the capture time */
+  ret = ea_parse_args(&ctx, argc, argv);
+  if (ret < 0) return ret;
+  if ((!ctx.pcap_file[0] && !ctx.iface[0]) || !ctx.nb_flows) {
+    printf(
+        "usage: %s --pcap <file> | --iface <netdev> [--video <udp port>] "
+        "[--audio <udp port>] [--anc <udp port>] [--utc_offset 37] [--report_s 0]\n",
+        argv[0]);
+    return -EINVAL;
+  }
+
+  if (ctx.pcap_file[0])
+    g_pcap = pcap_open_offline_with_tstamp_precision(ctx.pcap_file,
+                                                     PCAP_TSTAMP_PRECISION_NANO, errbuf);
+  else
+    g_pcap = ea_open_live(ctx.iface, errbuf);
+  if (!g_pcap) {
+    printf("open fail: %s\n", errbuf);
+    return -EIO;
+  }
+  if (pcap_datalink(g_pcap) != DLT_EN10MB) {
+    printf("not an ethernet capture\n");
+    pcap_close(g_pcap);
+    return -EIO;
+  }
+
+  signal(SIGINT, ea_sig_handler);
+  ret = pcap_loop(g_pcap, -1, ea_pkt_handler, (u_char*)&ctx);
+  if (ret == -1) printf("pcap_loop fail: %s\n", pcap_geterr(g_pcap));
+
+  ea_report(&ctx);
+  pcap_close(g_pcap);
+  return 0;
+}
@@ -0,0 +1,198 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <unistd.h>
+
+#include "mtl_telemetry_api.h"
+
+enum top_args_cmd {
+  TOP_ARG_UNKNOWN = 0,
+  TOP_ARG_PID = 0x100, /* start from end of ascii */
+  TOP_ARG_INTERVAL_MS,
+  TOP_ARG_ONCE,
+};
+
+struct top_context {
+  pid_t pid;
+  int interval_ms;
+  int once;
+};
+
+static struct option top_args_options[] = {
+    {"pid", required_argument, 0, TOP_ARG_PID},
+    {"interval_ms", required_argument, 0, TOP_ARG_INTERVAL_MS},
+    {"once", no_argument, 0, TOP_ARG_ONCE},
+
+    {0, 0, 0, 0}};
+
+static const char* top_session_type_names[MTL_TELEMETRY_SESSION_TYPE_MAX] = {
+    "st20_tx",
+    "st20_rx",
+    "st22_tx",
+    "st22_rx",
+};
+
+static int top_parse_args(struct top_context* ctx, int argc, char** argv) {
+  int cmd = -1, opt_idx = 0;
+
+  while (1) {
+    cmd = getopt_long_only(argc, argv, "hv", top_args_options, &opt_idx);
+    if (cmd == -1) break;
+
+    switch (cmd) {
+      case TOP_ARG_PID:
+        ctx->pid = atoi(optarg);
+        break;
+      case TOP_ARG_INTERVAL_MS:
+        ctx->interval_ms = atoi(optarg);
+        break;
+      case TOP_ARG_ONCE:
+        ctx->once = 1;
+        break;
+      default:
+        break;
+    }
+  };
+
+  return 0;
+}
+
+static double top_rate(uint64_t cur, uint64_t last, double time_sec) {
+  if ((time_sec <= 0) || (cur < last)) return 0;
+  return (double)(cur - last) / time_sec;
+}
+
+static void top_dump(struct mtl_telemetry_shm* cur, struct mtl_telemetry_shm* last) {
+  double time_sec = 0;
+  struct mtl_telemetry_session *s, *ls;
+
+  if (last->update_ns && (cur->update_ns > last->update_ns))
+    time_sec = (double)(cur->update_ns - last->update_ns) / 1000000000;
+
+  printf("mtl pid %d, seq %u, sessions %u\n", cur->pid, cur->seq, cur->nb_sessions);
+
+  printf("%-4s %-6s %-6s %-10s %-10s %-12s\n", "SCH", "LCORE", "TASKS", "SLEEP%",
+         "LOAD", "LOOPS/s");
+  for (uint32_t i = 0; i < cur->nb_schs; i++) {
+    struct mtl_telemetry_sch* sch = &cur->schs[i];
+    uint64_t last_loops = 0;
+    for (uint32_t j = 0; j < last->nb_schs; j++) {
+      if (last->schs[j].idx == sch->idx) last_loops = last->schs[j].loops;
+    }
+    printf("%-4d %-6d %-6u %-10.2f %-10.2f %-12.0f\n", sch->idx, sch->lcore,
+           sch->nb_tasklets, sch->sleep_ratio, sch->load,
+           top_rate(sch->loops, last_loops, time_sec));
+  }
+
+  for (uint32_t i = 0; i < cur->nb_ports; i++) {
+    struct mtl_telemetry_ptp* ptp = &cur->ptp[i];
+    if (!ptp->active) continue;
+    printf("PTP(%u): %s, offset %" PRId64 "ns path delay %" PRId64 "ns sync %" PRIu64
+           "\n",
+           i, ptp->master_initialized ? "locked" : "no master", ptp->offset_ns,
+           ptp->path_delay_ns, ptp->sync);
+  }
+
+  for (uint32_t i = 0; i < cur->nb_dmas; i++) {
+    struct mtl_telemetry_dma* dma = &cur->dma[i];
+    printf("DMA(%d): sch %d sessions %u inflight %u avg q %u load %.2fMb/s\n", dma->idx,
+           dma->sch_idx, dma->nb_session, dma->nb_inflight, dma->load_q,
+           (double)dma->load_bps / 1000 / 1000);
+  }
+
+  printf("%-8s %-4s %-4s %-20s %-10s %-8s %-12s %-10s %-10s %-10s\n", "TYPE", "SCH",
+         "IDX", "NAME", "SIZE", "FPS", "PKTS/s", "DROPS", "OOO", "EBU PASS%");
+  for (uint32_t i = 0; i < cur->nb_sessions; i++) {
+    char size[32];
+    double ebu_pass = 0;
+    s = &cur->sessions[i];
+    ls = NULL;
+    for (uint32_t j = 0; j < last->nb_sessions; j++) {
+      struct mtl_telemetry_session* t = &last->sessions[j];
+      if ((t->type == s->type) && (t->sch_idx == s->sch_idx) && (t->idx == s->idx)) {
+        ls = t;
+        break;
+      }
+    }
+    snprintf(size, sizeof(size), "%ux%u", s->width, s->height);
+    if (s->ebu.frames)
+      ebu_pass = (double)(s->ebu.compliance_narrow + s->ebu.compliance_wide) * 100 /
+                 s->ebu.frames;
+    printf("%-8s %-4d %-4u %-20s %-10s %-8.2f %-12.0f %-10" PRIu64 " %-10" PRIu64
+           " %-10.2f\n",
+           (s->type < MTL_TELEMETRY_SESSION_TYPE_MAX) ? top_session_type_names[s->type]
+                                                      : "unknown",
+           s->sch_idx, s->idx, s->name, size,
+           ls ? top_rate(s->frames, ls->frames, time_sec) : 0,
+           ls ? top_rate(s->pkts, ls->pkts, time_sec) : 0, s->drops, s->pkts_out_of_order,
+           ebu_pass);
+  }
+  printf("\n");
+}
+
+int main(int argc, char** argv) {
+  struct top_context ctx;
+  struct mtl_telemetry_shm *shm, *cur, *last, *tmp;
+  int shm_id, ret;
+
+  memset(&ctx, 0, sizeof(ctx));
+  ctx.interval_ms = 1000;
+  top_parse_args(&ctx, argc, argv);
+  if (ctx.pid <= 0) {
+    printf("usage: %s --pid <pid of the mtl process> [--interval_ms 1000] [--once]\n",
+           argv[0]);
+    return -EINVAL;
+  }
+
+  shm_id = shmget(mtl_telemetry_shm_key(ctx.pid), 0, 0);
+  if (shm_id < 0) {
+    printf("no telemetry segment for pid %d, is MTL_FLAG_TELEMETRY_SHM enabled?\n",
+           ctx.pid);
+    return -EIO;
+  }
+  shm = shmat(shm_id, NULL, SHM_RDONLY);
+  if (shm == (void*)-1) {
+    printf("attach telemetry segment fail\n");
+    return -EIO;
+  }
+
+  cur = calloc(1, sizeof(*cur));
+  last = calloc(1, sizeof(*last));
+  if (!cur || !last) {
+    printf("malloc fail\n");
+    free(cur);
+    free(last);
+    shmdt(shm);
+    return -ENOMEM;
+  }
+
+  while (1) {
+    ret = mtl_telemetry_read(shm, cur, 100);
+    if (ret < 0) {
+      printf("read telemetry fail %d\n", ret);
+      break;
+    }
+    if (cur->seq != last->seq) {
+      top_dump(cur, last);
+      tmp = last;
+      last = cur;
+      cur = tmp;
+    }
+    if (ctx.once) break;
+    usleep(ctx.interval_ms * 1000);
+  }
+
+  free(cur);
+  free(last);
+  shmdt(shm);
+  return 0;
+}